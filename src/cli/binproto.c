@@ -0,0 +1,480 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include <string.h>
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_BIN_PROTO
+
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "hwport.h"
+#include "phytsk.h"
+#include "timer.h"
+#include "uartdrv.h"
+#include "misc1.h"
+#include "binproto.h"
+
+#if UNMANAGED_PORT_STATISTICS_IF
+#include "h2stats.h"
+#endif
+
+#if TRANSIT_UNMANAGED_MAC_OPER_GET
+#include "h2mactab.h"
+#endif
+
+#if TRANSIT_SFLOW
+#include "h2sflow.h"
+#endif
+
+#if TRANSIT_LLDP
+#include "lldp_remote.h"
+#endif
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* Frame header: <len> <op> <seq>, the payload follows in bp_buf */
+#define BP_HDR_LEN          3
+#define BP_CRC_LEN          2
+
+#define BP_MAX_COUNTERS     8
+
+#define CLI_CTLC            0x03
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+
+static bit bp_active;
+
+/* Received frame without SOF, then the response payload from BP_HDR_LEN */
+static uchar xdata bp_buf[BP_HDR_LEN + BP_MAX_PAYLOAD + BP_CRC_LEN];
+static uchar xdata bp_rx_cnt;
+static ushort xdata bp_rx_crc;
+static ushort xdata bp_rx_tick;
+
+#if TRANSIT_UNMANAGED_MAC_OPER_GET
+static mac_tab_t xdata bp_mac_entry;
+static BOOL xdata bp_ipmc;
+#endif
+
+/*****************************************************************************
+ *
+ *
+ * Local functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+static ulong bp_get_ulong (uchar xdata *p)
+{
+    return ((ulong) p[0] << 24) | ((ulong) p[1] << 16) | ((ulong) p[2] << 8) | p[3];
+}
+
+static void bp_put_ulong (uchar xdata *p, ulong val)
+{
+    p[0] = (uchar) (val >> 24);
+    p[1] = (uchar) (val >> 16);
+    p[2] = (uchar) (val >> 8);
+    p[3] = (uchar) val;
+}
+
+static void bp_put_byte (uchar ch, ushort *crc)
+{
+    *crc = crc16_update(*crc, ch);
+    uart_put_byte(ch);
+}
+
+/* ************************************************************************ */
+static void bp_send (uchar len)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Send the response with len bytes payload in bp_buf.
+ * Remarks     : bp_buf[1] and bp_buf[2] still hold op and seq of the request.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ushort crc = CRC16_INIT;
+    uchar  i;
+
+    bp_buf[0] = len;
+    bp_buf[1] |= BP_OP_RESPONSE;
+
+    uart_put_byte(BP_SOF);
+    for (i = 0; i < BP_HDR_LEN + len; i++) {
+        bp_put_byte(bp_buf[i], &crc);
+    }
+    uart_put_byte((uchar) (crc >> 8));
+    uart_put_byte((uchar) crc);
+}
+
+static uchar bp_reg_read (uchar len, uchar xdata *p)
+{
+    ulong addr, val;
+    uchar cnt, i;
+
+    if (len != 5) {
+        return 0xFF;
+    }
+    addr = bp_get_ulong(&p[0]);
+    cnt  = p[4];
+    if (cnt == 0 || cnt > (BP_MAX_PAYLOAD - 1) / 4) {
+        p[0] = BP_STATUS_BAD_PARM;
+        return 1;
+    }
+
+    p[0] = BP_STATUS_OK;
+    for (i = 0; i < cnt; i++) {
+        H2_READ(addr, val);
+        bp_put_ulong(&p[1 + 4 * i], val);
+        addr += 4;
+    }
+    return 1 + 4 * cnt;
+}
+
+static uchar bp_reg_write (uchar len, uchar xdata *p)
+{
+    ulong addr, val;
+    uchar i;
+
+    if (len < 8 || (len & 3)) {
+        return 0xFF;
+    }
+    addr = bp_get_ulong(&p[0]);
+    for (i = 4; i < len; i += 4) {
+        val = bp_get_ulong(&p[i]);
+        H2_WRITE(addr, val);
+        addr += 4;
+    }
+
+    p[0] = BP_STATUS_OK;
+    return 1;
+}
+
+#if UNMANAGED_PORT_STATISTICS_IF
+static uchar bp_counters (uchar len, uchar xdata *p)
+{
+    uchar ids[BP_MAX_COUNTERS];
+    uchar cnt, uport, nports, i, j;
+    uchar xdata *q;
+
+    if (len < 2 || len > 1 + BP_MAX_COUNTERS) {
+        return 0xFF;
+    }
+    uport = p[0];
+    cnt = len - 1;
+    memcpy(ids, &p[1], cnt);
+    if (uport == 0 || uport > NO_OF_BOARD_PORTS) {
+        p[0] = BP_STATUS_BAD_PARM;
+        return 1;
+    }
+
+    nports = (BP_MAX_PAYLOAD - 2) / (1 + 4 * cnt);
+    if (nports > NO_OF_BOARD_PORTS + 1 - uport) {
+        nports = NO_OF_BOARD_PORTS + 1 - uport;
+    }
+
+    p[0] = BP_STATUS_OK;
+    p[1] = nports;
+    q = &p[2];
+    for (i = 0; i < nports; i++, uport++) {
+        *q++ = uport;
+        for (j = 0; j < cnt; j++) {
+            bp_put_ulong(q, h2_stats_counter_get(uport2cport(uport), (port_statistics_t) ids[j]));
+            q += 4;
+        }
+    }
+    return q - p;
+}
+#endif // UNMANAGED_PORT_STATISTICS_IF
+
+static uchar bp_link (uchar xdata *p)
+{
+    uchar uport;
+
+    p[0] = BP_STATUS_OK;
+    p[1] = NO_OF_BOARD_PORTS;
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        p[1 + uport] = port_link_mode_get(uport2cport(uport));
+    }
+    return 2 + NO_OF_BOARD_PORTS;
+}
+
+#if TRANSIT_UNMANAGED_MAC_OPER_GET
+static uchar bp_mac_page (uchar len, uchar xdata *p)
+{
+    ulong status, mask;
+    uchar cnt, uport;
+    uchar xdata *q;
+
+    if (len != 8) {
+        return 0xFF;
+    }
+    bp_mac_entry.vid = ((ushort) p[0] << 8) | p[1];
+    memcpy(bp_mac_entry.mac_addr, &p[2], MAC_ADDR_LEN);
+
+    p[0] = BP_STATUS_OK;
+    q = &p[2];
+    for (cnt = 0; cnt < BP_MAC_PER_PAGE; cnt++) {
+        status = h2_mactab_get_next(&bp_mac_entry, &bp_ipmc, TRUE);
+        if (status == 0xFFFFFFFF) {
+            break;
+        }
+
+        mask = TEST_PORT_BIT_MASK(CPU_CHIP_PORT, &bp_mac_entry.port_mask) ? 1 : 0;
+        for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+            if (TEST_PORT_BIT_MASK(uport2cport(uport), &bp_mac_entry.port_mask)) {
+                mask |= 1UL << uport;
+            }
+        }
+
+        *q++ = (uchar) (bp_mac_entry.vid >> 8);
+        *q++ = (uchar) bp_mac_entry.vid;
+        memcpy(q, bp_mac_entry.mac_addr, MAC_ADDR_LEN);
+        q += MAC_ADDR_LEN;
+        bp_put_ulong(q, mask);
+        q += 4;
+        *q++ = (VTSS_X_ANA_ANA_TABLES_MACACCESS_ENTRY_TYPE(status) ? 1 : 0) | (bp_ipmc ? 2 : 0);
+    }
+    p[1] = cnt;
+    return q - p;
+}
+#endif // TRANSIT_UNMANAGED_MAC_OPER_GET
+
+#if TRANSIT_LLDP
+static uchar bp_lldp (uchar len, uchar xdata *p)
+{
+    lldp_remote_entry_t xdata *entry;
+    uchar idx, max, clen, plen;
+    ushort ttl;
+    uchar xdata *q;
+
+    if (len != 1) {
+        return 0xFF;
+    }
+    idx = p[0];
+    max = lldp_remote_get_max_entries();
+
+    p[0] = BP_STATUS_OK;
+    q = &p[2];
+    for (; idx < max; idx++) {
+        entry = lldp_get_remote_entry(idx);
+        if (!entry->in_use) {
+            continue;
+        }
+        clen = entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID];
+        clen = clen > BP_LLDP_ID_LEN ? BP_LLDP_ID_LEN : clen;
+        plen = entry->str_len[LLDP_REMOTE_STR_PORT_ID];
+        plen = plen > BP_LLDP_ID_LEN ? BP_LLDP_ID_LEN : plen;
+        if ((q - p) + 7 + clen + plen > BP_MAX_PAYLOAD) {
+            break;
+        }
+        ttl = lldp_remote_ttl_left(entry);
+        *q++ = entry->receive_port;
+        *q++ = (uchar) (ttl >> 8);
+        *q++ = (uchar) ttl;
+        *q++ = entry->chassis_id_subtype;
+        *q++ = clen;
+        memcpy(q, lldp_remote_str(entry, LLDP_REMOTE_STR_CHASSIS_ID), clen);
+        q += clen;
+        *q++ = entry->port_id_subtype;
+        *q++ = plen;
+        memcpy(q, lldp_remote_str(entry, LLDP_REMOTE_STR_PORT_ID), plen);
+        q += plen;
+    }
+    p[1] = idx < max ? idx : 0xFF;
+    return q - p;
+}
+#endif // TRANSIT_LLDP
+
+/* ************************************************************************ */
+static void bp_handle_frame (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle the request in bp_buf and send the response.
+ * Remarks     : The handlers return the response payload length, or 0xFF
+ *               when the request has a bad length.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar xdata *p = &bp_buf[BP_HDR_LEN];
+    uchar len = bp_buf[0];
+    uchar rlen;
+
+    switch (bp_buf[1]) {
+    case BP_OP_INFO:
+        if (len != 0) {
+            rlen = 0xFF;
+            break;
+        }
+        p[0] = BP_STATUS_OK;
+        p[1] = BP_VERSION;
+        p[2] = NO_OF_BOARD_PORTS;
+        p[3] = BP_MAX_PAYLOAD;
+        rlen = 4;
+        break;
+
+    case BP_OP_REG_READ:
+        rlen = bp_reg_read(len, p);
+        break;
+
+    case BP_OP_REG_WRITE:
+        rlen = bp_reg_write(len, p);
+        break;
+
+#if UNMANAGED_PORT_STATISTICS_IF
+    case BP_OP_COUNTERS:
+        rlen = bp_counters(len, p);
+        break;
+#endif // UNMANAGED_PORT_STATISTICS_IF
+
+    case BP_OP_LINK:
+        rlen = len != 0 ? 0xFF : bp_link(p);
+        break;
+
+#if TRANSIT_UNMANAGED_MAC_OPER_GET
+    case BP_OP_MAC_PAGE:
+        rlen = bp_mac_page(len, p);
+        break;
+#endif // TRANSIT_UNMANAGED_MAC_OPER_GET
+
+#if TRANSIT_LLDP
+    case BP_OP_LLDP:
+        rlen = bp_lldp(len, p);
+        break;
+#endif // TRANSIT_LLDP
+
+#if TRANSIT_SFLOW
+    case BP_OP_SFLOW:
+        if (len != 0) {
+            rlen = 0xFF;
+            break;
+        }
+        p[0] = BP_STATUS_OK;
+        rlen = 1 + h2_sflow_export(&p[1], BP_MAX_PAYLOAD - 1);
+        break;
+#endif // TRANSIT_SFLOW
+
+    case BP_OP_EXIT:
+        if (len != 0) {
+            rlen = 0xFF;
+            break;
+        }
+        p[0] = BP_STATUS_OK;
+        rlen = 1;
+        bp_active = 0;
+        break;
+
+    default:
+        p[0] = BP_STATUS_BAD_OP;
+        rlen = 1;
+        break;
+    }
+
+    if (rlen == 0xFF) {
+        p[0] = BP_STATUS_BAD_LEN;
+        rlen = 1;
+    }
+    bp_send(rlen);
+}
+
+/*****************************************************************************
+ *
+ *
+ * Public functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+void binproto_start (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Switch the console to the binary protocol.
+ * Remarks     : See binproto.h for the frame layout.
+ * Restrictions:
+ * See also    : binproto_tsk
+ * Example     :
+ ****************************************************************************/
+{
+    bp_rx_cnt = 0;
+    bp_active = 1;
+}
+
+BOOL binproto_active (void)
+{
+    return bp_active;
+}
+
+/* ************************************************************************ */
+BOOL binproto_tsk (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Receive request frames and answer them.
+ * Remarks     : Called from cli_tsk() instead of the text CLI. At most one
+ *               request is handled per call. Returns FALSE when the binary
+ *               mode has ended.
+ * Restrictions:
+ * See also    : binproto_start
+ * Example     :
+ ****************************************************************************/
+{
+    uchar ch;
+
+    if (bp_rx_cnt && (ushort) (tick_count - bp_rx_tick) > BP_RX_TIMEOUT) {
+        bp_rx_cnt = 0; /* Frame stopped, wait for the next SOF */
+    }
+
+    while (bp_active && uart_byte_ready()) {
+        ch = uart_get_byte();
+        bp_rx_tick = tick_count;
+
+        if (bp_rx_cnt == 0) {
+            /* Hunt for SOF, bp_rx_cnt counts the SOF while receiving */
+            if (ch == BP_SOF) {
+                bp_rx_cnt = 1;
+                bp_rx_crc = CRC16_INIT;
+            } else if (ch == CLI_CTLC) {
+                bp_active = 0;
+            }
+            continue;
+        }
+
+        if (bp_rx_cnt == 1 && ch > BP_MAX_REQUEST) {
+            bp_rx_cnt = 0; /* Bad length */
+            continue;
+        }
+
+        bp_buf[bp_rx_cnt - 1] = ch;
+        bp_rx_cnt++;
+        if (bp_rx_cnt <= 1 + BP_HDR_LEN + bp_buf[0]) {
+            bp_rx_crc = crc16_update(bp_rx_crc, ch);
+        } else if (bp_rx_cnt == 1 + BP_HDR_LEN + bp_buf[0] + BP_CRC_LEN) {
+            bp_rx_cnt = 0;
+            if (bp_rx_crc == (((ushort) bp_buf[BP_HDR_LEN + bp_buf[0]] << 8) | bp_buf[BP_HDR_LEN + bp_buf[0] + 1])) {
+                bp_handle_frame();
+                break;
+            }
+        }
+    }
+
+    return bp_active;
+}
+#endif /* TRANSIT_BIN_PROTO */
@@ -0,0 +1,109 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __BINPROTO_H__
+#define __BINPROTO_H__
+
+#if TRANSIT_BIN_PROTO
+/*
+ * Binary telemetry protocol on the console UART, CLI command: BINARY
+ *
+ * Request and response frames have the same layout:
+ *   <SOF> <len> <op> <seq> <len bytes payload> <crc MSB> <crc LSB>
+ * The CRC-16/CCITT covers len, op, seq and the payload. Multi byte fields
+ * are sent MSB first. The response has op | BP_OP_RESPONSE and the seq of
+ * the request, its first payload byte is a BP_STATUS_xxx code.
+ *
+ * Frames with a bad CRC, or which stop for more than BP_RX_TIMEOUT ms, are
+ * dropped without a response. Text output from other tasks (traces, link
+ * messages) may appear between the frames and must be skipped by the host
+ * until the next SOF.
+ *
+ * The host sends the next request when the response has been received.
+ * Ctrl-C outside a frame or BP_OP_EXIT returns to the text CLI.
+ */
+#define BP_SOF              0xA5
+#define BP_VERSION          1
+#define BP_MAX_PAYLOAD      128
+#define BP_MAX_REQUEST      24  /* A whole request fits in the UART receive buffer */
+#define BP_RX_TIMEOUT       100
+
+#define BP_OP_RESPONSE      0x80
+
+/* Request: -
+ * Response: <status> <version> <no of ports> <max payload>
+ */
+#define BP_OP_INFO          0x01
+
+/* Request: <addr, 4 bytes> <cnt>
+ * Response: <status> <cnt values, 4 bytes each>
+ * Reads cnt consecutive registers (addr, addr + 4, ...).
+ */
+#define BP_OP_REG_READ      0x02
+
+/* Request: <addr, 4 bytes> <values, 4 bytes each>
+ * Response: <status>
+ * Writes consecutive registers.
+ */
+#define BP_OP_REG_WRITE     0x03
+
+/* Request: <first uport> <counter ids (port_statistics_t), 1 byte each>
+ * Response: <status> <nports> nports * (<uport> <counters, 4 bytes each>)
+ * As many ports as fit in one frame are returned, the host asks for the
+ * next ports with first uport = last uport + 1.
+ */
+#define BP_OP_COUNTERS      0x10
+
+/* Request: -
+ * Response: <status> <no of ports> <link mode (LINK_MODE_xxx)> per uport
+ */
+#define BP_OP_LINK          0x11
+
+/* Request: <vid, 2 bytes> <mac, 6 bytes>, all zero for the first page
+ * Response: <status> <cnt> cnt * (<vid, 2> <mac, 6> <uport mask, 4> <flags>)
+ * Bit 0 of the uport mask is the CPU. Flags: bit 0 static, bit 1 IPMC.
+ * The host asks for the next page with the last entry. A page with less
+ * than BP_MAC_PER_PAGE entries is the end of the table.
+ */
+#define BP_OP_MAC_PAGE      0x12
+#define BP_MAC_PER_PAGE     9
+
+/* Request: <first index>
+ * Response: <status> <next index, 0xFF at the end> entries of
+ *   <uport> <ttl, 2> <chassis id subtype> <len> <chassis id>
+ *   <port id subtype> <len> <port id>
+ * IDs longer than BP_LLDP_ID_LEN bytes are cut, so an entry always fits.
+ */
+#define BP_OP_LLDP          0x13
+#define BP_LLDP_ID_LEN      32
+
+/* Request: -
+ * Response: <status> <cnt> <seq, 2> <lost, 2>
+ *   cnt * (<uport> <dir> <rate, 2> <frame len, 2> <hdr len> <hdr>)
+ * The queued sFlow samples, oldest first, with seq the sequence number of
+ * the first one and lost the samples dropped since the last response. dir
+ * is 0 for received, 1 for transmitted frames, rate the 1-in-N sampling
+ * rate and hdr the first bytes of the frame. The samples are removed from
+ * the queue when sent. The sample pool is the port frame counters, read
+ * with BP_OP_COUNTERS.
+ */
+#define BP_OP_SFLOW         0x14
+
+/* Request: -
+ * Response: <status>, then the text CLI is resumed
+ */
+#define BP_OP_EXIT          0x7F
+
+#define BP_STATUS_OK        0
+#define BP_STATUS_BAD_OP    1
+#define BP_STATUS_BAD_LEN   2
+#define BP_STATUS_BAD_PARM  3
+
+void binproto_start (void);
+BOOL binproto_active (void);
+BOOL binproto_tsk (void);
+#endif /* TRANSIT_BIN_PROTO */
+
+#endif /* __BINPROTO_H__ */
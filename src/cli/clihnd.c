@@ -68,6 +68,34 @@
 #include "h2aggr.h"
 #endif
 
+#if TRANSIT_VLAN
+#include "h2vlan.h"
+#endif
+
+#if TRANSIT_IGMP_SNOOPING
+#include "ipmc_snoop.h"
+#endif
+
+#if TRANSIT_STORM_CONTROL
+#include "h2storm.h"
+#endif
+
+#if TRANSIT_SFLOW
+#include "h2sflow.h"
+#endif
+
+#if TRANSIT_MIRROR
+#include "h2mirror.h"
+#endif
+
+#if TRANSIT_QOS
+#include "h2qos.h"
+#endif
+
+#if TRANSIT_BUF_PROFILE
+#include "h2buf.h"
+#endif
+
 #if TRANSIT_LACP
 #include "vtss_lacp.h"
 #endif
@@ -79,6 +107,24 @@
 #if UNMANAGED_TCAM_DEBUG_IF
 #include "h2tcam.h"
 #endif
+
+#if TRANSIT_BIN_PROTO
+#include "binproto.h"
+#endif
+
+#if TRANSIT_US_CLOCK && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+#if TRANSIT_LLDP || TRANSIT_LACP
+#include "h2txrxaux.h"
+#endif
+#endif
+
+#if TRANSIT_TASK_PROFILE
+#include "taskdef.h"
+#endif
+
+#if TRANSIT_REG_TRACE
+#include "h2trace.h"
+#endif
 #ifndef NO_DEBUG_IF
 
 /*****************************************************************************
@@ -101,6 +147,18 @@
 #define EEE_WAKEUP_TIME_MIN 0
 #endif
 
+#if TRANSIT_CLI_RESUMABLE
+#define CLI_CONT_MAX_ROWS   4   /* Rows output per cli_tsk() call */
+#define CLI_CONT_MAX_MSEC   5   /* Time spent per cli_tsk() call */
+#define CLI_CONT_ROW_LEN    96  /* Transmit ring room needed for one row */
+#endif // TRANSIT_CLI_RESUMABLE
+
+#if TRANSIT_US_CLOCK && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+#define BENCH_LOOPS         100
+#define BENCH_FRAME_LEN     60
+#define BENCH_FLASH_LEN     16
+#endif // TRANSIT_US_CLOCK && !UNMANAGED_REDUCED_DEBUG_IF
+
 /*****************************************************************************
  *
  *
@@ -115,6 +173,36 @@ typedef struct {
     uchar len;
 } str_parm_t;
 
+#if TRANSIT_CLI_RESUMABLE
+/* Commands which output their rows over several cli_tsk() calls */
+typedef enum {
+    CLI_CONT_NONE,
+#if TRANSIT_UNMANAGED_MAC_OPER_GET
+    CLI_CONT_MAC_TABLE,
+#endif // TRANSIT_UNMANAGED_MAC_OPER_GET
+#if UNMANAGED_PORT_STATISTICS_IF
+    CLI_CONT_PORT_STATS,
+#endif // UNMANAGED_PORT_STATISTICS_IF
+#if TRANSIT_UNMANAGED_SWUP && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+    CLI_CONT_FLASH_DUMP,
+#endif // TRANSIT_UNMANAGED_SWUP && !UNMANAGED_REDUCED_DEBUG_IF
+} cli_cont_id_t;
+
+/* State of the running command */
+typedef struct {
+    cli_cont_id_t   id;
+    vtss_cport_no_t chip_port;  /* Port filter, or port being shown */
+    uchar           uport;      /* Next user port when showing all ports */
+    uchar           row;        /* Next row of the port */
+    ulong           addr;       /* Next flash address */
+    ulong           len;        /* Remaining flash bytes */
+    ulong           cnt;        /* Entries shown */
+#if TRANSIT_UNMANAGED_MAC_OPER_GET
+    mac_tab_t       mac_entry;  /* MAC table cursor */
+#endif // TRANSIT_UNMANAGED_MAC_OPER_GET
+} cli_cont_t;
+#endif // TRANSIT_CLI_RESUMABLE
+
 /*****************************************************************************
  *
  *
@@ -155,8 +243,52 @@ static void cmd_print_lldp_remoteinfo (void);
 static void cmd_run_veriphy(vtss_iport_no_t iport);
 #endif
 #if TRANSIT_UNMANAGED_MAC_OPER_GET
+#if !TRANSIT_CLI_RESUMABLE
 static void cli_show_mac_addr(vtss_cport_no_t chip_port);
+#endif // !TRANSIT_CLI_RESUMABLE
+static BOOL cli_show_mac_addr_next(mac_tab_t *mac_tab_entry, vtss_cport_no_t chip_port, ulong *total_cnt);
+static void cli_show_mac_addr_total(ulong total_cnt);
 #endif // TRANSIT_UNMANAGED_MAC_OPER_GET
+#if TRANSIT_CLI_RESUMABLE
+static void cli_cont_start(cli_cont_id_t id);
+static void cli_cont_run(void);
+#endif // TRANSIT_CLI_RESUMABLE
+#if TRANSIT_US_CLOCK && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+static void cmd_bench(uchar uport, BOOL tx);
+#endif // TRANSIT_US_CLOCK && !UNMANAGED_REDUCED_DEBUG_IF
+#if TRANSIT_TASK_WDT && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+static void cmd_wdt_show(void);
+#endif // TRANSIT_TASK_WDT && !UNMANAGED_REDUCED_DEBUG_IF
+#if TRANSIT_REG_TRACE
+static uchar cmd_trace(void);
+#endif // TRANSIT_REG_TRACE
+#if TRANSIT_LAG
+static uchar cmd_aggr(void);
+#endif // TRANSIT_LAG
+#if TRANSIT_VLAN
+static uchar cmd_vlan(void);
+#endif // TRANSIT_VLAN
+#if TRANSIT_IGMP_SNOOPING
+static uchar cmd_snoop(void);
+#endif // TRANSIT_IGMP_SNOOPING
+#if TRANSIT_STORM_CONTROL
+static uchar cmd_storm(void);
+#endif // TRANSIT_STORM_CONTROL
+#if TRANSIT_CPU_PROTECT
+static uchar cmd_cpuq(void);
+#endif // TRANSIT_CPU_PROTECT
+#if TRANSIT_SFLOW
+static uchar cmd_sflow(void);
+#endif // TRANSIT_SFLOW
+#if TRANSIT_MIRROR
+static uchar cmd_mirror(void);
+#endif // TRANSIT_MIRROR
+#if TRANSIT_QOS
+static uchar cmd_qos(void);
+#endif // TRANSIT_QOS
+#if TRANSIT_BUF_PROFILE
+static uchar cmd_buf_profile(void);
+#endif // TRANSIT_BUF_PROFILE
 
 /*****************************************************************************
  *
@@ -175,6 +307,14 @@ static uchar xdata cmd_buf [CLI_MAX_CMD_LEN];
 static uchar xdata *cmd_ptr;
 static uchar cmd_len = 0;
 
+#if TRANSIT_CLI_RESUMABLE
+static cli_cont_t xdata cli_cont;
+#endif // TRANSIT_CLI_RESUMABLE
+
+#if TRANSIT_US_CLOCK && !defined(UNMANAGED_REDUCED_DEBUG_IF) && (TRANSIT_LLDP || TRANSIT_LACP)
+static uchar xdata bench_buf [BENCH_FRAME_LEN];  /* Frame sent by BENCH */
+#endif // TRANSIT_US_CLOCK && !UNMANAGED_REDUCED_DEBUG_IF && (TRANSIT_LLDP || TRANSIT_LACP)
+
 /* Common Sequence Mnemonic */
 #define CLI_CTLC    0x03
 #define CLI_CTLD    0x04
@@ -215,6 +355,22 @@ void cli_tsk (void)
 {
     uchar error_status;
 
+#if TRANSIT_BIN_PROTO
+    if (binproto_active()) {
+        if (!binproto_tsk()) {
+            CLI_PROMPT();
+        }
+        return;
+    }
+#endif // TRANSIT_BIN_PROTO
+
+#if TRANSIT_CLI_RESUMABLE
+    if (cli_cont.id != CLI_CONT_NONE) {
+        cli_cont_run();
+        return;
+    }
+#endif // TRANSIT_CLI_RESUMABLE
+
     if (cmd_ready()) {
         cmd_ptr = &cmd_buf[0];
         skip_spaces();
@@ -268,9 +424,189 @@ void cli_tsk (void)
                     h2_reset();
                 }
             }
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+        } else if (cmd_cmp(cmd_ptr, "UPLOAD") == 0) {
+            /* UPLOAD <img_type> <len> <csum> [<baud>] */
+            cmd_ptr += (sizeof("UPLOAD") - 1);
+            if (retrieve_parms() != FORMAT_OK) {
+                error_status = FORMAT_ERROR;
+            } else if (parms_no != 3 && parms_no != 4) {
+                error_status = FORMAT_ERROR;
+            } else {
+#ifndef VTSS_COMMON_NDEBUG
+                vtss_os_trace_level = 0;
+#endif //VTSS_COMMON_NDEBUG
+#if FRONT_LED_PRESENT
+                led_update_system(VTSS_LED_MODE_BLINK_GREEN);
+#endif //FRONT_LED_PRESENT
+                print_cr_lf();
+                if (flash_upload_image((uchar) parms[0], (ulong) parms[1], (uchar) parms[2],
+                                       parms_no == 4 ? (ulong) parms[3] : 0)) {
+                    println_str("Fail");
+#if FRONT_LED_PRESENT
+                    led_update_system(VTSS_LED_MODE_ON_GREEN);
+#endif //FRONT_LED_PRESENT
+                } else {
+                    println_str("Done");
+                    h2_reset();
+                }
+            }
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM
         } else
 #endif //TRANSIT_UNMANAGED_SWUP
 
+#if TRANSIT_BIN_PROTO
+        if (cmd_cmp(cmd_ptr, "BINARY") == 0) {
+#ifndef VTSS_COMMON_NDEBUG
+            vtss_os_trace_level = 0;
+#endif //VTSS_COMMON_NDEBUG
+            print_cr_lf();
+            binproto_start();
+        } else
+#endif // TRANSIT_BIN_PROTO
+
+#if TRANSIT_US_CLOCK && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+        if (cmd_cmp(cmd_ptr, "BENCH") == 0) {
+            /* BENCH [<uport>] */
+            cmd_ptr += (sizeof("BENCH") - 1);
+            if (retrieve_parms() != FORMAT_OK || parms_no > 1 ||
+                (parms_no == 1 && (parms[0] < 1 || parms[0] > NO_OF_BOARD_PORTS))) {
+                println_str("%% Invalid command");
+            } else {
+                print_cr_lf();
+                cmd_bench(parms_no ? (uchar) parms[0] : 1, parms_no == 1);
+            }
+        } else
+#endif // TRANSIT_US_CLOCK && !UNMANAGED_REDUCED_DEBUG_IF
+
+#if TRANSIT_TASK_WDT && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+        if (cmd_cmp(cmd_ptr, "WDT") == 0) {
+            /* WDT [c] */
+            cmd_ptr += (sizeof("WDT") - 1);
+            print_cr_lf();
+            if (*cmd_ptr == ' ' && toupper(cmd_ptr[1]) == 'C') {
+                if (flash_pm_clear()) {
+                    println_str("%% Failed to erase the post-mortem records");
+                }
+            } else {
+                cmd_wdt_show();
+            }
+        } else
+#endif // TRANSIT_TASK_WDT && !UNMANAGED_REDUCED_DEBUG_IF
+
+#if TRANSIT_TASK_PROFILE
+        if (cmd_cmp(cmd_ptr, "PROFILE") == 0) {
+            /* PROFILE [c] */
+            cmd_ptr += (sizeof("PROFILE") - 1);
+            print_cr_lf();
+            if (*cmd_ptr == ' ' && toupper(cmd_ptr[1]) == 'C') {
+                task_prof_clear();
+            } else {
+                task_prof_print();
+            }
+        } else
+#endif // TRANSIT_TASK_PROFILE
+
+#if TRANSIT_REG_TRACE
+        if (cmd_cmp(cmd_ptr, "TRACE") == 0) {
+            /* TRACE [S [<addr>] | X | C | M <mask>] */
+            cmd_ptr += (sizeof("TRACE") - 1);
+            if (cmd_trace() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_REG_TRACE
+
+#if TRANSIT_LAG
+        if (cmd_cmp(cmd_ptr, "AGGR") == 0) {
+            /* AGGR [M <mode>] */
+            cmd_ptr += (sizeof("AGGR") - 1);
+            if (cmd_aggr() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_LAG
+
+#if TRANSIT_VLAN
+        if (cmd_cmp(cmd_ptr, "VLAN") == 0) {
+            /* VLAN [P <uport> <pvid> <aware> <tag> | A <vid> <uport mask>] */
+            cmd_ptr += (sizeof("VLAN") - 1);
+            if (cmd_vlan() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_VLAN
+
+#if TRANSIT_IGMP_SNOOPING
+        if (cmd_cmp(cmd_ptr, "SNOOP") == 0) {
+            /* SNOOP [E <enable> | F <uport> <enable>] */
+            cmd_ptr += (sizeof("SNOOP") - 1);
+            if (cmd_snoop() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_IGMP_SNOOPING
+
+#if TRANSIT_STORM_CONTROL
+        if (cmd_cmp(cmd_ptr, "STORM") == 0) {
+            /* STORM [C <class> <fps> | P <uport> <mode> <rate>] */
+            cmd_ptr += (sizeof("STORM") - 1);
+            if (cmd_storm() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_STORM_CONTROL
+
+#if TRANSIT_CPU_PROTECT
+        if (cmd_cmp(cmd_ptr, "CPUQ") == 0) {
+            /* CPUQ [C | R <queue> <fps>] */
+            cmd_ptr += (sizeof("CPUQ") - 1);
+            if (cmd_cpuq() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_CPU_PROTECT
+
+#if TRANSIT_SFLOW
+        if (cmd_cmp(cmd_ptr, "SFLOW") == 0) {
+            /* SFLOW [<uport> <rate> [<rx> <tx>]] */
+            cmd_ptr += (sizeof("SFLOW") - 1);
+            if (cmd_sflow() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_SFLOW
+
+#if TRANSIT_MIRROR
+        if (cmd_cmp(cmd_ptr, "MIRROR") == 0) {
+            /* MIRROR [D <uport> | P <uport> <rx> <tx> | C <cpu> | V <vid>] */
+            cmd_ptr += (sizeof("MIRROR") - 1);
+            if (cmd_mirror() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_MIRROR
+
+#if TRANSIT_QOS
+        if (cmd_cmp(cmd_ptr, "QOS") == 0) {
+            /* QOS [P <uport> <trust> <queue> <dwrr cnt> | C <pcp> <queue> | D <dscp> <queue> | W <queue> <weight> | S <uport>] */
+            cmd_ptr += (sizeof("QOS") - 1);
+            if (cmd_qos() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_QOS
+
+#if TRANSIT_BUF_PROFILE
+        if (cmd_cmp(cmd_ptr, "BUF") == 0) {
+            /* BUF [S <profile> | P <uport>] */
+            cmd_ptr += (sizeof("BUF") - 1);
+            if (cmd_buf_profile() != FORMAT_OK) {
+                println_str("%% Invalid command");
+            }
+        } else
+#endif // TRANSIT_BUF_PROFILE
+
 #if TRANSIT_UNMANAGED_SYS_MAC_CONF
             /*
                 config mac
@@ -294,6 +630,16 @@ void cli_tsk (void)
         }
 
         cmd_len = 0;
+#if TRANSIT_BIN_PROTO
+        /* The binary mode shows the prompt when it ends */
+        if (binproto_active()) {
+            return;
+        }
+#endif // TRANSIT_BIN_PROTO
+#if TRANSIT_CLI_RESUMABLE
+        /* A resumable command shows the prompt when it completes */
+        if (cli_cont.id == CLI_CONT_NONE)
+#endif // TRANSIT_CLI_RESUMABLE
         CLI_PROMPT();
     }
 }
@@ -505,6 +851,9 @@ static void cli_show_help_msg(void)
 
 #if UNMANAGED_PORT_STATISTICS_IF
     println_str("H <uport> [c]: Show/Clear port statistics (uport=0 for CPU port)");
+#if TRANSIT_CLI_RESUMABLE
+    println_str("H : Show port statistics of all ports");
+#endif // TRANSIT_CLI_RESUMABLE
 #endif // UNMANAGED_PORT_STATISTICS_IF
 
 #if defined(VTSS_ARCH_LUTON26)
@@ -514,9 +863,57 @@ static void cli_show_help_msg(void)
 #endif // VTSS_ARCH_LUTON26
 
     println_str("S <0|1>: Suspend/Resume applications (0=Resume, 1=Suspend)");
+#if TRANSIT_CLI_RESUMABLE
+    println_str("Ctrl-C : Abort a running M/H/D display");
+#endif // TRANSIT_CLI_RESUMABLE
+#if TRANSIT_BIN_PROTO
+    println_str("BINARY : Switch to the binary telemetry protocol (Ctrl-C returns)");
+#endif // TRANSIT_BIN_PROTO
+#if TRANSIT_US_CLOCK
+    println_str("BENCH [<uport>]: Time register/PHY/flash access, with uport also frame transmit");
+#endif // TRANSIT_US_CLOCK
+#if TRANSIT_TASK_WDT
+    println_str("WDT [c]: Show the last reset cause and the task watchdog post-mortem records/Clear the records");
+#endif // TRANSIT_TASK_WDT
+#if TRANSIT_TASK_PROFILE
+    println_str("PROFILE [c]: Show/Clear the run time per task and main loop iteration");
+#endif // TRANSIT_TASK_PROFILE
+#if TRANSIT_REG_TRACE
+    println_str("TRACE [s [<addr>]|x|c|m <mask>]: Show/Start (at write to addr)/Stop/Clear/Mask register trace");
+#endif // TRANSIT_REG_TRACE
+#if TRANSIT_LAG
+    println_str("AGGR [m <mode>]: Show aggregation hash mode and member utilisation/Set hash mode");
+#endif // TRANSIT_LAG
+#if TRANSIT_VLAN
+    println_str("VLAN [p <uport> <pvid> <aware> <tag 0|1|3>|a <vid> <uport mask>]: Show/Set port/Set VLAN members (mask 0 deletes)");
+#endif // TRANSIT_VLAN
+#if TRANSIT_IGMP_SNOOPING
+    println_str("SNOOP [e 0|1|f <uport> 0|1]: Show IGMP/MLD groups/Enable snooping/Enable fast leave");
+#endif // TRANSIT_IGMP_SNOOPING
+#if TRANSIT_STORM_CONTROL
+    println_str("STORM [c <0 uc|1 bc|2 mc> <fps>|p <uport> <0 off|1 kbps|2 fps> <rate>]: Show rates and drops/Set storm policer/Set port policer");
+#endif // TRANSIT_STORM_CONTROL
+#if TRANSIT_CPU_PROTECT
+    println_str("CPUQ [c|r <queue> <fps>]: Show CPU queue profile and counters/Clear counters/Set queue rate");
+#endif // TRANSIT_CPU_PROTECT
+#if TRANSIT_SFLOW
+    println_str("SFLOW [<uport> <rate> [<rx> <tx>]]: Show sFlow sampling/Sample 1 of <rate> frames, 0 is off");
+#endif // TRANSIT_SFLOW
+#if TRANSIT_MIRROR
+    println_str("MIRROR [d <uport>|p <uport> <rx> <tx>|c <0|1>|v <vid>]: Show mirroring and drops/Set destination, 0 is off/Set source port/Mirror CPU frames/Mirror VLAN, 0 is none");
+#endif // TRANSIT_MIRROR
+#if TRANSIT_QOS
+    println_str("QOS [p <uport> <trust> <queue> <dwrr cnt>|c <pcp> <queue>|d <dscp> <queue>|w <queue> <weight>|s <uport>]: Show QoS/Set port trust (0 port, 1 PCP, 2 DSCP), default queue and DWRR queues/Map PCP/Map DSCP/Set DWRR weight/Show queue counters");
+#endif // TRANSIT_QOS
+#if TRANSIT_BUF_PROFILE
+    println_str("BUF [s <profile>|p <uport>]: Show buffer profile and shared watermarks/Set profile at next boot (0 default, 1 jumbo, 2 qos, 3 burst)/Show reserved watermarks of a port, 0 is CPU");
+#endif // TRANSIT_BUF_PROFILE
 
 #if TRANSIT_UNMANAGED_SWUP
     println_str("D : Dump bytes from SPI flash");
+#if TRANSIT_SPI_FLASH_MANIFEST
+    println_str("D : Show image manifest and verify status");
+#endif // TRANSIT_SPI_FLASH_MANIFEST
 #endif // TRANSIT_UNMANAGED_SWUP
 
 #endif /* UNMANAGED_REDUCED_DEBUG_IF */
@@ -649,7 +1046,12 @@ static uchar handle_command (void)
 #if TRANSIT_UNMANAGED_MAC_OPER_GET
     case 'M': /* Show/Clear MAC address entries */
         if (parms_no <= 1) {
+#if TRANSIT_CLI_RESUMABLE
+            cli_cont_start(CLI_CONT_MAC_TABLE);
+            cli_cont.chip_port = parms_no ? (parms[0] == 0 ? CPU_CHIP_PORT : uport2cport(parms[0])) : 0xFF;
+#else
             cli_show_mac_addr(parms_no ? (parms[0] == 0 ? CPU_CHIP_PORT : uport2cport(parms[0])) : 0xFF);
+#endif // TRANSIT_CLI_RESUMABLE
         } else {
             h2_mactab_flush_port(uport2cport(parms[0]));
         }
@@ -1116,7 +1518,18 @@ break;
 #if UNMANAGED_PORT_STATISTICS_IF
     case 'H': /* Show/Clear port statistics */
         if (parms_no == 1) {
+#if TRANSIT_CLI_RESUMABLE
+            cli_cont_start(CLI_CONT_PORT_STATS);
+            cli_cont.chip_port = parms[0] == 0 ? CPU_CHIP_PORT : uport2cport(parms[0]);
+            cli_cont.uport = NO_OF_BOARD_PORTS + 1; /* Only this port */
+        } else if (parms_no == 0) {
+            /* All ports */
+            cli_cont_start(CLI_CONT_PORT_STATS);
+            cli_cont.chip_port = uport2cport(1);
+            cli_cont.uport = 1;
+#else
             print_port_statistics(parms[0] == 0 ? CPU_CHIP_PORT : uport2cport(parms[0]));
+#endif // TRANSIT_CLI_RESUMABLE
         } else if (parms_no == 2 && parms[0] <= NO_OF_BOARD_PORTS) {
             h2_stats_counter_clear(parms[0] == 0 ? CPU_CHIP_PORT : uport2cport(parms[0]));
         } else {
@@ -1326,7 +1739,22 @@ break;
 
 #if TRANSIT_UNMANAGED_SWUP
     case 'D': /* Dump bytes from SPI flash */
+#if TRANSIT_SPI_FLASH_MANIFEST
+        if (parms_no == 0) {
+            flash_verify_print();
+            break;
+        }
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+#if TRANSIT_CLI_RESUMABLE
+        if (parms[1] != 0) {
+            cli_cont_start(CLI_CONT_FLASH_DUMP);
+            cli_cont.addr = parms[0];
+            cli_cont.len  = parms[1];
+            print_cr_lf();
+        }
+#else
         flash_read_bytes(parms[0], parms[1]);
+#endif // TRANSIT_CLI_RESUMABLE
         break;
 #endif
 
@@ -1338,139 +1766,869 @@ break;
     return FORMAT_OK;
 }
 
+#if TRANSIT_US_CLOCK && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+typedef enum {
+    BENCH_LOOP,             /* Loop and dispatch overhead only */
+    BENCH_H2_READ,
+    BENCH_PHY_READ,
+    BENCH_FLASH_READ,
+    BENCH_TX_FRAME
+} bench_id_t;
+
 /* ************************************************************************ */
-static uchar retrieve_parms (void)
+static ulong bench_run(bench_id_t id, vtss_cport_no_t chip_port)
 /* ------------------------------------------------------------------------ --
- * Purpose     : Retrieve parameters from command string.
- * Remarks     : Module variable cmd_ptr must have been set to point to first
- *               char after the command in the command string, when this function
- *               is called.
- *               The module variables parms_no and parms are updated with
- *               actual number of parameters and the actual parameter values.
- *               Returns 0, if successful, otherwise <> 0.
+ * Purpose     : Time BENCH_LOOPS calls of one access function.
+ * Remarks     : Returns the time in usec. The values read go to a volatile,
+ *               so the reads are not optimized away.
  * Restrictions:
- * See also    :
+ * See also    : cmd_bench
  * Example     :
  ****************************************************************************/
 {
-    uchar ch;
-    uchar base;
-    uchar j;
-    uchar no_of_digits;
-    uchar digits [10];
-    ulong parm_bin;
-
-    ch = *cmd_ptr;
-    if ((ch != ' ') && (ch != CLI_CR)) {
-        return FORMAT_ERROR;
+    ulong start;
+    volatile ulong val;
+    uchar i;
+
+    start = us_clock_get();
+    for (i = 0; i < BENCH_LOOPS; i++) {
+        switch (id) {
+        case BENCH_H2_READ:
+            H2_READ(VTSS_DEVCPU_GCB_CHIP_REGS_CHIP_ID, val);
+            break;
+        case BENCH_PHY_READ:
+            val = phy_read(chip_port, 2);
+            break;
+#if TRANSIT_UNMANAGED_SWUP
+        case BENCH_FLASH_READ:
+            flash_read_bytes(0, BENCH_FLASH_LEN);
+            break;
+#endif // TRANSIT_UNMANAGED_SWUP
+#if TRANSIT_LLDP || TRANSIT_LACP
+        case BENCH_TX_FRAME:
+            (void) h2_tx_frame_port(chip_port, bench_buf, BENCH_FRAME_LEN, VTSS_VID_NULL);
+            break;
+#endif // TRANSIT_LLDP || TRANSIT_LACP
+        default:
+            break;
+        }
     }
+    return elapsed_us(start);
+}
 
+/* ************************************************************************ */
+static void cmd_bench(uchar uport, BOOL tx)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Show the time per call of the register, PHY, flash and frame
+ *               transmit functions.
+ * Remarks     : The PHY of uport is read. flash_read_bytes() prints its hex
+ *               dump, so the flash time includes the UART output. With tx,
+ *               BENCH_LOOPS frames to the own MAC address (ether type
+ *               0x88B5, local experimental) are sent on uport.
+ * Restrictions:
+ * See also    : bench_run
+ * Example     :
+ ****************************************************************************/
+{
+    static const char * code bench_name[] = {
+        "", "h2_read", "phy_read", "flash_read_bytes (16 bytes)", "h2_tx_frame_port (60 bytes)"
+    };
+    vtss_cport_no_t chip_port = uport2cport(uport);
+    ulong loop_us, us;
+    uchar id, last = BENCH_FLASH_READ;
 
-    parms_no = 0;
-    /* Preset parms to ff's, which may be used as default indication */
-    memset(parms, 0xff, sizeof(parms));
-
-    /*
-    ** Retrieve parameters one by one.
-    */
-    for (;;) {
-
-        skip_spaces();
-        base = 10; /* default parameter is specified in decimal */
-        no_of_digits = 0;
+#if TRANSIT_LLDP || TRANSIT_LACP
+    if (tx) {
+        memset(bench_buf, 0, BENCH_FRAME_LEN);
+        flash_read_mac_addr(&bench_buf[0]);
+        flash_read_mac_addr(&bench_buf[6]);
+        bench_buf[12] = 0x88;
+        bench_buf[13] = 0xB5;
+        last = BENCH_TX_FRAME;
+    }
+#endif // TRANSIT_LLDP || TRANSIT_LACP
 
-        /*
-        ** Check if any hex prefix
-        */
-        if (*cmd_ptr == '0' && (conv_to_upper_case(*(cmd_ptr + 1)) == 'X')) {
-            base = 16; /* parameter is specified in hex */
-            cmd_ptr += 2;
-            if (*cmd_ptr == ' ') {
-                return FORMAT_ERROR;
-            }
+    loop_us = bench_run(BENCH_LOOP, chip_port);
+    for (id = BENCH_H2_READ; id <= last; id++) {
+#if !TRANSIT_UNMANAGED_SWUP
+        if (id == BENCH_FLASH_READ) {
+            continue;   /* The flash access functions are not built */
         }
+#endif // !TRANSIT_UNMANAGED_SWUP
+        us = bench_run(id, chip_port);
+        us = (us > loop_us) ? us - loop_us : 0;
+
+        /* usec per call with one decimal */
+        us = us * 10 / BENCH_LOOPS;
+        print_str(bench_name[id]);
+        print_spaces(30 - strlen(bench_name[id]));
+        print_dec(us / 10);
+        print_ch('.');
+        print_dec(us % 10);
+        println_str(" us");
+    }
+}
+#endif // TRANSIT_US_CLOCK && !UNMANAGED_REDUCED_DEBUG_IF
 
-        /*
-        ** Retrieve digits until delimiter (space or CR) and then convert
-        ** parameter to binary
-        */
-        for (;;) {
-
-            ch = *cmd_ptr;
-
-            if ((ch == ' ') || (ch == CLI_CR)) {
+#if TRANSIT_TASK_WDT && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+/* ************************************************************************ */
+static void cmd_wdt_show(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Show whether the last reset was done by the watchdog and the
+ *               post-mortem records of the task watchdog.
+ * Remarks     : The task is a task_id_t/sub_task_id_t of this build, see
+ *               taskdef.h.
+ * Restrictions:
+ * See also    : flash_pm_get
+ * Example     :
+ ****************************************************************************/
+{
+    flash_pm_rec_t rec;
+    uchar idx, rc;
 
-                if (no_of_digits > 0) {
-                    parm_bin = 0;
-                    for (j = 0; j < no_of_digits; j++) {
-                        parm_bin = (parm_bin * base) + digits[j];
-                    }
-                    if (parms_no < CLI_MAX_NO_OF_PARMS) {
-                        parms[parms_no++] = parm_bin;
-                    }
-                }
-                /* End processing at end of command string */
-                if (ch == CLI_CR) {
-                    return FORMAT_OK;
-                }
-                break; /* go get new parameter */
-            } else {
+    print_str("Last reset: ");
+    println_str(wdt_last_reset_get() ? "watchdog" : "power-on/software");
 
-                ch = ascii_to_hex_nib(ch);
-                if (ch != 0xff) {
-                    if (no_of_digits < 10) {
-                        digits[no_of_digits++] = ch;
-                        if (ch > 9) {
-                            base = 16; /* parameter is specified in hex */
-                        }
-                    }
-                } else {
-                    return FORMAT_ERROR;
-                }
-            }
-            cmd_ptr++;
+    for (idx = 0; (rc = flash_pm_get(idx, &rec)) != 1; idx++) {
+        print_dec_8_right_2(idx + 1);
+        if (rc) {
+            println_str(": damaged record");
+            continue;
         }
+        print_str(": task ");
+        print_dec(rec.task_id);
+        print_str(", running ");
+        print_dec((ulong) rec.ticks * 100);
+        print_str(" ms, register 0x");
+        print_hex_dw(rec.reg_addr);
+        print_str(", up time ");
+        print_dec(rec.up_time);
+        println_str(" s");
+    }
+    if (idx == 0) {
+        println_str("No post-mortem records");
+    } else if (idx == FLASH_PM_REC_CNT) {
+        println_str("All record slots are used, further records are dropped until WDT C");
     }
 }
+#endif // TRANSIT_TASK_WDT && !UNMANAGED_REDUCED_DEBUG_IF
 
-#if TRANSIT_UNMANAGED_SYS_MAC_CONF
+#if TRANSIT_REG_TRACE
 /* ************************************************************************ */
-static uchar retrieve_str_parms (void)
+static uchar cmd_trace(void)
 /* ------------------------------------------------------------------------ --
- * Purpose     : Retrieve parameters from command string.
- * Remarks     : Module variable cmd_ptr must have been set to point to first
- *               char after the command in the command string, when this function
- *               is called.
- *               The module variables parms_no and parms are updated with
- *               actual number of parameters and the actual parameter values.
- *               Returns 0, if successful, otherwise <> 0.
+ * Purpose     : Handle TRACE [S [<addr>] | X | C | M <mask>].
+ * Remarks     : cmd_ptr points to the first char after TRACE.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
  * Restrictions:
- * See also    :
- * Example     :
+ * See also    : h2trace.c
+ * Example     : TRACE S 0x71880000 starts recording at a write to that
+ *               register.
  ****************************************************************************/
 {
-    uchar ch;
-    uchar j;
+    uchar opt;
 
-    ch = *cmd_ptr;
-    if ((ch != ' ') && (ch != CLI_CR)) {
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
         return FORMAT_ERROR;
     }
 
-    parms_no = 0;
-    for(parms_no = 0; parms_no < CLI_MAX_NO_OF_PARMS; parms_no++) {
-        skip_spaces();
-        str_parms[parms_no].str = cmd_ptr;
-        str_parms[parms_no].len = 0;
-        while(1) {
-            if(*cmd_ptr == CLI_CR) { /* Enter Key */
-                *cmd_ptr = '\0';
-                for(j = parms_no + 1; j < CLI_MAX_NO_OF_PARMS; j++) {
-                    str_parms[j].str = cmd_ptr;
-                    str_parms[j].len = 0;
-                }
-                return FORMAT_OK;
-            }
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        h2_trace_print();
+        break;
+    case 'S':
+        if (parms_no > 1) {
+            return FORMAT_ERROR;
+        }
+        h2_trace_start(parms_no ? parms[0] : 0);
+        break;
+    case 'X':
+        h2_trace_stop();
+        break;
+    case 'C':
+        h2_trace_clear();
+        break;
+    case 'M':
+        if (parms_no != 1 || parms[0] > 0xFF) {
+            return FORMAT_ERROR;
+        }
+        h2_trace_mask_set((uchar) parms[0]);
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+    return FORMAT_OK;
+}
+#endif // TRANSIT_REG_TRACE
+
+#if TRANSIT_LAG
+/* ************************************************************************ */
+static uchar cmd_aggr(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle AGGR [M <mode>].
+ * Remarks     : cmd_ptr points to the first char after AGGR.
+ *               <mode> is a mask of H2_AGGR_HASH_xxx. It is saved in flash
+ *               at once when the configuration journal is used, otherwise by
+ *               CONFIG SAVE.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2aggr.h
+ * Example     : AGGR M 0x06 hashes on the IPv4 addresses and TCP/UDP ports.
+ ****************************************************************************/
+{
+    uchar opt;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        print_str("Hash mode: 0x");
+        print_hex_b(h2_aggr_get_mode());
+        print_cr_lf();
+#if UNMANAGED_PORT_STATISTICS_IF
+        h2_aggr_print_util();
+#endif // UNMANAGED_PORT_STATISTICS_IF
+        break;
+    case 'M':
+        if (parms_no != 1 || parms[0] > 0xFF || h2_aggr_set_mode((uchar) parms[0])) {
+            return FORMAT_ERROR;
+        }
+#if TRANSIT_SPI_FLASH_JOURNAL
+        if (flash_program_config()) {
+            println_str("%% Flash write failed");
+        }
+#else
+        print_cr_lf();
+        println_str("Not saved, the hash mode is lost at the next boot");
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+    return FORMAT_OK;
+}
+#endif // TRANSIT_LAG
+
+#if TRANSIT_VLAN
+/* ************************************************************************ */
+static uchar cmd_vlan(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle VLAN [P <uport> <pvid> <aware> <tag> | A <vid> <uport mask>].
+ * Remarks     : cmd_ptr points to the first char after VLAN.
+ *               <tag> is H2_VLAN_TX_xxx, bit n of <uport mask> is uport n.
+ *               The change is saved in flash at once when the configuration
+ *               journal is used, otherwise by CONFIG SAVE.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2vlan.h
+ * Example     : VLAN A 10 0x6 makes uport 1 and 2 the members of VLAN 10,
+ *               VLAN P 1 10 0 0 puts uport 1 untagged in VLAN 10.
+ ****************************************************************************/
+{
+    h2_vlan_port_conf_t port_conf;
+    uchar opt;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        h2_vlan_print();
+        return FORMAT_OK;
+    case 'P':
+        if (parms_no != 4 || parms[0] > NO_OF_BOARD_PORTS || parms[1] > 0xFFFF || parms[3] > 0xFF) {
+            return FORMAT_ERROR;
+        }
+        port_conf.pvid   = (ushort) parms[1];
+        port_conf.aware  = (parms[2] != 0);
+        port_conf.tx_tag = (uchar) parms[3];
+        if (h2_vlan_port_set((vtss_uport_no_t) parms[0], &port_conf)) {
+            return FORMAT_ERROR;
+        }
+        break;
+    case 'A':
+        if (parms_no != 2 || parms[0] > 0xFFFF) {
+            return FORMAT_ERROR;
+        }
+        if (h2_vlan_entry_set((ushort) parms[0], parms[1])) {
+            return FORMAT_ERROR;
+        }
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+    if (flash_program_config()) {
+        println_str("%% Flash write failed");
+    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+    return FORMAT_OK;
+}
+#endif // TRANSIT_VLAN
+
+#if TRANSIT_IGMP_SNOOPING
+/* ************************************************************************ */
+static uchar cmd_snoop(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle SNOOP [E <enable> | F <uport> <enable>].
+ * Remarks     : cmd_ptr points to the first char after SNOOP.
+ *               The settings are not saved, snooping is enabled at boot.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : ipmc_snoop.h
+ * Example     : SNOOP F 3 1 enables fast leave on uport 3.
+ ****************************************************************************/
+{
+    uchar opt;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        ipmc_print();
+        break;
+    case 'E':
+        if (parms_no != 1) {
+            return FORMAT_ERROR;
+        }
+        ipmc_enable_set(parms[0] != 0);
+        break;
+    case 'F':
+        if (parms_no != 2 || parms[0] > NO_OF_BOARD_PORTS ||
+            ipmc_fast_leave_set((vtss_uport_no_t) parms[0], parms[1] != 0)) {
+            return FORMAT_ERROR;
+        }
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+    return FORMAT_OK;
+}
+#endif // TRANSIT_IGMP_SNOOPING
+
+#if TRANSIT_STORM_CONTROL
+/* ************************************************************************ */
+static uchar cmd_storm(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle STORM [C <class> <fps> | P <uport> <mode> <rate>].
+ * Remarks     : cmd_ptr points to the first char after STORM.
+ *               <class> is H2_STORM_CLASS_xxx, <mode> is H2_STORM_PORT_xxx.
+ *               The change is saved in flash at once when the configuration
+ *               journal is used, otherwise by CONFIG SAVE.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2storm.h
+ * Example     : STORM C 1 1000 limits broadcast to 512 frames/s,
+ *               STORM P 2 1 20000 limits uport 2 to 20 Mbit/s.
+ ****************************************************************************/
+{
+    h2_storm_port_conf_t port_conf;
+    uchar opt;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        h2_storm_print();
+        return FORMAT_OK;
+    case 'C':
+        if (parms_no != 2 || parms[0] > 0xFF ||
+            h2_storm_class_set((uchar) parms[0], parms[1])) {
+            return FORMAT_ERROR;
+        }
+        break;
+    case 'P':
+        if (parms_no < 2 || parms[0] > NO_OF_BOARD_PORTS || parms[1] > 0xFF) {
+            return FORMAT_ERROR;
+        }
+        port_conf.mode = (uchar) parms[1];
+        port_conf.rate = (parms_no > 2 ? parms[2] : 0);
+        if (h2_storm_port_set((vtss_uport_no_t) parms[0], &port_conf)) {
+            return FORMAT_ERROR;
+        }
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+    if (flash_program_config()) {
+        println_str("%% Flash write failed");
+    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+    return FORMAT_OK;
+}
+#endif // TRANSIT_STORM_CONTROL
+
+#if TRANSIT_CPU_PROTECT
+/* ************************************************************************ */
+static uchar cmd_cpuq(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle CPUQ [C | R <queue> <fps>].
+ * Remarks     : cmd_ptr points to the first char after CPUQ.
+ *               The rate is not saved, the profile default is used at boot.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2txrx.h
+ * Example     : CPUQ R 3 500 polices the IGMP/MLD queue to 500 frames/s.
+ ****************************************************************************/
+{
+    uchar opt;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        h2_cpuq_print();
+        break;
+    case 'C':
+        h2_cpuq_clear();
+        break;
+    case 'R':
+        if (parms_no != 2 || parms[0] > 0xFF || parms[1] > 0xFFFF ||
+            h2_cpuq_rate_set((uchar) parms[0], (ushort) parms[1])) {
+            return FORMAT_ERROR;
+        }
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+    return FORMAT_OK;
+}
+#endif // TRANSIT_CPU_PROTECT
+
+#if TRANSIT_SFLOW
+/* ************************************************************************ */
+static uchar cmd_sflow(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle SFLOW [<uport> <rate> [<rx> <tx>]].
+ * Remarks     : cmd_ptr points to the first char after SFLOW.
+ *               Without <rx> <tx> both directions are sampled.
+ *               The sampling is not saved, it is off at boot.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2sflow.h, BP_OP_SFLOW
+ * Example     : SFLOW 3 1000 0 1 samples 1 of 1024 frames sent on uport 3.
+ ****************************************************************************/
+{
+    h2_sflow_port_conf_t port_conf;
+
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    if (parms_no == 0) {
+        print_cr_lf();
+        h2_sflow_print();
+        return FORMAT_OK;
+    }
+
+    if ((parms_no != 2 && parms_no != 4) || parms[0] > NO_OF_BOARD_PORTS ||
+        parms[1] > 0xFFFF) {
+        return FORMAT_ERROR;
+    }
+    port_conf.rate = (ushort) parms[1];
+    port_conf.rx = (parms_no == 4 ? (parms[2] != 0) : 1);
+    port_conf.tx = (parms_no == 4 ? (parms[3] != 0) : 1);
+    if (h2_sflow_port_set((vtss_uport_no_t) parms[0], &port_conf)) {
+        return FORMAT_ERROR;
+    }
+    return FORMAT_OK;
+}
+#endif // TRANSIT_SFLOW
+
+#if TRANSIT_MIRROR
+/* ************************************************************************ */
+static uchar cmd_mirror(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle MIRROR [D <uport> | P <uport> <rx> <tx> | C <cpu> | V <vid>].
+ * Remarks     : cmd_ptr points to the first char after MIRROR.
+ *               The change is saved in flash at once when the configuration
+ *               journal is used, otherwise by CONFIG SAVE.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2mirror.h
+ * Example     : MIRROR P 1 1 1 and MIRROR D 8 copy all traffic of uport 1
+ *               to uport 8.
+ ****************************************************************************/
+{
+    h2_mirror_conf_t conf;
+    ulong            uport_bit;
+    uchar            opt;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    h2_mirror_conf_get(&conf);
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        h2_mirror_print();
+        return FORMAT_OK;
+    case 'D':
+        if (parms_no != 1 || parms[0] > 0xFF) {
+            return FORMAT_ERROR;
+        }
+        conf.dest = (uchar) parms[0];
+        break;
+    case 'P':
+        if (parms_no != 3 || parms[0] < 1 || parms[0] > NO_OF_BOARD_PORTS) {
+            return FORMAT_ERROR;
+        }
+        uport_bit = (ulong) 1 << parms[0];
+        conf.rx_mask = parms[1] ? (conf.rx_mask | uport_bit) : (conf.rx_mask & ~uport_bit);
+        conf.tx_mask = parms[2] ? (conf.tx_mask | uport_bit) : (conf.tx_mask & ~uport_bit);
+        break;
+    case 'C':
+        if (parms_no != 1) {
+            return FORMAT_ERROR;
+        }
+        conf.cpu = (parms[0] != 0);
+        break;
+    case 'V':
+        if (parms_no != 1 || parms[0] > 0xFFFF) {
+            return FORMAT_ERROR;
+        }
+        conf.vid = (ushort) parms[0];
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+    if (h2_mirror_conf_set(&conf)) {
+        return FORMAT_ERROR;
+    }
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+    if (flash_program_config()) {
+        println_str("%% Flash write failed");
+    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+    return FORMAT_OK;
+}
+#endif // TRANSIT_MIRROR
+
+#if TRANSIT_QOS
+/* ************************************************************************ */
+static uchar cmd_qos(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle QOS [P <uport> <trust> <queue> <dwrr cnt> |
+ *               C <pcp> <queue> | D <dscp> <queue> | W <queue> <weight> |
+ *               S <uport>].
+ * Remarks     : cmd_ptr points to the first char after QOS.
+ *               The change is saved in flash at once when the configuration
+ *               journal is used, otherwise by CONFIG SAVE.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2qos.h
+ * Example     : QOS P 1 2 0 4 classifies IP frames of uport 1 by DSCP and
+ *               schedules queues 0-3 by DWRR, 4-7 in strict priority.
+ ****************************************************************************/
+{
+    h2_qos_port_conf_t port_conf;
+    uchar              opt;
+    uchar              rc;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        h2_qos_print();
+        return FORMAT_OK;
+    case 'S':
+        if (parms_no != 1 || parms[0] < 1 || parms[0] > NO_OF_BOARD_PORTS) {
+            return FORMAT_ERROR;
+        }
+        print_cr_lf();
+        h2_qos_queue_print((vtss_uport_no_t) parms[0]);
+        return FORMAT_OK;
+    case 'P':
+        if (parms_no != 4 || parms[1] > 0xFF || parms[2] > 0xFF || parms[3] > 0xFF) {
+            return FORMAT_ERROR;
+        }
+        port_conf.trust = (uchar) parms[1];
+        port_conf.default_queue = (uchar) parms[2];
+        port_conf.dwrr_cnt = (uchar) parms[3];
+        rc = h2_qos_port_set((vtss_uport_no_t) parms[0], &port_conf);
+        break;
+    case 'C':
+    case 'D':
+    case 'W':
+        if (parms_no != 2 || parms[0] > 0xFF || parms[1] > 0xFF) {
+            return FORMAT_ERROR;
+        }
+        if (opt == 'C') {
+            rc = h2_qos_pcp_set((uchar) parms[0], (uchar) parms[1]);
+        } else if (opt == 'D') {
+            rc = h2_qos_dscp_set((uchar) parms[0], (uchar) parms[1]);
+        } else {
+            rc = h2_qos_weight_set((uchar) parms[0], (uchar) parms[1]);
+        }
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+    if (rc) {
+        return FORMAT_ERROR;
+    }
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+    if (flash_program_config()) {
+        println_str("%% Flash write failed");
+    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+    return FORMAT_OK;
+}
+#endif // TRANSIT_QOS
+
+#if TRANSIT_BUF_PROFILE
+/* ************************************************************************ */
+static uchar cmd_buf_profile(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle BUF [S <profile> | P <uport>].
+ * Remarks     : cmd_ptr points to the first char after BUF.
+ *               The profile is saved in flash at once when the
+ *               configuration journal is used, otherwise by CONFIG SAVE.
+ *               It takes effect at the next boot.
+ *               Returns FORMAT_OK if successful, otherwise FORMAT_ERROR.
+ * Restrictions:
+ * See also    : h2buf.h
+ * Example     : BUF S 3 selects the burst absorbing profile.
+ ****************************************************************************/
+{
+    uchar opt;
+
+    skip_spaces();
+    opt = toupper(*cmd_ptr);
+    if (opt != CLI_CR) {
+        cmd_ptr++;
+    }
+    if (retrieve_parms() != FORMAT_OK) {
+        return FORMAT_ERROR;
+    }
+
+    switch (opt) {
+    case CLI_CR:
+        print_cr_lf();
+        h2_buf_print();
+        return FORMAT_OK;
+    case 'P':
+        if (parms_no != 1 || parms[0] > NO_OF_BOARD_PORTS) {
+            return FORMAT_ERROR;
+        }
+        print_cr_lf();
+        h2_buf_port_print((vtss_uport_no_t) parms[0]);
+        return FORMAT_OK;
+    case 'S':
+        if (parms_no != 1 || parms[0] > 0xFF || h2_buf_profile_set((uchar) parms[0])) {
+            return FORMAT_ERROR;
+        }
+        break;
+    default:
+        return FORMAT_ERROR;
+    }
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+    if (flash_program_config()) {
+        println_str("%% Flash write failed");
+    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+    return FORMAT_OK;
+}
+#endif // TRANSIT_BUF_PROFILE
+
+/* ************************************************************************ */
+static uchar retrieve_parms (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Retrieve parameters from command string.
+ * Remarks     : Module variable cmd_ptr must have been set to point to first
+ *               char after the command in the command string, when this function
+ *               is called.
+ *               The module variables parms_no and parms are updated with
+ *               actual number of parameters and the actual parameter values.
+ *               Returns 0, if successful, otherwise <> 0.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar ch;
+    uchar base;
+    uchar j;
+    uchar no_of_digits;
+    uchar digits [10];
+    ulong parm_bin;
+
+    ch = *cmd_ptr;
+    if ((ch != ' ') && (ch != CLI_CR)) {
+        return FORMAT_ERROR;
+    }
+
+
+    parms_no = 0;
+    /* Preset parms to ff's, which may be used as default indication */
+    memset(parms, 0xff, sizeof(parms));
+
+    /*
+    ** Retrieve parameters one by one.
+    */
+    for (;;) {
+
+        skip_spaces();
+        base = 10; /* default parameter is specified in decimal */
+        no_of_digits = 0;
+
+        /*
+        ** Check if any hex prefix
+        */
+        if (*cmd_ptr == '0' && (conv_to_upper_case(*(cmd_ptr + 1)) == 'X')) {
+            base = 16; /* parameter is specified in hex */
+            cmd_ptr += 2;
+            if (*cmd_ptr == ' ') {
+                return FORMAT_ERROR;
+            }
+        }
+
+        /*
+        ** Retrieve digits until delimiter (space or CR) and then convert
+        ** parameter to binary
+        */
+        for (;;) {
+
+            ch = *cmd_ptr;
+
+            if ((ch == ' ') || (ch == CLI_CR)) {
+
+                if (no_of_digits > 0) {
+                    parm_bin = 0;
+                    for (j = 0; j < no_of_digits; j++) {
+                        parm_bin = (parm_bin * base) + digits[j];
+                    }
+                    if (parms_no < CLI_MAX_NO_OF_PARMS) {
+                        parms[parms_no++] = parm_bin;
+                    }
+                }
+                /* End processing at end of command string */
+                if (ch == CLI_CR) {
+                    return FORMAT_OK;
+                }
+                break; /* go get new parameter */
+            } else {
+
+                ch = ascii_to_hex_nib(ch);
+                if (ch != 0xff) {
+                    if (no_of_digits < 10) {
+                        digits[no_of_digits++] = ch;
+                        if (ch > 9) {
+                            base = 16; /* parameter is specified in hex */
+                        }
+                    }
+                } else {
+                    return FORMAT_ERROR;
+                }
+            }
+            cmd_ptr++;
+        }
+    }
+}
+
+#if TRANSIT_UNMANAGED_SYS_MAC_CONF
+/* ************************************************************************ */
+static uchar retrieve_str_parms (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Retrieve parameters from command string.
+ * Remarks     : Module variable cmd_ptr must have been set to point to first
+ *               char after the command in the command string, when this function
+ *               is called.
+ *               The module variables parms_no and parms are updated with
+ *               actual number of parameters and the actual parameter values.
+ *               Returns 0, if successful, otherwise <> 0.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar ch;
+    uchar j;
+
+    ch = *cmd_ptr;
+    if ((ch != ' ') && (ch != CLI_CR)) {
+        return FORMAT_ERROR;
+    }
+
+    parms_no = 0;
+    for(parms_no = 0; parms_no < CLI_MAX_NO_OF_PARMS; parms_no++) {
+        skip_spaces();
+        str_parms[parms_no].str = cmd_ptr;
+        str_parms[parms_no].len = 0;
+        while(1) {
+            if(*cmd_ptr == CLI_CR) { /* Enter Key */
+                *cmd_ptr = '\0';
+                for(j = parms_no + 1; j < CLI_MAX_NO_OF_PARMS; j++) {
+                    str_parms[j].str = cmd_ptr;
+                    str_parms[j].len = 0;
+                }
+                return FORMAT_OK;
+            }
             if(*cmd_ptr == ' ') { /* Space Key */
                 *cmd_ptr = '\0'; // string null end sign
                 cmd_ptr++;
@@ -1719,57 +2877,60 @@ static void report_remote_entry_val (std_txt_t txt_no, lldp_tlv_t lldp_field, ll
 
 static void cmd_print_lldp_remoteinfo (void)
 {
-    uchar i, max;
     lldp_remote_entry_t xdata * entry;
     uchar ext_port;
     uchar found = FALSE;
 
 
     for(ext_port = 1; ext_port < NO_OF_BOARD_PORTS; ext_port++) {
-        max = lldp_remote_get_max_entries();
-        for(i = 0; i < max; i++) {
-            entry = lldp_get_remote_entry(i);
-            if((entry->in_use) && (entry->receive_port == ext_port)) {
-                found = TRUE;
-                print_txt(TXT_NO_LLDP_LOCAL_PORT);
-                print_ch(':');
-                print_spaces(4);
-                print_dec(ext_port);
-                print_cr_lf();
+        for(entry = lldp_remote_get_port_first(ext_port); entry != XNULL; entry = lldp_remote_get_port_next(entry)) {
+            found = TRUE;
+            print_txt(TXT_NO_LLDP_LOCAL_PORT);
+            print_ch(':');
+            print_spaces(4);
+            print_dec(ext_port);
+            print_cr_lf();
 
-                print_txt_left(TXT_NO_LLDP_CHASSIS_TYPE, 15);
-                lldp_chassis_type_to_string(entry, rx_packet);
-                println_str(rx_packet);
+            print_txt_left(TXT_NO_LLDP_CHASSIS_TYPE, 15);
+            lldp_chassis_type_to_string(entry, rx_packet);
+            println_str(rx_packet);
 
-                report_remote_entry_val(TXT_NO_LLDP_CHASSIS_ID, LLDP_TLV_BASIC_MGMT_CHASSIS_ID, entry);
+            report_remote_entry_val(TXT_NO_LLDP_CHASSIS_ID, LLDP_TLV_BASIC_MGMT_CHASSIS_ID, entry);
 
-                print_txt_left(TXT_NO_LLDP_PORT_TYPE, 15);
-                lldp_port_type_to_string(entry, rx_packet);
-                println_str(rx_packet);
+            print_txt_left(TXT_NO_LLDP_PORT_TYPE, 15);
+            lldp_port_type_to_string(entry, rx_packet);
+            println_str(rx_packet);
 
-                report_remote_entry_val(TXT_NO_LLDP_PORT_ID, LLDP_TLV_BASIC_MGMT_PORT_ID, entry);
-                report_remote_entry_val(TXT_NO_LLDP_SYSTEM_NAME, LLDP_TLV_BASIC_MGMT_SYSTEM_NAME, entry);
-                report_remote_entry_val(TXT_NO_LLDP_SYSTEM_DESCR, LLDP_TLV_BASIC_MGMT_SYSTEM_DESCR, entry);
-                report_remote_entry_val(TXT_NO_LLDP_PORT_DESCR, LLDP_TLV_BASIC_MGMT_PORT_DESCR, entry);
-                report_remote_entry_val(TXT_NO_LLDP_SYSTEM_CAPA, LLDP_TLV_BASIC_MGMT_SYSTEM_CAPA, entry);
-                report_remote_entry_val(TXT_NO_LLDP_MGMT_ADDR, LLDP_TLV_BASIC_MGMT_MGMT_ADDR, entry);
+            report_remote_entry_val(TXT_NO_LLDP_PORT_ID, LLDP_TLV_BASIC_MGMT_PORT_ID, entry);
+            report_remote_entry_val(TXT_NO_LLDP_SYSTEM_NAME, LLDP_TLV_BASIC_MGMT_SYSTEM_NAME, entry);
+            report_remote_entry_val(TXT_NO_LLDP_SYSTEM_DESCR, LLDP_TLV_BASIC_MGMT_SYSTEM_DESCR, entry);
+            report_remote_entry_val(TXT_NO_LLDP_PORT_DESCR, LLDP_TLV_BASIC_MGMT_PORT_DESCR, entry);
+            report_remote_entry_val(TXT_NO_LLDP_SYSTEM_CAPA, LLDP_TLV_BASIC_MGMT_SYSTEM_CAPA, entry);
+            report_remote_entry_val(TXT_NO_LLDP_MGMT_ADDR, LLDP_TLV_BASIC_MGMT_MGMT_ADDR, entry);
 #if UNMANAGED_EEE_DEBUG_IF
-                report_remote_entry_val(TXT_NO_EEE_STAT, LLDP_TLV_ORG_EEE_TLV, entry);
+            report_remote_entry_val(TXT_NO_EEE_STAT, LLDP_TLV_ORG_EEE_TLV, entry);
 #endif
 #ifndef NDEBUG
-                print_str("TTL: ");
-                print_dec(entry->rx_info_ttl);
-                print_cr_lf();
+            print_str("TTL: ");
+            print_dec(lldp_remote_ttl_left(entry));
+            print_cr_lf();
 #endif
 
-                print_cr_lf();
-            }
+            print_cr_lf();
         }
     }
 
     if(!found) {
         println_str(TXT_NO_LLDP_NO_ENTRIES);
     }
+
+    print_str("String pool: ");
+    print_dec(lldp_remote_pool_used());
+    print_ch('/');
+    print_dec(LLDP_REMOTE_POOL_SIZE);
+    print_str(" bytes, evictions: ");
+    print_dec(lldp_get_mib_stats()->pool_evictions);
+    print_cr_lf();
 }
 #endif
 #endif
@@ -1895,7 +3056,6 @@ static uchar handle_sys_config (void)
 }
 #endif
 
-#if TRANSIT_UNMANAGED_SWUP
 /* ************************************************************************ */
 static uchar cmd_cmp (char *s1, char *s2) small
 /* ------------------------------------------------------------------------ --
@@ -1924,7 +3084,6 @@ static uchar cmd_cmp (char *s1, char *s2) small
         }
     }
 }
-#endif
 
 #endif /* NO_DEBUG_IF */
 #if !defined(BRINGUP)
@@ -2097,57 +3256,199 @@ static void cli_show_port_info(void)
 #ifndef NO_DEBUG_IF
 
 #if TRANSIT_UNMANAGED_MAC_OPER_GET
-/* Show MAC address entries, chip_port=0xFF for all ports */
-static void cli_show_mac_addr(vtss_cport_no_t chip_port)
+/*
+ * Show the MAC address entry following *mac_tab_entry if it matches chip_port
+ * (0xFF for all). Returns FALSE at the end of the table.
+ */
+static BOOL cli_show_mac_addr_next(mac_tab_t *mac_tab_entry, vtss_cport_no_t chip_port, ulong *total_cnt)
 {
-    mac_tab_t mac_tab_entry;
     BOOL is_ipmc_entry;
-    ulong status, total_cnt = 0;
+    ulong status;
 
-    mac_tab_entry.vid = 0;
-    mac_tab_entry.mac_addr[0] = mac_tab_entry.mac_addr[1] = mac_tab_entry.mac_addr[2] = mac_tab_entry.mac_addr[3] = mac_tab_entry.mac_addr[4] = mac_tab_entry.mac_addr[5] = 0;
+    status = h2_mactab_get_next(mac_tab_entry, &is_ipmc_entry, TRUE);
+    if (status == 0xFFFFFFFF) {
+        return FALSE;
+    }
 
-    while(1) {
-        status = h2_mactab_get_next(&mac_tab_entry, &is_ipmc_entry, TRUE);
-        if (status == 0xFFFFFFFF) {
-            break;
-        }
+    if (chip_port != 0xFF && !TEST_PORT_BIT_MASK(chip_port, &mac_tab_entry->port_mask)) {
+        return TRUE;
+    }
 
-        if (chip_port != 0xFF && !TEST_PORT_BIT_MASK(chip_port, &mac_tab_entry.port_mask)) {
-            continue;
-        }
+    (*total_cnt)++;
 
-        total_cnt++;
+    // Show MAC address
+    print_mac_addr(mac_tab_entry->mac_addr);
+    print_spaces(2);
 
-        // Show MAC address
-        print_mac_addr(mac_tab_entry.mac_addr);
-        print_spaces(2);
+    // Show MAC address entry mode (static/dynamic)
+    print_str(VTSS_X_ANA_ANA_TABLES_MACACCESS_ENTRY_TYPE(status) ? "S" : "D");
+    print_spaces(2);
 
-        // Show MAC address entry mode (static/dynamic)
-        print_str(VTSS_X_ANA_ANA_TABLES_MACACCESS_ENTRY_TYPE(status) ? "S" : "D");
-        print_spaces(2);
+    // Show IPMC
+    print_str(is_ipmc_entry ? "IPMC" : "    ");
+    print_spaces(2);
 
-        // Show IPMC
-        print_str(is_ipmc_entry ? "IPMC" : "    ");
-        print_spaces(2);
+    // Show CPU
+    //print_str(VTSS_X_ANA_ANA_AGENCTRL_LEARN_SRC_KILL(status) ? "CPU" : "   ");
+    //print_spaces(2);
 
-        // Show CPU
-        //print_str(VTSS_X_ANA_ANA_AGENCTRL_LEARN_SRC_KILL(status) ? "CPU" : "   ");
-        //print_spaces(2);
+    // Show portmask
+    print_port_list(mac_tab_entry->port_mask);
+    print_cr_lf();
 
-        // Show portmask
-        print_port_list(mac_tab_entry.port_mask);
-        print_cr_lf();
-    };
+    return TRUE;
+}
 
+static void cli_show_mac_addr_total(ulong total_cnt)
+{
     // Show total count
     print_cr_lf();
     print_str("Total count = ");
     print_dec(total_cnt);
     print_cr_lf();
 }
+
+#if !TRANSIT_CLI_RESUMABLE
+/* Show MAC address entries, chip_port=0xFF for all ports */
+static void cli_show_mac_addr(vtss_cport_no_t chip_port)
+{
+    mac_tab_t mac_tab_entry;
+    ulong total_cnt = 0;
+
+    mac_tab_entry.vid = 0;
+    mac_tab_entry.mac_addr[0] = mac_tab_entry.mac_addr[1] = mac_tab_entry.mac_addr[2] = mac_tab_entry.mac_addr[3] = mac_tab_entry.mac_addr[4] = mac_tab_entry.mac_addr[5] = 0;
+
+    while (cli_show_mac_addr_next(&mac_tab_entry, chip_port, &total_cnt)) {
+    }
+
+    cli_show_mac_addr_total(total_cnt);
+}
+#endif // !TRANSIT_CLI_RESUMABLE
+#endif // TRANSIT_UNMANAGED_MAC_OPER_GET
+
+#if TRANSIT_CLI_RESUMABLE
+/* ************************************************************************ */
+static void cli_cont_start(cli_cont_id_t id)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Start a resumable command. The caller sets up the command
+ *               specific fields of cli_cont afterwards.
+ * Remarks     : The rows are output by cli_cont_run() from cli_tsk().
+ * Restrictions:
+ * See also    : cli_cont_run
+ * Example     :
+ ****************************************************************************/
+{
+    memset(&cli_cont, 0, sizeof(cli_cont));
+    cli_cont.id = id;
+}
+
+/* ************************************************************************ */
+static BOOL cli_cont_step(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Output the next row of the running command.
+ * Remarks     : Returns TRUE when the command is complete.
+ * Restrictions:
+ * See also    : cli_cont_run
+ * Example     :
+ ****************************************************************************/
+{
+#if TRANSIT_UNMANAGED_SWUP && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+    uchar len;
+#endif // TRANSIT_UNMANAGED_SWUP && !UNMANAGED_REDUCED_DEBUG_IF
+
+    switch (cli_cont.id) {
+#if TRANSIT_UNMANAGED_MAC_OPER_GET
+    case CLI_CONT_MAC_TABLE:
+        if (cli_show_mac_addr_next(&cli_cont.mac_entry, cli_cont.chip_port, &cli_cont.cnt)) {
+            return FALSE;
+        }
+        cli_show_mac_addr_total(cli_cont.cnt);
+        break;
 #endif // TRANSIT_UNMANAGED_MAC_OPER_GET
 
+#if UNMANAGED_PORT_STATISTICS_IF
+    case CLI_CONT_PORT_STATS:
+        if (cli_cont.row == 0 && cli_cont.uport <= NO_OF_BOARD_PORTS) {
+            print_cr_lf();
+            print_str("Port ");
+            print_dec(cli_cont.uport);
+            print_cr_lf();
+        }
+        if (print_port_statistics_line(cli_cont.chip_port, cli_cont.row++)) {
+            return FALSE;
+        }
+        if (cli_cont.uport < NO_OF_BOARD_PORTS) {
+            cli_cont.uport++;
+            cli_cont.chip_port = uport2cport(cli_cont.uport);
+            cli_cont.row = 0;
+            return FALSE;
+        }
+        break;
+#endif // UNMANAGED_PORT_STATISTICS_IF
+
+#if TRANSIT_UNMANAGED_SWUP && !defined(UNMANAGED_REDUCED_DEBUG_IF)
+    case CLI_CONT_FLASH_DUMP:
+        len = cli_cont.len > 16 ? 16 : cli_cont.len;
+        flash_print_row(cli_cont.addr, len);
+        cli_cont.addr += len;
+        cli_cont.len  -= len;
+        if (cli_cont.len) {
+            return FALSE;
+        }
+        print_cr_lf();
+        break;
+#endif // TRANSIT_UNMANAGED_SWUP && !UNMANAGED_REDUCED_DEBUG_IF
+
+    default:
+        break;
+    }
+
+    return TRUE;
+}
+
+/* ************************************************************************ */
+static void cli_cont_run(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Output a few rows of the running command and return to the
+ *               main loop.
+ * Remarks     : Yields after CLI_CONT_MAX_ROWS rows, after CLI_CONT_MAX_MSEC
+ *               or when the transmit ring cannot hold another row. Ctrl-C
+ *               aborts the command, other input is discarded.
+ * Restrictions:
+ * See also    : cli_cont_step
+ * Example     :
+ ****************************************************************************/
+{
+    ushort start = tick_count;
+    uchar  rows;
+
+    while (uart_byte_ready()) {
+        if (uart_get_byte() == CLI_CTLC) {
+            println_str("^C");
+            cli_cont.id = CLI_CONT_NONE;
+            CLI_PROMPT();
+            return;
+        }
+    }
+
+    for (rows = 0; rows < CLI_CONT_MAX_ROWS; rows++) {
+#if TRANSIT_UART_TX_RING
+        if (uart_tx_room() < CLI_CONT_ROW_LEN) {
+            break;
+        }
+#endif // TRANSIT_UART_TX_RING
+        if ((ushort) (tick_count - start) >= CLI_CONT_MAX_MSEC) {
+            break;
+        }
+        if (cli_cont_step()) {
+            cli_cont.id = CLI_CONT_NONE;
+            CLI_PROMPT();
+            return;
+        }
+    }
+}
+#endif // TRANSIT_CLI_RESUMABLE
+
 /* ************************************************************************ */
 static void cli_show_sw_ver(void)
 /* ------------------------------------------------------------------------ --
@@ -2191,6 +3492,13 @@ static void cli_show_sw_ver(void)
     print_chips_temp();
 #endif
 
+#if TRANSIT_UART_TX_RING && (UART_TX_OVERFLOW_MODE == UART_TX_OVERFLOW_COUNT)
+    print_str("Console Dropped :");
+    print_spaces(1);
+    print_dec(uart_tx_drop_cnt);
+    print_cr_lf();
+#endif
+
 #ifndef UNMANAGED_REDUCED_DEBUG_IF
     /* Info about ports */
     print_cr_lf();
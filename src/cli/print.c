@@ -288,7 +288,7 @@ void print_dec_right (ulong value)
 #endif
 
 
-#if UNMANAGED_EEE_DEBUG_IF
+#if UNMANAGED_EEE_DEBUG_IF || TRANSIT_SPI_FLASH_MANIFEST
 /* ************************************************************************ */
 void print_dec_nright (ulong value, uchar fieldwidth)
 /* ------------------------------------------------------------------------ --
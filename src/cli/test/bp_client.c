@@ -0,0 +1,520 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+/*
+ * Linux client of the binary telemetry protocol of binproto.c, as a
+ * library for bp_test.c and as a command line tool:
+ *
+ *   bpc <tty> info | link | counters | mac | lldp
+ *   bpc <tty> read <addr> [<cnt>] | write <addr> <value>
+ *
+ * Built from the repository root with the firmware headers and the CRC of
+ * misc1.c, the rest of misc1.c is dropped by the linker:
+ *
+ *   gcc -Wall -std=gnu89 -include src/config/test/host.h -fpack-struct -fshort-enums \
+ *       -ffunction-sections -Wl,--gc-sections \
+ *       -DVTSS_ARCH_OCELOT -DFERRET_F11 -DPROJ_OPT=99998 -Isrc/cli/test -Isrc/config/test \
+ *       -Isrc/config -Isrc/config/proj_opt -Isrc/cli -Isrc/lldp -Isrc/main -Isrc/switch \
+ *       -Isrc/util -Isrc/switch/vtss_api/base -Isrc/switch/vtss_api/base/ocelot \
+ *       -o /tmp/bpc src/cli/test/bp_client.c src/util/misc1.c
+ */
+
+#include "common.h"
+#include "misc1.h"
+#include "h2stats.h"
+#include "binproto.h"
+
+#include "bp_client.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+#define BP_FRAME_MAX    (1 + 3 + BP_MAX_PAYLOAD + 2)
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+uchar bp_client_faults;
+
+static uchar bp_seq;
+
+/*****************************************************************************
+ *
+ *
+ * Local functions
+ *
+ *
+ *
+ ****************************************************************************/
+static ulong bp_get_ulong (const uchar *p)
+{
+    return ((ulong) p[0] << 24) | ((ulong) p[1] << 16) | ((ulong) p[2] << 8) | p[3];
+}
+
+static void bp_put_ulong (uchar *p, ulong val)
+{
+    p[0] = (uchar) (val >> 24);
+    p[1] = (uchar) (val >> 16);
+    p[2] = (uchar) (val >> 8);
+    p[3] = (uchar) val;
+}
+
+static long bp_msec_left (const struct timespec *end)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (end->tv_sec - now.tv_sec) * 1000 + (end->tv_nsec - now.tv_nsec) / 1000000;
+}
+
+/* Get a byte from fd before end, return 1 on timeout or error */
+static int bp_get_byte (int fd, uchar *ch, const struct timespec *end)
+{
+    struct pollfd pfd;
+    long          msec;
+
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+    for (;;) {
+        if ((msec = bp_msec_left(end)) <= 0 || poll(&pfd, 1, msec) <= 0) {
+            return 1;
+        }
+        switch (read(fd, ch, 1)) {
+        case 1:
+            return 0;
+        case 0:
+            return 1;
+        default:
+            if (errno != EAGAIN) {
+                return 1;
+            }
+        }
+    }
+}
+
+static int bp_send (int fd, uchar op, const uchar *req, uchar req_len)
+{
+    uchar  frame[BP_FRAME_MAX];
+    ushort crc = CRC16_INIT;
+    int    i, cnt;
+
+    frame[0] = BP_SOF;
+    frame[1] = req_len;
+    frame[2] = op;
+    frame[3] = bp_seq;
+    memcpy(&frame[4], req, req_len);
+    for (i = 1; i < 4 + req_len; i++) {
+        crc = crc16_update(crc, frame[i]);
+    }
+    frame[4 + req_len] = (uchar) (crc >> 8);
+    frame[5 + req_len] = (uchar) crc;
+    cnt = 6 + req_len;
+
+    if (bp_client_faults & BP_FAULT_NOISE) {
+        bp_client_faults &= ~BP_FAULT_NOISE;
+        if (write(fd, "\r\n?\r\n", 5) != 5) {
+            return 1;
+        }
+    }
+    if (bp_client_faults & BP_FAULT_CRC) {
+        bp_client_faults &= ~BP_FAULT_CRC;
+        frame[5 + req_len] ^= 0x01;
+    } else if (bp_client_faults & BP_FAULT_CUT) {
+        bp_client_faults &= ~BP_FAULT_CUT;
+        cnt /= 2;
+    }
+    return write(fd, frame, cnt) != cnt;
+}
+
+/*
+ * Receive the response to op with the current seq, skipping text and other
+ * frames. Returns 0 with the payload in rsp, 1 on timeout.
+ */
+static int bp_receive (int fd, uchar op, uchar *rsp, uchar *rsp_len)
+{
+    struct timespec end;
+    uchar  hdr[3], crc_buf[2], ch;
+    ushort crc;
+    int    i;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec  += BP_CLIENT_TIMEOUT / 1000;
+    end.tv_nsec += (BP_CLIENT_TIMEOUT % 1000) * 1000000L;
+    if (end.tv_nsec >= 1000000000L) {
+        end.tv_sec++;
+        end.tv_nsec -= 1000000000L;
+    }
+
+    for (;;) {
+        do {
+            if (bp_get_byte(fd, &ch, &end)) {
+                return 1;
+            }
+        } while (ch != BP_SOF);
+
+        crc = CRC16_INIT;
+        for (i = 0; i < 3; i++) {
+            if (bp_get_byte(fd, &hdr[i], &end)) {
+                return 1;
+            }
+            crc = crc16_update(crc, hdr[i]);
+        }
+        if (hdr[0] > BP_MAX_PAYLOAD || hdr[0] == 0) {
+            continue;
+        }
+        for (i = 0; i < hdr[0]; i++) {
+            if (bp_get_byte(fd, &rsp[i], &end)) {
+                return 1;
+            }
+            crc = crc16_update(crc, rsp[i]);
+        }
+        if (bp_get_byte(fd, &crc_buf[0], &end) || bp_get_byte(fd, &crc_buf[1], &end)) {
+            return 1;
+        }
+        if (crc == (((ushort) crc_buf[0] << 8) | crc_buf[1]) &&
+            hdr[1] == (op | BP_OP_RESPONSE) && hdr[2] == bp_seq) {
+            *rsp_len = hdr[0];
+            return 0;
+        }
+    }
+}
+
+/*****************************************************************************
+ *
+ *
+ * Public functions
+ *
+ *
+ *
+ ****************************************************************************/
+int bp_open (const char *tty)
+{
+    struct termios tio;
+    int    fd;
+
+    if ((fd = open(tty, O_RDWR | O_NOCTTY)) < 0) {
+        return -1;
+    }
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);     /* BAUD_RATE */
+        cfsetospeed(&tio, B115200);
+        tcsetattr(fd, TCSANOW, &tio);
+        tcflush(fd, TCIOFLUSH);
+    }
+    if (write(fd, "BINARY\r", 7) != 7) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int bp_request (int fd, uchar op, const uchar *req, uchar req_len, uchar *rsp, uchar *rsp_len)
+{
+    uchar buf[BP_MAX_PAYLOAD];
+    uchar len, try;
+
+    bp_seq++;
+    for (try = 0; try <= BP_CLIENT_RETRIES; try++) {
+        if (bp_send(fd, op, req, req_len)) {
+            return BP_CLIENT_ERR;
+        }
+        if (bp_receive(fd, op, buf, &len) == 0) {
+            *rsp_len = len - 1;
+            memcpy(rsp, &buf[1], len - 1);
+            return buf[0];
+        }
+    }
+    return BP_CLIENT_ERR;
+}
+
+int bp_info (int fd, bp_info_t *info)
+{
+    uchar rsp[BP_MAX_PAYLOAD], len;
+    int   rc;
+
+    if ((rc = bp_request(fd, BP_OP_INFO, NULL, 0, rsp, &len)) != 0) {
+        return rc;
+    }
+    if (len != 3) {
+        return BP_CLIENT_ERR;
+    }
+    info->version     = rsp[0];
+    info->ports       = rsp[1];
+    info->max_payload = rsp[2];
+    return 0;
+}
+
+int bp_reg_read (int fd, ulong addr, uchar cnt, ulong *val)
+{
+    uchar req[5], rsp[BP_MAX_PAYLOAD], len, i;
+    int   rc;
+
+    bp_put_ulong(req, addr);
+    req[4] = cnt;
+    if ((rc = bp_request(fd, BP_OP_REG_READ, req, sizeof(req), rsp, &len)) != 0) {
+        return rc;
+    }
+    if (len != 4 * cnt) {
+        return BP_CLIENT_ERR;
+    }
+    for (i = 0; i < cnt; i++) {
+        val[i] = bp_get_ulong(&rsp[4 * i]);
+    }
+    return 0;
+}
+
+int bp_reg_write (int fd, ulong addr, uchar cnt, const ulong *val)
+{
+    uchar req[BP_MAX_REQUEST], rsp[BP_MAX_PAYLOAD], len, i;
+
+    if (4 + 4 * cnt > BP_MAX_REQUEST) {
+        return BP_STATUS_BAD_LEN;
+    }
+    bp_put_ulong(req, addr);
+    for (i = 0; i < cnt; i++) {
+        bp_put_ulong(&req[4 + 4 * i], val[i]);
+    }
+    return bp_request(fd, BP_OP_REG_WRITE, req, 4 + 4 * cnt, rsp, &len);
+}
+
+int bp_counters (int fd, uchar ports, uchar cnt, const uchar *ids, ulong *val)
+{
+    uchar req[BP_MAX_REQUEST], rsp[BP_MAX_PAYLOAD], len, nports, i, j;
+    uchar *p;
+    uchar uport = 1;
+    int   rc;
+
+    if (1 + cnt > BP_MAX_REQUEST) {
+        return BP_STATUS_BAD_LEN;
+    }
+    memcpy(&req[1], ids, cnt);
+    while (uport <= ports) {
+        req[0] = uport;
+        if ((rc = bp_request(fd, BP_OP_COUNTERS, req, 1 + cnt, rsp, &len)) != 0) {
+            return rc;
+        }
+        nports = rsp[0];
+        if (nports == 0 || len != 1 + nports * (1 + 4 * cnt)) {
+            return BP_CLIENT_ERR;
+        }
+        p = &rsp[1];
+        for (i = 0; i < nports; i++) {
+            if (*p != uport + i || *p > ports) {
+                return BP_CLIENT_ERR;
+            }
+            p++;
+            for (j = 0; j < cnt; j++, p += 4) {
+                val[(uport + i - 1) * cnt + j] = bp_get_ulong(p);
+            }
+        }
+        uport += nports;
+    }
+    return 0;
+}
+
+int bp_link (int fd, uchar *ports, uchar *mode)
+{
+    uchar rsp[BP_MAX_PAYLOAD], len;
+    int   rc;
+
+    if ((rc = bp_request(fd, BP_OP_LINK, NULL, 0, rsp, &len)) != 0) {
+        return rc;
+    }
+    if (len != 1 + rsp[0]) {
+        return BP_CLIENT_ERR;
+    }
+    *ports = rsp[0];
+    memcpy(mode, &rsp[1], rsp[0]);
+    return 0;
+}
+
+int bp_mac_walk (int fd, bp_mac_cb_t cb, void *ctx)
+{
+    uchar    req[8], rsp[BP_MAX_PAYLOAD], len, cnt, i;
+    uchar    *p;
+    bp_mac_t mac;
+    int      rc;
+
+    memset(req, 0, sizeof(req));
+    do {
+        if ((rc = bp_request(fd, BP_OP_MAC_PAGE, req, sizeof(req), rsp, &len)) != 0) {
+            return rc;
+        }
+        cnt = rsp[0];
+        if (cnt > BP_MAC_PER_PAGE || len != 1 + cnt * 13) {
+            return BP_CLIENT_ERR;
+        }
+        for (i = 0, p = &rsp[1]; i < cnt; i++, p += 13) {
+            mac.vid = ((ushort) p[0] << 8) | p[1];
+            memcpy(mac.mac, &p[2], 6);
+            mac.uport_mask = bp_get_ulong(&p[8]);
+            mac.flags      = p[12];
+            if (cb(&mac, ctx)) {
+                return 0;
+            }
+            /* The next page starts after the last entry */
+            memcpy(req, p, 8);
+        }
+    } while (cnt == BP_MAC_PER_PAGE);
+    return 0;
+}
+
+int bp_lldp_walk (int fd, bp_lldp_cb_t cb, void *ctx)
+{
+    uchar     req[1], rsp[BP_MAX_PAYLOAD], len;
+    uchar     *p, *end;
+    bp_lldp_t lldp;
+    int       rc;
+
+    req[0] = 0;
+    do {
+        if ((rc = bp_request(fd, BP_OP_LLDP, req, sizeof(req), rsp, &len)) != 0) {
+            return rc;
+        }
+        if (len < 1) {
+            return BP_CLIENT_ERR;
+        }
+        p   = &rsp[1];
+        end = &rsp[len];
+        while (p < end) {
+            if (end - p < 7 || p[4] > BP_LLDP_ID_LEN || end - p < 7 + p[4] + p[6 + p[4]] ||
+                p[6 + p[4]] > BP_LLDP_ID_LEN) {
+                return BP_CLIENT_ERR;
+            }
+            lldp.uport              = p[0];
+            lldp.ttl                = ((ushort) p[1] << 8) | p[2];
+            lldp.chassis_id_subtype = p[3];
+            lldp.chassis_id_len     = p[4];
+            memcpy(lldp.chassis_id, &p[5], p[4]);
+            p += 5 + lldp.chassis_id_len;
+            lldp.port_id_subtype    = p[0];
+            lldp.port_id_len        = p[1];
+            memcpy(lldp.port_id, &p[2], p[1]);
+            p += 2 + lldp.port_id_len;
+            if (cb(&lldp, ctx)) {
+                return 0;
+            }
+        }
+        req[0] = rsp[0];
+    } while (req[0] != 0xFF);
+    return 0;
+}
+
+int bp_exit (int fd)
+{
+    uchar rsp[BP_MAX_PAYLOAD], len;
+
+    return bp_request(fd, BP_OP_EXIT, NULL, 0, rsp, &len);
+}
+
+#ifndef BP_CLIENT_NO_MAIN
+/*****************************************************************************
+ *
+ *
+ * Command line tool
+ *
+ *
+ *
+ ****************************************************************************/
+static int bpc_print_mac (const bp_mac_t *mac, void *ctx)
+{
+    printf("%4u %02x-%02x-%02x-%02x-%02x-%02x 0x%08x %s%s\n", mac->vid,
+           mac->mac[0], mac->mac[1], mac->mac[2], mac->mac[3], mac->mac[4], mac->mac[5],
+           mac->uport_mask, mac->flags & 1 ? "static" : "dynamic", mac->flags & 2 ? " ipmc" : "");
+    return 0;
+}
+
+static int bpc_print_lldp (const bp_lldp_t *lldp, void *ctx)
+{
+    printf("port %u ttl %u chassis %u:%.*s port %u:%.*s\n", lldp->uport, lldp->ttl,
+           lldp->chassis_id_subtype, lldp->chassis_id_len, lldp->chassis_id,
+           lldp->port_id_subtype, lldp->port_id_len, lldp->port_id);
+    return 0;
+}
+
+static int bpc_run (int fd, int argc, char **argv)
+{
+    static const uchar ids[] = {CNT_RX_OCTETS, CNT_RX_PKTS, CNT_TX_OCTETS, CNT_TX_PKTS};
+    bp_info_t info;
+    ulong     val[32 * sizeof(ids)];
+    uchar     mode[BP_MAX_PAYLOAD], ports, i;
+    int       rc;
+
+    if (strcmp(argv[0], "info") == 0) {
+        if ((rc = bp_info(fd, &info)) == 0) {
+            printf("version %u, %u ports, max payload %u\n", info.version, info.ports, info.max_payload);
+        }
+    } else if (strcmp(argv[0], "link") == 0) {
+        if ((rc = bp_link(fd, &ports, mode)) == 0) {
+            for (i = 0; i < ports; i++) {
+                printf("port %2u: 0x%02x\n", i + 1, mode[i]);
+            }
+        }
+    } else if (strcmp(argv[0], "counters") == 0) {
+        if ((rc = bp_info(fd, &info)) == 0 && info.ports > 32) {
+            rc = BP_CLIENT_ERR;
+        }
+        if (rc == 0 && (rc = bp_counters(fd, info.ports, sizeof(ids), ids, val)) == 0) {
+            printf("port   rx octets    rx frames   tx octets    tx frames\n");
+            for (i = 0; i < info.ports; i++) {
+                printf("%4u %11u %12u %11u %12u\n", i + 1, val[4 * i], val[4 * i + 1], val[4 * i + 2], val[4 * i + 3]);
+            }
+        }
+    } else if (strcmp(argv[0], "mac") == 0) {
+        rc = bp_mac_walk(fd, bpc_print_mac, NULL);
+    } else if (strcmp(argv[0], "lldp") == 0) {
+        rc = bp_lldp_walk(fd, bpc_print_lldp, NULL);
+    } else if (strcmp(argv[0], "read") == 0 && argc >= 2) {
+        ports = argc > 2 ? (uchar) strtoul(argv[2], NULL, 0) : 1;
+        if (ports == 0 || ports > 32) {
+            return BP_STATUS_BAD_PARM;
+        }
+        if ((rc = bp_reg_read(fd, strtoul(argv[1], NULL, 0), ports, val)) == 0) {
+            for (i = 0; i < ports; i++) {
+                printf("0x%08x: 0x%08x\n", (ulong) strtoul(argv[1], NULL, 0) + 4 * i, val[i]);
+            }
+        }
+    } else if (strcmp(argv[0], "write") == 0 && argc == 3) {
+        val[0] = strtoul(argv[2], NULL, 0);
+        rc = bp_reg_write(fd, strtoul(argv[1], NULL, 0), 1, val);
+    } else {
+        return BP_STATUS_BAD_OP;
+    }
+    return rc;
+}
+
+int main (int argc, char **argv)
+{
+    int fd, rc;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <tty> info | link | counters | mac | lldp\n"
+                        "       %s <tty> read <addr> [<cnt>] | write <addr> <value>\n", argv[0], argv[0]);
+        return 1;
+    }
+    if ((fd = bp_open(argv[1])) < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    rc = bpc_run(fd, argc - 2, argv + 2);
+    bp_exit(fd);
+    if (rc) {
+        fprintf(stderr, "%s failed: %d\n", argv[2], rc);
+        return 1;
+    }
+    return 0;
+}
+#endif /* BP_CLIENT_NO_MAIN */
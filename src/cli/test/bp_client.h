@@ -0,0 +1,83 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __BP_CLIENT_H__
+#define __BP_CLIENT_H__
+
+/*
+ * Linux client of the binary telemetry protocol, see binproto.h. A request
+ * without a valid response within BP_CLIENT_TIMEOUT msec is sent again,
+ * BP_CLIENT_RETRIES times. Text between the frames is skipped and
+ * responses with another seq, i.e. answers to an earlier try, are dropped.
+ *
+ * The functions return 0 on success, the BP_STATUS_xxx code of the switch,
+ * or BP_CLIENT_ERR when no response came.
+ */
+#define BP_CLIENT_TIMEOUT   1500    // msec, longer than BP_RX_TIMEOUT of the switch
+#define BP_CLIENT_RETRIES   3
+#define BP_CLIENT_ERR       (-1)
+
+/* Faults bp_request() puts on the line, once each */
+#define BP_FAULT_CRC        0x01    // The next request with a wrong CRC
+#define BP_FAULT_CUT        0x02    // Half of the next request, the switch times out
+#define BP_FAULT_NOISE      0x04    // Line noise in front of the next request
+
+extern uchar bp_client_faults;
+
+typedef struct {
+    uchar version;
+    uchar ports;
+    uchar max_payload;
+} bp_info_t;
+
+typedef struct {
+    ushort vid;
+    uchar  mac[6];
+    ulong  uport_mask;      // Bit 0 is the CPU
+    uchar  flags;           // Bit 0 static, bit 1 IPMC
+} bp_mac_t;
+
+typedef struct {
+    uchar  uport;
+    ushort ttl;
+    uchar  chassis_id_subtype;
+    uchar  chassis_id_len;
+    uchar  chassis_id[BP_LLDP_ID_LEN];
+    uchar  port_id_subtype;
+    uchar  port_id_len;
+    uchar  port_id[BP_LLDP_ID_LEN];
+} bp_lldp_t;
+
+/* Called per table entry, a non zero return stops the walk */
+typedef int (*bp_mac_cb_t) (const bp_mac_t *mac, void *ctx);
+typedef int (*bp_lldp_cb_t) (const bp_lldp_t *lldp, void *ctx);
+
+/* Open tty at BAUD_RATE and switch the CLI to the binary protocol.
+   Returns the fd or -1 */
+int bp_open (const char *tty);
+
+/*
+ * Send the request of op and return the response payload after the status
+ * byte in rsp, rsp_len is its length. rsp must hold BP_MAX_PAYLOAD bytes.
+ */
+int bp_request (int fd, uchar op, const uchar *req, uchar req_len, uchar *rsp, uchar *rsp_len);
+
+int bp_info (int fd, bp_info_t *info);
+int bp_reg_read (int fd, ulong addr, uchar cnt, ulong *val);
+int bp_reg_write (int fd, ulong addr, uchar cnt, const ulong *val);
+
+/* cnt counters ids of all ports, val[(uport - 1) * cnt + i] */
+int bp_counters (int fd, uchar ports, uchar cnt, const uchar *ids, ulong *val);
+
+/* Link mode (LINK_MODE_xxx) per uport, mode[uport - 1] */
+int bp_link (int fd, uchar *ports, uchar *mode);
+
+int bp_mac_walk (int fd, bp_mac_cb_t cb, void *ctx);
+int bp_lldp_walk (int fd, bp_lldp_cb_t cb, void *ctx);
+
+/* Return the switch to the text CLI */
+int bp_exit (int fd);
+
+#endif /* __BP_CLIENT_H__ */
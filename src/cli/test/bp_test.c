@@ -0,0 +1,252 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+/*
+ * Loopback test of the binary telemetry protocol: binproto.c runs on the
+ * simulated UART of host_sim.c and bp_client.c talks to it over a socket
+ * pair, with line faults and trace text between the frames. The ports,
+ * counters, MAC table and LLDP neighbours are fixed tables of this file.
+ * The answers are printed, expected.txt holds the output to compare with.
+ * From the repository root:
+ *
+ *   gcc -std=gnu89 -include src/config/test/host.h -fpack-struct -fshort-enums \
+ *       -DVTSS_ARCH_OCELOT -DFERRET_F11 -DPROJ_OPT=99998 -DBP_CLIENT_NO_MAIN -pthread \
+ *       -Isrc/cli/test -Isrc/config/test -Isrc/config -Isrc/config/proj_opt -Isrc/cli \
+ *       -Isrc/lldp -Isrc/main -Isrc/phy -Isrc/switch -Isrc/util -Isrc/switch/vtss_api/base \
+ *       -Isrc/switch/vtss_api/base/ocelot -o /tmp/bp_test \
+ *       src/cli/test/bp_test.c src/cli/test/bp_client.c src/config/test/host_sim.c \
+ *       src/cli/binproto.c src/util/misc1.c && \
+ *   /tmp/bp_test | diff - src/cli/test/expected.txt
+ */
+
+#include "common.h"
+#include "vtss_api_base_regs.h"
+#include "hwport.h"
+#include "phytsk.h"
+#include "print.h"
+#include "h2stats.h"
+#include "h2mactab.h"
+#include "lldp_remote.h"
+#include "binproto.h"
+
+#include "host_sim.h"
+#include "bp_client.h"
+
+#define TEST_MAC_CNT        (2 * BP_MAC_PER_PAGE)   // The last page is empty
+#define TEST_LLDP_CNT       8
+#define TEST_LINK_TRACE     3                       // Trace text in front of the LINK response
+#define TEST_REG_ADDR       0x71070000UL
+#define TEST_OP_UNKNOWN     0x55
+
+static const uchar test_ids[] = {
+    CNT_RX_OCTETS, CNT_RX_PKTS, CNT_RX_MCAST_PKTS, CNT_RX_BCAST_PKTS,
+    CNT_TX_OCTETS, CNT_TX_PKTS, CNT_DROP_LOCAL, CNT_DROP_TAIL
+};
+
+static mac_tab_t           test_mac[TEST_MAC_CNT];
+static lldp_remote_entry_t test_lldp[TEST_LLDP_CNT];
+static uchar               test_lldp_str[TEST_LLDP_CNT][LLDP_REMOTE_STR_CNT][48];
+
+/*****************************************************************************
+ *
+ *
+ * Board of the test
+ *
+ *
+ *
+ ****************************************************************************/
+vtss_cport_no_t uport2cport (vtss_uport_no_t uport)
+{
+    return uport - 1;
+}
+
+uchar port_link_mode_get (vtss_cport_no_t chip_port)
+{
+    if (chip_port == TEST_LINK_TRACE) {
+        println_str("port 4: link up");
+    }
+    if (chip_port & 1) {
+        return LINK_MODE_DOWN;
+    }
+    return LINK_MODE_SPEED_1000 | LINK_MODE_FDX_MASK | (chip_port == 2 ? LINK_MODE_PAUSE_MASK : 0);
+}
+
+ulong h2_stats_counter_get (vtss_cport_no_t chip_port, port_statistics_t counter_id)
+{
+    return (ulong) chip_port << 16 | counter_id;
+}
+
+/* The entries are sorted by vid and MAC as the hardware walks them */
+ulong h2_mactab_get_next (mac_tab_t xdata *mac_tab_entry_ptr, BOOL xdata *ipmc_entry, BOOL xdata is_getnext)
+{
+    uchar i;
+
+    for (i = 0; i < TEST_MAC_CNT; i++) {
+        if (test_mac[i].vid > mac_tab_entry_ptr->vid ||
+            (test_mac[i].vid == mac_tab_entry_ptr->vid &&
+             memcmp(test_mac[i].mac_addr, mac_tab_entry_ptr->mac_addr, MAC_ADDR_LEN) > 0)) {
+            *mac_tab_entry_ptr = test_mac[i];
+            *ipmc_entry = (test_mac[i].mac_addr[0] == 0x01);
+            return (i % 3) == 0 ? VTSS_F_ANA_ANA_TABLES_MACACCESS_ENTRY_TYPE(1) : 0;
+        }
+    }
+    return 0xFFFFFFFF;
+}
+
+lldp_u8_t lldp_remote_get_max_entries (void)
+{
+    return TEST_LLDP_CNT;
+}
+
+lldp_remote_entry_t xdata *lldp_get_remote_entry (lldp_u8_t idx)
+{
+    return &test_lldp[idx];
+}
+
+lldp_u16_t lldp_remote_ttl_left (lldp_remote_entry_t xdata *entry)
+{
+    return entry->rx_info_ttl;
+}
+
+lldp_u8_t xdata *lldp_remote_str (lldp_remote_entry_t xdata *entry, lldp_u8_t str)
+{
+    return test_lldp_str[entry - test_lldp][str];
+}
+
+static void test_tables (void)
+{
+    uchar i, len;
+
+    for (i = 0; i < TEST_MAC_CNT; i++) {
+        test_mac[i].vid = 1 + i / 6;
+        test_mac[i].mac_addr[0] = (i % 6) == 5 ? 0x01 : 0x00;
+        test_mac[i].mac_addr[1] = 0x01;
+        test_mac[i].mac_addr[5] = 0x10 + i;
+        test_mac[i].port_mask = (i % 6) == 5 ? 0x0F | 1UL << CPU_CHIP_PORT : 1UL << (i % NO_OF_BOARD_PORTS);
+    }
+
+    /* Entries 1 and 4 are free, entry 6 has IDs which are cut */
+    for (i = 0; i < TEST_LLDP_CNT; i++) {
+        if (i == 1 || i == 4) {
+            continue;
+        }
+        test_lldp[i].in_use = 1;
+        test_lldp[i].receive_port = 1 + i;
+        test_lldp[i].rx_info_ttl = 120 - i;
+        test_lldp[i].chassis_id_subtype = 4;
+        test_lldp[i].port_id_subtype = 5;
+        len = sprintf((char *) test_lldp_str[i][LLDP_REMOTE_STR_CHASSIS_ID],
+                      i == 6 ? "chassis-%u-with-an-id-longer-than-32-bytes" : "chassis-%u", i);
+        test_lldp[i].str_len[LLDP_REMOTE_STR_CHASSIS_ID] = len;
+        len = sprintf((char *) test_lldp_str[i][LLDP_REMOTE_STR_PORT_ID],
+                      i == 6 ? "port-%u-with-an-id-longer-than-32-bytes-too" : "port-%u", i);
+        test_lldp[i].str_len[LLDP_REMOTE_STR_PORT_ID] = len;
+    }
+}
+
+/*****************************************************************************
+ *
+ *
+ * Client side
+ *
+ *
+ *
+ ****************************************************************************/
+static int test_print_mac (const bp_mac_t *mac, void *ctx)
+{
+    printf("  %u %02x-%02x-%02x-%02x-%02x-%02x 0x%08x 0x%02x\n", mac->vid,
+           mac->mac[0], mac->mac[1], mac->mac[2], mac->mac[3], mac->mac[4], mac->mac[5],
+           mac->uport_mask, mac->flags);
+    (*(int *) ctx)++;
+    return 0;
+}
+
+static int test_print_lldp (const bp_lldp_t *lldp, void *ctx)
+{
+    printf("  port %u ttl %u chassis %u:%.*s port %u:%.*s\n", lldp->uport, lldp->ttl,
+           lldp->chassis_id_subtype, lldp->chassis_id_len, lldp->chassis_id,
+           lldp->port_id_subtype, lldp->port_id_len, lldp->port_id);
+    return 0;
+}
+
+static void *test_client (void *arg)
+{
+    int       fd = *(int *) arg;
+    bp_info_t info;
+    ulong     val[NO_OF_BOARD_PORTS * sizeof(test_ids)], wr[4] = {0x11111111, 0x22222222, 0x33333333, 0x44444444};
+    uchar     mode[BP_MAX_PAYLOAD], rsp[BP_MAX_PAYLOAD], ports, len, i, j;
+    int       rc, cnt = 0;
+
+    bp_client_faults = BP_FAULT_CRC;
+    rc = bp_info(fd, &info);
+    printf("-- info, bad CRC first: rc=%d, version %u, %u ports, max payload %u\n",
+           rc, info.version, info.ports, info.max_payload);
+
+    bp_client_faults = BP_FAULT_CUT;
+    rc = bp_link(fd, &ports, mode);
+    printf("-- link, cut first: rc=%d,", rc);
+    for (i = 0; i < ports; i++) {
+        printf(" %02x", mode[i]);
+    }
+    printf("\n");
+
+    bp_client_faults = BP_FAULT_NOISE;
+    rc = bp_reg_write(fd, TEST_REG_ADDR, 4, wr);
+    printf("-- reg write, noise first: rc=%d\n", rc);
+    rc = bp_reg_read(fd, TEST_REG_ADDR - 4, 6, val);
+    printf("-- reg read: rc=%d,", rc);
+    for (i = 0; i < 6; i++) {
+        printf(" %08x", val[i]);
+    }
+    printf("\n");
+    printf("-- reg read of 0 registers: rc=%d\n", bp_reg_read(fd, TEST_REG_ADDR, 0, val));
+    printf("-- unknown op: rc=%d\n", bp_request(fd, TEST_OP_UNKNOWN, NULL, 0, rsp, &len));
+    printf("-- info with a payload: rc=%d\n", bp_request(fd, BP_OP_INFO, rsp, 1, rsp, &len));
+
+    rc = bp_counters(fd, info.ports, sizeof(test_ids), test_ids, val);
+    printf("-- counters: rc=%d\n", rc);
+    for (i = 0; rc == 0 && i < info.ports; i++) {
+        printf("  %2u:", i + 1);
+        for (j = 0; j < sizeof(test_ids); j++) {
+            printf(" %06x", val[i * sizeof(test_ids) + j]);
+        }
+        printf("\n");
+    }
+
+    printf("-- mac table\n");
+    rc = bp_mac_walk(fd, test_print_mac, &cnt);
+    printf("-- mac table: rc=%d, %d entries\n", rc, cnt);
+
+    printf("-- lldp\n");
+    rc = bp_lldp_walk(fd, test_print_lldp, NULL);
+    printf("-- lldp: rc=%d\n", rc);
+
+    printf("-- exit: rc=%d\n", bp_exit(fd));
+    fflush(stdout);
+    return NULL;
+}
+
+int main (void)
+{
+    pthread_t thread;
+    int       sv[2];
+
+    test_tables();
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv)) {
+        perror("socketpair");
+        exit(2);
+    }
+    host_sim_uart(sv[0]);
+    pthread_create(&thread, NULL, test_client, &sv[1]);
+
+    /* As cli_tsk() after the BINARY command */
+    binproto_start();
+    while (binproto_tsk()) {
+        usleep(1000);
+    }
+    pthread_join(thread, NULL);
+    printf("-- binary mode ended\n");
+    return 0;
+}
@@ -156,11 +156,12 @@ sbit GPR7     = 0x87;
  * Set WATCHDOG_ENABLE to 1, if watchdog should be running all the time, otherwise
  * set it to 0 (in which case it will only be used in case of software reboot).
  */
-#define WATCHDOG_PRESENT    0
-#define WATCHDOG_ENABLE     0
+#define WATCHDOG_PRESENT    1
+#define WATCHDOG_ENABLE     TRANSIT_TASK_WDT
 
 /*
- * Define macros to enable and kick watchdog, see hwport.c.
+ * The watchdog is enabled by enable_watchdog() and kicked by the task
+ * watchdog in the timer interrupt, see hwport.c.
  */
 
 
@@ -14,6 +14,9 @@
 #include "h2io.h"
 #include "timer.h"
 #include "version.h"
+#if TRANSIT_TASK_WDT
+#include "taskdef.h"
+#endif
 
 #if defined(HWPORT_DEBUG_ENABLE)
 #include "print.h"
@@ -27,6 +30,16 @@
  *
  *
  ****************************************************************************/
+#if TRANSIT_TASK_WDT
+/* Run time deadlines of the main loop tasks, in 100 msec ticks */
+#define WDT_DEADLINE            50      /* 5 seconds */
+#define WDT_DEADLINE_CLI        250     /* 25 seconds, the CLI erases and programs the flash */
+
+/* WDT_LOCK sequence, see VTSS_ICPU_CFG_TIMERS_WDT */
+#define WDT_LOCK_KEY_0          0xBE
+#define WDT_LOCK_KEY_1          0xEF
+#define WDT_LOCK_FORCE_RESET    0x00    /* Any value but the keys after WDT_LOCK_KEY_0 */
+#endif // TRANSIT_TASK_WDT
 
 /*****************************************************************************
  *
@@ -54,6 +67,10 @@
  *
  *
  ****************************************************************************/
+#if TRANSIT_TASK_WDT
+data uchar wdt_task = TASK_ID_MAIN;
+data uchar wdt_task_ticks;
+#endif // TRANSIT_TASK_WDT
 
 /*****************************************************************************
  *
@@ -65,6 +82,13 @@
 static code uchar port2ext_tab [NO_OF_CHIP_PORTS] = CPORT_MAPTO_UPORT;
 static code uchar port2int_tab [NO_OF_BOARD_PORTS] = UPORT_MAPTO_CPORT;
 
+#if TRANSIT_TASK_WDT
+static bit   wdt_armed;         // Set by enable_watchdog()
+static bit   wdt_last_reset;    // Last reset was done by the watchdog
+static uchar wdt_sec_ticks;
+static ulong wdt_up_time;       // Seconds, counted by the interrupt itself
+#endif // TRANSIT_TASK_WDT
+
 /*****************************************************************************
  *
  *
@@ -263,6 +287,85 @@ void gpio_init(void)
     h2_sgpio_enable();
 }
 
+#if TRANSIT_TASK_WDT
+/* ************************************************************************ */
+void enable_watchdog (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Enable the chip watchdog and the task deadlines.
+ * Remarks     : The watchdog resets the chip when it is not kicked for 2
+ *               seconds. From here on it is kicked by wdt_tick().
+ * Restrictions:
+ * See also    : wdt_tick
+ * Example     :
+ ****************************************************************************/
+{
+    ulong reg;
+
+    H2_READ(VTSS_ICPU_CFG_TIMERS_WDT, reg);
+    wdt_last_reset = VTSS_X_ICPU_CFG_TIMERS_WDT_WDT_STATUS(reg);
+
+    H2_WRITE(VTSS_ICPU_CFG_TIMERS_WDT,
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_ENABLE(1) |
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_LOCK(WDT_LOCK_KEY_0));
+    H2_WRITE(VTSS_ICPU_CFG_TIMERS_WDT,
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_ENABLE(1) |
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_LOCK(WDT_LOCK_KEY_1));
+    wdt_task_ticks = 0;
+    wdt_armed = TRUE;
+}
+
+/* Whether the last reset was done by the watchdog */
+BOOL wdt_last_reset_get (void)
+{
+    return wdt_last_reset;
+}
+
+/* Called with the register bank of the interrupt */
+#pragma NOAREGS
+/* ************************************************************************ */
+void wdt_tick (void) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Check the deadline of the running task and kick the
+ *               watchdog.
+ * Remarks     : Called by the timer interrupt every 100 msec, so a task
+ *               stuck in a busy-wait is caught. When the task misses its
+ *               deadline, the post-mortem record is written into the flash
+ *               and the watchdog reset is forced right away.
+ * Restrictions: Only called from the timer interrupt.
+ * See also    : flash_pm_write
+ * Example     :
+ ****************************************************************************/
+{
+    if (++wdt_sec_ticks == 10) {
+        wdt_sec_ticks = 0;
+        wdt_up_time++;
+    }
+    if (!wdt_armed) {
+        return;
+    }
+
+    if (++wdt_task_ticks < (wdt_task == TASK_ID_CLI ? WDT_DEADLINE_CLI : WDT_DEADLINE)) {
+        H2_WRITE(VTSS_ICPU_CFG_TIMERS_WDT,
+                 VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_ENABLE(1) |
+                 VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_LOCK(WDT_LOCK_KEY_0));
+        H2_WRITE(VTSS_ICPU_CFG_TIMERS_WDT,
+                 VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_ENABLE(1) |
+                 VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_LOCK(WDT_LOCK_KEY_1));
+        return;
+    }
+
+    flash_pm_write(wdt_task, wdt_task_ticks, h2_last_addr, wdt_up_time);
+    H2_WRITE(VTSS_ICPU_CFG_TIMERS_WDT,
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_ENABLE(1) |
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_LOCK(WDT_LOCK_KEY_0));
+    H2_WRITE(VTSS_ICPU_CFG_TIMERS_WDT,
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_ENABLE(1) |
+             VTSS_F_ICPU_CFG_TIMERS_WDT_WDT_LOCK(WDT_LOCK_FORCE_RESET));
+    while (1);
+}
+#pragma AREGS
+#endif // TRANSIT_TASK_WDT
+
 /*****************************************************************************
  *                                                                           *
  *  End of file.                                                             *
@@ -65,6 +65,22 @@ void phy_hw_init (void);
 /* GPIO/SGPIO initialization and SFP_TXDISABLE setup */
 void gpio_init(void);
 
+#if TRANSIT_TASK_WDT
+/**
+ * Enable the chip watchdog. From then on, it is kicked by the timer interrupt
+ * as long as the running task is within its deadline, see taskdef.h.
+ */
+void enable_watchdog(void);
+
+/**
+ * Whether the last reset was done by the watchdog.
+ */
+BOOL wdt_last_reset_get(void);
+
+/* Task deadline check, called by the timer interrupt every 100 msec */
+void wdt_tick(void) small;
+#endif /* TRANSIT_TASK_WDT */
+
 #endif /* __HWPORT_H__ */
 
 /*****************************************************************************
@@ -54,6 +54,10 @@
 /* Enable debug for TCAM */
 #define UNMANAGED_TCAM_DEBUG_IF                 0 
 
+/* Instrumented build: run time per main loop task, see CLI command PROFILE */
+#define TRANSIT_US_CLOCK                        1
+#define TRANSIT_TASK_PROFILE                    1
+
 
 /****************************************************************************
  * MAC configuration
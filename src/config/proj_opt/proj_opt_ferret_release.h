@@ -37,6 +37,16 @@
  * MUST set value =0x2 or 0x9 for CPORT_MAPTO_MIIMBUS accoringly
  */
 //#define SGMII_SERDES_FORCE_1G_DEBUG_ENABLE
+/****************************************************************************
+ * Console UART
+ ****************************************************************************/
+#define TRANSIT_UART_TX_RING                    1
+#define TRANSIT_CLI_RESUMABLE                   1
+#define TRANSIT_BIN_PROTO                       1
+#define TRANSIT_TIMER_WHEEL                     1
+#define TRANSIT_US_CLOCK                        1
+#define TRANSIT_TASK_WDT                        1
+
 /****************************************************************************
  * MAC configuration
  ****************************************************************************/
@@ -59,7 +69,10 @@
  * Enable flash driver for accessing MAC address stored in SPI flash
  ****************************************************************************/
 #define TRANSIT_UNMANAGED_SWUP                  1
+#define TRANSIT_UNMANAGED_SWUP_STREAM           1
 #define TRANSIT_SPI_FLASH                       1
+#define TRANSIT_SPI_FLASH_JOURNAL               1
+#define TRANSIT_SPI_FLASH_MANIFEST              1
 
 
 /****************************************************************************
@@ -54,6 +54,16 @@
 #define TRANSIT_FLOW_CTRL_DEFAULT               0 /* Disable */
 
 
+/****************************************************************************
+ * Enable flash driver for the configuration in SPI flash
+ * The journal keeps the aggregation hash mode (CLI AGGR M, mailbox) across
+ * a reboot. The image update by stream and the image manifest stay off.
+ ****************************************************************************/
+#define TRANSIT_UNMANAGED_SWUP                  1
+#define TRANSIT_SPI_FLASH                       1
+#define TRANSIT_SPI_FLASH_JOURNAL               1
+
+
 /****************************************************************************
  * LACP
  ****************************************************************************/
@@ -132,6 +142,13 @@
  *      2.1 w 0x71000000 0x0 0x20 0x83010064 --> Enable with key 100(ox64) LACP on uport 1.
  *      2.2 w 0x71000000 0x0 0x20 0x84010064 --> Disable LACP on uport 1.
  *    After that, use command 'F' to check if the new configuration is applied.
+ *
+ * 3. Command ring.
+ *    Possible value of <conf_type>( 6-bit) - H2MAILC_TYPE_RING_ADDR(5)
+ *    The lower 16 bits of the reply <conf_data> are the 8051 memory address
+ *    of the command and response ring, see h2mailc.h for the ring layout.
+ *      3.1 w 0x71000000 0x0 0x20 0x85000000 --> Get the ring address.
  ****************************************************************************/
 #define TRANSIT_MAILBOX_COMM                    1
+#define TRANSIT_MAILBOX_RING                    1
 
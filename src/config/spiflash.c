@@ -18,6 +18,10 @@
 #include "h2txrx.h" /* using uchar rx_packet[] */
 #include "timer.h"
 #include "h2mactab.h"
+#include "taskdef.h"
+#if TRANSIT_SPI_FLASH_JOURNAL || TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_SPI_FLASH_MANIFEST
+#include "misc1.h"
+#endif // TRANSIT_SPI_FLASH_JOURNAL || TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_SPI_FLASH_MANIFEST
 
 #if defined(NPI_CHIP_PORT) && TRANSIT_UNMANAGED_MAC_OPER_SET
 #include "h2mactab.h"
@@ -103,6 +107,91 @@
 // Image start address
 #define FLASH_IMG_START_ADDR_BL         0x0
 
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+#define FLASH_UPLOAD_MAX_RETRY      10          // Retries of one block
+#define FLASH_UPLOAD_RX_TIMEOUT     MSEC_1000   // Idle time before a block is requested again
+#define FLASH_UPLOAD_WIP_MAX_POLL   1000        // Status polls for one page program
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+/*
+ Configuration journal layout
+ The first sector of CFG keeps the legacy config_contents block since the
+ boot loader reads rt_magic/rt_idx from there. The remaining sectors of CFG
+ are used as a ring of journal sectors:
+
+   <0xC5> <0x4A> <seq MSB> <seq LSB> <record> <record> ... <0xFF (erased)>
+
+ record = <key> <len> <crc MSB> <crc LSB> <len bytes of data>
+ The CRC-16 covers key, len and data. A later record overrides an earlier
+ record of the same key. When the active sector is full, the current value
+ of every key is written into the next sector (compaction) and its header is
+ programmed last, so an interrupted compaction leaves the old sector active.
+*/
+#define FLASH_JRNL_MAGIC_0          0xC5
+#define FLASH_JRNL_MAGIC_1          0x4A
+#define FLASH_JRNL_HDR_LEN          4       // Sector header length
+#define FLASH_JRNL_REC_HDR_LEN      4       // Record header length
+#define FLASH_JRNL_MIN_SECTORS      2
+#define FLASH_JRNL_MAX_SECTORS      8
+#define FLASH_JRNL_MAX_DATA_LEN     64      // Max. data length of a record
+/* Data length of a record in flash_jrnl_keys[]. The array size turns negative
+   and fails to compile when the record exceeds FLASH_JRNL_MAX_DATA_LEN. */
+#define FLASH_JRNL_LEN(len)         (sizeof(char [((len) <= FLASH_JRNL_MAX_DATA_LEN) ? 1 : -1]) * (len))
+#define FLASH_JRNL_BUF_SIZE         128     // Records batched into one page program
+#define FLASH_JRNL_SECT_NONE        0xFF    // No valid journal sector found
+
+// Record keys. Never reuse a key for a different content.
+#define FLASH_JRNL_KEY_SYS_MAC      0x01
+#define FLASH_JRNL_KEY_RT0_MANIFEST 0x02
+#define FLASH_JRNL_KEY_RT1_MANIFEST 0x03
+#define FLASH_JRNL_KEY_AGGR_MODE    0x04
+#define FLASH_JRNL_KEY_VLAN_PORT    0x05
+#define FLASH_JRNL_KEY_VLAN_TAB     0x06
+#define FLASH_JRNL_KEY_STORM_CLASS  0x07
+#define FLASH_JRNL_KEY_STORM_PORT   0x08
+#define FLASH_JRNL_KEY_MIRROR       0x09
+#define FLASH_JRNL_KEY_QOS_MAP      0x0A
+#define FLASH_JRNL_KEY_QOS_PORT     0x0B
+#define FLASH_JRNL_KEY_BUF_PROFILE  0x0C
+#define FLASH_JRNL_KEY_FREE         0xFF    // Erased flash, end of journal
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+
+#if TRANSIT_SPI_FLASH_MANIFEST
+/*
+ Image manifest
+ A manifest is kept in the configuration for each runtime image slot. It is
+ computed from a read back of the flash when the image is programmed. The
+ digest is the CRC-32 over the chunk CRCs (MSB first), so two images can be
+ compared by their digest alone.
+*/
+#define FLASH_MANIFEST_MAGIC        0x4D
+#define FLASH_MANIFEST_CHUNK_SIZE   0x1000UL    // One CRC per 4K chunk
+#define FLASH_MANIFEST_CHUNK_CNT    (FLASH_IMG_SIZE_RT / FLASH_MANIFEST_CHUNK_SIZE)
+#define FLASH_VERIFY_BYTES_PER_RUN  32          // Bytes read per flash_verify_tsk() call
+#define FLASH_VERIFY_INTERVAL       6000        // 10 minutes (100ms ticks) between passes over the other slot
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
+#if TRANSIT_TASK_WDT
+/*
+ Post-mortem records
+ FLASH_PM_REC_CNT record slots at the start of the last CFG sector. This
+ sector is used for nothing else, the journal ends in front of it, so the
+ records survive configuration writes and image activations. A sector of
+ another content found at boot (a journal sector of an older layout) is
+ erased. The task watchdog programs its record into the first erased slot,
+ so nothing is erased when the system fails. Records are dropped once all
+ slots are used until flash_pm_clear() erases the sector.
+ With a single CFG sector (sector size 16K or more) the slots are the last
+ page of that sector, behind the legacy config_contents block. Every write
+ of the legacy block, i.e. an image activation or a configuration write
+ without the journal, erases the sector and clears the records.
+*/
+#define FLASH_PM_MAGIC              0x57
+#define FLASH_PM_OWN_SECTOR()       (cur_flash_info.sa_rt0 - cur_flash_info.sa_cfg >= 2 * cur_flash_info.ss)
+#define FLASH_PM_WIP_MAX_POLL       5000        // Status polls, well below the 2 seconds of the watchdog
+#endif // TRANSIT_TASK_WDT
+
 
 /*****************************************************************************
  *
@@ -112,11 +201,54 @@
  *
  *
  ****************************************************************************/
+#if TRANSIT_SPI_FLASH_MANIFEST
+typedef struct {
+    uchar   magic;                                  // FLASH_MANIFEST_MAGIC when valid
+    ulong   len;                                    // Image length
+    ulong   digest;                                 // CRC-32 over chunk_crc[]
+    ulong   chunk_crc[FLASH_MANIFEST_CHUNK_CNT];    // CRC-32 of each chunk
+} flash_manifest_t;
+
+typedef enum {
+    FLASH_VERIFY_PENDING,       // Not verified since boot/programming
+    FLASH_VERIFY_NO_MANIFEST,   // Programmed without a manifest
+    FLASH_VERIFY_OK,
+    FLASH_VERIFY_FAIL
+} flash_verify_status_t;
+
+typedef struct {
+    flash_verify_status_t   status;
+    uchar                   bad_chunk;  // Chunk with a CRC mismatch
+    ushort                  pass_cnt;   // Passes without error
+} flash_verify_info_t;
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
 struct config_contents {
     uchar       rt_magic;       // run-time valid bit
     uchar       rt_idx;         // Runtime code index
     uchar       signature;      // Configuration signature
     mac_addr_t  sys_mac;        // System MAC address
+#if TRANSIT_SPI_FLASH_MANIFEST
+    flash_manifest_t rt_manifest[2];    // Manifest of RT0 and RT1
+#endif
+#if TRANSIT_LAG
+    uchar       aggr_mode;      // Aggregation hash mode, FLASH_AGGR_MODE_NONE if not set
+#endif
+#if TRANSIT_VLAN
+    h2_vlan_conf_t vlan_conf;   // VLAN configuration, all 0xFF if not set
+#endif
+#if TRANSIT_STORM_CONTROL
+    h2_storm_conf_t storm_conf; // Storm control configuration, all 0xFF if not set
+#endif
+#if TRANSIT_MIRROR
+    h2_mirror_conf_t mirror_conf;   // Mirror configuration, all 0xFF if not set
+#endif
+#if TRANSIT_QOS
+    h2_qos_conf_t qos_conf;     // QoS configuration, all 0xFF if not set
+#endif
+#if TRANSIT_BUF_PROFILE
+    uchar       buf_profile;    // Buffer profile, FLASH_BUF_PROFILE_NONE if not set
+#endif
 };
 
 struct flash_info {
@@ -131,6 +263,38 @@ struct flash_info {
     ulong   sa_rt1;         // Start Address of Runtime Code 1
 };
 
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+/* Receive state of an upload block */
+typedef enum {
+    FLASH_UPLOAD_RX_SOH,
+    FLASH_UPLOAD_RX_BLK_MSB,
+    FLASH_UPLOAD_RX_BLK_LSB,
+    FLASH_UPLOAD_RX_DATA,
+    FLASH_UPLOAD_RX_CRC_MSB,
+    FLASH_UPLOAD_RX_CRC_LSB,
+    FLASH_UPLOAD_RX_DONE,
+    FLASH_UPLOAD_RX_CANCEL
+} flash_upload_rx_state_t;
+
+typedef struct {
+    flash_upload_rx_state_t state;
+    uchar                   buf_idx;    // Buffer receiving the block
+    ushort                  blk_no;     // Received block number
+    ushort                  cnt;        // Received data bytes
+    ushort                  crc;        // Received CRC
+    ushort                  crc_calc;   // Calculated CRC
+    BOOL                    progress;   // Any byte received since last check
+} flash_upload_rx_t;
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+typedef struct {
+    uchar   key;            // Record key
+    ushort  offset;         // Offset in struct config_contents
+    uchar   len;            // Data length
+} flash_jrnl_key_t;
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+
 mac_addr_t xdata mac_addr_0  = {0x00,0x00,0x00,0x00,0x00,0x00};
 mac_addr_t xdata mac_addr_ff = {0xff,0xff,0xff,0xff,0xff,0xff};
 mac_addr_t spiflash_mac_addr = {0, 0x01, 0xc1, 0, 0, 0};
@@ -149,6 +313,78 @@ static xdata struct config_contents config_shadow;
 static ulong data simaster_shadow = 0x00;
 static xdata struct flash_info cur_flash_info;
 
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+static flash_upload_rx_t upload_rx;
+#if TRANSIT_LLDP || TRANSIT_LACP
+/* The frame buffer is idle while the CLI runs the upload, use it for the
+   two upload blocks */
+#define FLASH_UPLOAD_BUF(idx)   (&rx_packet[(idx) * FLASH_UPLOAD_BLOCK_SIZE])
+#else
+static xdata uchar upload_buf[2][FLASH_UPLOAD_BLOCK_SIZE];
+#define FLASH_UPLOAD_BUF(idx)   (upload_buf[idx])
+#endif // TRANSIT_LLDP || TRANSIT_LACP
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+/* The configuration items kept in the journal */
+static code flash_jrnl_key_t flash_jrnl_keys[] = {
+    { FLASH_JRNL_KEY_SYS_MAC, offsetof(struct config_contents, sys_mac), FLASH_JRNL_LEN(sizeof(mac_addr_t)) },
+#if TRANSIT_SPI_FLASH_MANIFEST
+    { FLASH_JRNL_KEY_RT0_MANIFEST, offsetof(struct config_contents, rt_manifest[0]), FLASH_JRNL_LEN(sizeof(flash_manifest_t)) },
+    { FLASH_JRNL_KEY_RT1_MANIFEST, offsetof(struct config_contents, rt_manifest[1]), FLASH_JRNL_LEN(sizeof(flash_manifest_t)) },
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+#if TRANSIT_LAG
+    { FLASH_JRNL_KEY_AGGR_MODE, offsetof(struct config_contents, aggr_mode), FLASH_JRNL_LEN(sizeof(uchar)) },
+#endif // TRANSIT_LAG
+#if TRANSIT_VLAN
+    { FLASH_JRNL_KEY_VLAN_PORT, offsetof(struct config_contents, vlan_conf.port), FLASH_JRNL_LEN(sizeof(h2_vlan_port_conf_t) * NO_OF_BOARD_PORTS) },
+    { FLASH_JRNL_KEY_VLAN_TAB, offsetof(struct config_contents, vlan_conf.vlan), FLASH_JRNL_LEN(sizeof(h2_vlan_entry_t) * H2_VLAN_CNT) },
+#endif // TRANSIT_VLAN
+#if TRANSIT_STORM_CONTROL
+    { FLASH_JRNL_KEY_STORM_CLASS, offsetof(struct config_contents, storm_conf.class_rate), FLASH_JRNL_LEN(sizeof(ulong) * H2_STORM_CLASS_CNT) },
+    { FLASH_JRNL_KEY_STORM_PORT, offsetof(struct config_contents, storm_conf.port), FLASH_JRNL_LEN(sizeof(h2_storm_port_conf_t) * NO_OF_BOARD_PORTS) },
+#endif // TRANSIT_STORM_CONTROL
+#if TRANSIT_MIRROR
+    { FLASH_JRNL_KEY_MIRROR, offsetof(struct config_contents, mirror_conf), FLASH_JRNL_LEN(sizeof(h2_mirror_conf_t)) },
+#endif // TRANSIT_MIRROR
+#if TRANSIT_QOS
+    /* PCP map, DSCP map and weights are one record */
+    { FLASH_JRNL_KEY_QOS_MAP, offsetof(struct config_contents, qos_conf.pcp_queue), FLASH_JRNL_LEN(offsetof(h2_qos_conf_t, port)) },
+    { FLASH_JRNL_KEY_QOS_PORT, offsetof(struct config_contents, qos_conf.port), FLASH_JRNL_LEN(sizeof(h2_qos_port_conf_t) * NO_OF_BOARD_PORTS) },
+#endif // TRANSIT_QOS
+#if TRANSIT_BUF_PROFILE
+    { FLASH_JRNL_KEY_BUF_PROFILE, offsetof(struct config_contents, buf_profile), FLASH_JRNL_LEN(sizeof(uchar)) },
+#endif // TRANSIT_BUF_PROFILE
+};
+#define FLASH_JRNL_KEY_CNT  (sizeof(flash_jrnl_keys) / sizeof(flash_jrnl_key_t))
+
+/* Configuration as it is currently stored in the journal */
+static xdata struct config_contents config_persisted;
+static xdata uchar  jrnl_buf[FLASH_JRNL_BUF_SIZE];
+static ushort       jrnl_buf_len;
+static ulong        jrnl_sa;            // Start address of the first journal sector
+static uchar        jrnl_sect_cnt;      // 0 when the journal is not available
+static uchar        jrnl_active;        // Active sector index
+static ushort       jrnl_seq;           // Sequence number of the active sector
+static ushort       jrnl_wr_off;        // Next free offset in the active sector
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+
+#if TRANSIT_SPI_FLASH_MANIFEST
+static xdata flash_verify_info_t verify_info[2];
+static uchar        verify_run_slot;    // Slot of the running image
+static uchar        verify_slot;        // Slot being verified
+static uchar        verify_chunk;       // Chunk being verified
+static ushort       verify_off;         // Offset in the image
+static ulong        verify_crc;         // CRC of the chunk so far
+static ushort       verify_idle;        // 100ms ticks until the next pass
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
+#if TRANSIT_TASK_WDT
+static ulong        pm_addr;            // Free record slot, 0 when all are used
+static uchar        pm_cnt;             // Records in the flash
+static ulong        pm_simaster;        // SW_MODE shadow of flash_pm_write()
+#endif // TRANSIT_TASK_WDT
+
 
 /*****************************************************************************
  *
@@ -244,7 +480,7 @@ static uchar flash_read_status (void) small {
 static uchar flash_wait_wip (ulong timeout_value) small {
     ushort status, sec = 0, ms = 0;
 
-    if (timeout > MSEC_1000) {
+    if (timeout_value > MSEC_1000) {
         sec = timeout_value / MSEC_1000 - 1;
         ms  = timeout_value % MSEC_1000;
         start_timer(MSEC_1000);
@@ -253,14 +489,16 @@ static uchar flash_wait_wip (ulong timeout_value) small {
     }
 
     do {
+        /* Bounded by timeout_value, not a stall for the task watchdog */
+        WDT_TASK_ALIVE();
         status = flash_read_status() & FLASH_STATUS_WIP;
         if (timeout()) {
             if (sec != 0) {
                 sec--;
                 start_timer(MSEC_1000);
             } else if (ms != 0) {
-                ms = 0;
                 start_timer(ms);
+                ms = 0;
             } else {
 #if FLASH_DEBUG
                 print_str("WIP timout");
@@ -318,13 +556,12 @@ static uchar flash_page_program (ulong addr, uchar *data_ptr, ulong len)
     ulong cnt, i;
 
     while (len > 0) {
-        if (len > FLASH_PAGE_SIZE) {
-            cnt = FLASH_PAGE_SIZE;
-            len -= FLASH_PAGE_SIZE;
-        } else {
+        /* Never cross a page boundary, the address would wrap within the page */
+        cnt = FLASH_PAGE_SIZE - (addr & (FLASH_PAGE_SIZE - 1));
+        if (cnt > len) {
             cnt = len;
-            len = 0;
         }
+        len -= cnt;
 
         spi_ctrl_enter();
         flash_enable_write();
@@ -343,13 +580,33 @@ static uchar flash_page_program (ulong addr, uchar *data_ptr, ulong len)
         }
         spi_ctrl_exit();
 
-        addr += FLASH_PAGE_SIZE;
+        addr += cnt;
     }
 
     return 0;
 }
 
-#if FLASH_SUPPORT_IMAGE_CHECKSUM
+#if TRANSIT_SPI_FLASH_JOURNAL || TRANSIT_SPI_FLASH_MANIFEST || TRANSIT_TASK_WDT
+/* Start a fast read at addr, read the data with input_byte() */
+static void flash_read_start (ulong addr) small
+{
+    spi_ctrl_enter();
+    set_cs(FLASH_VOLTAGE_LOW);
+    output_byte(FLASH_FAST_READ);
+    output_byte(addr >> 16 & 0xFF);
+    output_byte(addr >> 8 & 0xFF);
+    output_byte(addr & 0xFF);
+    output_byte(0); // Dummy byte
+}
+
+static void flash_read_stop (void) small
+{
+    set_cs(FLASH_VOLTAGE_HIGH);
+    spi_ctrl_exit();
+}
+#endif // TRANSIT_SPI_FLASH_JOURNAL || TRANSIT_SPI_FLASH_MANIFEST || TRANSIT_TASK_WDT
+
+#if FLASH_SUPPORT_IMAGE_CHECKSUM && !TRANSIT_SPI_FLASH_MANIFEST
 static uchar flash_checksum (ulong start_addr, ulong len)
 {
     uchar csum;
@@ -381,6 +638,193 @@ static uchar flash_change_rt_idx (void)
     return flash_page_program(cur_flash_info.sa_cfg, (uchar *) &config_shadow, sizeof(config_shadow));
 }
 
+#if TRANSIT_SPI_FLASH_MANIFEST
+static ulong flash_manifest_digest (flash_manifest_t xdata *mf)
+{
+    ulong crc = CRC32_INIT;
+    uchar i, j;
+
+    for (i = 0; i < FLASH_MANIFEST_CHUNK_CNT; i++) {
+        for (j = 24; ; j -= 8) {
+            crc = crc32_update(crc, (uchar) (mf->chunk_crc[i] >> j));
+            if (j == 0) {
+                break;
+            }
+        }
+    }
+    return ~crc;
+}
+
+/* ************************************************************************ */
+static uchar flash_manifest_build (ulong addr, ulong len, flash_manifest_t xdata *mf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Read back an image, return its 8-bit checksum and fill in
+ *               the manifest in the same pass
+ * Remarks     : mf may be NULL when no manifest is kept (boot loader,
+ *               single image flash). The manifest is only marked valid by
+ *               the caller once the checksum matches.
+ * Restrictions:
+ * See also    : flash_checksum
+ * Example     :
+ ****************************************************************************/
+{
+    ulong i, crc = CRC32_INIT;
+    uchar csum = 0, ch, chunk = 0;
+
+    if (mf) {
+        memset(mf, 0, sizeof(*mf));
+    }
+    flash_read_start(addr);
+    for (i = 0; i < len; i++) {
+        ch = input_byte();
+        csum += ch;
+        if (mf) {
+            crc = crc32_update(crc, ch);
+            if (((i + 1) & (FLASH_MANIFEST_CHUNK_SIZE - 1)) == 0 || i + 1 == len) {
+                mf->chunk_crc[chunk++] = ~crc;
+                crc = CRC32_INIT;
+            }
+        }
+    }
+    flash_read_stop();
+
+    if (mf) {
+        mf->len    = len;
+        mf->digest = flash_manifest_digest(mf);
+    }
+    return csum;
+}
+
+/* Verify slot from the start, e.g. when it has been reprogrammed */
+static void flash_verify_restart (uchar slot)
+{
+    verify_info[slot].status = FLASH_VERIFY_PENDING;
+    verify_slot = slot;
+    verify_off  = 0;
+    verify_idle = 0;
+}
+
+/* Select the next pass: the running image until it passed once, then the
+   other slot every FLASH_VERIFY_INTERVAL */
+static void flash_verify_next (void)
+{
+    verify_off = 0;
+    if (verify_info[verify_run_slot].status == FLASH_VERIFY_PENDING) {
+        verify_slot = verify_run_slot;
+    } else {
+        verify_slot = verify_run_slot ^ 1;
+        if (verify_info[verify_slot].status != FLASH_VERIFY_PENDING) {
+            verify_idle = FLASH_VERIFY_INTERVAL;
+        }
+    }
+}
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
+/*
+ * Get the programming address of an image
+ *  return: 0 - success, 1 - fail
+ */
+static uchar flash_image_addr_get (uchar img_type, ulong len, ulong *addr)
+{
+    if (len == 0) {
+        return 1;
+    }
+
+    switch (img_type) {
+    case FLASH_IMG_TYPE_BL:
+        if (len > FLASH_IMG_SIZE_BL) {
+            return 1;
+        }
+        *addr = FLASH_IMG_START_ADDR_BL;
+        break;
+    case FLASH_IMG_TYPE_RT:
+        if (len > FLASH_IMG_SIZE_RT) {
+            return 1;
+        }
+        if (cur_flash_info.is_single_img) {
+            *addr = FLASH_IMG_START_ADDR_BL;
+        } else {
+            if (config_shadow.rt_idx == 1) {
+                *addr = cur_flash_info.sa_rt0;
+            } else {
+                *addr = cur_flash_info.sa_rt1;
+            }
+        }
+        break;
+    default:
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Verify a programmed image and activate it
+ *  return: 0 - success, 1 - fail
+ */
+static uchar flash_image_commit (uchar img_type, ulong img_addr, ulong img_len, uchar csum)
+{
+#if TRANSIT_SPI_FLASH_MANIFEST
+    flash_manifest_t xdata *mf = NULL;
+    uchar slot = 0, rc;
+
+    if (!cur_flash_info.is_single_img && img_type == FLASH_IMG_TYPE_RT) {
+        slot = (img_addr == cur_flash_info.sa_rt1);
+        mf = &config_shadow.rt_manifest[slot];
+    }
+
+    /* Check image checksum, the manifest is built in the same read back */
+    if (csum != flash_manifest_build(img_addr, img_len, mf)) {
+#if FLASH_DEBUG
+        print_str("csum = ");
+        print_dec(csum);
+        print_cr_lf();
+#endif
+        return 1;
+    }
+
+    if (mf) {
+        mf->magic = FLASH_MANIFEST_MAGIC;
+        flash_verify_restart(slot);
+
+        /* Change runtime code index, this writes the manifest to the legacy
+           block as well */
+        rc = flash_change_rt_idx();
+#if TRANSIT_SPI_FLASH_JOURNAL
+        /* The journal overrides the legacy block */
+        if (rc == 0 && jrnl_sect_cnt) {
+            rc = flash_program_config();
+        }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+        return rc;
+    }
+
+    return 0;
+#else
+#if FLASH_SUPPORT_IMAGE_CHECKSUM
+    /* Check image checksum */
+    if (csum != flash_checksum(img_addr, img_len)) {
+#if FLASH_DEBUG
+        print_str("csum = ");
+        print_dec(csum);
+        print_cr_lf();
+#endif
+        return 1;
+    }
+#else
+    csum = 0;
+    img_addr = img_len = 0;
+#endif /* FLASH_SUPPORT_IMAGE_CHECKSUM */
+
+    /* Change runtime code index */
+    if (!cur_flash_info.is_single_img && img_type == FLASH_IMG_TYPE_RT) {
+        return flash_change_rt_idx();
+    }
+
+    return 0;
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+}
+
 /* ************************************************************************ */
 uchar flash_erase_code (uchar img_type)
 /* ------------------------------------------------------------------------ --
@@ -392,6 +836,9 @@ uchar flash_erase_code (uchar img_type)
  ****************************************************************************/
 {
     ulong i, img_size, addr;
+#if TRANSIT_SPI_FLASH_MANIFEST
+    uchar slot;
+#endif // TRANSIT_SPI_FLASH_MANIFEST
 
     switch (img_type) {
     case FLASH_IMG_TYPE_BL:
@@ -421,6 +868,16 @@ uchar flash_erase_code (uchar img_type)
         }
     }
 
+#if TRANSIT_SPI_FLASH_MANIFEST
+    if (!cur_flash_info.is_single_img && img_type == FLASH_IMG_TYPE_RT) {
+        /* The manifest no longer describes the slot, verify reports it as
+           without manifest until the slot is programmed again */
+        slot = (addr == cur_flash_info.sa_rt1);
+        config_shadow.rt_manifest[slot].magic = 0;
+        flash_verify_restart(slot);
+    }
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
     return 0;
 }
 
@@ -434,47 +891,16 @@ uchar flash_download_image (uchar img_type, ulong len, uchar csum)
  * Example     :
  ****************************************************************************/
 {
-    ulong img_size, addr, i, cnt;
+    ulong addr, i, cnt;
     ulong timeout_cnt = 5; // 5 seconds
-#if FLASH_SUPPORT_IMAGE_CHECKSUM
     ulong img_addr, img_len;
-#endif
-
-    if (len == 0) {
-        return 1;
-    }
 
-    switch (img_type) {
-    case FLASH_IMG_TYPE_BL:
-        if (len > FLASH_IMG_SIZE_BL) {
-            return 1;
-        }
-        img_size = FLASH_IMG_SIZE_BL;
-        addr     = FLASH_IMG_START_ADDR_BL;
-        break;
-    case FLASH_IMG_TYPE_RT:
-        if (len > FLASH_IMG_SIZE_RT) {
-            return 1;
-        }
-        img_size = FLASH_IMG_SIZE_RT;
-        if (cur_flash_info.is_single_img) {
-            addr = FLASH_IMG_START_ADDR_BL;
-        } else {
-            if (config_shadow.rt_idx == 1) {
-                addr = cur_flash_info.sa_rt0;
-            } else {
-                addr = cur_flash_info.sa_rt1;
-            }
-        }
-        break;
-    default:
+    if (flash_image_addr_get(img_type, len, &addr)) {
         return 1;
     }
 
-#if FLASH_SUPPORT_IMAGE_CHECKSUM
     img_addr = addr;
     img_len = len;
-#endif
 
     /* Erase flash sectors */
     /* We should call flash_erase_code() first.
@@ -532,95 +958,463 @@ uchar flash_download_image (uchar img_type, ulong len, uchar csum)
         addr += FLASH_PAGE_SIZE;
     }
 
-#if FLASH_SUPPORT_IMAGE_CHECKSUM
-    /* Check image checksum */
-    if (csum != flash_checksum(img_addr, img_len)) {
-#if FLASH_DEBUG
-        print_str("csum = ");
-        print_dec(csum);
-        print_cr_lf();
-#endif
-        return 1;
-    }
-#else
-    csum = 0;
-#endif /* FLASH_SUPPORT_IMAGE_CHECKSUM */
+    return flash_image_commit(img_type, img_addr, img_len, csum);
+}
 
-    /* Change runtime code index */
-    if (!cur_flash_info.is_single_img && img_type == FLASH_IMG_TYPE_RT) {
-        return flash_change_rt_idx();
-    }
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+static void flash_upload_send (uchar ch, ushort blk_no)
+{
+    uart_put_byte(ch);
+    uart_put_byte(HIGH_BYTE(blk_no));
+    uart_put_byte(LOW_BYTE(blk_no));
+}
 
-    return 0;
+static void flash_upload_rx_start (uchar buf_idx)
+{
+    upload_rx.state   = FLASH_UPLOAD_RX_SOH;
+    upload_rx.buf_idx = buf_idx;
 }
 
-#ifndef UNMANAGED_REDUCED_DEBUG_IF
 /* ************************************************************************ */
-void flash_read_bytes (ulong start_addr, ulong len)
+static void flash_upload_rx_poll (void)
 /* ------------------------------------------------------------------------ --
- * Purpose     : Read len bytes from flash starting from start_addr and print
- * Remarks     : them to UART
+ * Purpose     : Move the received bytes into the upload block being received
+ * Remarks     : Called between the bytes of a page program as well, so the
+ *               next block is received while the previous one is programmed.
+ *               Stops consuming bytes when a complete block is received.
  * Restrictions:
  * See also    :
  * Example     :
  ****************************************************************************/
 {
-    ulong i;
-
-    if (len == 0) {
-        return;
-    }
-
-    print_cr_lf();
-    spi_ctrl_enter();
-    set_cs(FLASH_VOLTAGE_LOW);
-    output_byte(FLASH_FAST_READ);
-    output_byte(start_addr >> 16 & 0xFF);
-    output_byte(start_addr >> 8 & 0xFF);
-    output_byte(start_addr & 0xFF);
-    output_byte(0); // Dummy byte
-    for (i = 0; i < len; i++) {
-        print_hex_b(input_byte());
-        print_spaces(1);
-        if ((i & 0x0f) == 0x0f) {
-            print_cr_lf(); /* CR/LF every 16 byte */
+    uchar ch;
+
+    while (upload_rx.state < FLASH_UPLOAD_RX_DONE && uart_byte_ready()) {
+        ch = uart_get_byte();
+        upload_rx.progress = TRUE;
+
+        switch (upload_rx.state) {
+        case FLASH_UPLOAD_RX_SOH:
+            if (ch == FLASH_UPLOAD_SOH) {
+                upload_rx.state = FLASH_UPLOAD_RX_BLK_MSB;
+                upload_rx.crc_calc = CRC16_INIT;
+            } else if (ch == FLASH_UPLOAD_CAN) {
+                upload_rx.state = FLASH_UPLOAD_RX_CANCEL;
+            }
+            // Other bytes are line noise, keep hunting for SOH
+            continue;
+        case FLASH_UPLOAD_RX_BLK_MSB:
+            upload_rx.blk_no = (ushort) ch << 8;
+            upload_rx.state = FLASH_UPLOAD_RX_BLK_LSB;
+            break;
+        case FLASH_UPLOAD_RX_BLK_LSB:
+            upload_rx.blk_no |= ch;
+            upload_rx.cnt = 0;
+            upload_rx.state = FLASH_UPLOAD_RX_DATA;
+            break;
+        case FLASH_UPLOAD_RX_DATA:
+            FLASH_UPLOAD_BUF(upload_rx.buf_idx)[upload_rx.cnt] = ch;
+            if (++upload_rx.cnt == FLASH_UPLOAD_BLOCK_SIZE) {
+                upload_rx.state = FLASH_UPLOAD_RX_CRC_MSB;
+            }
+            break;
+        case FLASH_UPLOAD_RX_CRC_MSB:
+            upload_rx.crc = (ushort) ch << 8;
+            upload_rx.state = FLASH_UPLOAD_RX_CRC_LSB;
+            continue;
+        case FLASH_UPLOAD_RX_CRC_LSB:
+            upload_rx.crc |= ch;
+            upload_rx.state = FLASH_UPLOAD_RX_DONE;
+            continue;
+        default:
+            /* DONE and CANCEL end the loop above */
+            continue;
         }
+        upload_rx.crc_calc = crc16_update(upload_rx.crc_calc, ch);
     }
-    set_cs(FLASH_VOLTAGE_HIGH);
-    spi_ctrl_exit();
-    print_cr_lf();
 }
-#endif /* UNMANAGED_REDUCED_DEBUG_IF */
-
-/*****************************************************************************
- *
- *
- * Help functions
- *
- *
- *
- ****************************************************************************/
 
 /* ************************************************************************ */
-static ulong flash_read_id (void) small
+static uchar flash_upload_program (ulong addr, uchar xdata *buf, ushort len)
 /* ------------------------------------------------------------------------ --
- * Purpose     : Read flash identification
- * Remarks     :
+ * Purpose     : Program a block while receiving the next one
+ * Remarks     : Return 0 - success, 1 - fail
  * Restrictions:
- * See also    :
+ * See also    : flash_page_program
  * Example     :
  ****************************************************************************/
 {
-    ulong id;
+    ushort cnt, i;
 
-    spi_ctrl_enter();
-    set_cs(FLASH_VOLTAGE_LOW);
-    output_byte(FLASH_RDID);
-    id = (ulong) input_byte() << 16;
-    if (id == 0x7F0000) { // Specifical for A25L80, the flash ID is 4 byte
-        id = id << 8;
-        id |= (ulong) input_byte() << 16;
-    }
+    while (len > 0) {
+        cnt = FLASH_PAGE_SIZE - (addr & (FLASH_PAGE_SIZE - 1));
+        if (cnt > len) {
+            cnt = len;
+        }
+
+        spi_ctrl_enter();
+        flash_enable_write();
+        set_cs(FLASH_VOLTAGE_LOW);
+        output_byte(FLASH_PP);
+        output_byte(addr >> 16 & 0xFF);
+        output_byte(addr >> 8 & 0xFF);
+        output_byte(addr & 0xFF);
+        for (i = 0; i < cnt; i++) {
+            output_byte(buf[i]);
+            flash_upload_rx_poll();
+        }
+        set_cs(FLASH_VOLTAGE_HIGH);
+
+        /* The common timer is used for the receive timeout, count the polls */
+        for (i = 0; flash_read_status() & FLASH_STATUS_WIP; i++) {
+            if (i == FLASH_UPLOAD_WIP_MAX_POLL) {
+                spi_ctrl_exit();
+                return 1;
+            }
+            flash_upload_rx_poll();
+        }
+        spi_ctrl_exit();
+
+        addr += cnt;
+        buf  += cnt;
+        len  -= cnt;
+    }
+
+    return 0;
+}
+
+/* ************************************************************************ */
+uchar flash_upload_image (uchar img_type, ulong len, uchar csum, ulong baud)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Update Flash with an image uploaded in CRC-protected blocks
+ * Remarks     : See the protocol description in spiflash.h. The flash must
+ *               have been erased with flash_erase_code().
+ * Restrictions:
+ * See also    : flash_download_image
+ * Example     :
+ ****************************************************************************/
+{
+    ulong   img_addr, prog_len;
+    ushort  blk_cnt, expect = 0, prog_blk = 0;
+    uchar   retry = 0, rc = 1;
+    BOOL    prog_pending = FALSE;
+
+    if (flash_image_addr_get(img_type, len, &img_addr)) {
+        return 1;
+    }
+    blk_cnt = (len + FLASH_UPLOAD_BLOCK_SIZE - 1) / FLASH_UPLOAD_BLOCK_SIZE;
+
+    if (baud != 0) {
+        if ((baud = uart_baud_check(baud)) == 0) {
+            return 1;
+        }
+        print_str("BAUD ");
+        print_dec(baud);
+        print_cr_lf();
+        (void) uart_set_baud(baud);
+    }
+
+    flash_upload_rx_start(0);
+    flash_upload_send(FLASH_UPLOAD_NAK, 0);
+    start_timer(FLASH_UPLOAD_RX_TIMEOUT);
+
+    while (expect < blk_cnt || prog_pending) {
+        if (prog_pending) {
+            /* Program block prog_blk while block 'expect' is received */
+            prog_len = len - (ulong) prog_blk * FLASH_UPLOAD_BLOCK_SIZE;
+            if (prog_len > FLASH_UPLOAD_BLOCK_SIZE) {
+                prog_len = FLASH_UPLOAD_BLOCK_SIZE;
+            }
+            if (flash_upload_program(img_addr + (ulong) prog_blk * FLASH_UPLOAD_BLOCK_SIZE,
+                                     FLASH_UPLOAD_BUF(upload_rx.buf_idx ^ 1), prog_len)) {
+                uart_put_byte(FLASH_UPLOAD_CAN);
+                goto upload_exit;
+            }
+            prog_pending = FALSE;
+            start_timer(FLASH_UPLOAD_RX_TIMEOUT);
+        }
+
+        flash_upload_rx_poll();
+
+        if (upload_rx.state == FLASH_UPLOAD_RX_CANCEL) {
+            goto upload_exit;
+        } else if (upload_rx.state == FLASH_UPLOAD_RX_DONE) {
+            if (upload_rx.crc == upload_rx.crc_calc && upload_rx.blk_no == expect) {
+                /* Program it from this buffer and receive the next block
+                   into the other one */
+                flash_upload_send(FLASH_UPLOAD_ACK, expect);
+                WDT_TASK_ALIVE();
+                prog_blk = expect++;
+                prog_pending = TRUE;
+                retry = 0;
+                flash_upload_rx_start(upload_rx.buf_idx ^ 1);
+            } else {
+                if (upload_rx.crc == upload_rx.crc_calc && upload_rx.blk_no + 1 == expect) {
+                    /* Our ACK was lost, the block is already taken */
+                    flash_upload_send(FLASH_UPLOAD_ACK, upload_rx.blk_no);
+                } else if (++retry > FLASH_UPLOAD_MAX_RETRY) {
+                    uart_put_byte(FLASH_UPLOAD_CAN);
+                    goto upload_exit;
+                } else {
+                    flash_upload_send(FLASH_UPLOAD_NAK, expect);
+                }
+                flash_upload_rx_start(upload_rx.buf_idx);
+            }
+            start_timer(FLASH_UPLOAD_RX_TIMEOUT);
+        } else if (timeout()) {
+            if (upload_rx.progress) {
+                upload_rx.progress = FALSE;
+            } else if (++retry > FLASH_UPLOAD_MAX_RETRY) {
+                uart_put_byte(FLASH_UPLOAD_CAN);
+                goto upload_exit;
+            } else {
+                flash_upload_rx_start(upload_rx.buf_idx);
+                flash_upload_send(FLASH_UPLOAD_NAK, expect);
+            }
+            start_timer(FLASH_UPLOAD_RX_TIMEOUT);
+        }
+    }
+    rc = 0;
+
+upload_exit:
+    if (baud != 0) {
+        /* Let the host see the last answer before going back */
+        uart_tx_flush();
+        delay(MSEC_100);
+        (void) uart_set_baud(BAUD_RATE);
+    }
+
+    if (rc) {
+        return 1;
+    }
+    return flash_image_commit(img_type, img_addr, len, csum);
+}
+#endif /* TRANSIT_UNMANAGED_SWUP_STREAM */
+
+#if TRANSIT_SPI_FLASH_MANIFEST
+/* ************************************************************************ */
+void flash_verify_tsk (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Verify the runtime images against their manifest in the
+ *               background
+ * Remarks     : Called every 100ms and reads FLASH_VERIFY_BYTES_PER_RUN
+ *               bytes per call, so a 48K image takes about 2.5 minutes.
+ *               A CRC mismatch is reported once per pass.
+ * Restrictions:
+ * See also    : flash_verify_print
+ * Example     :
+ ****************************************************************************/
+{
+    flash_manifest_t xdata *mf;
+    ulong  chunk_end;
+    uchar  i, cnt;
+
+    if (cur_flash_info.is_single_img) {
+        return;
+    }
+    if (verify_idle) {
+        verify_idle--;
+        return;
+    }
+
+    mf = &config_shadow.rt_manifest[verify_slot];
+    if (verify_off == 0) {
+        if (mf->magic != FLASH_MANIFEST_MAGIC || mf->len == 0 || mf->len > FLASH_IMG_SIZE_RT) {
+            verify_info[verify_slot].status = FLASH_VERIFY_NO_MANIFEST;
+            flash_verify_next();
+            return;
+        }
+        verify_chunk = 0;
+        verify_crc = CRC32_INIT;
+    }
+
+    chunk_end = (ulong) (verify_chunk + 1) * FLASH_MANIFEST_CHUNK_SIZE;
+    if (chunk_end > mf->len) {
+        chunk_end = mf->len;
+    }
+    cnt = (chunk_end - verify_off) > FLASH_VERIFY_BYTES_PER_RUN ? FLASH_VERIFY_BYTES_PER_RUN : (chunk_end - verify_off);
+
+    flash_read_start((verify_slot ? cur_flash_info.sa_rt1 : cur_flash_info.sa_rt0) + verify_off);
+    for (i = 0; i < cnt; i++) {
+        verify_crc = crc32_update(verify_crc, input_byte());
+    }
+    flash_read_stop();
+    verify_off += cnt;
+
+    if (verify_off != chunk_end) {
+        return;
+    }
+    if (~verify_crc != mf->chunk_crc[verify_chunk]) {
+        verify_info[verify_slot].status    = FLASH_VERIFY_FAIL;
+        verify_info[verify_slot].bad_chunk = verify_chunk;
+        print_str("Flash image RT");
+        print_dec(verify_slot);
+        print_str(" CRC error at 0x");
+        print_hex_w(verify_chunk * FLASH_MANIFEST_CHUNK_SIZE);
+        print_cr_lf();
+        flash_verify_next();
+    } else if (verify_off == mf->len) {
+        verify_info[verify_slot].status = FLASH_VERIFY_OK;
+        verify_info[verify_slot].pass_cnt++;
+        flash_verify_next();
+    } else {
+        verify_chunk++;
+        verify_crc = CRC32_INIT;
+    }
+}
+
+/* ************************************************************************ */
+void flash_verify_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Show the manifest and verify status of the runtime images
+ * Remarks     :
+ * Restrictions:
+ * See also    : flash_verify_tsk
+ * Example     :
+ ****************************************************************************/
+{
+    flash_manifest_t xdata *mf;
+    uchar slot;
+
+    if (cur_flash_info.is_single_img) {
+        println_str("Single image flash, no manifest");
+        return;
+    }
+
+    println_str("Image  Length  Digest      Passes  Status");
+    for (slot = 0; slot < 2; slot++) {
+        mf = &config_shadow.rt_manifest[slot];
+        print_str("RT");
+        print_dec(slot);
+        print_str(slot == verify_run_slot ? "*   " : "    ");
+        if (mf->magic == FLASH_MANIFEST_MAGIC) {
+            print_dec_nright(mf->len, 6);
+            print_str("  0x");
+            print_hex_dw(mf->digest);
+        } else {
+            print_str("     -  -         ");
+        }
+        print_spaces(2);
+        print_dec_nright(verify_info[slot].pass_cnt, 6);
+        print_spaces(2);
+        switch (verify_info[slot].status) {
+        case FLASH_VERIFY_PENDING:
+            print_str(slot == verify_slot && verify_off ? "Verifying" : "Pending");
+            break;
+        case FLASH_VERIFY_NO_MANIFEST:
+            print_str("No manifest");
+            break;
+        case FLASH_VERIFY_OK:
+            print_str("OK");
+            break;
+        case FLASH_VERIFY_FAIL:
+            print_str("CRC error at 0x");
+            print_hex_w(verify_info[slot].bad_chunk * FLASH_MANIFEST_CHUNK_SIZE);
+            break;
+        }
+        print_cr_lf();
+    }
+}
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
+#ifndef UNMANAGED_REDUCED_DEBUG_IF
+#if TRANSIT_CLI_RESUMABLE
+/* ************************************************************************ */
+void flash_print_row (ulong start_addr, uchar len)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print up to 16 bytes from flash starting from start_addr as
+ *               one line
+ * Remarks     : Used by the CLI to dump the flash a few lines at a time
+ * Restrictions:
+ * See also    : flash_read_bytes
+ * Example     :
+ ****************************************************************************/
+{
+    uchar i;
+
+    spi_ctrl_enter();
+    set_cs(FLASH_VOLTAGE_LOW);
+    output_byte(FLASH_FAST_READ);
+    output_byte(start_addr >> 16 & 0xFF);
+    output_byte(start_addr >> 8 & 0xFF);
+    output_byte(start_addr & 0xFF);
+    output_byte(0); // Dummy byte
+    for (i = 0; i < len && i < 16; i++) {
+        print_hex_b(input_byte());
+        print_spaces(1);
+    }
+    set_cs(FLASH_VOLTAGE_HIGH);
+    spi_ctrl_exit();
+    print_cr_lf();
+}
+#endif // TRANSIT_CLI_RESUMABLE
+
+/* ************************************************************************ */
+void flash_read_bytes (ulong start_addr, ulong len)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Read len bytes from flash starting from start_addr and print
+ * Remarks     : them to UART
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong i;
+
+    if (len == 0) {
+        return;
+    }
+
+    print_cr_lf();
+    spi_ctrl_enter();
+    set_cs(FLASH_VOLTAGE_LOW);
+    output_byte(FLASH_FAST_READ);
+    output_byte(start_addr >> 16 & 0xFF);
+    output_byte(start_addr >> 8 & 0xFF);
+    output_byte(start_addr & 0xFF);
+    output_byte(0); // Dummy byte
+    for (i = 0; i < len; i++) {
+        print_hex_b(input_byte());
+        print_spaces(1);
+        if ((i & 0x0f) == 0x0f) {
+            print_cr_lf(); /* CR/LF every 16 byte */
+        }
+    }
+    set_cs(FLASH_VOLTAGE_HIGH);
+    spi_ctrl_exit();
+    print_cr_lf();
+}
+#endif /* UNMANAGED_REDUCED_DEBUG_IF */
+
+/*****************************************************************************
+ *
+ *
+ * Help functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+static ulong flash_read_id (void) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Read flash identification
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong id;
+
+    spi_ctrl_enter();
+    set_cs(FLASH_VOLTAGE_LOW);
+    output_byte(FLASH_RDID);
+    id = (ulong) input_byte() << 16;
+    if (id == 0x7F0000) { // Specifical for A25L80, the flash ID is 4 byte
+        id = id << 8;
+        id |= (ulong) input_byte() << 16;
+    }
     id |= ((ulong) input_byte() << 8);
     id |= input_byte();
     set_cs(FLASH_VOLTAGE_HIGH);
@@ -759,6 +1553,516 @@ int flash_init (void)
  *
  ****************************************************************************/
 
+#if TRANSIT_SPI_FLASH_JOURNAL
+static ulong flash_jrnl_sect_addr (uchar sect_idx)
+{
+    return jrnl_sa + sect_idx * cur_flash_info.ss;
+}
+
+/* ************************************************************************ */
+static void flash_jrnl_find_active (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Find the journal sector with the newest sequence number
+ * Remarks     : jrnl_active is FLASH_JRNL_SECT_NONE if no sector is valid.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar  sect_idx, hdr[FLASH_JRNL_HDR_LEN], i;
+    ushort seq;
+
+    jrnl_active = FLASH_JRNL_SECT_NONE;
+    for (sect_idx = 0; sect_idx < jrnl_sect_cnt; sect_idx++) {
+        flash_read_start(flash_jrnl_sect_addr(sect_idx));
+        for (i = 0; i < FLASH_JRNL_HDR_LEN; i++) {
+            hdr[i] = input_byte();
+        }
+        flash_read_stop();
+
+        if (hdr[0] != FLASH_JRNL_MAGIC_0 || hdr[1] != FLASH_JRNL_MAGIC_1) {
+            continue;
+        }
+        seq = ((ushort) hdr[2] << 8) | hdr[3];
+        if (jrnl_active == FLASH_JRNL_SECT_NONE || (short) (seq - jrnl_seq) > 0) {
+            jrnl_active = sect_idx;
+            jrnl_seq    = seq;
+        }
+    }
+}
+
+/* ************************************************************************ */
+static void flash_jrnl_replay (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Apply the records of the active journal sector to
+ *               config_shadow in one sequential read
+ * Remarks     : Records with CRC errors or unknown keys are skipped. A
+ *               record with an invalid length ends the replay and forces a
+ *               compaction on the next save.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar  hdr[FLASH_JRNL_REC_HDR_LEN], i, k;
+    ushort off, crc;
+
+    off = FLASH_JRNL_HDR_LEN;
+    flash_read_start(flash_jrnl_sect_addr(jrnl_active) + off);
+    while (off + FLASH_JRNL_REC_HDR_LEN <= cur_flash_info.ss) {
+        for (i = 0; i < FLASH_JRNL_REC_HDR_LEN; i++) {
+            hdr[i] = input_byte();
+        }
+        if (hdr[0] == FLASH_JRNL_KEY_FREE) {
+            break; // End of journal
+        }
+        if (hdr[1] > FLASH_JRNL_MAX_DATA_LEN ||
+            off + FLASH_JRNL_REC_HDR_LEN + hdr[1] > cur_flash_info.ss) {
+            off = cur_flash_info.ss;
+            break;
+        }
+
+        crc = crc16_update(crc16_update(CRC16_INIT, hdr[0]), hdr[1]);
+        for (i = 0; i < hdr[1]; i++) {
+            jrnl_buf[i] = input_byte();
+            crc = crc16_update(crc, jrnl_buf[i]);
+        }
+        off += FLASH_JRNL_REC_HDR_LEN + hdr[1];
+
+        if (crc != (((ushort) hdr[2] << 8) | hdr[3])) {
+#if FLASH_DEBUG
+            print_str("journal CRC error, key = ");
+            print_hex_b(hdr[0]);
+            print_cr_lf();
+#endif
+            continue;
+        }
+        for (k = 0; k < FLASH_JRNL_KEY_CNT; k++) {
+            if (flash_jrnl_keys[k].key == hdr[0] && flash_jrnl_keys[k].len == hdr[1]) {
+                memcpy((uchar *) &config_shadow + flash_jrnl_keys[k].offset, jrnl_buf, hdr[1]);
+                break;
+            }
+        }
+    }
+    flash_read_stop();
+    jrnl_wr_off = off;
+}
+
+static ushort flash_jrnl_rec_len (uchar k)
+{
+    return FLASH_JRNL_REC_HDR_LEN + flash_jrnl_keys[k].len;
+}
+
+/* Program the batched records at the write offset of the sector at sect_addr */
+static uchar flash_jrnl_flush (ulong sect_addr)
+{
+    if (jrnl_buf_len == 0) {
+        return 0;
+    }
+    if (flash_page_program(sect_addr + jrnl_wr_off, jrnl_buf, jrnl_buf_len)) {
+        return 1;
+    }
+    jrnl_wr_off += jrnl_buf_len;
+    jrnl_buf_len = 0;
+    return 0;
+}
+
+/* Add the record of key index k to the batch */
+static uchar flash_jrnl_emit (ulong sect_addr, uchar k)
+{
+    uchar xdata *rec_p;
+    uchar        i, *data_p;
+    ushort       crc;
+
+    if (jrnl_buf_len + flash_jrnl_rec_len(k) > FLASH_JRNL_BUF_SIZE &&
+        flash_jrnl_flush(sect_addr)) {
+        return 1;
+    }
+
+    rec_p  = &jrnl_buf[jrnl_buf_len];
+    data_p = (uchar *) &config_shadow + flash_jrnl_keys[k].offset;
+    rec_p[0] = flash_jrnl_keys[k].key;
+    rec_p[1] = flash_jrnl_keys[k].len;
+    crc = crc16_update(crc16_update(CRC16_INIT, rec_p[0]), rec_p[1]);
+    for (i = 0; i < flash_jrnl_keys[k].len; i++) {
+        rec_p[FLASH_JRNL_REC_HDR_LEN + i] = data_p[i];
+        crc = crc16_update(crc, data_p[i]);
+    }
+    rec_p[2] = crc >> 8;
+    rec_p[3] = crc & 0xFF;
+    jrnl_buf_len += flash_jrnl_rec_len(k);
+
+    return 0;
+}
+
+/* ************************************************************************ */
+static uchar flash_jrnl_compact (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write all keys into the next journal sector and make it the
+ *               active sector
+ * Remarks     : The sector header is programmed last.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar xdata hdr[FLASH_JRNL_HDR_LEN];
+    uchar       next, k;
+    ulong       sect_addr;
+
+    next = (jrnl_active == FLASH_JRNL_SECT_NONE) ? 0 : (jrnl_active + 1) % jrnl_sect_cnt;
+    sect_addr = flash_jrnl_sect_addr(next);
+    if (flash_erase_sector(sect_addr)) {
+        return 1;
+    }
+
+    jrnl_wr_off  = FLASH_JRNL_HDR_LEN;
+    jrnl_buf_len = 0;
+    for (k = 0; k < FLASH_JRNL_KEY_CNT; k++) {
+        if (flash_jrnl_emit(sect_addr, k)) {
+            return 1;
+        }
+    }
+    if (flash_jrnl_flush(sect_addr)) {
+        return 1;
+    }
+
+    jrnl_seq++;
+    hdr[0] = FLASH_JRNL_MAGIC_0;
+    hdr[1] = FLASH_JRNL_MAGIC_1;
+    hdr[2] = jrnl_seq >> 8;
+    hdr[3] = jrnl_seq & 0xFF;
+    if (flash_page_program(sect_addr, hdr, FLASH_JRNL_HDR_LEN)) {
+        return 1;
+    }
+    jrnl_active = next;
+
+    return 0;
+}
+
+/* ************************************************************************ */
+static uchar flash_jrnl_save (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Append a record for each changed key to the journal
+ * Remarks     : Normally a single page program. Compacts into the next
+ *               sector when the active sector cannot hold the records.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar  k, rc;
+    ushort len = 0;
+
+    for (k = 0; k < FLASH_JRNL_KEY_CNT; k++) {
+        if (memcmp((uchar *) &config_shadow + flash_jrnl_keys[k].offset,
+                   (uchar *) &config_persisted + flash_jrnl_keys[k].offset,
+                   flash_jrnl_keys[k].len)) {
+            len += flash_jrnl_rec_len(k);
+        }
+    }
+    if (len == 0) {
+        return 0; // Nothing changed
+    }
+
+    if (jrnl_active == FLASH_JRNL_SECT_NONE || jrnl_wr_off + len > cur_flash_info.ss) {
+        rc = flash_jrnl_compact();
+    } else {
+        jrnl_buf_len = 0;
+        for (k = 0; k < FLASH_JRNL_KEY_CNT; k++) {
+            if (memcmp((uchar *) &config_shadow + flash_jrnl_keys[k].offset,
+                       (uchar *) &config_persisted + flash_jrnl_keys[k].offset,
+                       flash_jrnl_keys[k].len) &&
+                flash_jrnl_emit(flash_jrnl_sect_addr(jrnl_active), k)) {
+                return 1;
+            }
+        }
+        rc = flash_jrnl_flush(flash_jrnl_sect_addr(jrnl_active));
+    }
+
+    if (rc == 0) {
+        memcpy(&config_persisted, &config_shadow, sizeof(config_persisted));
+    }
+    return rc;
+}
+
+/* ************************************************************************ */
+static void flash_jrnl_load (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Locate the journal in the CFG area and replay it
+ * Remarks     : The journal is not used when the CFG area holds less than
+ *               FLASH_JRNL_MIN_SECTORS sectors besides the legacy block.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong sect_cnt, jrnl_end = cur_flash_info.sa_rt0;
+
+#if TRANSIT_TASK_WDT
+    /* The last sector holds the post-mortem records */
+    if (FLASH_PM_OWN_SECTOR()) {
+        jrnl_end -= cur_flash_info.ss;
+    }
+#endif // TRANSIT_TASK_WDT
+    jrnl_sa  = cur_flash_info.sa_cfg + cur_flash_info.ss;
+    sect_cnt = jrnl_end > jrnl_sa ? (jrnl_end - jrnl_sa) / cur_flash_info.ss : 0;
+    if (sect_cnt > FLASH_JRNL_MAX_SECTORS) {
+        sect_cnt = FLASH_JRNL_MAX_SECTORS;
+    }
+    jrnl_sect_cnt = sect_cnt < FLASH_JRNL_MIN_SECTORS ? 0 : sect_cnt;
+    if (jrnl_sect_cnt == 0) {
+        return;
+    }
+
+    flash_jrnl_find_active();
+    if (jrnl_active != FLASH_JRNL_SECT_NONE) {
+        flash_jrnl_replay();
+        memcpy(&config_persisted, &config_shadow, sizeof(config_persisted));
+    } else {
+        /* Empty journal, everything is written by the first save */
+        memset(&config_persisted, 0xFF, sizeof(config_persisted));
+    }
+}
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+
+#if TRANSIT_TASK_WDT
+static ulong flash_pm_area (void)
+{
+    if (FLASH_PM_OWN_SECTOR()) {
+        return cur_flash_info.sa_rt0 - cur_flash_info.ss;
+    }
+    return cur_flash_info.sa_cfg + cur_flash_info.ss - FLASH_PAGE_SIZE;
+}
+
+/* ************************************************************************ */
+static void flash_pm_load (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Count the post-mortem records and find the free slot
+ * Remarks     : A slot is free when its first byte is erased.
+ * Restrictions:
+ * See also    : flash_pm_write
+ * Example     :
+ ****************************************************************************/
+{
+    uchar i, j, magic;
+
+    pm_cnt  = 0;
+    pm_addr = 0;
+    flash_read_start(flash_pm_area());
+    for (i = 0; i < FLASH_PM_REC_CNT; i++) {
+        magic = input_byte();
+        for (j = 1; j < sizeof(flash_pm_rec_t); j++) {
+            (void) input_byte();
+        }
+        if (magic == 0xFF) {
+            pm_addr = flash_pm_area() + i * sizeof(flash_pm_rec_t);
+            break;
+        }
+        if (i == 0 && magic != FLASH_PM_MAGIC && FLASH_PM_OWN_SECTOR()) {
+            break;
+        }
+        pm_cnt++;
+    }
+    flash_read_stop();
+
+    if (i == 0 && pm_addr == 0) {
+        /* Not a post-mortem sector */
+        if (flash_erase_sector(flash_pm_area()) == 0) {
+            pm_addr = flash_pm_area();
+        }
+    }
+}
+
+/* ************************************************************************ */
+uchar flash_pm_clear (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Erase the post-mortem records
+ * Remarks     : return: 0 - success, 1 - failure
+ *               With a single CFG sector, the legacy block is written again.
+ * Restrictions:
+ * See also    : flash_pm_write
+ * Example     :
+ ****************************************************************************/
+{
+    ulong addr = flash_pm_area();
+    uchar rc;
+
+    /* Keep the timer interrupt away from the slots while they are erased */
+    EA = 0;
+    pm_addr = 0;
+    EA = 1;
+
+    if (FLASH_PM_OWN_SECTOR()) {
+        rc = flash_erase_sector(addr);
+    } else {
+        config_shadow.signature = FLASH_CFG_SIGNATURE;
+        rc = flash_erase_sector(cur_flash_info.sa_cfg);
+        if (rc == 0) {
+            rc = flash_page_program(cur_flash_info.sa_cfg, (uchar *) &config_shadow, sizeof(config_shadow));
+        }
+    }
+
+    if (rc == 0) {
+        EA = 0;
+        pm_cnt  = 0;
+        pm_addr = addr;
+        EA = 1;
+    }
+
+    return rc;
+}
+
+/* ************************************************************************ */
+uchar flash_pm_get (uchar idx, flash_pm_rec_t *rec)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Read post-mortem record idx, 0 is the oldest
+ * Remarks     : return: 0 - success, 1 - no such record, 2 - damaged record
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar i, sum = 0;
+
+    if (idx >= pm_cnt) {
+        return 1;
+    }
+    flash_read_start(flash_pm_area() + idx * sizeof(flash_pm_rec_t));
+    for (i = 0; i < sizeof(flash_pm_rec_t); i++) {
+        ((uchar *) rec)[i] = input_byte();
+        sum += ((uchar *) rec)[i];
+    }
+    flash_read_stop();
+
+    return (rec->magic != FLASH_PM_MAGIC || sum != 0) ? 2 : 0;
+}
+
+/*
+ * The functions below run in the timer interrupt and must not share any
+ * function with main, hence the SPI access of their own.
+ */
+#pragma NOAREGS
+static void pm_simaster_write (ulong value) small
+{
+    pm_simaster = value;
+    H2_WRITE(VTSS_ICPU_CFG_SPI_MST_SW_MODE, pm_simaster);
+}
+
+static void pm_set_cs (char voltage) small
+{
+    if (voltage == FLASH_VOLTAGE_LOW) {
+        pm_simaster_write(pm_simaster | SI_CS_MSK);
+    } else {
+        pm_simaster_write(pm_simaster & (~SI_CS_MSK));
+    }
+}
+
+static void pm_output_byte (uchar byte_val) small
+{
+    uchar i;
+
+    for (i = 0; i < 8; i++) {
+        if (byte_val & 0x80) {
+            pm_simaster_write(pm_simaster | SI_DO_MSK);
+        } else {
+            pm_simaster_write(pm_simaster & (~SI_DO_MSK));
+        }
+        byte_val <<= 1;
+        pm_simaster_write(pm_simaster | SI_CLK_MSK);
+        pm_simaster_write(pm_simaster & (~SI_CLK_MSK));
+    }
+}
+
+static uchar pm_input_byte (void) small
+{
+    uchar i, byte_val = 0;
+    ulong value;
+
+    for (i = 0; i < 8; i++) {
+        H2_READ(VTSS_ICPU_CFG_SPI_MST_SW_MODE, value);
+        byte_val = (byte_val << 1) | ((value & SI_DI_MSK) != 0);
+        pm_simaster_write(pm_simaster | SI_CLK_MSK);
+        pm_simaster_write(pm_simaster & (~SI_CLK_MSK));
+    }
+
+    return byte_val;
+}
+
+/* Wait for a program/erase in progress, return 1 when it does not end */
+static uchar pm_wait_wip (void) small
+{
+    ushort poll;
+    uchar  status;
+
+    for (poll = 0; poll < FLASH_PM_WIP_MAX_POLL; poll++) {
+        pm_set_cs(FLASH_VOLTAGE_LOW);
+        pm_output_byte(FLASH_RDSR);
+        status = pm_input_byte();
+        pm_set_cs(FLASH_VOLTAGE_HIGH);
+        if (!(status & FLASH_STATUS_WIP)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* ************************************************************************ */
+void flash_pm_write (uchar task_id, uchar ticks, ulong reg_addr, ulong up_time) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Program a post-mortem record into the free slot
+ * Remarks     : A flash access of main is cut off by the software mode
+ *               below (CS high). A program or erase which is still in
+ *               progress is waited for first.
+ * Restrictions: Only called from the timer interrupt, the system must be
+ *               reset afterwards.
+ * See also    : wdt_tick
+ * Example     :
+ ****************************************************************************/
+{
+    flash_pm_rec_t rec;
+    uchar          i, sum = 0;
+
+    if (pm_addr == 0) {
+        return;
+    }
+
+    rec.magic    = FLASH_PM_MAGIC;
+    rec.task_id  = task_id;
+    rec.ticks    = ticks;
+    rec.csum     = 0;
+    rec.reg_addr = reg_addr;
+    rec.up_time  = up_time;
+    rec.rsvd     = 0xFFFFFFFF;
+    for (i = 0; i < sizeof(rec); i++) {
+        sum += ((uchar *) &rec)[i];
+    }
+    rec.csum = 0 - sum;
+
+    pm_simaster_write(0x2A22); // Software mode as in spi_ctrl_enter()
+    if (pm_wait_wip()) {
+        return;
+    }
+
+    pm_set_cs(FLASH_VOLTAGE_LOW);
+    pm_output_byte(FLASH_WREN);
+    pm_set_cs(FLASH_VOLTAGE_HIGH);
+
+    pm_set_cs(FLASH_VOLTAGE_LOW);
+    pm_output_byte(FLASH_PP);
+    pm_output_byte(pm_addr >> 16 & 0xFF);
+    pm_output_byte(pm_addr >> 8 & 0xFF);
+    pm_output_byte(pm_addr & 0xFF);
+    for (i = 0; i < sizeof(rec); i++) {
+        pm_output_byte(((uchar *) &rec)[i]);
+    }
+    pm_set_cs(FLASH_VOLTAGE_HIGH);
+    (void) pm_wait_wip();
+}
+#pragma AREGS
+#endif // TRANSIT_TASK_WDT
+
 #if TRANSIT_SPI_FLASH
 /* ************************************************************************ */
 uchar flash_program_config (void)
@@ -773,6 +2077,11 @@ uchar flash_program_config (void)
 
     config_shadow.signature = FLASH_CFG_SIGNATURE;
 #if TRANSIT_UNMANAGED_SWUP
+#if TRANSIT_SPI_FLASH_JOURNAL
+    if (jrnl_sect_cnt) {
+        return flash_jrnl_save();
+    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
     if (flash_erase_sector(cur_flash_info.sa_cfg)) {
         return 1;
     }
@@ -815,9 +2124,63 @@ void flash_load_config (void)
         /* Set all configuration to all 0 and use the default MAC address
            when the signature is not valid */
         mac_copy(&config_shadow.sys_mac, spiflash_mac_addr);
+#if TRANSIT_SPI_FLASH_MANIFEST
+        memset(config_shadow.rt_manifest, 0, sizeof(config_shadow.rt_manifest));
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+#if TRANSIT_LAG
+        config_shadow.aggr_mode = FLASH_AGGR_MODE_NONE;
+#endif // TRANSIT_LAG
+#if TRANSIT_VLAN
+        memset(&config_shadow.vlan_conf, 0xFF, sizeof(config_shadow.vlan_conf));
+#endif // TRANSIT_VLAN
+#if TRANSIT_STORM_CONTROL
+        memset(&config_shadow.storm_conf, 0xFF, sizeof(config_shadow.storm_conf));
+#endif // TRANSIT_STORM_CONTROL
+#if TRANSIT_MIRROR
+        memset(&config_shadow.mirror_conf, 0xFF, sizeof(config_shadow.mirror_conf));
+#endif // TRANSIT_MIRROR
+#if TRANSIT_QOS
+        memset(&config_shadow.qos_conf, 0xFF, sizeof(config_shadow.qos_conf));
+#endif // TRANSIT_QOS
+#if TRANSIT_BUF_PROFILE
+        config_shadow.buf_profile = FLASH_BUF_PROFILE_NONE;
+#endif // TRANSIT_BUF_PROFILE
     }
+
+#if TRANSIT_SPI_FLASH_JOURNAL
+    /* Journal records override the legacy configuration block */
+    flash_jrnl_load();
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+
+#if TRANSIT_TASK_WDT
+    flash_pm_load();
+#endif // TRANSIT_TASK_WDT
+
+#if TRANSIT_SPI_FLASH_MANIFEST
+    /* The boot loader does not check the image, verify the running image
+       first in the background */
+    verify_run_slot = verify_slot = (config_shadow.rt_idx == 1);
+#endif // TRANSIT_SPI_FLASH_MANIFEST
 #else
     mac_copy(&config_shadow.sys_mac, spiflash_mac_addr);
+#if TRANSIT_LAG
+    config_shadow.aggr_mode = FLASH_AGGR_MODE_NONE;
+#endif // TRANSIT_LAG
+#if TRANSIT_VLAN
+    memset(&config_shadow.vlan_conf, 0xFF, sizeof(config_shadow.vlan_conf));
+#endif // TRANSIT_VLAN
+#if TRANSIT_STORM_CONTROL
+    memset(&config_shadow.storm_conf, 0xFF, sizeof(config_shadow.storm_conf));
+#endif // TRANSIT_STORM_CONTROL
+#if TRANSIT_MIRROR
+    memset(&config_shadow.mirror_conf, 0xFF, sizeof(config_shadow.mirror_conf));
+#endif // TRANSIT_MIRROR
+#if TRANSIT_QOS
+    memset(&config_shadow.qos_conf, 0xFF, sizeof(config_shadow.qos_conf));
+#endif // TRANSIT_QOS
+#if TRANSIT_BUF_PROFILE
+    config_shadow.buf_profile = FLASH_BUF_PROFILE_NONE;
+#endif // TRANSIT_BUF_PROFILE
 #endif
 }
 
@@ -826,6 +2189,84 @@ void flash_read_mac_addr (uchar xdata *mac_addr)
     mac_copy(mac_addr, &config_shadow.sys_mac);
 }
 
+#if TRANSIT_LAG
+uchar flash_read_aggr_mode (void)
+{
+    return config_shadow.aggr_mode;
+}
+
+/* Only update RAM copy; call flash_program_config to write into flash */
+void flash_write_aggr_mode (uchar mode)
+{
+    config_shadow.aggr_mode = mode;
+}
+#endif // TRANSIT_LAG
+
+#if TRANSIT_VLAN
+void flash_read_vlan_conf (h2_vlan_conf_t xdata *conf)
+{
+    memcpy(conf, &config_shadow.vlan_conf, sizeof(h2_vlan_conf_t));
+}
+
+/* Only update RAM copy; call flash_program_config to write into flash */
+void flash_write_vlan_conf (const h2_vlan_conf_t xdata *conf)
+{
+    memcpy(&config_shadow.vlan_conf, conf, sizeof(h2_vlan_conf_t));
+}
+#endif // TRANSIT_VLAN
+
+#if TRANSIT_STORM_CONTROL
+void flash_read_storm_conf (h2_storm_conf_t xdata *conf)
+{
+    memcpy(conf, &config_shadow.storm_conf, sizeof(h2_storm_conf_t));
+}
+
+/* Only update RAM copy; call flash_program_config to write into flash */
+void flash_write_storm_conf (const h2_storm_conf_t xdata *conf)
+{
+    memcpy(&config_shadow.storm_conf, conf, sizeof(h2_storm_conf_t));
+}
+#endif // TRANSIT_STORM_CONTROL
+
+#if TRANSIT_MIRROR
+void flash_read_mirror_conf (h2_mirror_conf_t xdata *conf)
+{
+    memcpy(conf, &config_shadow.mirror_conf, sizeof(h2_mirror_conf_t));
+}
+
+/* Only update RAM copy; call flash_program_config to write into flash */
+void flash_write_mirror_conf (const h2_mirror_conf_t xdata *conf)
+{
+    memcpy(&config_shadow.mirror_conf, conf, sizeof(h2_mirror_conf_t));
+}
+#endif // TRANSIT_MIRROR
+
+#if TRANSIT_QOS
+void flash_read_qos_conf (h2_qos_conf_t xdata *conf)
+{
+    memcpy(conf, &config_shadow.qos_conf, sizeof(h2_qos_conf_t));
+}
+
+/* Only update RAM copy; call flash_program_config to write into flash */
+void flash_write_qos_conf (const h2_qos_conf_t xdata *conf)
+{
+    memcpy(&config_shadow.qos_conf, conf, sizeof(h2_qos_conf_t));
+}
+#endif // TRANSIT_QOS
+
+#if TRANSIT_BUF_PROFILE
+uchar flash_read_buf_profile (void)
+{
+    return config_shadow.buf_profile;
+}
+
+/* Only update RAM copy; call flash_program_config to write into flash */
+void flash_write_buf_profile (uchar profile)
+{
+    config_shadow.buf_profile = profile;
+}
+#endif // TRANSIT_BUF_PROFILE
+
 #if TRANSIT_UNMANAGED_SYS_MAC_CONF
 /* Only update RAM copy; call flash_pp_configuration to write into flash */
 uchar flash_write_mac_addr (uchar xdata *mac_addr)
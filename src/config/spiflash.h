@@ -16,6 +16,22 @@
 #include "fan_api.h"
 #endif
 
+#if TRANSIT_VLAN
+#include "h2vlan.h"
+#endif
+
+#if TRANSIT_STORM_CONTROL
+#include "h2storm.h"
+#endif
+
+#if TRANSIT_MIRROR
+#include "h2mirror.h"
+#endif
+
+#if TRANSIT_QOS
+#include "h2qos.h"
+#endif
+
 #if TRANSIT_EEE
 #include "eee_api.h"
 #endif
@@ -52,11 +68,82 @@ uchar flash_erase_code (uchar img_type);
  *  return: 0 - success, 1 - fail
  */
 uchar flash_download_image (uchar img_type, ulong len, uchar csum);
+
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+/*
+ * Block based image upload, CLI command: UPLOAD <img_type> <len> <csum> [<baud>]
+ *
+ * 1. When <baud> is given and can be generated, the switch answers
+ *    "BAUD <actual rate>" at the current rate and then changes its rate.
+ * 2. The switch requests a block with <NAK> <blk_no MSB> <blk_no LSB>,
+ *    starting with block 0.
+ * 3. The host sends <SOH> <blk_no MSB> <blk_no LSB> <FLASH_UPLOAD_BLOCK_SIZE
+ *    bytes> <crc MSB> <crc LSB>. The CRC-16/CCITT covers blk_no and data.
+ *    The last block is padded with 0xFF.
+ * 4. The switch answers <ACK> <blk_no> once the block is verified and it
+ *    has room for the next block, so the host sends block n+1 while block n
+ *    is programmed. A damaged or missing block is requested again with
+ *    <NAK> <blk_no>; only that block is resent.
+ * 5. <CAN> from either side aborts. After the last ACK the switch goes back
+ *    to the default baud rate and verifies <csum> as for PROGRAM.
+ *
+ *  return: 0 - success, 1 - fail
+ */
+#define FLASH_UPLOAD_SOH            0x01
+#define FLASH_UPLOAD_ACK            0x06
+#define FLASH_UPLOAD_NAK            0x15
+#define FLASH_UPLOAD_CAN            0x18
+#define FLASH_UPLOAD_BLOCK_SIZE     512
+uchar flash_upload_image (uchar img_type, ulong len, uchar csum, ulong baud);
+#endif /* TRANSIT_UNMANAGED_SWUP_STREAM */
+
+#if TRANSIT_SPI_FLASH_MANIFEST
+/*
+ * Background verify of the runtime images against their manifest,
+ * call every 100ms
+ */
+void flash_verify_tsk (void);
+
+/* Show the manifest and verify status of the runtime images */
+void flash_verify_print (void);
+#endif /* TRANSIT_SPI_FLASH_MANIFEST */
+
+#if TRANSIT_TASK_WDT
+/*
+ * Post-mortem record of the task watchdog. The byte sum of a record is 0.
+ */
+typedef struct {
+    uchar   magic;      // Erased (0xFF) for a free slot
+    uchar   task_id;    // task_id_t/sub_task_id_t which missed its deadline
+    uchar   ticks;      // 100ms ticks the task had been running
+    uchar   csum;
+    ulong   reg_addr;   // Last switch register address accessed
+    ulong   up_time;    // Seconds since boot
+    ulong   rsvd;
+} flash_pm_rec_t;
+
+#define FLASH_PM_REC_CNT    16  // Record slots in the flash
+
+/*
+ * Get post-mortem record idx, 0 is the oldest
+ *  return: 0 - success, 1 - no such record, 2 - damaged record
+ */
+uchar flash_pm_get (uchar idx, flash_pm_rec_t *rec);
+
+/* Erase the post-mortem records, return 0 on success */
+uchar flash_pm_clear (void);
+
+/* Write a post-mortem record, only called by the timer interrupt */
+void flash_pm_write (uchar task_id, uchar ticks, ulong reg_addr, ulong up_time) small;
+#endif /* TRANSIT_TASK_WDT */
 #endif /* TRANSIT_UNMANAGED_SWUP */
 
 #ifndef UNMANAGED_REDUCED_DEBUG_IF
 uchar flash_checksum_ok (ulong len);
 void flash_read_bytes (ulong start_addr, ulong len);
+#if TRANSIT_CLI_RESUMABLE
+void flash_print_row (ulong start_addr, uchar len);
+#endif /* TRANSIT_CLI_RESUMABLE */
 #endif /* UNMANAGED_REDUCED_DEBUG_IF */
 
 #endif /* NO_DEBUG_IF */
@@ -67,6 +154,32 @@ void flash_load_config (void);
 /* Functions for updating/reading config at RAM shadow */
 void flash_read_mac_addr (uchar xdata *mac_addr);
 uchar flash_write_mac_addr (uchar xdata *mac_addr);
+#if TRANSIT_LAG
+#define FLASH_AGGR_MODE_NONE    0xFF    // Aggregation hash mode not configured
+uchar flash_read_aggr_mode (void);
+void flash_write_aggr_mode (uchar mode);
+#endif // TRANSIT_LAG
+#if TRANSIT_VLAN
+void flash_read_vlan_conf (h2_vlan_conf_t xdata *conf);
+void flash_write_vlan_conf (const h2_vlan_conf_t xdata *conf);
+#endif // TRANSIT_VLAN
+#if TRANSIT_STORM_CONTROL
+void flash_read_storm_conf (h2_storm_conf_t xdata *conf);
+void flash_write_storm_conf (const h2_storm_conf_t xdata *conf);
+#endif // TRANSIT_STORM_CONTROL
+#if TRANSIT_MIRROR
+void flash_read_mirror_conf (h2_mirror_conf_t xdata *conf);
+void flash_write_mirror_conf (const h2_mirror_conf_t xdata *conf);
+#endif // TRANSIT_MIRROR
+#if TRANSIT_QOS
+void flash_read_qos_conf (h2_qos_conf_t xdata *conf);
+void flash_write_qos_conf (const h2_qos_conf_t xdata *conf);
+#endif // TRANSIT_QOS
+#if TRANSIT_BUF_PROFILE
+#define FLASH_BUF_PROFILE_NONE  0xFF    // Buffer profile not configured
+uchar flash_read_buf_profile (void);
+void flash_write_buf_profile (uchar profile);
+#endif // TRANSIT_BUF_PROFILE
 
 /*
  * Flash initialization
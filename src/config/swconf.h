@@ -16,6 +16,8 @@
             #include "proj_opt_ferret_release.h"
         #elif (PROJ_OPT == 99999)
             #include "proj_opt_ferret_release_lacp.h"
+        #elif (PROJ_OPT == 99997)
+            #include "proj_opt_ferret_release_l2.h"
         #else
             #include "proj_opt_ferret_develop.h"
         #endif
@@ -84,6 +84,40 @@
 #define UNMANAGED_ENHANCEMENT_DEBUG             1
 #endif
 
+/****************************************************************************
+ * Console UART
+ ****************************************************************************/
+/* Queue console output in a ring buffer which is sent by the UART transmit
+ * interrupt, instead of waiting for the transmitter on every byte.
+ */
+#ifndef TRANSIT_UART_TX_RING
+#define TRANSIT_UART_TX_RING                    0
+#endif
+
+/* What uart_put_byte() does when the transmit ring is full:
+ * 0 = Wait for room, no output is lost
+ * 1 = Drop the byte
+ * 2 = Drop the byte and count it (shown by command 'V')
+ */
+#ifndef UART_TX_OVERFLOW_MODE
+#define UART_TX_OVERFLOW_MODE                   0
+#endif
+
+/* Long CLI displays (MAC table, port statistics, flash dump) output a few
+ * lines per main loop round instead of running to completion, so the
+ * periodic tasks keep running. Ctrl-C aborts the display.
+ */
+#ifndef TRANSIT_CLI_RESUMABLE
+#define TRANSIT_CLI_RESUMABLE                   0
+#endif
+
+/* Binary telemetry protocol for automated polling, entered with the CLI
+ * command BINARY (see binproto.h)
+ */
+#ifndef TRANSIT_BIN_PROTO
+#define TRANSIT_BIN_PROTO                       0
+#endif
+
 /****************************************************************************
  * MAC configuration
  ****************************************************************************/
@@ -120,6 +154,77 @@
 #endif
 
 
+/****************************************************************************
+ * VLAN - Port-based and IEEE 802.1Q VLANs from the flash configuration
+ ****************************************************************************/
+#ifndef TRANSIT_VLAN
+#define TRANSIT_VLAN                            0
+#endif
+
+
+/****************************************************************************
+ * IGMP/MLD snooping - IP multicast only to the member and router ports
+ ****************************************************************************/
+#ifndef TRANSIT_IGMP_SNOOPING
+#define TRANSIT_IGMP_SNOOPING                   0
+#endif
+
+
+/****************************************************************************
+ * Storm control - Broadcast/multicast/unknown unicast storm policers and
+ * per-port ingress policers from the flash configuration
+ ****************************************************************************/
+#ifndef TRANSIT_STORM_CONTROL
+#define TRANSIT_STORM_CONTROL                   0
+#endif
+
+
+/****************************************************************************
+ * CPU protection - One extraction queue per protocol, policed by the QoS
+ * policers of the CPU port and serviced in priority order with a frame
+ * budget per queue
+ ****************************************************************************/
+#ifndef TRANSIT_CPU_PROTECT
+#define TRANSIT_CPU_PROTECT                     0
+#endif
+
+
+/****************************************************************************
+ * sFlow - Hardware sampling of the port traffic to a dedicated extraction
+ * queue, the samples are read out with the binary protocol
+ ****************************************************************************/
+#ifndef TRANSIT_SFLOW
+#define TRANSIT_SFLOW                           0
+#endif
+
+
+/****************************************************************************
+ * Port mirroring - Ingress/egress source ports, CPU and VLAN sources and
+ * one destination port from the flash configuration
+ ****************************************************************************/
+#ifndef TRANSIT_MIRROR
+#define TRANSIT_MIRROR                          0
+#endif
+
+
+/****************************************************************************
+ * QoS - PCP/DSCP classification to the egress queues and strict/DWRR
+ * egress scheduling from the flash configuration
+ ****************************************************************************/
+#ifndef TRANSIT_QOS
+#define TRANSIT_QOS                             0
+#endif
+
+
+/****************************************************************************
+ * Buffer profiles - queue system watermarks from a named profile in the
+ * flash configuration, applied at boot
+ ****************************************************************************/
+#ifndef TRANSIT_BUF_PROFILE
+#define TRANSIT_BUF_PROFILE                     0
+#endif
+
+
 /****************************************************************************
  * Enable/Disable Loop Detection / Protection
  ****************************************************************************/
@@ -159,6 +264,13 @@
 #define TRANSIT_MAILBOX_COMM                    0
 #endif
 
+/* Command and response ring in the onchip 8051 memory, for batches of
+ * commands and bulk responses (see h2mailc.h)
+ */
+#ifndef TRANSIT_MAILBOX_RING
+#define TRANSIT_MAILBOX_RING                    0
+#endif
+
 
 /****************************************************************************
  * LLDP - IEEE802.1AB
@@ -167,6 +279,25 @@
 #define TRANSIT_LLDP                            0
 #endif
 
+/* Capacity of the LLDP neighbour table (at most 254), one neighbour per
+ * port by default. Raise it for edge ports behind unmanaged hubs.
+ */
+#ifndef LLDP_REMOTE_ENTRIES
+#define LLDP_REMOTE_ENTRIES                     (NO_OF_BOARD_PORTS)
+#endif
+
+/* Bytes of the string pool shared by all LLDP neighbours for chassis ID,
+ * port ID, system name, port description and management address. Port
+ * description and system name are cut at LLDP_REMOTE_OPT_STR_MAX bytes.
+ */
+#ifndef LLDP_REMOTE_POOL_SIZE
+#define LLDP_REMOTE_POOL_SIZE                   (LLDP_REMOTE_ENTRIES * 24)
+#endif
+
+#ifndef LLDP_REMOTE_OPT_STR_MAX
+#define LLDP_REMOTE_OPT_STR_MAX                 32
+#endif
+
 /****************************************************************************
  * EEE
  ****************************************************************************/
@@ -206,6 +337,13 @@
 #define TRANSIT_UNMANAGED_SWUP                  0   /* Not implemented yet */
 #endif
 
+/* Block based image upload (CLI command UPLOAD) with CRC-protected blocks,
+ * selective retransmit and an optional higher baud rate during the upload.
+ */
+#ifndef TRANSIT_UNMANAGED_SWUP_STREAM
+#define TRANSIT_UNMANAGED_SWUP_STREAM           0
+#endif
+
 
 /****************************************************************************
  * SPI Flash
@@ -214,6 +352,24 @@
 #define TRANSIT_SPI_FLASH                       0   /* Not implemented yet */
 #endif
 
+/* Store the configuration as an append-only journal of keyed records across
+ * the sectors of the CFG area instead of rewriting the whole CFG sector.
+ * Only used when the CFG area holds at least two sectors besides the first
+ * one (i.e. 4K-sector flashes), otherwise it falls back to the legacy block.
+ */
+#ifndef TRANSIT_SPI_FLASH_JOURNAL
+#define TRANSIT_SPI_FLASH_JOURNAL               0
+#endif
+
+/* Keep a CRC-32 manifest (one CRC per 4K chunk) for each runtime image slot,
+ * written when an image is programmed. A background task verifies the
+ * running image after boot and then re-verifies the other slot periodically.
+ * Only used on flashes with two runtime image slots.
+ */
+#ifndef TRANSIT_SPI_FLASH_MANIFEST
+#define TRANSIT_SPI_FLASH_MANIFEST              0
+#endif
+
 
 /****************************************************************************
  * FTIME
@@ -229,6 +385,57 @@
 #endif
 
 
+/****************************************************************************
+ * Timer wheel
+ ****************************************************************************/
+/* Set TRANSIT_TIMER_WHEEL to 1 to run module timers (LED blink, loop
+ * detection aging, LLDP neighbour aging) as one-shot/periodic timers on a
+ * hierarchical wheel, dispatched from the main loop, instead of counters
+ * ticked every second.
+ */
+#ifndef TRANSIT_TIMER_WHEEL
+#define TRANSIT_TIMER_WHEEL                     0
+#endif
+
+/* Set TRANSIT_US_CLOCK to 1 for a usec clock (us_clock_get/elapsed_us) and
+ * the CLI command BENCH, which times the register, PHY, frame and flash
+ * access functions. The ICPU_CFG timer tick is changed to 1 us.
+ */
+#ifndef TRANSIT_US_CLOCK
+#define TRANSIT_US_CLOCK                        0
+#endif
+
+/* Set TRANSIT_TASK_WDT to 1 to run the chip watchdog with a run time deadline
+ * for each main loop task. The timer interrupt kicks the watchdog as long as
+ * the running task is within its deadline. Otherwise a post-mortem record
+ * (task, last register address, up time) is written into the SPI flash and
+ * the system is reset, see the CLI command WDT.
+ * Set TRANSIT_TASK_WDT of the A51 Set control of the target equal to this
+ * one, see swconf.inc.
+ */
+#ifndef TRANSIT_TASK_WDT
+#define TRANSIT_TASK_WDT                        0
+#endif
+
+/* Set TRANSIT_TASK_PROFILE to 1 for an instrumented build, which measures the
+ * calls and run time of each main loop task (TASK()) and of the main loop
+ * iterations, see the CLI command PROFILE.
+ */
+#ifndef TRANSIT_TASK_PROFILE
+#define TRANSIT_TASK_PROFILE                    0
+#endif
+
+/* Set TRANSIT_REG_TRACE to 1 to record the register (SBA) and PHY (MIIM)
+ * accesses of the main loop in a trace ring, with module masks and a start
+ * trigger, see the CLI command TRACE.
+ * Set TRANSIT_REG_TRACE of the A51 Set control of the target equal to this
+ * one, see swconf.inc.
+ */
+#ifndef TRANSIT_REG_TRACE
+#define TRANSIT_REG_TRACE                       0
+#endif
+
+
 /****************************************************************************
  * FAN S/W Control
  ****************************************************************************/
@@ -320,6 +527,35 @@
     #endif
 #endif // TRANSIT_LACP
 
+// IGMP/MLD snooping
+#if TRANSIT_IGMP_SNOOPING
+    #if TRANSIT_LLDP == 0
+    #error "Require TRANSIT_LLDP (frame extraction)"
+    #endif
+
+    #if TRANSIT_UNMANAGED_MAC_OPER_SET == 0 || TRANSIT_UNMANAGED_MAC_OPER_GET == 0
+    #error "Require TRANSIT_UNMANAGED_MAC_OPER_SET and TRANSIT_UNMANAGED_MAC_OPER_GET"
+    #endif
+#endif // TRANSIT_IGMP_SNOOPING
+
+// CPU protection
+#if TRANSIT_CPU_PROTECT
+    #if TRANSIT_LLDP == 0
+    #error "Require TRANSIT_LLDP (frame extraction)"
+    #endif
+#endif // TRANSIT_CPU_PROTECT
+
+// sFlow
+#if TRANSIT_SFLOW
+    #if TRANSIT_LLDP == 0
+    #error "Require TRANSIT_LLDP (frame extraction)"
+    #endif
+
+    #if TRANSIT_BIN_PROTO == 0
+    #error "Require TRANSIT_BIN_PROTO (sample export)"
+    #endif
+#endif // TRANSIT_SFLOW
+
 // EEE
 #if TRANSIT_EEE_LLDP
     #if TRANSIT_EEE == 0
@@ -341,3 +577,79 @@
     #error "Require TRANSIT_UNMANAGED_MAC_OPER_SET"
     #endif
 #endif // TRANSIT_MAILBOX_COMM
+
+#if TRANSIT_MAILBOX_RING
+    #if TRANSIT_MAILBOX_COMM == 0
+    #error "Require TRANSIT_MAILBOX_COMM"
+    #endif
+#endif // TRANSIT_MAILBOX_RING
+
+// Block based image upload
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+    #if TRANSIT_UNMANAGED_SWUP == 0
+    #error "Require TRANSIT_UNMANAGED_SWUP"
+    #endif
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM
+
+// SPI flash configuration journal
+#if TRANSIT_SPI_FLASH_JOURNAL
+    #if TRANSIT_SPI_FLASH == 0
+    #error "Require TRANSIT_SPI_FLASH"
+    #endif
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+
+// Console UART
+#if TRANSIT_UART_TX_RING
+    #if defined(NO_DEBUG_IF)
+    #error "Require the UART driver (NO_DEBUG_IF undefined)"
+    #endif
+#endif // TRANSIT_UART_TX_RING
+
+#if TRANSIT_BIN_PROTO
+    #if defined(NO_DEBUG_IF)
+    #error "Require the CLI (NO_DEBUG_IF undefined)"
+    #endif
+#endif // TRANSIT_BIN_PROTO
+
+// SPI flash image manifest
+#if TRANSIT_SPI_FLASH_MANIFEST
+    #if TRANSIT_SPI_FLASH == 0
+    #error "Require TRANSIT_SPI_FLASH"
+    #endif
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
+// Task watchdog
+#if TRANSIT_TASK_WDT
+    #if TRANSIT_SPI_FLASH == 0
+    #error "Require TRANSIT_SPI_FLASH"
+    #endif
+
+    #if defined(NO_DEBUG_IF)
+    #error "Require the CLI (NO_DEBUG_IF undefined)"
+    #endif
+#endif // TRANSIT_TASK_WDT
+
+// Task profiling
+#if TRANSIT_TASK_PROFILE
+    #if TRANSIT_US_CLOCK == 0
+    #error "Require TRANSIT_US_CLOCK"
+    #endif
+
+    #if defined(NO_DEBUG_IF)
+    #error "Require the CLI (NO_DEBUG_IF undefined)"
+    #endif
+#endif // TRANSIT_TASK_PROFILE
+
+// Register trace
+#if TRANSIT_REG_TRACE
+    #if defined(NO_DEBUG_IF)
+    #error "Require the CLI (NO_DEBUG_IF undefined)"
+    #endif
+#endif // TRANSIT_REG_TRACE
+
+// Buffer profiles
+#if TRANSIT_BUF_PROFILE
+    #if !defined(VTSS_ARCH_OCELOT)
+    #error "Require VTSS_ARCH_OCELOT"
+    #endif
+#endif // TRANSIT_BUF_PROFILE
@@ -0,0 +1,6 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+/* Host replacement of the Keil absolute memory access header, not used */
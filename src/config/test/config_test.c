@@ -0,0 +1,105 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+/*
+ * Host test of the configuration journal of spiflash.c in the release_lacp
+ * profile: the aggregation hash mode is saved, the firmware is booted again
+ * from the simulated flash of flash_sim.c and the mode read back. The saves
+ * wrap the ring of journal sectors several times. The steps are printed,
+ * config_expected.txt holds the output to compare with. From the
+ * repository root:
+ *
+ *   gcc -std=gnu89 -include src/config/test/host.h -fpack-struct -fshort-enums \
+ *       -DVTSS_ARCH_OCELOT -DFERRET_F11 -DPROJ_OPT=99999 \
+ *       -Isrc/config/test -Isrc/config -Isrc/config/proj_opt -Isrc/cli -Isrc/lldp \
+ *       -Isrc/main -Isrc/switch -Isrc/util -Isrc/switch/vtss_api/base \
+ *       -Isrc/switch/vtss_api/base/ocelot -o /tmp/config_test \
+ *       src/config/test/config_test.c src/config/test/host_sim.c src/config/test/flash_sim.c \
+ *       src/config/spiflash.c src/util/misc1.c && \
+ *   /tmp/config_test | diff - src/config/test/config_expected.txt
+ */
+
+#include "common.h"
+#include "spiflash.h"
+#include "h2aggr.h"
+
+#include "host_sim.h"
+#include "flash_sim.h"
+
+#define TEST_SAVES          3000    // Saves to wrap the journal sectors
+#define TEST_BOOT_EVERY     500     // Saves between two boots
+
+/* Sector of the CFG area with the journal header of the highest sequence
+   number, i.e. the active one. 0 when there is none */
+static uchar test_active_sector (void)
+{
+    ulong  addr;
+    ushort seq, best_seq = 0;
+    uchar  sect, best = 0;
+
+    for (sect = 1; sect < (FLASH_SIM_SA_RT0 - FLASH_SIM_SA_CFG) / FLASH_SIM_SECTOR_SIZE; sect++) {
+        addr = FLASH_SIM_SA_CFG + sect * FLASH_SIM_SECTOR_SIZE;
+        seq  = flash_sim_mem[addr + 2] << 8 | flash_sim_mem[addr + 3];
+        if (flash_sim_mem[addr] == 0xC5 && flash_sim_mem[addr + 1] == 0x4A &&
+            (best == 0 || (short) (seq - best_seq) > 0)) {
+            best     = sect;
+            best_seq = seq;
+        }
+    }
+    return best;
+}
+
+static void test_boot (const char *what)
+{
+    flash_init();
+    flash_load_config();
+    printf("-- boot %s: mode 0x%02x, journal sector %u\n", what, flash_read_aggr_mode(), test_active_sector());
+}
+
+static uchar test_cfg[FLASH_SIM_SA_RT0 - FLASH_SIM_SA_CFG];
+
+static void test_save (uchar mode)
+{
+    uchar rc;
+
+    flash_write_aggr_mode(mode);
+    rc = flash_program_config();
+    if (rc) {
+        printf("-- save 0x%02x: rc=%u\n", mode, rc);
+    }
+}
+
+int main (void)
+{
+    ushort i;
+    uchar  mode = 0;
+
+    /* As delivered: the CFG area erased, the hash mode not configured */
+    flash_sim_init();
+    test_boot("as delivered");
+
+    test_save(H2_AGGR_HASH_IP4_SIPDIP | H2_AGGR_HASH_IP4_TCPUDP);
+    test_boot("after a save");
+
+    /* Set but not saved, the saved mode comes back */
+    flash_write_aggr_mode(H2_AGGR_HASH_SMAC);
+    test_boot("after a change without save");
+
+    /* The same mode again appends nothing */
+    memcpy(test_cfg, &flash_sim_mem[FLASH_SIM_SA_CFG], sizeof(test_cfg));
+    test_save(flash_read_aggr_mode());
+    printf("-- save of the same mode: %s\n",
+           memcmp(test_cfg, &flash_sim_mem[FLASH_SIM_SA_CFG], sizeof(test_cfg)) ? "flash changed" : "flash unchanged");
+
+    for (i = 1; i <= TEST_SAVES; i++) {
+        mode = (uchar) ((i % 127 + 1) << 1);    // Valid modes, bit 0 is not used
+        test_save(mode);
+        if (i % TEST_BOOT_EVERY == 0) {
+            printf("-- %u saves, last 0x%02x\n", i, mode);
+            test_boot("after the saves");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,261 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"
+#include "vtss_api_base_regs.h"
+#include "h2mactab.h"
+
+#include "host_sim.h"
+#include "flash_sim.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+#define SIM_CLK_MSK     VTSS_M_ICPU_CFG_SPI_MST_SW_MODE_SW_SPI_SCK
+#define SIM_DO_MSK      VTSS_M_ICPU_CFG_SPI_MST_SW_MODE_SW_SPI_SDO
+#define SIM_DI_MSK      VTSS_M_ICPU_CFG_SPI_MST_SW_MODE_SW_SPI_SDI
+#define SIM_CS_MSK      VTSS_F_ICPU_CFG_SPI_MST_SW_MODE_SW_SPI_CS(0x01)
+
+/* Flash commands */
+#define SIM_WREN        0x06
+#define SIM_WRDI        0x04
+#define SIM_RDID        0x9F
+#define SIM_RDSR        0x05
+#define SIM_READ        0x03
+#define SIM_FAST_READ   0x0B
+#define SIM_PP          0x02
+#define SIM_SE          0x20
+
+#define SIM_STATUS_WIP  0x01
+#define SIM_STATUS_WEL  0x02
+
+/* Status reads the flash stays busy after a program and an erase */
+#define SIM_PP_BUSY     2
+#define SIM_SE_BUSY     5
+
+#define SIM_PAGE_SIZE   256
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+uchar flash_sim_mem[FLASH_SIM_SIZE];
+
+static code uchar sim_id[] = { 0xC2, 0x20, 0x15 };
+
+static struct {
+    ulong   sw_mode;        // Last value written to SPI_MST_SW_MODE
+    uchar   shift_in;
+    uchar   bit_cnt;
+    uchar   out_byte;       // Byte shifted out on SDI
+    ushort  byte_cnt;       // Bytes received since CS was asserted
+    uchar   cmd;
+    ulong   addr;
+    uchar   wel;
+    uchar   busy;           // Status reads until the flash is ready
+    uchar   page[SIM_PAGE_SIZE];
+    BOOL    page_used;
+} spi;
+
+/*****************************************************************************
+ *
+ *
+ * SPI flash
+ *
+ *
+ *
+ ****************************************************************************/
+static uchar sim_status (void)
+{
+    return (spi.busy ? SIM_STATUS_WIP : 0) | (spi.wel ? SIM_STATUS_WEL : 0);
+}
+
+static void sim_fail (const char *what)
+{
+    fprintf(stderr, "flash_sim: %s, command 0x%02x\n", what, spi.cmd);
+    exit(2);
+}
+
+/* A complete byte is received, select the byte to shift out next */
+static void sim_byte_in (uchar ch)
+{
+    ushort idx = spi.byte_cnt++;
+
+    if (idx == 0) {
+        spi.cmd = ch;
+        if (spi.busy && ch != SIM_RDSR) {
+            sim_fail("command while busy");
+        }
+        switch (ch) {
+        case SIM_WREN:
+            spi.wel = 1;
+            break;
+        case SIM_WRDI:
+            spi.wel = 0;
+            break;
+        case SIM_RDID:
+            spi.out_byte = sim_id[0];
+            break;
+        case SIM_RDSR:
+            spi.out_byte = sim_status();
+            break;
+        case SIM_READ:
+        case SIM_FAST_READ:
+        case SIM_SE:
+            spi.addr = 0;
+            break;
+        case SIM_PP:
+            spi.addr = 0;
+            memset(spi.page, 0xFF, sizeof(spi.page));
+            spi.page_used = FALSE;
+            break;
+        default:
+            sim_fail("unknown command");
+        }
+        return;
+    }
+
+    switch (spi.cmd) {
+    case SIM_RDID:
+        spi.out_byte = idx < sizeof(sim_id) ? sim_id[idx] : 0xFF;
+        break;
+    case SIM_RDSR:
+        if (spi.busy) {
+            spi.busy--;
+        }
+        spi.out_byte = sim_status();
+        break;
+    case SIM_READ:
+    case SIM_FAST_READ:
+        if (idx <= 3) {
+            spi.addr = spi.addr << 8 | ch;
+        } else if (idx > 4 || spi.cmd == SIM_READ) {
+            spi.addr = (spi.addr + 1) % FLASH_SIM_SIZE;
+        }
+        if (idx == 3 && spi.cmd == SIM_FAST_READ) {
+            break;  // Dummy byte follows
+        }
+        if (idx >= 3) {
+            spi.out_byte = flash_sim_mem[spi.addr % FLASH_SIM_SIZE];
+        }
+        break;
+    case SIM_PP:
+        if (idx <= 3) {
+            spi.addr = spi.addr << 8 | ch;
+        } else {
+            /* The address wraps within the page as on the real flash */
+            spi.page[(spi.addr + idx - 4) % SIM_PAGE_SIZE] &= ch;
+            spi.page_used = TRUE;
+        }
+        break;
+    case SIM_SE:
+        if (idx <= 3) {
+            spi.addr = spi.addr << 8 | ch;
+        }
+        break;
+    }
+}
+
+/* CS is deasserted, execute a program or erase */
+static void sim_cmd_end (void)
+{
+    ulong base, i;
+
+    switch (spi.cmd) {
+    case SIM_PP:
+        if (spi.byte_cnt < 4 || !spi.page_used) {
+            break;
+        }
+        if (!spi.wel) {
+            sim_fail("program without write enable");
+        }
+        base = (spi.addr % FLASH_SIM_SIZE) & ~(ulong) (SIM_PAGE_SIZE - 1);
+        for (i = 0; i < SIM_PAGE_SIZE; i++) {
+            flash_sim_mem[base + i] &= spi.page[i];
+        }
+        spi.wel  = 0;
+        spi.busy = SIM_PP_BUSY;
+        break;
+    case SIM_SE:
+        if (spi.byte_cnt != 4) {
+            sim_fail("bad sector erase");
+        }
+        if (!spi.wel) {
+            sim_fail("erase without write enable");
+        }
+        base = (spi.addr % FLASH_SIM_SIZE) & ~(FLASH_SIM_SECTOR_SIZE - 1);
+        memset(&flash_sim_mem[base], 0xFF, FLASH_SIM_SECTOR_SIZE);
+        spi.wel  = 0;
+        spi.busy = SIM_SE_BUSY;
+        break;
+    }
+}
+
+static void sim_sw_mode_write (ulong value)
+{
+    ulong old = spi.sw_mode;
+
+    spi.sw_mode = value;
+    if ((value & SIM_CS_MSK) && !(old & SIM_CS_MSK)) {
+        spi.byte_cnt = 0;
+        spi.bit_cnt  = 0;
+        spi.out_byte = 0xFF;
+    } else if (!(value & SIM_CS_MSK) && (old & SIM_CS_MSK)) {
+        sim_cmd_end();
+    }
+
+    /* Sample SDO on the rising clock edge */
+    if ((value & SIM_CS_MSK) && (value & SIM_CLK_MSK) && !(old & SIM_CLK_MSK)) {
+        spi.shift_in = spi.shift_in << 1 | ((value & SIM_DO_MSK) != 0);
+        if (++spi.bit_cnt == 8) {
+            spi.bit_cnt = 0;
+            sim_byte_in(spi.shift_in);
+        }
+    }
+}
+
+static BOOL sim_reg_read (ulong addr, ulong *value)
+{
+    if (addr != VTSS_ICPU_CFG_SPI_MST_SW_MODE) {
+        return FALSE;
+    }
+    if (spi.out_byte & (0x80 >> spi.bit_cnt)) {
+        *value = spi.sw_mode | SIM_DI_MSK;
+    } else {
+        *value = spi.sw_mode & ~SIM_DI_MSK;
+    }
+    return TRUE;
+}
+
+static BOOL sim_reg_write (ulong addr, ulong value)
+{
+    if (addr != VTSS_ICPU_CFG_SPI_MST_SW_MODE) {
+        return FALSE;
+    }
+    sim_sw_mode_write(value);
+    return TRUE;
+}
+
+void flash_sim_init (void)
+{
+    memset(flash_sim_mem, 0xFF, sizeof(flash_sim_mem));
+    memset(&spi, 0, sizeof(spi));
+    host_sim_reg_hook(sim_reg_read, sim_reg_write);
+}
+
+void h2_mactab_set (const mac_tab_t xdata *mac_tab_entry_ptr, BOOL xdata is_add)
+{
+    (void) mac_tab_entry_ptr;
+    (void) is_add;
+}
@@ -0,0 +1,29 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __FLASH_SIM_H__
+#define __FLASH_SIM_H__
+
+/*
+ * Host simulation of a MX25L1606E SPI flash behind the bit-banged
+ * ICPU_CFG::SPI_MST_SW_MODE register, on top of host_sim.c. The flash
+ * follows the commands bit by bit, a missing write enable or a command
+ * sent while the flash is busy stops the test.
+ */
+
+/* MX25L1606E: 2M bytes, 4K sectors, see flash_info_get() */
+#define FLASH_SIM_SIZE          0x200000UL
+#define FLASH_SIM_SECTOR_SIZE   0x1000UL
+#define FLASH_SIM_SA_CFG        0x10000UL
+#define FLASH_SIM_SA_RT0        0x14000UL
+#define FLASH_SIM_SA_RT1        0x20000UL
+
+/* Flash contents, the test may change it directly */
+extern uchar flash_sim_mem[FLASH_SIM_SIZE];
+
+/* Erase the whole flash and attach it to SPI_MST_SW_MODE */
+void flash_sim_init (void);
+
+#endif /* __FLASH_SIM_H__ */
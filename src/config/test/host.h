@@ -0,0 +1,53 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+/*
+ * Pre-included header (gcc -include) of the host tests that compile
+ * firmware sources unchanged. The Keil memory types and bit types are
+ * defined away and the C51 LARGE model sizes are kept: long is 32-bit,
+ * and with -fpack-struct -fshort-enums structures and enums have no
+ * padding. The SFRs of hwconf.h become unused variables local to each
+ * file. The system headers are included first so the remapping of long
+ * and of the firmware type names does not reach them.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/socket.h>
+
+#define long        int
+#define ulong       c51_ulong
+#define ushort      c51_ushort
+#define uint        c51_uint
+#define time_t      c51_time_t
+
+#define code        const
+#define xdata
+#define data
+#define idata
+#define pdata
+#define small
+#define large
+#define reentrant
+#define bit         unsigned char
+#define sbit        static unsigned char __attribute__((unused))
+#define sfr         static unsigned char __attribute__((unused))
+#define sfr16       static unsigned short __attribute__((unused))
+
+#endif /* __HOST_H__ */
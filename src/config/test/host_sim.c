@@ -0,0 +1,316 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"
+#include "h2io.h"
+#include "misc2.h"
+#include "misc3.h"
+#include "uartdrv.h"
+#include "timer.h"
+#include "print.h"
+#include "h2txrx.h"
+#include "taskdef.h"
+
+#include "host_sim.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+#define HOST_SIM_REG_CNT    4096    // Registers written by a test
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+/* The firmware globals of the simulated modules */
+unsigned char EA;
+data ushort tick_count;
+uchar xdata rx_packet[2048];
+#if TRANSIT_TASK_WDT
+data uchar wdt_task_ticks;
+#endif
+
+static struct {
+    ulong addr;
+    ulong value;
+} sim_reg[HOST_SIM_REG_CNT];
+static ushort               sim_reg_cnt;
+static ulong                sim_wr_val;
+static host_sim_reg_read_t  sim_reg_rd;
+static host_sim_reg_write_t sim_reg_wr;
+
+static int          uart_fd = -1;
+static uchar        uart_rx_buf[256];
+static int          uart_rx_cnt, uart_rx_pos;
+static ushort       timer_end;
+
+/*****************************************************************************
+ *
+ *
+ * Switch registers
+ *
+ *
+ *
+ ****************************************************************************/
+/* Index of the register, added when add is set. -1 when not found */
+static int sim_reg_find (ulong addr, BOOL add)
+{
+    ushort i;
+
+    for (i = 0; i < sim_reg_cnt; i++) {
+        if (sim_reg[i].addr == addr) {
+            return i;
+        }
+    }
+    if (!add) {
+        return -1;
+    }
+    if (sim_reg_cnt == HOST_SIM_REG_CNT) {
+        fprintf(stderr, "host_sim: too many registers\n");
+        exit(2);
+    }
+    sim_reg[sim_reg_cnt].addr = addr;
+    return sim_reg_cnt++;
+}
+
+void host_sim_reg_hook (host_sim_reg_read_t rd, host_sim_reg_write_t wr)
+{
+    sim_reg_rd = rd;
+    sim_reg_wr = wr;
+}
+
+ulong host_sim_reg_get (ulong addr)
+{
+    int i = sim_reg_find(addr, FALSE);
+
+    return i < 0 ? 0 : sim_reg[i].value;
+}
+
+void host_sim_reg_set (ulong addr, ulong value)
+{
+    sim_reg[sim_reg_find(addr, TRUE)].value = value;
+}
+
+ulong h2_read (ulong addr) small
+{
+    ulong value;
+
+    if (sim_reg_rd && sim_reg_rd(addr, &value)) {
+        return value;
+    }
+    return host_sim_reg_get(addr);
+}
+
+void h2_write_val (ulong value) small
+{
+    sim_wr_val = value;
+}
+
+void h2_write_addr (ulong addr) small
+{
+    if (sim_reg_wr && sim_reg_wr(addr, sim_wr_val)) {
+        return;
+    }
+    host_sim_reg_set(addr, sim_wr_val);
+}
+
+/*****************************************************************************
+ *
+ *
+ * Timer
+ *
+ *
+ *
+ ****************************************************************************/
+/* tick_count is the 10 msec ticks since the first call */
+static void sim_tick_update (void)
+{
+    static struct timespec start;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (start.tv_sec == 0 && start.tv_nsec == 0) {
+        start = now;
+    }
+    tick_count = (ushort) ((now.tv_sec - start.tv_sec) * 100 + (now.tv_nsec - start.tv_nsec) / 10000000);
+}
+
+void start_timer (uchar time_in_10_msec) small
+{
+    sim_tick_update();
+    timer_end = tick_count + time_in_10_msec;
+}
+
+bool timeout (void) small
+{
+    sim_tick_update();
+    return (short) (tick_count - timer_end) >= 0;
+}
+
+void delay (uchar delay_in_10_msec) small
+{
+    usleep(delay_in_10_msec * 10000);
+}
+
+/*****************************************************************************
+ *
+ *
+ * UART and print
+ *
+ *
+ *
+ ****************************************************************************/
+void host_sim_uart (int fd)
+{
+    if (fd >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    uart_fd = fd;
+    uart_rx_cnt = uart_rx_pos = 0;
+}
+
+bool uart_byte_ready (void) small
+{
+    int n;
+
+    sim_tick_update();
+    if (uart_rx_pos == uart_rx_cnt && uart_fd >= 0) {
+        n = read(uart_fd, uart_rx_buf, sizeof(uart_rx_buf));
+        uart_rx_cnt = n > 0 ? n : 0;
+        uart_rx_pos = 0;
+    }
+    return uart_rx_pos < uart_rx_cnt;
+}
+
+uchar uart_get_byte (void) small
+{
+    while (!uart_byte_ready()) {
+    }
+    return uart_rx_buf[uart_rx_pos++];
+}
+
+void uart_put_byte (uchar ch) small
+{
+    if (uart_fd < 0) {
+        if (ch != '\r') {
+            putchar(ch);
+        }
+    } else if (write(uart_fd, &ch, 1) != 1) {
+        fprintf(stderr, "host_sim: UART write failed\n");
+        exit(2);
+    }
+}
+
+void uart_tx_flush (void) small
+{
+}
+
+ulong uart_baud_check (ulong baud)
+{
+    return baud;
+}
+
+ulong uart_set_baud (ulong baud)
+{
+    return baud;
+}
+
+void print_str (const char *s)
+{
+    while (*s) {
+        uart_put_byte(*s++);
+    }
+}
+
+void print_cr_lf (void)
+{
+    print_str("\r\n");
+}
+
+void println_str (const char *s)
+{
+    print_str(s);
+    print_cr_lf();
+}
+
+void print_hex_b (uchar value)
+{
+    char buf[4];
+
+    sprintf(buf, "%02X", value);
+    print_str(buf);
+}
+
+void print_hex_w (ushort value)
+{
+    char buf[8];
+
+    sprintf(buf, "%04X", value);
+    print_str(buf);
+}
+
+void print_hex_dw (ulong value)
+{
+    char buf[12];
+
+    sprintf(buf, "%08X", value);
+    print_str(buf);
+}
+
+void print_dec (ulong value)
+{
+    char buf[12];
+
+    sprintf(buf, "%u", value);
+    print_str(buf);
+}
+
+void print_dec_nright (ulong value, uchar fieldwidth)
+{
+    char buf[12];
+
+    sprintf(buf, "%*u", fieldwidth, value);
+    print_str(buf);
+}
+
+void print_spaces (uchar count)
+{
+    while (count-- > 0) {
+        uart_put_byte(' ');
+    }
+}
+
+/*****************************************************************************
+ *
+ *
+ * Assembler helpers
+ *
+ *
+ *
+ ****************************************************************************/
+bit test_bit_32 (uchar bit_no, ulong *src_ptr) small
+{
+    return (*src_ptr >> bit_no) & 1;
+}
+
+void mac_copy (uchar xdata *mac_addr_dst, uchar xdata *mac_addr_src)
+{
+    memcpy(mac_addr_dst, mac_addr_src, 6);
+}
+
+/* 0 when equal as mem_cmp of misc3.a51 */
+uchar mem_cmp (uchar xdata *dst_mem_addr, uchar xdata *src_mem_addr, uchar size) small
+{
+    return memcmp(dst_mem_addr, src_mem_addr, size) != 0;
+}
@@ -0,0 +1,33 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __HOST_SIM_H__
+#define __HOST_SIM_H__
+
+/*
+ * Host simulation of the 8051 environment for the host tests: the switch
+ * registers, the UART, the 10 msec timer, the print functions and the
+ * assembler helpers of misc2.a51/misc3.a51. The registers read back what
+ * was written to them unless a simulated device (flash_sim.c) handles the
+ * address. tick_count follows the clock and is updated when the UART or
+ * the timer is polled.
+ */
+
+/* Register access of a simulated device, return TRUE when addr is handled */
+typedef BOOL (*host_sim_reg_read_t) (ulong addr, ulong *value);
+typedef BOOL (*host_sim_reg_write_t) (ulong addr, ulong value);
+
+void host_sim_reg_hook (host_sim_reg_read_t rd, host_sim_reg_write_t wr);
+
+/* Register value as the firmware sees it, without the device hook */
+ulong host_sim_reg_get (ulong addr);
+void  host_sim_reg_set (ulong addr, ulong value);
+
+/* Use fd as the UART, -1 for none. print_str() and friends write to the
+   UART as well; without a UART the output goes to stdout with plain line
+   ends */
+void host_sim_uart (int fd);
+
+#endif /* __HOST_SIM_H__ */
@@ -0,0 +1,152 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+/*
+ * Host test of the image upload and the image manifests of spiflash.c
+ * against the simulated flash of flash_sim.c. The images are sent by
+ * upload_blocks() of the upload.c sender over a socket pair, once with
+ * line faults. The steps and the verify status are printed, expected.txt
+ * holds the output to compare with. From the repository root:
+ *
+ *   gcc -std=gnu89 -include src/config/test/host.h -fpack-struct -fshort-enums \
+ *       -DVTSS_ARCH_OCELOT -DFERRET_F11 -DPROJ_OPT=99998 -DUPLOAD_NO_MAIN -pthread \
+ *       -Isrc/config/test -Isrc/config -Isrc/config/proj_opt -Isrc/cli -Isrc/lldp \
+ *       -Isrc/main -Isrc/switch -Isrc/util -Isrc/switch/vtss_api/base \
+ *       -Isrc/switch/vtss_api/base/ocelot -o /tmp/spiflash_test \
+ *       src/config/test/spiflash_test.c src/config/test/host_sim.c src/config/test/flash_sim.c \
+ *       src/config/test/upload.c src/config/spiflash.c src/util/misc1.c && \
+ *   /tmp/spiflash_test | diff - src/config/test/expected.txt
+ */
+
+#include "common.h"
+#include "spiflash.h"
+
+#include "host_sim.h"
+#include "flash_sim.h"
+#include "upload.h"
+
+#define TEST_IMG_CNT        4
+#define TEST_IMG_LEN        10000   // Not a multiple of the block or chunk size
+#define TEST_VERIFY_RUNS    3000    // flash_verify_tsk() calls to verify both slots
+
+typedef struct {
+    int         fd;
+    const uchar *img;
+    ulong       len;
+    uchar       faults;
+    int         rc;
+} test_sender_t;
+
+static uchar test_img[TEST_IMG_CNT][TEST_IMG_LEN];
+
+static void *test_sender (void *arg)
+{
+    test_sender_t *snd = arg;
+
+    snd->rc = upload_blocks(snd->fd, snd->img, snd->len, snd->faults);
+    return NULL;
+}
+
+static void test_boot (void)
+{
+    printf("-- boot\n");
+    flash_init();
+    flash_load_config();
+    flash_verify_print();
+}
+
+static void test_verify (void)
+{
+    ushort i;
+
+    printf("-- verify\n");
+    for (i = 0; i < TEST_VERIFY_RUNS; i++) {
+        flash_verify_tsk();
+    }
+    flash_verify_print();
+}
+
+static void test_erase (ulong slot_addr)
+{
+    ulong i;
+
+    printf("-- erase: rc=%u", flash_erase_code(FLASH_IMG_TYPE_RT));
+    for (i = 0; i < 0xC000 && flash_sim_mem[slot_addr + i] == 0xFF; i++) {
+    }
+    printf(", %s\n", i == 0xC000 ? "erased" : "not erased");
+    flash_verify_print();
+}
+
+/* Send image idx with the sender thread while the firmware receives it */
+static void test_upload (uchar idx, ulong slot_addr, uchar faults, ulong baud)
+{
+    test_sender_t snd;
+    pthread_t     thread;
+    int           sv[2];
+    uchar         csum = 0, rc;
+    ulong         i;
+
+    for (i = 0; i < TEST_IMG_LEN; i++) {
+        csum += test_img[idx][i];
+    }
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv)) {
+        perror("socketpair");
+        exit(2);
+    }
+    snd.fd     = sv[1];
+    snd.img    = test_img[idx];
+    snd.len    = TEST_IMG_LEN;
+    snd.faults = faults;
+    pthread_create(&thread, NULL, test_sender, &snd);
+
+    host_sim_uart(sv[0]);
+    rc = flash_upload_image(FLASH_IMG_TYPE_RT, TEST_IMG_LEN, csum, baud);
+    host_sim_uart(-1);
+    close(sv[0]);
+    pthread_join(thread, NULL);
+    close(sv[1]);
+
+    printf("-- upload image %u, faults 0x%02x: rc=%u, sender rc=%d, %s\n", idx, faults, rc, snd.rc,
+           memcmp(&flash_sim_mem[slot_addr], test_img[idx], TEST_IMG_LEN) ? "flash differs" : "flash ok");
+}
+
+int main (void)
+{
+    ulong seed = 1, i;
+    uchar idx;
+
+    for (idx = 0; idx < TEST_IMG_CNT; idx++) {
+        for (i = 0; i < TEST_IMG_LEN; i++) {
+            seed = seed * 1103515245 + 12345;
+            test_img[idx][i] = seed >> 16;
+        }
+    }
+
+    /* As delivered: image 0 in RT0 and active (rt_idx 0 and the
+       configuration signature, see struct config_contents), no manifest */
+    flash_sim_init();
+    memcpy(&flash_sim_mem[FLASH_SIM_SA_RT0], test_img[0], TEST_IMG_LEN);
+    flash_sim_mem[FLASH_SIM_SA_CFG + 1] = 0;
+    flash_sim_mem[FLASH_SIM_SA_CFG + 2] = 0x77;
+
+    test_boot();
+    test_verify();
+
+    /* Into RT1 over a line with faults at a higher rate, then into RT0 */
+    test_erase(FLASH_SIM_SA_RT1);
+    test_upload(1, FLASH_SIM_SA_RT1, UPLOAD_FAULT_CRC | UPLOAD_FAULT_NOISE | UPLOAD_FAULT_DUP | UPLOAD_FAULT_CUT, 460800);
+    test_verify();
+    test_erase(FLASH_SIM_SA_RT0);
+    test_upload(2, FLASH_SIM_SA_RT0, 0, 0);
+    test_verify();
+
+    /* Erase, verify and program RT1 again. The erased slot is without
+       manifest until it is programmed, not a CRC error */
+    test_erase(FLASH_SIM_SA_RT1);
+    test_verify();
+    test_upload(3, FLASH_SIM_SA_RT1, 0, 0);
+    test_verify();
+    return 0;
+}
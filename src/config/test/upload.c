@@ -0,0 +1,291 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+/*
+ * Linux sender of a runtime image over the serial port, using the block
+ * based upload of spiflash.h. It erases the inactive image with ERASE,
+ * sends the image with UPLOAD and waits for the switch to activate it.
+ *
+ *   upload <tty> <image> [<baud>]
+ *
+ * <baud> is the rate of the transfer, the CLI runs at BAUD_RATE. Built
+ * from the repository root with the firmware headers and the CRC of
+ * misc1.c, the rest of misc1.c is dropped by the linker:
+ *
+ *   gcc -Wall -std=gnu89 -include src/config/test/host.h -fpack-struct -fshort-enums \
+ *       -ffunction-sections -Wl,--gc-sections \
+ *       -DVTSS_ARCH_OCELOT -DFERRET_F11 -DPROJ_OPT=99998 -Isrc/config/test -Isrc/config \
+ *       -Isrc/config/proj_opt -Isrc/cli -Isrc/lldp -Isrc/main -Isrc/switch -Isrc/util \
+ *       -Isrc/switch/vtss_api/base -Isrc/switch/vtss_api/base/ocelot \
+ *       -o /tmp/upload src/config/test/upload.c src/util/misc1.c
+ *
+ * spiflash_test.c uses upload_blocks() against the simulated flash.
+ */
+
+#include "common.h"
+#include "misc1.h"
+#include "spiflash.h"
+
+#include "upload.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+#define UPLOAD_REPLY_TIMEOUT    5000    // msec without an answer to a block
+#define UPLOAD_ERASE_TIMEOUT    60000   // msec for ERASE
+#define UPLOAD_DONE_TIMEOUT     30000   // msec for the read back after the last block
+#define UPLOAD_LINE_MAX         80
+
+/*****************************************************************************
+ *
+ *
+ * Local functions
+ *
+ *
+ *
+ ****************************************************************************/
+/* Get a byte from fd, return 1 on timeout or error */
+static int upload_get_byte (int fd, uchar *ch, int msec)
+{
+    struct pollfd pfd;
+
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+    for (;;) {
+        if (poll(&pfd, 1, msec) <= 0) {
+            return 1;
+        }
+        switch (read(fd, ch, 1)) {
+        case 1:
+            return 0;
+        case 0:
+            return 1;
+        default:
+            if (errno != EAGAIN) {
+                return 1;
+            }
+        }
+    }
+}
+
+static int upload_put (int fd, const uchar *buf, ushort len)
+{
+    return write(fd, buf, len) != len;
+}
+
+/* Set the rate of fd when it is a tty, rates without a Bxxx are ignored */
+static void upload_set_baud (int fd, ulong baud)
+{
+    struct termios tio;
+    speed_t        speed;
+
+    switch (baud) {
+    case 115200: speed = B115200; break;
+    case 230400: speed = B230400; break;
+    case 460800: speed = B460800; break;
+    case 921600: speed = B921600; break;
+    default:
+        return;
+    }
+    if (tcgetattr(fd, &tio) == 0) {
+        tcdrain(fd);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+}
+
+static int upload_send_block (int fd, const uchar *img, ulong len, ushort blk_no, uchar *faults)
+{
+    uchar  blk[FLASH_UPLOAD_BLOCK_SIZE + 5];
+    ulong  off = (ulong) blk_no * FLASH_UPLOAD_BLOCK_SIZE;
+    ushort crc = CRC16_INIT, i, cnt;
+
+    blk[0] = FLASH_UPLOAD_SOH;
+    blk[1] = blk_no >> 8;
+    blk[2] = blk_no & 0xFF;
+    memset(&blk[3], 0xFF, FLASH_UPLOAD_BLOCK_SIZE);
+    memcpy(&blk[3], img + off, len - off > FLASH_UPLOAD_BLOCK_SIZE ? FLASH_UPLOAD_BLOCK_SIZE : len - off);
+    for (i = 1; i < FLASH_UPLOAD_BLOCK_SIZE + 3; i++) {
+        crc = crc16_update(crc, blk[i]);
+    }
+    blk[FLASH_UPLOAD_BLOCK_SIZE + 3] = crc >> 8;
+    blk[FLASH_UPLOAD_BLOCK_SIZE + 4] = crc & 0xFF;
+    cnt = sizeof(blk);
+
+    if (blk_no == 1 && (*faults & UPLOAD_FAULT_CRC)) {
+        *faults &= ~UPLOAD_FAULT_CRC;
+        blk[FLASH_UPLOAD_BLOCK_SIZE + 4] ^= 0x01;
+    } else if (blk_no == 2 && (*faults & UPLOAD_FAULT_NOISE)) {
+        *faults &= ~UPLOAD_FAULT_NOISE;
+        if (upload_put(fd, (const uchar *) "\r\n?\r\n", 5)) {
+            return 1;
+        }
+    } else if (blk_no == 3 && (*faults & UPLOAD_FAULT_CUT)) {
+        *faults &= ~UPLOAD_FAULT_CUT;
+        cnt = FLASH_UPLOAD_BLOCK_SIZE / 2;
+    }
+    return upload_put(fd, blk, cnt);
+}
+
+#ifndef UPLOAD_NO_MAIN
+/* Wait for a line starting with "Done" or "Fail", return 0 on "Done" */
+static int upload_wait_done (int fd, int msec)
+{
+    char  line[UPLOAD_LINE_MAX];
+    uchar ch;
+    int   n = 0;
+
+    while (upload_get_byte(fd, &ch, msec) == 0) {
+        if (ch == '\r' || ch == '\n') {
+            line[n] = 0;
+            if (strncmp(line, "Done", 4) == 0) {
+                return 0;
+            }
+            if (strncmp(line, "Fail", 4) == 0) {
+                return 1;
+            }
+            n = 0;
+        } else if (n < UPLOAD_LINE_MAX - 1) {
+            line[n++] = ch;
+        }
+    }
+    return 1;
+}
+#endif /* UPLOAD_NO_MAIN */
+
+/*****************************************************************************
+ *
+ *
+ * Public functions
+ *
+ *
+ *
+ ****************************************************************************/
+int upload_blocks (int fd, const uchar *img, ulong len, uchar faults)
+{
+    char   line[UPLOAD_LINE_MAX];
+    ushort blk_cnt = (len + FLASH_UPLOAD_BLOCK_SIZE - 1) / FLASH_UPLOAD_BLOCK_SIZE;
+    ushort blk_no;
+    uchar  ch, hi, lo;
+    int    n = 0;
+
+    for (;;) {
+        if (upload_get_byte(fd, &ch, UPLOAD_REPLY_TIMEOUT)) {
+            return 1;
+        }
+        if (ch == FLASH_UPLOAD_CAN) {
+            return 1;
+        }
+        if (ch != FLASH_UPLOAD_ACK && ch != FLASH_UPLOAD_NAK) {
+            /* CLI text in front of the first request, e.g. the BAUD answer */
+            if (ch == '\r' || ch == '\n') {
+                line[n] = 0;
+                if (strncmp(line, "BAUD ", 5) == 0) {
+                    upload_set_baud(fd, strtoul(line + 5, NULL, 10));
+                }
+                n = 0;
+            } else if (n < UPLOAD_LINE_MAX - 1) {
+                line[n++] = ch;
+            }
+            continue;
+        }
+
+        if (upload_get_byte(fd, &hi, UPLOAD_REPLY_TIMEOUT) ||
+            upload_get_byte(fd, &lo, UPLOAD_REPLY_TIMEOUT)) {
+            return 1;
+        }
+        blk_no = (ushort) hi << 8 | lo;
+        if (blk_no >= blk_cnt) {
+            return 1;
+        }
+        if (ch == FLASH_UPLOAD_ACK) {
+            if (blk_no == 2 && (faults & UPLOAD_FAULT_DUP)) {
+                /* Send the block again as if the ACK was lost */
+                faults &= ~UPLOAD_FAULT_DUP;
+            } else if (blk_no + 1 == blk_cnt) {
+                return 0;
+            } else {
+                blk_no++;
+            }
+        }
+        if (upload_send_block(fd, img, len, blk_no, &faults)) {
+            return 1;
+        }
+    }
+}
+
+#ifndef UPLOAD_NO_MAIN
+int main (int argc, char **argv)
+{
+    struct termios tio;
+    FILE   *fp;
+    uchar  *img;
+    ulong  len, i, baud = 0;
+    uchar  csum = 0;
+    char   cmd[64];
+    int    fd;
+
+    if (argc != 3 && argc != 4) {
+        fprintf(stderr, "usage: %s <tty> <image> [<baud>]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 4) {
+        baud = strtoul(argv[3], NULL, 10);
+    }
+
+    if ((fp = fopen(argv[2], "rb")) == NULL) {
+        perror(argv[2]);
+        return 1;
+    }
+    img = malloc(FLASH_UPLOAD_BLOCK_SIZE * 256);
+    len = fread(img, 1, FLASH_UPLOAD_BLOCK_SIZE * 256, fp);
+    fclose(fp);
+    for (i = 0; i < len; i++) {
+        csum += img[i];
+    }
+
+    if ((fd = open(argv[1], O_RDWR | O_NOCTTY)) < 0 || tcgetattr(fd, &tio)) {
+        perror(argv[1]);
+        return 1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+    upload_set_baud(fd, BAUD_RATE);
+    tcflush(fd, TCIOFLUSH);
+
+    fprintf(stderr, "Erasing\n");
+    sprintf(cmd, "ERASE %u\r", FLASH_IMG_TYPE_RT);
+    if (upload_put(fd, (uchar *) cmd, strlen(cmd)) || upload_wait_done(fd, UPLOAD_ERASE_TIMEOUT)) {
+        fprintf(stderr, "Erase failed\n");
+        return 1;
+    }
+
+    fprintf(stderr, "Uploading %u bytes\n", len);
+    if (baud) {
+        sprintf(cmd, "UPLOAD %u %u %u %u\r", FLASH_IMG_TYPE_RT, len, csum, baud);
+    } else {
+        sprintf(cmd, "UPLOAD %u %u %u\r", FLASH_IMG_TYPE_RT, len, csum);
+    }
+    if (upload_put(fd, (uchar *) cmd, strlen(cmd)) || upload_blocks(fd, img, len, 0)) {
+        fprintf(stderr, "Upload failed\n");
+        return 1;
+    }
+
+    /* The switch is back at BAUD_RATE after the last block */
+    upload_set_baud(fd, BAUD_RATE);
+    if (upload_wait_done(fd, UPLOAD_DONE_TIMEOUT)) {
+        fprintf(stderr, "Image check failed\n");
+        return 1;
+    }
+    fprintf(stderr, "Done, the switch restarts\n");
+    return 0;
+}
+#endif /* UPLOAD_NO_MAIN */
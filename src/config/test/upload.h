@@ -0,0 +1,23 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __UPLOAD_H__
+#define __UPLOAD_H__
+
+/* Faults upload_blocks() puts on the line, once each */
+#define UPLOAD_FAULT_CRC    0x01    // Block 1 with a wrong CRC
+#define UPLOAD_FAULT_NOISE  0x02    // Line noise in front of block 2
+#define UPLOAD_FAULT_DUP    0x04    // Block 2 again after its ACK, as after a lost ACK
+#define UPLOAD_FAULT_CUT    0x08    // Half of block 3, the switch times out
+
+/*
+ * Send img to the switch over fd once the UPLOAD command is given, see
+ * flash_upload_image(). A "BAUD <rate>" answer changes the rate of fd when
+ * it is a tty.
+ *  return: 0 - the switch acknowledged the last block, 1 - fail
+ */
+int upload_blocks (int fd, const uchar *img, ulong len, uchar faults);
+
+#endif /* __UPLOAD_H__ */
@@ -18,6 +18,8 @@
         #define VER_SUFFIX_TXT      " Ocelot-REL_Unmanaged"
     #elif (PROJ_OPT == 99999)
         #define VER_SUFFIX_TXT      " Ocelot-REL_Unmanaged_LACP"
+    #elif (PROJ_OPT == 99997)
+        #define VER_SUFFIX_TXT      " Ocelot-REL_Unmanaged_L2"
     #endif
 #else
     #define VER_SUFFIX_TXT          ""
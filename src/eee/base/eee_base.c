@@ -189,8 +189,6 @@ ushort eee_default_lpi_timing_get(ushort speed)
 static void eee_rx_state_diagram(eee_sm_t xdata *sm)
 {
 
-    uchar max;
-    int i;
     lldp_remote_entry_t *entry;
     BOOL local_system_change = FALSE;
 
@@ -211,10 +209,8 @@ static void eee_rx_state_diagram(eee_sm_t xdata *sm)
 
     case rx_running:
         sm->tm.RemTxSystemValue = PHY_WAKEUP_VALUE(sm->speed);
-        max = lldp_remote_get_max_entries();
-        for (i = 0; i < max; i++) {
-            entry = lldp_get_remote_entry(i);
-            if ((entry->in_use) && (entry->receive_port == eee_iport2uport(sm->iport)) && entry->is_eee) {
+        for (entry = lldp_remote_get_port_first(eee_iport2uport(sm->iport)); entry != XNULL; entry = lldp_remote_get_port_next(entry)) {
+            if (entry->is_eee) {
                 sm->tm.RemTxSystemValue     = entry->xmit_time;
                 sm->tm.RemRxSystemValueEcho = entry->echo_recv_time;
 #if 0
@@ -281,7 +277,6 @@ static void eee_rx_state_diagram(eee_sm_t xdata *sm)
 // IEEE 802.3az/D3.2 Figure 78-5 - EEE DLL Transmitter State Diagram
 static void eee_tx_state_diagram(eee_sm_t xdata *sm)
 {
-    uchar  i, max;
     lldp_remote_entry_t *entry;
     vtss_eee_port_conf_t eee_port_conf;
 
@@ -313,11 +308,9 @@ static void eee_tx_state_diagram(eee_sm_t xdata *sm)
         ** ps: Add a temp variable new_tx_value. */
 
         /* Read LLDP TLV */
-        max = lldp_remote_get_max_entries();
         sm->tm.RemRxSystemValue = PHY_WAKEUP_VALUE(sm->speed);
-        for (i = 0; i < max; i++) {
-            entry = lldp_get_remote_entry(i);
-            if ((entry->in_use) && (entry->receive_port == eee_iport2uport(sm->iport)) && entry->is_eee) {
+        for (entry = lldp_remote_get_port_first(eee_iport2uport(sm->iport)); entry != XNULL; entry = lldp_remote_get_port_next(entry)) {
+            if (entry->is_eee) {
                 sm->tm.RemRxSystemValue = entry->recv_time;
                 sm->tm.RemTxSystemValueEcho = entry->echo_xmit_time;
 #if 0
@@ -0,0 +1,399 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_IGMP_SNOOPING
+
+#include <string.h>
+
+#include "ipmc_parse.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+#define IPMC_GET16(p)           (((ushort) (p)[0] << 8) | (p)[1])
+
+#define IPMC_ETHTYPE_CTAG       0x8100
+#define IPMC_ETHTYPE_IP         0x0800
+#define IPMC_ETHTYPE_IP6        0x86DD
+
+#define IPMC_IP_PROTO_IGMP      2
+#define IPMC_IP6_NH_HOP         0       /* Hop-by-hop options, carries the router alert */
+#define IPMC_IP6_NH_ROUTING     43
+#define IPMC_IP6_NH_DEST        60
+#define IPMC_IP6_NH_ICMP        58
+
+#define IPMC_IGMP_QUERY         0x11
+#define IPMC_IGMP_V1_REPORT     0x12
+#define IPMC_IGMP_V2_REPORT     0x16
+#define IPMC_IGMP_V2_LEAVE      0x17
+#define IPMC_IGMP_V3_REPORT     0x22
+
+#define IPMC_MLD_QUERY          130
+#define IPMC_MLD_V1_REPORT      131
+#define IPMC_MLD_V1_DONE        132
+#define IPMC_MLD_V2_REPORT      143
+
+/* IGMPv3/MLDv2 group record types */
+#define IPMC_REC_IS_IN          1
+#define IPMC_REC_IS_EX          2
+#define IPMC_REC_TO_IN          3
+#define IPMC_REC_TO_EX          4
+#define IPMC_REC_ALLOW          5
+#define IPMC_REC_BLOCK          6
+
+/*****************************************************************************
+ *
+ *
+ * Local functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+static ulong ipmc_csum_add (ulong sum, const uchar xdata *p, ushort len)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Add len bytes to an Internet checksum.
+ * Remarks     : An odd last byte is padded with zero.
+ * Restrictions:
+ * See also    : RFC 1071
+ * Example     :
+ ****************************************************************************/
+{
+    for (; len > 1; len -= 2, p += 2) {
+        sum += IPMC_GET16(p);
+    }
+    if (len) {
+        sum += (ushort) p[0] << 8;
+    }
+    return sum;
+}
+
+/* ************************************************************************ */
+static BOOL ipmc_csum_ok (ulong sum)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Check an Internet checksum summed over the checksum field.
+ * Remarks     :
+ * Restrictions:
+ * See also    : ipmc_csum_add()
+ * Example     :
+ ****************************************************************************/
+{
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return sum == 0xFFFF;
+}
+
+/* ************************************************************************ */
+static BOOL ipmc_addr_zero (const uchar xdata *addr, uchar len)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Check for the unspecified address of a general query.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    while (len--) {
+        if (*addr++) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* ************************************************************************ */
+static BOOL ipmc_group_mac (BOOL ipv6, const uchar xdata *addr, uchar xdata *mac)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Map a group address to its MAC address.
+ * Remarks     : Returns FALSE if the group is not snooped: not multicast,
+ *               224.0.0.x or an IPv6 scope up to link-local. These are
+ *               flooded as IP multicast control frames.
+ * Restrictions:
+ * See also    : RFC 1112 section 6.4, RFC 2464 section 7
+ * Example     :
+ ****************************************************************************/
+{
+    if (ipv6) {
+        mac[0] = 0x33;
+        mac[1] = 0x33;
+        memcpy(&mac[2], &addr[12], 4);
+        return addr[0] == 0xFF && (addr[1] & 0x0F) > 2;
+    }
+
+    mac[0] = 0x01;
+    mac[1] = 0x00;
+    mac[2] = 0x5E;
+    mac[3] = addr[1] & 0x7F;
+    mac[4] = addr[2];
+    mac[5] = addr[3];
+    return (addr[0] & 0xF0) == 0xE0 && !(addr[0] == 224 && addr[1] == 0 && addr[2] == 0);
+}
+
+/* ************************************************************************ */
+static uchar ipmc_rec_act (uchar type, ushort src_cnt)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the action of an IGMPv3/MLDv2 group record.
+ * Remarks     : Sources are not tracked, so any listener of a source joins
+ *               the group, and only TO_IN({}) leaves it. BLOCK and IS_IN({})
+ *               leave the membership timer running.
+ * Restrictions:
+ * See also    : RFC 3376 section 6.4, RFC 3810 section 7.4
+ * Example     :
+ ****************************************************************************/
+{
+    switch (type) {
+    case IPMC_REC_IS_IN:
+    case IPMC_REC_ALLOW:
+        return src_cnt ? IPMC_ACT_JOIN : IPMC_ACT_NONE;
+    case IPMC_REC_IS_EX:
+    case IPMC_REC_TO_EX:
+        return IPMC_ACT_JOIN;
+    case IPMC_REC_TO_IN:
+        return src_cnt ? IPMC_ACT_JOIN : IPMC_ACT_LEAVE;
+    default:
+        return IPMC_ACT_NONE;
+    }
+}
+
+/* ************************************************************************ */
+static void ipmc_parse_igmp (const uchar xdata *frame, ushort off, ushort len, ipmc_msg_t xdata *msg)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Parse an IPv4 packet at frame offset off.
+ * Remarks     : msg->kind is left IPMC_MSG_NONE unless it is valid IGMP.
+ * Restrictions:
+ * See also    : RFC 2236, RFC 3376
+ * Example     :
+ ****************************************************************************/
+{
+    const uchar xdata *ip = frame + off;
+    const uchar xdata *igmp;
+    ushort hlen, tot, ilen;
+
+    if (len < off + 20 || (ip[0] >> 4) != 4) {
+        return;
+    }
+    hlen = (ip[0] & 0x0F) * 4;
+    tot  = IPMC_GET16(ip + 2);
+    if (hlen < 20 || tot < hlen + 8 || off + tot > len || ip[9] != IPMC_IP_PROTO_IGMP ||
+        (ip[6] & 0x3F) || ip[7]) {
+        return; /* Truncated, not IGMP or a fragment */
+    }
+    igmp = ip + hlen;
+    ilen = tot - hlen;
+    if (!ipmc_csum_ok(ipmc_csum_add(0, igmp, ilen))) {
+        return;
+    }
+
+    msg->rec_end = off + tot;
+    switch (igmp[0]) {
+    case IPMC_IGMP_QUERY:
+        msg->version = ilen >= 12 ? 3 : igmp[1] ? 2 : 1;
+        if (!ipmc_addr_zero(igmp + 4, 4)) {
+            /* A query of a group that is not snooped counts as general */
+            msg->group_valid = ipmc_group_mac(FALSE, igmp + 4, msg->group);
+        }
+        msg->kind = IPMC_MSG_QUERY;
+        break;
+    case IPMC_IGMP_V1_REPORT:
+    case IPMC_IGMP_V2_REPORT:
+    case IPMC_IGMP_V2_LEAVE:
+        msg->version = igmp[0] == IPMC_IGMP_V1_REPORT ? 1 : 2;
+        msg->group_valid = TRUE;
+        msg->act = !ipmc_group_mac(FALSE, igmp + 4, msg->group) ? IPMC_ACT_NONE :
+                   igmp[0] == IPMC_IGMP_V2_LEAVE ? IPMC_ACT_LEAVE : IPMC_ACT_JOIN;
+        msg->rec_cnt = 1;
+        msg->kind = IPMC_MSG_REPORT;
+        break;
+    case IPMC_IGMP_V3_REPORT:
+        msg->version = 3;
+        msg->rec_cnt = IPMC_GET16(igmp + 6);
+        msg->rec_offset = off + hlen + 8;
+        msg->kind = IPMC_MSG_REPORT;
+        break;
+    default:
+        break;
+    }
+}
+
+/* ************************************************************************ */
+static void ipmc_parse_mld (const uchar xdata *frame, ushort off, ushort len, ipmc_msg_t xdata *msg)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Parse an IPv6 packet at frame offset off.
+ * Remarks     : The extension headers before ICMPv6 are skipped.
+ *               msg->kind is left IPMC_MSG_NONE unless it is valid MLD.
+ * Restrictions:
+ * See also    : RFC 2710, RFC 3810
+ * Example     :
+ ****************************************************************************/
+{
+    const uchar xdata *ip6 = frame + off;
+    const uchar xdata *icmp;
+    ulong  sum;
+    ushort end, hoff, ilen;
+    uchar  nh;
+
+    if (len < off + 40 || (ip6[0] >> 4) != 6) {
+        return;
+    }
+    end = 40 + IPMC_GET16(ip6 + 4);
+    if (off + end > len) {
+        return;
+    }
+    nh = ip6[6];
+    hoff = 40;
+    while (nh == IPMC_IP6_NH_HOP || nh == IPMC_IP6_NH_ROUTING || nh == IPMC_IP6_NH_DEST) {
+        if (hoff + 8 > end) {
+            return;
+        }
+        nh = ip6[hoff];
+        hoff += (ip6[hoff + 1] + 1) * 8;
+    }
+    if (nh != IPMC_IP6_NH_ICMP || hoff + 24 > end) {
+        return; /* Not ICMPv6 or too short for MLD */
+    }
+    icmp = ip6 + hoff;
+    ilen = end - hoff;
+
+    /* Pseudo header: addresses, upper-layer length and next header */
+    sum = ipmc_csum_add(0, ip6 + 8, 32) + ilen + IPMC_IP6_NH_ICMP;
+    if (!ipmc_csum_ok(ipmc_csum_add(sum, icmp, ilen))) {
+        return;
+    }
+
+    msg->ipv6 = TRUE;
+    msg->rec_end = off + end;
+    switch (icmp[0]) {
+    case IPMC_MLD_QUERY:
+        msg->version = ilen >= 28 ? 2 : 1;
+        if (!ipmc_addr_zero(icmp + 8, 16)) {
+            msg->group_valid = ipmc_group_mac(TRUE, icmp + 8, msg->group);
+        }
+        msg->kind = IPMC_MSG_QUERY;
+        break;
+    case IPMC_MLD_V1_REPORT:
+    case IPMC_MLD_V1_DONE:
+        msg->version = 1;
+        msg->group_valid = TRUE;
+        msg->act = !ipmc_group_mac(TRUE, icmp + 8, msg->group) ? IPMC_ACT_NONE :
+                   icmp[0] == IPMC_MLD_V1_DONE ? IPMC_ACT_LEAVE : IPMC_ACT_JOIN;
+        msg->rec_cnt = 1;
+        msg->kind = IPMC_MSG_REPORT;
+        break;
+    case IPMC_MLD_V2_REPORT:
+        msg->version = 2;
+        msg->rec_cnt = IPMC_GET16(icmp + 6);
+        msg->rec_offset = off + hoff + 8;
+        msg->kind = IPMC_MSG_REPORT;
+        break;
+    default:
+        break;
+    }
+}
+
+/*****************************************************************************
+ *
+ *
+ * Public functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+uchar ipmc_parse_frame (const uchar xdata *frame, ushort len, ipmc_msg_t xdata *msg)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Parse an IGMP/MLD frame starting at the destination MAC.
+ * Remarks     : len may include the FCS. One C-tag is skipped.
+ *               Returns msg->kind, IPMC_MSG_NONE if the frame is not IGMP or
+ *               MLD or is malformed. The groups of a report are then read by
+ *               ipmc_parse_record().
+ * Restrictions: The frame buffer must be kept until the records are read.
+ * See also    : ipmc_parse_record()
+ * Example     :
+ ****************************************************************************/
+{
+    ushort type;
+    ushort off = 14;
+
+    memset(msg, 0, sizeof(*msg));
+    if (len < off) {
+        return IPMC_MSG_NONE;
+    }
+    type = IPMC_GET16(frame + 12);
+    if (type == IPMC_ETHTYPE_CTAG) {
+        off += 4;
+        if (len < off) {
+            return IPMC_MSG_NONE;
+        }
+        type = IPMC_GET16(frame + 16);
+    }
+
+    if (type == IPMC_ETHTYPE_IP) {
+        ipmc_parse_igmp(frame, off, len, msg);
+    } else if (type == IPMC_ETHTYPE_IP6) {
+        ipmc_parse_mld(frame, off, len, msg);
+    }
+    return msg->kind;
+}
+
+/* ************************************************************************ */
+BOOL ipmc_parse_record (const uchar xdata *frame, ipmc_msg_t xdata *msg, ipmc_rec_t xdata *rec)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the next group of a report.
+ * Remarks     : Returns FALSE when there are no more groups, or the rest of
+ *               the report is truncated. IGMPv1/v2 and MLDv1 reports have a
+ *               single group.
+ * Restrictions: msg must be filled in by ipmc_parse_frame() for frame.
+ * See also    : ipmc_parse_frame()
+ * Example     : while (ipmc_parse_record(frame, &msg, &rec)) { ... }
+ ****************************************************************************/
+{
+    const uchar xdata *p;
+    ushort rec_len;
+    uchar  alen;
+
+    if (msg->kind != IPMC_MSG_REPORT || msg->rec_cnt == 0) {
+        return FALSE;
+    }
+    msg->rec_cnt--;
+
+    if (msg->group_valid) {
+        rec->act = msg->act;
+        memcpy(rec->group, msg->group, sizeof(mac_addr_t));
+        return TRUE;
+    }
+
+    /* Type, aux data length, number of sources, group, sources, aux data */
+    p = frame + msg->rec_offset;
+    alen = msg->ipv6 ? 16 : 4;
+    if (msg->rec_offset + 4 + alen > msg->rec_end) {
+        msg->rec_cnt = 0;
+        return FALSE;
+    }
+    rec_len = 4 + alen + IPMC_GET16(p + 2) * alen + p[1] * 4;
+    if (msg->rec_offset + rec_len > msg->rec_end) {
+        msg->rec_cnt = 0;
+        return FALSE;
+    }
+    msg->rec_offset += rec_len;
+
+    rec->act = ipmc_rec_act(p[0], IPMC_GET16(p + 2));
+    if (!ipmc_group_mac(msg->ipv6, p + 4, rec->group)) {
+        rec->act = IPMC_ACT_NONE;
+    }
+    return TRUE;
+}
+
+#endif // TRANSIT_IGMP_SNOOPING
@@ -0,0 +1,45 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __IPMC_PARSE_H__
+#define __IPMC_PARSE_H__
+
+/*
+ * IGMP/MLD frame parser of the snooping. It only looks at the frame buffer,
+ * so it builds on the host as well (with the Keil memory types defined
+ * empty) and can be fed with captured frames, see test/ipmc_parse_test.c.
+ */
+
+/* Message kind, returned by ipmc_parse_frame() */
+#define IPMC_MSG_NONE           0       /* Not IGMP/MLD or malformed */
+#define IPMC_MSG_QUERY          1       /* General or group-specific query */
+#define IPMC_MSG_REPORT         2       /* Report or leave, see ipmc_parse_record() */
+
+/* Group record action, returned by ipmc_parse_record() */
+#define IPMC_ACT_NONE           0       /* Nothing to do, e.g. link-local group */
+#define IPMC_ACT_JOIN           1
+#define IPMC_ACT_LEAVE          2
+
+typedef struct {
+    uchar       kind;           /* IPMC_MSG_xxx */
+    uchar       version;        /* IGMP 1-3, MLD 1-2 */
+    BOOL        ipv6;           /* MLD */
+    BOOL        group_valid;    /* Group-specific query or single-group report */
+    mac_addr_t  group;          /* Group MAC address */
+    uchar       act;            /* IPMC_ACT_xxx of a single-group report */
+    ushort      rec_cnt;        /* Group records left */
+    ushort      rec_offset;     /* Next group record in the frame */
+    ushort      rec_end;        /* End of the IGMP/MLD message */
+} ipmc_msg_t;
+
+typedef struct {
+    uchar       act;            /* IPMC_ACT_xxx */
+    mac_addr_t  group;          /* Group MAC address */
+} ipmc_rec_t;
+
+uchar   ipmc_parse_frame  (const uchar xdata *frame, ushort len, ipmc_msg_t xdata *msg);
+BOOL    ipmc_parse_record (const uchar xdata *frame, ipmc_msg_t xdata *msg, ipmc_rec_t xdata *rec);
+
+#endif /* __IPMC_PARSE_H__ */
@@ -0,0 +1,582 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_IGMP_SNOOPING
+
+#include <string.h>
+
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "h2.h"
+#include "h2mactab.h"
+#include "h2vlan.h"
+#include "h2packet.h"
+#include "h2txrx.h"
+#include "h2txrxaux.h"
+#include "hwport.h"
+#include "misc2.h"
+#include "print.h"
+#include "ipmc_parse.h"
+#include "ipmc_snoop.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+#define IPMC_VID_NONE           0       /* Unused group table entry */
+
+/* The timers count ticks of IPMC_TICK_SEC seconds, so they fit in a byte */
+#define IPMC_TICK_SEC           2
+#define IPMC_MEMBER_TICKS       (260 / IPMC_TICK_SEC)       /* Group membership interval, RFC 3376 8.4 */
+#define IPMC_ROUTER_TICKS       (256 / IPMC_TICK_SEC)       /* Other querier present interval, RFC 3376 8.5 */
+#define IPMC_LEAVE_TICKS        2                           /* Last member query time (2 s) plus a tick */
+
+/*****************************************************************************
+ *
+ *
+ * Typedefs and enums
+ *
+ *
+ *
+ ****************************************************************************/
+
+typedef struct {
+    ushort      vid;                        /* IPMC_VID_NONE for an unused entry */
+    mac_addr_t  mac;                        /* Group MAC address */
+    uchar       timer[NO_OF_BOARD_PORTS];   /* Ticks left per iport, 0 if not member */
+} ipmc_group_t;
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+
+static ipmc_group_t xdata ipmc_groups [IPMC_GROUP_CNT];
+static uchar xdata ipmc_router_timer [NO_OF_BOARD_PORTS];  /* Ticks left per iport */
+
+static port_bit_mask_t xdata ipmc_router_mask;      /* Router ports, chip port mask */
+static port_bit_mask_t xdata ipmc_fast_leave_mask;  /* Fast leave ports, chip port mask */
+static ulong xdata ipmc_flood_ipmc;                 /* ANA:ANA:FLOODING_IPMC at init */
+static ushort xdata ipmc_full_cnt;                  /* Joins without a free entry */
+static BOOL xdata ipmc_full;                        /* The table ran full */
+static BOOL xdata ipmc_enabled;
+static uchar xdata ipmc_tick_sec;
+
+/*****************************************************************************
+ *
+ *
+ * Local functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+static port_bit_mask_t ipmc_members (const ipmc_group_t xdata *grp)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the member ports of a group as a chip port mask.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    port_bit_mask_t mask = 0;
+    vtss_iport_no_t iport;
+
+    for (iport = 0; iport < NO_OF_BOARD_PORTS; iport++) {
+        if (grp->timer[iport]) {
+            mask |= VTSS_BIT(iport2cport(iport));
+        }
+    }
+    return mask;
+}
+
+/* ************************************************************************ */
+static void ipmc_flood_update (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the flood mask of the unknown IP multicast data.
+ * Remarks     : Unknown groups go to the router ports only. Once a join did
+ *               not fit in the table they are flooded to all ports, until an
+ *               entry is freed.
+ * Restrictions:
+ * See also    : ipmc_group_program()
+ * Example     :
+ ****************************************************************************/
+{
+    H2_WRITE(VTSS_ANA_PGID_PGID(VTSS_PGID_IPMC_FLOOD),
+             ipmc_full ? ALL_PORTS : ipmc_router_mask);
+}
+
+/* ************************************************************************ */
+static void ipmc_group_program (ipmc_group_t xdata *grp)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write a group into the MAC table, or delete it when it has
+ *               no members left.
+ * Remarks     : The router ports get all groups.
+ * Restrictions:
+ * See also    : h2_mactab_set()
+ * Example     :
+ ****************************************************************************/
+{
+    mac_tab_t       entry;
+    port_bit_mask_t members = ipmc_members(grp);
+
+    entry.vid = grp->vid;
+    memcpy(entry.mac_addr, grp->mac, sizeof(mac_addr_t));
+    entry.port_mask = members | ipmc_router_mask;
+    h2_mactab_set(&entry, members != 0);
+
+    if (!members) {
+        grp->vid = IPMC_VID_NONE;
+        if (ipmc_full) {
+            ipmc_full = FALSE;
+            ipmc_flood_update();
+        }
+    }
+}
+
+/* ************************************************************************ */
+static ipmc_group_t xdata *ipmc_group_find (ushort vid, const uchar xdata *mac, BOOL add)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Look up a group, with add also take a free entry for it.
+ * Remarks     : Returns 0 if not found or the table is full.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ipmc_group_t xdata *grp;
+    ipmc_group_t xdata *free_grp = 0;
+    uchar idx;
+
+    for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+        grp = &ipmc_groups[idx];
+        if (grp->vid == vid && memcmp(grp->mac, mac, sizeof(mac_addr_t)) == 0) {
+            return grp;
+        }
+        if (free_grp == 0 && grp->vid == IPMC_VID_NONE) {
+            free_grp = grp;
+        }
+    }
+
+    if (add && free_grp) {
+        free_grp->vid = vid;
+        memcpy(free_grp->mac, mac, sizeof(mac_addr_t));
+        memset(free_grp->timer, 0, sizeof(free_grp->timer));
+    }
+    return add ? free_grp : 0;
+}
+
+/* ************************************************************************ */
+static void ipmc_group_update (vtss_iport_no_t iport, ushort vid, const ipmc_rec_t xdata *rec)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle a join or leave of a group on a port.
+ * Remarks     : A leave on a fast leave port removes the port at once.
+ *               Otherwise the membership only ends if no host answers the
+ *               group-specific queries of the router.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ipmc_group_t xdata *grp;
+    uchar old_timer;
+
+    if (rec->act == IPMC_ACT_NONE) {
+        return;
+    }
+
+    grp = ipmc_group_find(vid, rec->group, rec->act == IPMC_ACT_JOIN);
+    if (grp == 0) {
+        if (rec->act == IPMC_ACT_JOIN) {
+            ipmc_full_cnt++;
+            if (!ipmc_full) {
+                ipmc_full = TRUE;
+                ipmc_flood_update();
+            }
+        }
+        return;
+    }
+
+    old_timer = grp->timer[iport];
+    if (rec->act == IPMC_ACT_JOIN) {
+        grp->timer[iport] = IPMC_MEMBER_TICKS;
+        if (old_timer == 0) {
+            ipmc_group_program(grp);
+        }
+    } else if (TEST_PORT_BIT_MASK(iport2cport(iport), &ipmc_fast_leave_mask)) {
+        grp->timer[iport] = 0;
+        if (old_timer) {
+            ipmc_group_program(grp);
+        }
+    } else if (old_timer > IPMC_LEAVE_TICKS) {
+        grp->timer[iport] = IPMC_LEAVE_TICKS;
+    }
+}
+
+/* ************************************************************************ */
+static void ipmc_query (vtss_iport_no_t iport, const ipmc_msg_t xdata *msg)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle a query, the port it came from is a router port.
+ * Remarks     : A group-specific query shortens the membership of the group
+ *               on all ports, the members answer it with a report.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ipmc_group_t xdata *grp;
+    vtss_cport_no_t chip_port = iport2cport(iport);
+    uchar idx;
+
+    ipmc_router_timer[iport] = IPMC_ROUTER_TICKS;
+    if (!TEST_PORT_BIT_MASK(chip_port, &ipmc_router_mask)) {
+        ipmc_router_mask |= VTSS_BIT(chip_port);
+        for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+            if (ipmc_groups[idx].vid != IPMC_VID_NONE) {
+                ipmc_group_program(&ipmc_groups[idx]);
+            }
+        }
+        ipmc_flood_update();
+    }
+
+    if (!msg->group_valid) {
+        return;
+    }
+    for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+        grp = &ipmc_groups[idx];
+        if (grp->vid != IPMC_VID_NONE && memcmp(grp->mac, msg->group, sizeof(mac_addr_t)) == 0) {
+            for (iport = 0; iport < NO_OF_BOARD_PORTS; iport++) {
+                if (grp->timer[iport] > IPMC_LEAVE_TICKS) {
+                    grp->timer[iport] = IPMC_LEAVE_TICKS;
+                }
+            }
+        }
+    }
+}
+
+/* ************************************************************************ */
+static void ipmc_router_remove (port_bit_mask_t mask)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Remove router ports and rewrite the groups without them.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar idx;
+
+    if ((ipmc_router_mask & mask) == 0) {
+        return;
+    }
+    ipmc_router_mask &= ~mask;
+    for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+        if (ipmc_groups[idx].vid != IPMC_VID_NONE) {
+            ipmc_group_program(&ipmc_groups[idx]);
+        }
+    }
+    ipmc_flood_update();
+}
+
+/* ************************************************************************ */
+static void ipmc_clear (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Delete all groups and router ports.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar idx;
+
+    for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+        if (ipmc_groups[idx].vid != IPMC_VID_NONE) {
+            memset(ipmc_groups[idx].timer, 0, sizeof(ipmc_groups[idx].timer));
+            ipmc_group_program(&ipmc_groups[idx]);
+        }
+    }
+    memset(ipmc_router_timer, 0, sizeof(ipmc_router_timer));
+    ipmc_router_mask = 0;
+    ipmc_full = FALSE;
+}
+
+/*****************************************************************************
+ *
+ *
+ * Public functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+void ipmc_init (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Initialize and enable the IGMP/MLD snooping.
+ * Remarks     :
+ * Restrictions: Call after h2_rx_init().
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    H2_READ(VTSS_ANA_ANA_FLOODING_IPMC, ipmc_flood_ipmc);
+    ipmc_enable_set(TRUE);
+}
+
+/* ************************************************************************ */
+void ipmc_enable_set (BOOL enable)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Enable or disable the snooping.
+ * Remarks     : When enabled, IGMP and MLD frames are redirected to the CPU
+ *               and unknown IP multicast data only goes to the router ports.
+ *               Disabling deletes all groups, so IP multicast is flooded
+ *               again.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong flood_ipmc = ipmc_flood_ipmc;
+
+    ipmc_clear();
+    ipmc_enabled = enable;
+    if (enable) {
+        ipmc_flood_update();
+        flood_ipmc = (flood_ipmc & ~(VTSS_M_ANA_ANA_FLOODING_IPMC_FLD_MC4_DATA |
+                                     VTSS_M_ANA_ANA_FLOODING_IPMC_FLD_MC6_DATA)) |
+                     VTSS_F_ANA_ANA_FLOODING_IPMC_FLD_MC4_DATA(VTSS_PGID_IPMC_FLOOD) |
+                     VTSS_F_ANA_ANA_FLOODING_IPMC_FLD_MC6_DATA(VTSS_PGID_IPMC_FLOOD);
+    }
+    H2_WRITE(VTSS_ANA_ANA_FLOODING_IPMC, flood_ipmc);
+    h2_ipmc_registration(enable);
+}
+
+/* ************************************************************************ */
+BOOL ipmc_enable_get (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get whether the snooping is enabled.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    return ipmc_enabled;
+}
+
+/* ************************************************************************ */
+uchar ipmc_fast_leave_set (vtss_uport_no_t uport, BOOL enable)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Enable or disable fast leave on a port.
+ * Remarks     : Use it on ports with a single host only, as the other hosts
+ *               lose the group when one of them leaves.
+ *               Returns 0, if succeeded, otherwise ERROR_IPMC_PARM.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (uport < 1 || uport > NO_OF_BOARD_PORTS) {
+        return ERROR_IPMC_PARM;
+    }
+    WRITE_PORT_BIT_MASK(uport2cport(uport), enable, &ipmc_fast_leave_mask);
+    return 0;
+}
+
+/* ************************************************************************ */
+void ipmc_frame_received (vtss_cport_no_t chip_port, ushort vid, uchar xdata *frame, ushort len)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Handle a frame redirected to the CPU.
+ * Remarks     : len includes the FCS. Queries are forwarded to all other
+ *               ports and reports to the router ports, limited by the source
+ *               mask of the ingress port and the members of vid. Other
+ *               frames are dropped. The frame is sent in vid, tagged on the
+ *               ports where the rewriter tags vid.
+ * Restrictions:
+ * See also    : ipmc_parse_frame()
+ * Example     :
+ ****************************************************************************/
+{
+    ipmc_msg_t      msg;
+    ipmc_rec_t      rec;
+    port_bit_mask_t fwd_mask;
+    ulong           src_mask;
+    vtss_iport_no_t iport = cport2iport(chip_port);
+
+    if (!ipmc_enabled || iport >= NO_OF_BOARD_PORTS) {
+        return;
+    }
+
+    switch (ipmc_parse_frame(frame, len, &msg)) {
+    case IPMC_MSG_QUERY:
+        ipmc_query(iport, &msg);
+        fwd_mask = ALL_PORTS;
+        break;
+    case IPMC_MSG_REPORT:
+        while (ipmc_parse_record(frame, &msg, &rec)) {
+            ipmc_group_update(iport, vid, &rec);
+        }
+        fwd_mask = ipmc_router_mask;
+        break;
+    default:
+        return;
+    }
+
+    H2_READ(VTSS_ANA_PGID_PGID(VTSS_PGID_SOURCE_MASK_START + chip_port), src_mask);
+    fwd_mask &= src_mask & h2_vlan_members_get(vid) & ~VTSS_BIT(chip_port);
+
+    /* Drop the received C-tag, h2_tx_frame_port() inserts the tag of vid.
+       The frame stays 32-bit aligned */
+    if (frame[12] == (VTSS_ETHTYPE_CTAG >> 8) && frame[13] == (VTSS_ETHTYPE_CTAG & 0xFF)) {
+        memmove(frame + 4, frame, 12);
+        frame += 4;
+        len   -= 4;
+    }
+    for (chip_port = 0; chip_port < NO_OF_CHIP_PORTS; chip_port++) {
+        if (TEST_PORT_BIT_MASK(chip_port, &fwd_mask)) {
+            (void) h2_tx_frame_port(chip_port, frame, len - 4,
+                                    h2_vlan_tx_tagged(chip_port, vid) ? vid : VTSS_VID_NULL);
+        }
+    }
+}
+
+/* ************************************************************************ */
+void ipmc_aging_1s (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Age the group members and router ports.
+ * Remarks     : Called every second, the timers count every IPMC_TICK_SEC.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ipmc_group_t xdata *grp;
+    port_bit_mask_t expired = 0;
+    vtss_iport_no_t iport;
+    BOOL  changed;
+    uchar idx;
+
+    if (++ipmc_tick_sec < IPMC_TICK_SEC) {
+        return;
+    }
+    ipmc_tick_sec = 0;
+
+    for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+        grp = &ipmc_groups[idx];
+        if (grp->vid == IPMC_VID_NONE) {
+            continue;
+        }
+        changed = FALSE;
+        for (iport = 0; iport < NO_OF_BOARD_PORTS; iport++) {
+            if (grp->timer[iport] && --grp->timer[iport] == 0) {
+                changed = TRUE;
+            }
+        }
+        if (changed) {
+            ipmc_group_program(grp);
+        }
+    }
+
+    for (iport = 0; iport < NO_OF_BOARD_PORTS; iport++) {
+        if (ipmc_router_timer[iport] && --ipmc_router_timer[iport] == 0) {
+            expired |= VTSS_BIT(iport2cport(iport));
+        }
+    }
+    ipmc_router_remove(expired);
+}
+
+/* ************************************************************************ */
+void ipmc_port_down (vtss_cport_no_t chip_port)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Remove a port from all groups and the router ports when its
+ *               link goes down.
+ * Remarks     :
+ * Restrictions:
+ * See also    : callback_link_down()
+ * Example     :
+ ****************************************************************************/
+{
+    ipmc_group_t xdata *grp;
+    vtss_iport_no_t iport = cport2iport(chip_port);
+    uchar idx;
+
+    if (!ipmc_enabled || iport >= NO_OF_BOARD_PORTS) {
+        return;
+    }
+
+    for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+        grp = &ipmc_groups[idx];
+        if (grp->vid != IPMC_VID_NONE && grp->timer[iport]) {
+            grp->timer[iport] = 0;
+            ipmc_group_program(grp);
+        }
+    }
+    ipmc_router_timer[iport] = 0;
+    ipmc_router_remove(VTSS_BIT(chip_port));
+}
+
+/* ************************************************************************ */
+void ipmc_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the state, router ports and group table.
+ * Remarks     : The member ports are shown with the seconds left.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ipmc_group_t xdata *grp;
+    vtss_iport_no_t iport;
+    uchar idx;
+
+    print_str("Snooping: ");
+    println_str(ipmc_enabled ? "enabled" : "disabled");
+    print_str("Router ports: ");
+    print_port_list(ipmc_router_mask);
+    print_cr_lf();
+    print_str("Fast leave ports: ");
+    print_port_list(ipmc_fast_leave_mask);
+    print_cr_lf();
+    print_str("Table full: ");
+    print_dec(ipmc_full_cnt);
+    println_str(ipmc_full ? " joins lost, flooding unknown groups" : " joins lost");
+
+    println_str("VID  Group MAC          Port:seconds");
+    for (idx = 0; idx < IPMC_GROUP_CNT; idx++) {
+        grp = &ipmc_groups[idx];
+        if (grp->vid == IPMC_VID_NONE) {
+            continue;
+        }
+        print_dec(grp->vid);
+        print_spaces(grp->vid < 10 ? 4 : grp->vid < 100 ? 3 : grp->vid < 1000 ? 2 : 1);
+        print_mac_addr(grp->mac);
+        print_spaces(1);
+        for (iport = 0; iport < NO_OF_BOARD_PORTS; iport++) {
+            if (grp->timer[iport]) {
+                print_spaces(1);
+                print_dec(iport2uport(iport));
+                print_ch(':');
+                print_dec((ushort) grp->timer[iport] * IPMC_TICK_SEC);
+            }
+        }
+        print_cr_lf();
+    }
+}
+
+#endif // TRANSIT_IGMP_SNOOPING
@@ -0,0 +1,24 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __IPMC_SNOOP_H__
+#define __IPMC_SNOOP_H__
+
+#if TRANSIT_IGMP_SNOOPING
+#define IPMC_GROUP_CNT          16      /* Group table entries, one per VID and group MAC */
+
+#define ERROR_IPMC_PARM         1       /* Invalid parameter */
+
+void    ipmc_init           (void);
+void    ipmc_enable_set     (BOOL enable);
+BOOL    ipmc_enable_get     (void);
+uchar   ipmc_fast_leave_set (vtss_uport_no_t uport, BOOL enable);
+void    ipmc_frame_received (vtss_cport_no_t chip_port, ushort vid, uchar xdata *frame, ushort len);
+void    ipmc_aging_1s       (void);
+void    ipmc_port_down      (vtss_cport_no_t chip_port);
+void    ipmc_print          (void);
+#endif // TRANSIT_IGMP_SNOOPING
+
+#endif /* __IPMC_SNOOP_H__ */
@@ -0,0 +1,37 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __COMMON_H__
+#define __COMMON_H__
+
+/*
+ * Host replacement of config/common.h for ipmc_parse_test.c. It provides
+ * the types ipmc_parse.c uses, with the Keil memory types defined empty
+ * and the sizes of the C51 LARGE model.
+ */
+
+#define TRANSIT_IGMP_SNOOPING   1
+
+#define code
+#define xdata
+#define data
+#define idata
+#define small
+
+typedef unsigned char   uchar;
+typedef unsigned short  ushort;
+typedef unsigned int    ulong;  /* 32-bit as in C51 */
+typedef unsigned char   BOOL;
+
+typedef unsigned char   u8;
+
+#define TRUE    1
+#define FALSE   0
+
+#define MAC_ADDR_LEN    (6)
+
+typedef u8 mac_addr_t [ MAC_ADDR_LEN ];
+
+#endif /* __COMMON_H__ */
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+# SPDX-License-Identifier: MIT
+#
+# Generate the IGMP/MLD test frames of ipmc_parse_test.c:
+#   python3 gen_frames.py > frames.txt
+# One "<name> <frame in hex>" line per frame, FCS included.
+
+import struct
+
+
+def csum(b):
+    if len(b) % 2:
+        b += b'\0'
+    s = sum(struct.unpack('!%dH' % (len(b) // 2), b))
+    while s >> 16:
+        s = (s & 0xFFFF) + (s >> 16)
+    return ~s & 0xFFFF
+
+
+def eth(dmac, etype, vid=None):
+    hdr = bytes(dmac) + bytes([0, 1, 2, 3, 4, 5])
+    if vid is not None:
+        hdr += struct.pack('!HH', 0x8100, vid)
+    return hdr + struct.pack('!H', etype)
+
+
+def ip4(payload, dst):
+    """IPv4 header with the router alert option, protocol IGMP"""
+    opt = bytes([0x94, 4, 0, 0])
+    hdr = bytearray(struct.pack('!BBHHHBBH4s4s', 0x46, 0xC0, 24 + len(payload), 0, 0, 1, 2, 0,
+                                bytes([10, 0, 0, 1]), bytes(dst))) + opt
+    hdr[10:12] = struct.pack('!H', csum(bytes(hdr)))
+    return bytes(hdr) + payload
+
+
+def igmp(msg):
+    msg = bytearray(msg)
+    msg[2:4] = struct.pack('!H', csum(bytes(msg)))
+    return bytes(msg)
+
+
+def ip6(icmp, dst):
+    """IPv6 header with a hop-by-hop router alert, next header ICMPv6"""
+    src = bytes([0xFE, 0x80] + [0] * 13 + [1])
+    hbh = bytes([58, 0, 5, 2, 0, 0, 1, 0])
+    pseudo = src + dst + struct.pack('!IxxxB', len(icmp), 58)
+    icmp = bytearray(icmp)
+    icmp[2:4] = struct.pack('!H', csum(pseudo + bytes(icmp)))
+    return struct.pack('!IHBB', 0x60000000, len(hbh) + len(icmp), 0, 1) + src + dst + hbh + bytes(icmp)
+
+
+def ip6_addr(*tail, prefix=(0xFF, 0x02)):
+    return bytes(list(prefix) + [0] * (16 - len(prefix) - len(tail)) + list(tail))
+
+
+FCS = b'\xDE\xAD\xBE\xEF'
+frames = []
+
+# IGMPv2 general query
+frames.append(('v2q', eth([1, 0, 0x5E, 0, 0, 1], 0x800) +
+               ip4(igmp(struct.pack('!BBH4s', 0x11, 100, 0, bytes(4))), [224, 0, 0, 1]) + FCS))
+# IGMPv2 report 239.129.2.3, VLAN tagged, maps to the same MAC as 239.1.2.3
+frames.append(('v2r', eth([1, 0, 0x5E, 1, 2, 3], 0x800, vid=10) +
+               ip4(igmp(struct.pack('!BBH4s', 0x16, 0, 0, bytes([239, 129, 2, 3]))), [239, 1, 2, 3]) + FCS))
+# IGMPv2 leave 239.1.2.3
+frames.append(('v2l', eth([1, 0, 0x5E, 0, 0, 2], 0x800) +
+               ip4(igmp(struct.pack('!BBH4s', 0x17, 0, 0, bytes([239, 1, 2, 3]))), [224, 0, 0, 2]) + FCS))
+# IGMPv2 report 224.0.0.251, link-local, not snooped
+frames.append(('v2r_ll', eth([1, 0, 0x5E, 0, 0, 251], 0x800) +
+               ip4(igmp(struct.pack('!BBH4s', 0x16, 0, 0, bytes([224, 0, 0, 251]))), [224, 0, 0, 251]) + FCS))
+# IGMPv3 group-specific query 239.1.2.3
+frames.append(('v3q', eth([1, 0, 0x5E, 1, 2, 3], 0x800) +
+               ip4(igmp(struct.pack('!BBH4sBBH', 0x11, 10, 0, bytes([239, 1, 2, 3]), 2, 125, 0)), [239, 1, 2, 3]) + FCS))
+# IGMPv3 report: TO_EX 239.1.1.1 {}, TO_IN 239.2.2.2 {}, ALLOW 239.3.3.3 {10.0.0.9} with one aux word
+recs = (struct.pack('!BBH4s', 4, 0, 0, bytes([239, 1, 1, 1])) +
+        struct.pack('!BBH4s', 3, 0, 0, bytes([239, 2, 2, 2])) +
+        struct.pack('!BBH4s4s4s', 5, 1, 1, bytes([239, 3, 3, 3]), bytes([10, 0, 0, 9]), bytes(4)))
+frames.append(('v3r', eth([1, 0, 0x5E, 0, 0, 22], 0x800) +
+               ip4(igmp(struct.pack('!BBHHH', 0x22, 0, 0, 0, 3) + recs), [224, 0, 0, 22]) + FCS))
+# IGMPv3 report claiming 4 records with 3 in the frame (truncated)
+frames.append(('v3r_trunc', eth([1, 0, 0x5E, 0, 0, 22], 0x800) +
+               ip4(igmp(struct.pack('!BBHHH', 0x22, 0, 0, 0, 4) + recs), [224, 0, 0, 22]) + FCS))
+# IGMPv2 report with a bad IGMP checksum
+bad = bytearray(frames[1][1])
+bad[-6] ^= 1
+frames.append(('v2r_badcs', bytes(bad)))
+# IGMPv2 report cut in the IGMP message, shorter than the IP total length
+frames.append(('v2r_short', frames[1][1][:44]))
+# MLDv1 general query
+frames.append(('mld1q', eth([0x33, 0x33, 0, 0, 0, 1], 0x86DD) +
+               ip6(struct.pack('!BBHHH16s', 130, 0, 0, 1000, 0, bytes(16)), ip6_addr(1)) + FCS))
+# MLDv1 report ff0e::1:2
+grp = ip6_addr(0, 1, 0, 2, prefix=(0xFF, 0x0E))
+frames.append(('mld1r', eth([0x33, 0x33, 0, 1, 0, 2], 0x86DD) +
+               ip6(struct.pack('!BBHHH16s', 131, 0, 0, 0, 0, grp), grp) + FCS))
+# MLDv1 done ff0e::1:2
+frames.append(('mld1d', eth([0x33, 0x33, 0, 0, 0, 2], 0x86DD) +
+               ip6(struct.pack('!BBHHH16s', 132, 0, 0, 0, 0, grp), ip6_addr(2)) + FCS))
+# MLDv2 report: IS_EX ff0e::1:2, TO_IN ff02::fb (link-local, not snooped)
+recs6 = (struct.pack('!BBH16s', 2, 0, 0, grp) +
+         struct.pack('!BBH16s', 4, 0, 0, ip6_addr(0xFB)))
+frames.append(('mld2r', eth([0x33, 0x33, 0, 0, 0, 0x16], 0x86DD) +
+               ip6(struct.pack('!BBHHH', 143, 0, 0, 0, 2) + recs6, ip6_addr(0x16)) + FCS))
+# UDP to a group, not IGMP
+frames.append(('udp', eth([1, 0, 0x5E, 1, 2, 3], 0x800) +
+               bytes([0x45, 0, 0, 28, 0, 0, 0, 0, 1, 17, 0, 0, 10, 0, 0, 1, 239, 1, 2, 3]) + bytes(8) + FCS))
+
+for name, frame in frames:
+    print(name, frame.hex())
@@ -0,0 +1,64 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+/*
+ * Host test of the IGMP/MLD frame parser (ipmc_parse.c).
+ *
+ * Reads "<name> <frame in hex>" lines, see frames.txt, and prints the
+ * message and its group records. frames.txt is made by gen_frames.py,
+ * expected.txt holds the output to compare with. From the repository root:
+ *
+ *   gcc -Wall -Isrc/ipmc/test -Isrc/ipmc -o /tmp/ipmc_parse_test src/ipmc/test/ipmc_parse_test.c src/ipmc/ipmc_parse.c && /tmp/ipmc_parse_test < src/ipmc/test/frames.txt | diff - src/ipmc/test/expected.txt
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common.h"
+#include "ipmc_parse.h"
+
+#define TEST_FRAME_MAX  1518
+
+static void print_mac (const uchar *mac)
+{
+    printf("%02x:%02x:%02x:%02x:%02x:%02x",
+           mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+int main (void)
+{
+    char       name[32], hex[2 * TEST_FRAME_MAX + 1];
+    uchar      frame[TEST_FRAME_MAX];
+    ushort     len, i;
+    ipmc_msg_t msg;
+    ipmc_rec_t rec;
+    uchar      kind;
+
+    while (scanf("%31s %3036s", name, hex) == 2) {
+        len = (ushort) (strlen(hex) / 2);
+        for (i = 0; i < len; i++) {
+            sscanf(hex + 2 * i, "%2hhx", &frame[i]);
+        }
+
+        memset(&msg, 0, sizeof(msg));
+        kind = ipmc_parse_frame(frame, len, &msg);
+        printf("%-10s kind=%u v=%u ipv6=%u gv=%u", name, kind, msg.version, msg.ipv6, msg.group_valid);
+        if (kind == IPMC_MSG_QUERY && msg.group_valid) {
+            printf(" grp=");
+            print_mac(msg.group);
+        }
+        printf("\n");
+
+        if (kind == IPMC_MSG_REPORT) {
+            while (ipmc_parse_record(frame, &msg, &rec)) {
+                printf("    act=%u ", rec.act);
+                print_mac(rec.group);
+                printf("\n");
+            }
+        }
+    }
+
+    return 0;
+}
@@ -14,6 +14,9 @@
 #include "h2stats.h"
 #include "ledtsk.h"
 #include "string.h"
+#if TRANSIT_TIMER_WHEEL
+#include "timer.h"
+#endif
 
 #if defined(LEDTSK_DEBUG_ENABLE)
 #include "print.h"
@@ -489,6 +492,9 @@ void led_init(void)
 #endif // UNMANAGED_PORT_STATISTICS_IF && HW_LED_TOWER_PRESENT
 
     led_mode_timer = LED_MODE_DEFAULT_TIME;
+#if TRANSIT_TIMER_WHEEL
+    tmr_start(TMR_ID_LED_BLINK, MSEC_1000, MSEC_1000);
+#endif
 
     /* Light status LED green */
     led_update_system(VTSS_LED_MODE_ON_GREEN);
@@ -141,6 +141,8 @@ void lldp_init (void)
 
     mac_addr_t  mac_addr;
 
+    lldp_remote_init();
+
 #if TRANSIT_BPDU_PASS_THROUGH
     h2_bpdu_t_registration(0x0e, TRUE);
 #endif // TRANSIT_BPDU_PASS_THROUGH
@@ -159,6 +161,15 @@ void lldp_init (void)
     }
 }
 
+/*
+** The txTTR, txDelayWhile and txShutdownWhile timers of 802.1AB are
+** counted down here and the state machines test them for zero. They stay
+** on the 1 second tick with TRANSIT_TIMER_WHEEL as well: lldp_sm.c follows
+** the timer variables of the standard, which the state entries reload,
+** and the tick costs three decrements per port. The neighbour aging,
+** which only has work when an entry runs out, is on the wheel, see
+** lldp_remote_timer_expired().
+*/
 void lldp_1sec_timer_tick (void)
 {
     lldp_port_t port;
@@ -167,7 +178,9 @@ void lldp_1sec_timer_tick (void)
             lldp_port_timers_tick(&lldp_sm[port]);
     }
 
+#if !TRANSIT_TIMER_WHEEL
     lldp_remote_1sec_timer();
+#endif
 }
 
 
@@ -420,27 +433,13 @@ static void debug_dump_lldpdu (lldp_rx_remote_entry_t xdata * rx_entry)
     VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Validated TLV Follows:"));
     VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Receive port: %u", (unsigned)rx_entry->receive_port));
     VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Chassis ID Subtype: %u", (unsigned)rx_entry->chassis_id_subtype));
-    debug_dump_utf8("Chassis ID", rx_entry->chassis_id, rx_entry->chassis_id_length);
+    debug_dump_utf8("Chassis ID", rx_entry->str[LLDP_REMOTE_STR_CHASSIS_ID], rx_entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID]);
     VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Port ID Subtype: %u", (unsigned)rx_entry->port_id_subtype));
     VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("TTL: %u", (unsigned)rx_entry->ttl));
-    debug_dump_utf8("Port ID", rx_entry->port_id, rx_entry->port_id_length);
-    debug_dump_utf8("Port Description", rx_entry->port_description, rx_entry->port_description_length);
-    debug_dump_utf8("System Name", rx_entry->system_name, rx_entry->system_name_length);
-    debug_dump_utf8("System Description", rx_entry->system_description, rx_entry->system_description_length);
-    debug_dump_utf8("System Capabilities", rx_entry->system_capabilities, 4);
-
-    VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Mgmt address subtype: %u", (unsigned)rx_entry->mgmt_address_subtype));
-    if(rx_entry->mgmt_address_subtype == 1) { /* IPv4 */
-        print_str("Mgmt address: ");
-        print_ip_addr(rx_entry->mgmt_address);
-        print_cr_lf();
-    } else {
-        debug_dump_utf8("Mgmt address", rx_entry->mgmt_address, rx_entry->mgmt_address_length);
-    }
-
-    VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("interface numbering subtype: %u", (unsigned)rx_entry->mgmt_address_if_number_subtype));
-    debug_dump_utf8("interface number", rx_entry->mgmt_address_if_number, 4);
-    debug_dump_utf8("OID", rx_entry->oid, rx_entry->oid_length);
+    debug_dump_utf8("Port ID", rx_entry->str[LLDP_REMOTE_STR_PORT_ID], rx_entry->str_len[LLDP_REMOTE_STR_PORT_ID]);
+    debug_dump_utf8("Port Description", rx_entry->str[LLDP_REMOTE_STR_PORT_DESCR], rx_entry->str_len[LLDP_REMOTE_STR_PORT_DESCR]);
+    debug_dump_utf8("System Name", rx_entry->str[LLDP_REMOTE_STR_SYSTEM_NAME], rx_entry->str_len[LLDP_REMOTE_STR_SYSTEM_NAME]);
+    debug_dump_utf8("Mgmt address", rx_entry->str[LLDP_REMOTE_STR_MGMT_ADDR], rx_entry->str_len[LLDP_REMOTE_STR_MGMT_ADDR]);
 
 #if TRANSIT_EEE
     VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("IEEE 802.3az subtype: %u", (unsigned)rx_entry->mgmt_ieee_subtype));
@@ -516,9 +515,9 @@ static lldp_bool_t validate_lldpdu (lldp_sm_t xdata * sm, lldp_rx_remote_entry_t
         return LLDP_FALSE;
     }
 
-    rx_entry->chassis_id_length = len - 1;
+    rx_entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID] = len - 1;
     rx_entry->chassis_id_subtype = tlv[2];
-    rx_entry->chassis_id = &tlv[3];
+    rx_entry->str[LLDP_REMOTE_STR_CHASSIS_ID] = &tlv[3];
 
     /* advance to next tlv */
     tlv += (2+len);
@@ -537,9 +536,9 @@ static lldp_bool_t validate_lldpdu (lldp_sm_t xdata * sm, lldp_rx_remote_entry_t
         return LLDP_FALSE;
     }
 
-    rx_entry->port_id_length = len - 1;
+    rx_entry->str_len[LLDP_REMOTE_STR_PORT_ID] = len - 1;
     rx_entry->port_id_subtype = tlv[2];
-    rx_entry->port_id = &tlv[3];
+    rx_entry->str[LLDP_REMOTE_STR_PORT_ID] = &tlv[3];
 
     /* advance to next tlv */
     tlv += (2+len);
@@ -600,6 +599,25 @@ static lldp_bool_t validate_lldpdu (lldp_sm_t xdata * sm, lldp_rx_remote_entry_t
 
             return LLDP_TRUE;
 
+        case LLDP_TLV_BASIC_MGMT_PORT_DESCR:
+            rx_entry->str_len[LLDP_REMOTE_STR_PORT_DESCR] = (len > LLDP_REMOTE_OPT_STR_MAX) ? LLDP_REMOTE_OPT_STR_MAX : len;
+            rx_entry->str[LLDP_REMOTE_STR_PORT_DESCR] = &tlv[2];
+            break;
+
+        case LLDP_TLV_BASIC_MGMT_SYSTEM_NAME:
+            rx_entry->str_len[LLDP_REMOTE_STR_SYSTEM_NAME] = (len > LLDP_REMOTE_OPT_STR_MAX) ? LLDP_REMOTE_OPT_STR_MAX : len;
+            rx_entry->str[LLDP_REMOTE_STR_SYSTEM_NAME] = &tlv[2];
+            break;
+
+        case LLDP_TLV_BASIC_MGMT_MGMT_ADDR:
+            /* address string length, family and address, then 6 bytes or more of interface number and OID */
+            if(rx_entry->str_len[LLDP_REMOTE_STR_MGMT_ADDR] == 0 &&
+               tlv[2] >= 2 && tlv[2] <= 32 && len >= (lldp_u16_t)tlv[2] + 7) {
+                rx_entry->str_len[LLDP_REMOTE_STR_MGMT_ADDR] = tlv[2];
+                rx_entry->str[LLDP_REMOTE_STR_MGMT_ADDR] = &tlv[3];
+            }
+            break;
+
         case LLDP_TLV_ORG_TLV:
 #if TRANSIT_EEE
             if(len == 14 && xmemcmp((tlv + 2), ieee_802_3_oui_header, 3) == 0) {
@@ -18,6 +18,9 @@
 
 #include "eee_api.h"
 #include "misc1.h"
+#if TRANSIT_TIMER_WHEEL
+#include "timer.h"
+#endif
 /*****************************************************************************
  *
  *
@@ -27,8 +30,18 @@
  *
  ****************************************************************************/
 
-#define LLDP_REMOTE_ENTRIES LLDP_PORTS
-#define MSAP_ID_IDX_UNKNOWN 0xFF
+#if LLDP_REMOTE_ENTRIES > 254
+#error "LLDP_REMOTE_ENTRIES must be at most 254"
+#endif
+
+#if LLDP_REMOTE_OPT_STR_MAX > 255
+#error "LLDP_REMOTE_OPT_STR_MAX must be at most 255"
+#endif
+
+#define MSAP_ID_IDX_UNKNOWN LLDP_REMOTE_NIL
+
+/* Number of MSAP hash buckets, a power of 2 */
+#define LLDP_REMOTE_HASH_SIZE 16
 
 
 #ifndef MIN
@@ -39,6 +52,11 @@
 #define MAX(a,b) ((a)<(b)?(b):(a))
 #endif /* MAX */
 
+#if TRANSIT_TIMER_WHEEL
+/* Longest TMR_ID_LLDP_REMOTE run in seconds, the wheel reaches 655 s */
+#define LLDP_REMOTE_TMR_MAX_SECS 600
+#endif
+
 /*****************************************************************************
  *
  *
@@ -55,9 +73,19 @@
  *
  *
  ****************************************************************************/
+static lldp_u8_t msap_hash (lldp_rx_remote_entry_t xdata * rx_entry);
 static lldp_u8_t msap_id_idx (lldp_rx_remote_entry_t xdata * rx_entry);
+static void port_list_insert (lldp_u8_t idx);
+static void port_list_remove (lldp_u8_t idx);
+static void expire_list_insert (lldp_u8_t idx, lldp_u16_t ttl);
+static void expire_list_remove (lldp_u8_t idx);
+static void remove_entry (lldp_u8_t idx);
+static lldp_u16_t pool_block_len (lldp_remote_entry_t xdata * entry);
+static void pool_compact (void);
+static lldp_bool_t pool_alloc (lldp_u8_t idx, lldp_rx_remote_entry_t xdata * rx_entry);
+static void pool_release (lldp_u8_t idx);
 static lldp_u8_t compare_msap_ids (lldp_rx_remote_entry_t xdata * rx_entry, lldp_remote_entry_t xdata * remote_entry);
-static void update_entry (lldp_rx_remote_entry_t xdata * rx_entry, lldp_remote_entry_t xdata * entry);
+static void update_entry (lldp_rx_remote_entry_t xdata * rx_entry, lldp_u8_t idx);
 static lldp_bool_t insert_new_entry (lldp_rx_remote_entry_t xdata * rx_entry);
 static lldp_bool_t update_neccessary (lldp_rx_remote_entry_t xdata * rx_entry, lldp_remote_entry_t xdata * entry);
 
@@ -74,6 +102,7 @@ static void mib_stats_inc_inserts (void);
 static void mib_stats_inc_deletes (void);
 static void mib_stats_inc_drops (void);
 static void mib_stats_inc_ageouts (void);
+static void mib_stats_inc_evictions (void);
 static void update_entry_mib_info (lldp_remote_entry_t xdata * entry, lldp_bool_t update_remote_idx);
 static lldp_u8_t get_next(lldp_u32_t time_mark, lldp_port_t port, lldp_u16_t remote_idx);
 static lldp_u8_t compare_values (lldp_u32_t time_mark, lldp_port_t port, lldp_u16_t remote_idx, lldp_remote_entry_t xdata * entry);
@@ -97,57 +126,154 @@ static lldp_u8_t compare_values (lldp_u32_t time_mark, lldp_port_t port, lldp_u1
  ****************************************************************************/
 
 static lldp_u8_t too_many_neighbors = LLDP_FALSE;
+#if TRANSIT_TIMER_WHEEL
+static lldp_u32_t too_many_neighbors_end;  /* Second of the remote clock where it ends */
+#else
 static lldp_timer_t too_many_neighbors_timer = 0;
+#endif
 static lldp_remote_entry_t remote_entries[LLDP_REMOTE_ENTRIES];
 static lldp_mib_stats_t lldp_mib_stats = {0};
 static lldp_u32_t last_remote_index = 0;
 
+/*
+** Index of remote_entries, all lists hold entry numbers and end with
+** LLDP_REMOTE_NIL:
+** - hash_head: entries by MSAP identifier, chained by hash_next
+** - port_head: entries by receive port, chained by port_next
+** - expire_head/tail: entries in use ordered by expire_time
+** - free_head: unused entries, chained by hash_next
+*/
+static lldp_u8_t hash_head[LLDP_REMOTE_HASH_SIZE];
+static lldp_u8_t port_head[LLDP_PORTS];
+static lldp_u8_t expire_head;
+static lldp_u8_t expire_tail;
+static lldp_u8_t free_head;
+static lldp_u32_t remote_secs = 0;      /* The remote clock, see remote_now() */
+
+/*
+** String pool. The strings of an entry are one block, the blocks are
+** allocated from pool_used and upwards and kept in the pool list (pool_head,
+** chained by pool_next) in address order. Released blocks leave holes of
+** pool_holes bytes in total, which pool_compact() squeezes out by sliding
+** the blocks above them down.
+*/
+static lldp_u8_t xdata str_pool[LLDP_REMOTE_POOL_SIZE];
+static lldp_u16_t pool_used;
+static lldp_u16_t pool_holes;
+static lldp_u8_t pool_head;
+static lldp_u8_t pool_tail;
+
+
+void lldp_remote_init (void)
+{
+    lldp_u8_t i;
+
+    memset(hash_head, LLDP_REMOTE_NIL, sizeof(hash_head));
+    memset(port_head, LLDP_REMOTE_NIL, sizeof(port_head));
+    expire_head = expire_tail = LLDP_REMOTE_NIL;
+    pool_head = pool_tail = LLDP_REMOTE_NIL;
+    pool_used = pool_holes = 0;
+
+    free_head = LLDP_REMOTE_NIL;
+    for(i = LLDP_REMOTE_ENTRIES; i-- > 0; ) {
+        remote_entries[i].in_use = 0;
+        remote_entries[i].hash_next = free_head;
+        free_head = i;
+    }
+}
+
 
 void lldp_remote_delete_entries_for_local_port (lldp_port_t port)
 {
-    lldp_u8_t i;
-    for(i = 0; i < LLDP_REMOTE_ENTRIES; i++) {
-        if(remote_entries[i].in_use && (remote_entries[i].receive_port == port)) {
-            remote_entries[i].in_use = 0;
-#if TRANSIT_EEE_LLDP
-            remote_entries[i].is_eee = 0;
-#endif
-            mib_stats_table_changed_now();
-            mib_stats_inc_deletes();
-        }
+    lldp_u8_t idx;
+
+    while((idx = port_head[port - 1]) != LLDP_REMOTE_NIL) {
+        remove_entry(idx);
+        mib_stats_table_changed_now();
+        mib_stats_inc_deletes();
     }
 }
 
 
-void lldp_remote_1sec_timer (void)
+/*
+** Seconds since boot. Without the timer wheel it is counted by
+** lldp_remote_1sec_timer(), with the wheel it is read when needed.
+*/
+static lldp_u32_t remote_now (void)
 {
-    lldp_u8_t i;
+#if TRANSIT_TIMER_WHEEL
+    remote_secs = time_since_boot_ticks() / 100;
+#endif
+    return remote_secs;
+}
+
+#if TRANSIT_TIMER_WHEEL
+/* run TMR_ID_LLDP_REMOTE until the next entry ages out or tooManyNeighbors ends */
+static void remote_timer_set (void)
+{
+    lldp_u32_t now = remote_now();
+    lldp_u32_t end = 0;
+
+    if(expire_head != LLDP_REMOTE_NIL) {
+        end = remote_entries[expire_head].expire_time;
+    }
+    if(too_many_neighbors && (end == 0 || too_many_neighbors_end < end)) {
+        end = too_many_neighbors_end;
+    }
+    if(end == 0) {
+        tmr_stop(TMR_ID_LLDP_REMOTE);
+        return;
+    }
+
+    /* the remote clock runs up to a second late, try again a second later */
+    end = (end <= now) ? 1 : MIN(end - now, LLDP_REMOTE_TMR_MAX_SECS);
+    tmr_start(TMR_ID_LLDP_REMOTE, (ushort)end * MSEC_1000, 0);
+}
+#endif /* TRANSIT_TIMER_WHEEL */
+
+/* age out the entries which have run out */
+static void remote_age (void)
+{
+    lldp_u8_t idx;
+    lldp_port_t port;
     lldp_sm_t xdata * sm;
 
-    for(i = 0; i < LLDP_REMOTE_ENTRIES; i++) {
-        if(remote_entries[i].in_use) {
-            if(remote_entries[i].rx_info_ttl > 0) {
-                if(--remote_entries[i].rx_info_ttl == 0) {
-                    /* timer expired, we shall remove this entry */
-                    remote_entries[i].in_use = 0;
-#if TRANSIT_EEE_LLDP
-                    remote_entries[i].is_eee = 0;
-#endif
-                    mib_stats_table_changed_now();
-                    mib_stats_inc_ageouts();
-                    mib_stats_inc_deletes();
-                    VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Ageing performed for remote entry on port %u",
-                                      (unsigned)remote_entries[i].receive_port));
-                    sm = lldp_get_port_sm(remote_entries[i].receive_port);
-                    sm->rx.rxInfoAge = LLDP_TRUE;
-                    sm->stats.statsAgeoutsTotal++;
-                    lldp_sm_step(sm);
-
-                    /* note that we do not clear tooManyNeighbors here but wait until its timer runs out */
-                }
-            }
-        }
+    /* the expiry list is ordered, so only the entries running out now are visited */
+    while(expire_head != LLDP_REMOTE_NIL && remote_entries[expire_head].expire_time <= remote_secs) {
+        /* timer expired, we shall remove this entry */
+        idx = expire_head;
+        port = remote_entries[idx].receive_port;
+        remove_entry(idx);
+        mib_stats_table_changed_now();
+        mib_stats_inc_ageouts();
+        mib_stats_inc_deletes();
+        VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Ageing performed for remote entry on port %u",
+                          (unsigned)port));
+        sm = lldp_get_port_sm(port);
+        sm->rx.rxInfoAge = LLDP_TRUE;
+        sm->stats.statsAgeoutsTotal++;
+        lldp_sm_step(sm);
+
+        /* note that we do not clear tooManyNeighbors here but wait until its timer runs out */
+    }
+}
+
+#if TRANSIT_TIMER_WHEEL
+/* TMR_ID_LLDP_REMOTE expired */
+void lldp_remote_timer_expired (void)
+{
+    remote_now();
+    remote_age();
+    if(too_many_neighbors && too_many_neighbors_end <= remote_secs) {
+        too_many_neighbors = LLDP_FALSE;
     }
+    remote_timer_set();
+}
+#else
+void lldp_remote_1sec_timer (void)
+{
+    remote_secs++;
+    remote_age();
 
     if(too_many_neighbors) {
         if(too_many_neighbors_timer > 0) {
@@ -157,6 +283,7 @@ void lldp_remote_1sec_timer (void)
         }
     }
 }
+#endif /* TRANSIT_TIMER_WHEEL */
 
 lldp_bool_t lldp_remote_handle_msap (lldp_rx_remote_entry_t xdata * rx_entry)
 {
@@ -183,19 +310,26 @@ lldp_bool_t lldp_remote_handle_msap (lldp_rx_remote_entry_t xdata * rx_entry)
     } else {
         if(update_neccessary(rx_entry, &remote_entries[msap_idx])) {
             VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Updating remote entry"));
-            update_entry(rx_entry, &remote_entries[msap_idx]);
+            /* the neighbour may have moved to another port */
+            port_list_remove(msap_idx);
+            update_entry(rx_entry, msap_idx);
             update_entry_mib_info(&remote_entries[msap_idx], LLDP_FALSE);
+            port_list_insert(msap_idx);
+            expire_list_remove(msap_idx);
+            expire_list_insert(msap_idx, rx_entry->ttl);
             return LLDP_TRUE;
         } else {
             VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("No update neccessary - new rxTTL=%u", (unsigned)rx_entry->ttl));
             remote_entries[msap_idx].rx_info_ttl = rx_entry->ttl;
+            expire_list_remove(msap_idx);
+            expire_list_insert(msap_idx, rx_entry->ttl);
         }
     }
 
     return LLDP_FALSE;
 }
 
-#if TRANSIT_EEE_LLDP || UNMANAGED_LLDP_DEBUG_IF
+#if TRANSIT_EEE_LLDP || UNMANAGED_LLDP_DEBUG_IF || TRANSIT_BIN_PROTO
 lldp_u8_t lldp_remote_get_max_entries (void)
 {
     return LLDP_REMOTE_ENTRIES;
@@ -205,32 +339,77 @@ lldp_remote_entry_t xdata * lldp_get_remote_entry (lldp_u8_t idx)
 {
     return &remote_entries[idx];
 }
+
+/* first entry in use received on port, XNULL if none */
+lldp_remote_entry_t xdata * lldp_remote_get_port_first (lldp_port_t port)
+{
+    lldp_u8_t idx = port_head[port - 1];
+
+    return (idx == LLDP_REMOTE_NIL) ? XNULL : &remote_entries[idx];
+}
+
+/* next entry in use received on the same port as entry, XNULL if none */
+lldp_remote_entry_t xdata * lldp_remote_get_port_next (lldp_remote_entry_t xdata * entry)
+{
+    return (entry->port_next == LLDP_REMOTE_NIL) ? XNULL : &remote_entries[entry->port_next];
+}
+
+/* seconds until the entry ages out */
+lldp_u16_t lldp_remote_ttl_left (lldp_remote_entry_t xdata * entry)
+{
+    return (lldp_u16_t)(entry->expire_time - remote_now());
+}
+
+lldp_u16_t lldp_remote_pool_used (void)
+{
+    return pool_used - pool_holes;
+}
+
+lldp_mib_stats_t xdata * lldp_get_mib_stats (void)
+{
+    return &lldp_mib_stats;
+}
 #endif
 
+/* start of string LLDP_REMOTE_STR_xxx of entry, its length is entry->str_len[str] */
+lldp_u8_t xdata * lldp_remote_str (lldp_remote_entry_t xdata * entry, lldp_u8_t str)
+{
+    lldp_u16_t offset = entry->str_offset;
+    lldp_u8_t i;
+
+    for(i = 0; i < str; i++) {
+        offset += entry->str_len[i];
+    }
+    return &str_pool[offset];
+}
+
 #if UNMANAGED_LLDP_DEBUG_IF
 static void remote_chassis_id_to_string (lldp_remote_entry_t xdata * entry)
 {
+    lldp_u8_t xdata * id = lldp_remote_str(entry, LLDP_REMOTE_STR_CHASSIS_ID);
+    lldp_u8_t len = entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID];
+
     switch(entry->chassis_id_subtype) {
     case 2: /* interface alias */
     case 3: /* port component */
     case 6: /* interface name */
     case 7: /* locally assigned */
-        if(string_is_printable(entry->chassis_id, entry->chassis_id_length)) {
-            print_characters(entry->chassis_id, entry->chassis_id_length);
+        if(string_is_printable(id, len)) {
+            print_characters(id, len);
         } else {
-            print_hex_value(entry->chassis_id, entry->chassis_id_length);
+            print_hex_value(id, len);
         }
         break;
 
     case 4: /* MAC address */
-        print_mac_addr(entry->chassis_id);
+        print_mac_addr(id);
         break;
 
     case 5: /* network address */
-        if(entry->chassis_id[0] == 1) { /* IANA Address Family = IPv4 */
-            print_ip_addr(&entry->chassis_id[1]);
+        if(id[0] == 1) { /* IANA Address Family = IPv4 */
+            print_ip_addr(&id[1]);
         } else {
-            print_hex_value(entry->chassis_id, entry->chassis_id_length);
+            print_hex_value(id, len);
         }
         break;
 
@@ -238,34 +417,37 @@ static void remote_chassis_id_to_string (lldp_remote_entry_t xdata * entry)
     case 0: /* reserved */
     case 1: /* chassis component */
     default: /* reserved */
-        print_hex_value(entry->chassis_id, entry->chassis_id_length);
+        print_hex_value(id, len);
         break;
     }
 }
 
 static void remote_port_id_to_string (lldp_remote_entry_t xdata * entry)
 {
+    lldp_u8_t xdata * id = lldp_remote_str(entry, LLDP_REMOTE_STR_PORT_ID);
+    lldp_u8_t len = entry->str_len[LLDP_REMOTE_STR_PORT_ID];
+
     switch(entry->port_id_subtype) {
     case 1: /* interface Alias */
     case 2: /* port component */
     case 5: /* interface name */
     case 7: /* locally assigned */
-        if(string_is_printable(entry->port_id, entry->port_id_length)) {
-            print_characters(entry->port_id, entry->port_id_length);
+        if(string_is_printable(id, len)) {
+            print_characters(id, len);
         } else {
-            print_hex_value(entry->port_id, entry->port_id_length);
+            print_hex_value(id, len);
         }
         break;
 
     case 3: /* MAC address */
-        print_mac_addr(entry->port_id);
+        print_mac_addr(id);
         break;
 
     case 4: /* network address */
-        if(entry->port_id[0] == 1) { /* IANA Address Family = IPv4 */
-            print_ip_addr(&entry->port_id[1]);
+        if(id[0] == 1) { /* IANA Address Family = IPv4 */
+            print_ip_addr(&id[1]);
         } else {
-            print_hex_value(entry->port_id, entry->port_id_length);
+            print_hex_value(id, len);
         }
         break;
 
@@ -273,7 +455,7 @@ static void remote_port_id_to_string (lldp_remote_entry_t xdata * entry)
     case 0: /* reserved */
     case 6: /* agent circuit ID */
     default: /* reserved */
-        print_hex_value(entry->port_id, entry->port_id_length);
+        print_hex_value(id, len);
         break;
     }
 }
@@ -293,6 +475,25 @@ void lldp_remote_tlv_to_string (lldp_remote_entry_t xdata * entry, lldp_u8_t fie
     case LLDP_TLV_BASIC_MGMT_PORT_ID:
         remote_port_id_to_string(entry);
         break;
+
+    case LLDP_TLV_BASIC_MGMT_PORT_DESCR:
+        p = lldp_remote_str(entry, LLDP_REMOTE_STR_PORT_DESCR);
+        len = entry->str_len[LLDP_REMOTE_STR_PORT_DESCR];
+        break;
+
+    case LLDP_TLV_BASIC_MGMT_SYSTEM_NAME:
+        p = lldp_remote_str(entry, LLDP_REMOTE_STR_SYSTEM_NAME);
+        len = entry->str_len[LLDP_REMOTE_STR_SYSTEM_NAME];
+        break;
+
+    case LLDP_TLV_BASIC_MGMT_MGMT_ADDR:
+        p = lldp_remote_str(entry, LLDP_REMOTE_STR_MGMT_ADDR);
+        if(entry->str_len[LLDP_REMOTE_STR_MGMT_ADDR] == 5 && p[0] == 1) { /* IANA Address Family = IPv4 */
+            print_ip_addr(&p[1]);
+        } else {
+            len = entry->str_len[LLDP_REMOTE_STR_MGMT_ADDR];
+        }
+        break;
 #if UNMANAGED_EEE_DEBUG_IF
     case LLDP_TLV_ORG_EEE_TLV:
         if(entry->is_eee) {
@@ -372,12 +573,6 @@ void lldp_port_type_to_string (lldp_remote_entry_t xdata * entry, lldp_u8_t xdat
 }
 
 #if 0
-lldp_mib_stats_t xdata * lldp_get_mib_stats (void)
-{
-    return &lldp_mib_stats;
-}
-
-
 lldp_remote_entry_t xdata * lldp_remote_get(lldp_u32_t time_mark, lldp_port_t port, lldp_u16_t remote_idx)
 {
     lldp_u8_t i;
@@ -475,7 +670,7 @@ static lldp_u8_t compare_msap_ids (lldp_rx_remote_entry_t xdata * rx_entry, lldp
         return 1;
     }
 
-    if(rx_entry->chassis_id_length != remote_entry->chassis_id_length) {
+    if(rx_entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID] != remote_entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID]) {
         return 1;
     }
 
@@ -483,31 +678,54 @@ static lldp_u8_t compare_msap_ids (lldp_rx_remote_entry_t xdata * rx_entry, lldp
         return 1;
     }
 
-    if(rx_entry->port_id_length != remote_entry->port_id_length) {
+    if(rx_entry->str_len[LLDP_REMOTE_STR_PORT_ID] != remote_entry->str_len[LLDP_REMOTE_STR_PORT_ID]) {
         return 1;
     }
 
-    if(xmemcmp(rx_entry->chassis_id, remote_entry->chassis_id, rx_entry->chassis_id_length) != 0) {
+    /* the IDs are stored in full and back to back */
+    if(xmemcmp(rx_entry->str[LLDP_REMOTE_STR_CHASSIS_ID], &str_pool[remote_entry->str_offset],
+               rx_entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID]) != 0) {
         return 1;
     }
 
-    if(xmemcmp(rx_entry->port_id, remote_entry->port_id, rx_entry->port_id_length) != 0) {
+    if(xmemcmp(rx_entry->str[LLDP_REMOTE_STR_PORT_ID],
+               &str_pool[remote_entry->str_offset + remote_entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID]],
+               rx_entry->str_len[LLDP_REMOTE_STR_PORT_ID]) != 0) {
         return 1;
     }
 
     return 0;
 }
 
+/* hash of the chassis ID and port ID */
+static lldp_u8_t msap_hash (lldp_rx_remote_entry_t xdata * rx_entry)
+{
+    lldp_u8_t h = rx_entry->chassis_id_subtype ^ (rx_entry->port_id_subtype << 4);
+    lldp_u8_t i, len;
+    lldp_u8_t xdata * p;
+
+    p = rx_entry->str[LLDP_REMOTE_STR_CHASSIS_ID];
+    len = rx_entry->str_len[LLDP_REMOTE_STR_CHASSIS_ID];
+    for(i = 0; i < len; i++) {
+        h = ((h << 1) | (h >> 7)) ^ p[i];
+    }
+    p = rx_entry->str[LLDP_REMOTE_STR_PORT_ID];
+    len = rx_entry->str_len[LLDP_REMOTE_STR_PORT_ID];
+    for(i = 0; i < len; i++) {
+        h = ((h << 1) | (h >> 7)) ^ p[i];
+    }
+
+    return (h ^ (h >> 4)) & (LLDP_REMOTE_HASH_SIZE - 1);
+}
+
 static lldp_u8_t msap_id_idx (lldp_rx_remote_entry_t xdata * rx_entry)
 {
     lldp_u8_t i;
-    for(i = 0; i < LLDP_REMOTE_ENTRIES; i++) {
-        if(remote_entries[i].in_use) {
-            if(compare_msap_ids(rx_entry, &remote_entries[i]) == 0) {
-                VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Found MSAP identifier in index %u",
-                                  (unsigned)i));
-                return i;
-            }
+    for(i = hash_head[msap_hash(rx_entry)]; i != LLDP_REMOTE_NIL; i = remote_entries[i].hash_next) {
+        if(compare_msap_ids(rx_entry, &remote_entries[i]) == 0) {
+            VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("Found MSAP identifier in index %u",
+                              (unsigned)i));
+            return i;
         }
     }
 
@@ -515,19 +733,219 @@ static lldp_u8_t msap_id_idx (lldp_rx_remote_entry_t xdata * rx_entry)
     return MSAP_ID_IDX_UNKNOWN;
 }
 
+static void port_list_insert (lldp_u8_t idx)
+{
+    lldp_u8_t port = remote_entries[idx].receive_port;
 
-static lldp_bool_t insert_new_entry (lldp_rx_remote_entry_t xdata * rx_entry)
+    remote_entries[idx].port_next = port_head[port - 1];
+    port_head[port - 1] = idx;
+}
+
+static void port_list_remove (lldp_u8_t idx)
+{
+    lldp_u8_t xdata * p = &port_head[remote_entries[idx].receive_port - 1];
+
+    while(*p != idx) {
+        p = &remote_entries[*p].port_next;
+    }
+    *p = remote_entries[idx].port_next;
+}
+
+/* insert ordered by expire time, new entries normally go last */
+static void expire_list_insert (lldp_u8_t idx, lldp_u16_t ttl)
+{
+    lldp_remote_entry_t xdata * entry = &remote_entries[idx];
+    lldp_u8_t prev = expire_tail;
+
+    entry->expire_time = remote_now() + ttl;
+    while(prev != LLDP_REMOTE_NIL && remote_entries[prev].expire_time > entry->expire_time) {
+        prev = remote_entries[prev].expire_prev;
+    }
+
+    entry->expire_prev = prev;
+    if(prev == LLDP_REMOTE_NIL) {
+        entry->expire_next = expire_head;
+        expire_head = idx;
+#if TRANSIT_TIMER_WHEEL
+        remote_timer_set();
+#endif
+    } else {
+        entry->expire_next = remote_entries[prev].expire_next;
+        remote_entries[prev].expire_next = idx;
+    }
+    if(entry->expire_next == LLDP_REMOTE_NIL) {
+        expire_tail = idx;
+    } else {
+        remote_entries[entry->expire_next].expire_prev = idx;
+    }
+}
+
+static void expire_list_remove (lldp_u8_t idx)
+{
+    lldp_remote_entry_t xdata * entry = &remote_entries[idx];
+
+    if(entry->expire_prev == LLDP_REMOTE_NIL) {
+        expire_head = entry->expire_next;
+    } else {
+        remote_entries[entry->expire_prev].expire_next = entry->expire_next;
+    }
+    if(entry->expire_next == LLDP_REMOTE_NIL) {
+        expire_tail = entry->expire_prev;
+    } else {
+        remote_entries[entry->expire_next].expire_prev = entry->expire_prev;
+    }
+}
+
+/* unlink the entry from all lists and return it to the free list */
+static void remove_entry (lldp_u8_t idx)
 {
+    lldp_u8_t xdata * p = &hash_head[remote_entries[idx].hash];
+
+    while(*p != idx) {
+        p = &remote_entries[*p].hash_next;
+    }
+    *p = remote_entries[idx].hash_next;
+
+    port_list_remove(idx);
+    expire_list_remove(idx);
+    pool_release(idx);
+
+    remote_entries[idx].in_use = 0;
+#if TRANSIT_EEE_LLDP
+    remote_entries[idx].is_eee = 0;
+#endif
+    remote_entries[idx].hash_next = free_head;
+    free_head = idx;
+}
+
+static lldp_u16_t pool_block_len (lldp_remote_entry_t xdata * entry)
+{
+    lldp_u16_t len = 0;
     lldp_u8_t i;
-    for(i = 0; i < LLDP_REMOTE_ENTRIES; i++) {
-        if(!remote_entries[i].in_use) {
-            update_entry(rx_entry, &remote_entries[i]);
-            update_entry_mib_info(&remote_entries[i], LLDP_TRUE);
-            return LLDP_TRUE;
+
+    for(i = 0; i < LLDP_REMOTE_STR_CNT; i++) {
+        len += entry->str_len[i];
+    }
+    return len;
+}
+
+/* slide all blocks down over the holes, the order of the blocks is kept */
+static void pool_compact (void)
+{
+    lldp_u16_t offset = 0;
+    lldp_u16_t len;
+    lldp_u8_t idx;
+
+    for(idx = pool_head; idx != LLDP_REMOTE_NIL; idx = remote_entries[idx].pool_next) {
+        len = pool_block_len(&remote_entries[idx]);
+        if(remote_entries[idx].str_offset != offset) {
+            memmove(&str_pool[offset], &str_pool[remote_entries[idx].str_offset], len);
+            remote_entries[idx].str_offset = offset;
+        }
+        offset += len;
+    }
+    pool_used = offset;
+    pool_holes = 0;
+    lldp_mib_stats.pool_compactions++;
+}
+
+/*
+** store the strings of rx_entry as the block of entry idx, which must not
+** have a block. When the pool is full, the optional strings are left out.
+** Returns LLDP_FALSE if not even the chassis ID and port ID fit.
+*/
+static lldp_bool_t pool_alloc (lldp_u8_t idx, lldp_rx_remote_entry_t xdata * rx_entry)
+{
+    lldp_remote_entry_t xdata * entry = &remote_entries[idx];
+    lldp_u16_t len = 0;
+    lldp_u16_t id_len = 0;
+    lldp_u8_t i;
+
+    for(i = 0; i < LLDP_REMOTE_STR_CNT; i++) {
+        len += rx_entry->str_len[i];
+        if(i < LLDP_REMOTE_STR_OPT_FIRST) {
+            id_len = len;
+        }
+    }
+
+    if(LLDP_REMOTE_POOL_SIZE - pool_used < len && pool_holes > 0) {
+        pool_compact();
+    }
+    if(LLDP_REMOTE_POOL_SIZE - pool_used < len) {
+        if(LLDP_REMOTE_POOL_SIZE - pool_used < id_len) {
+            return LLDP_FALSE;
         }
+        len = id_len;
+        mib_stats_inc_evictions();
+    }
+
+    entry->str_offset = pool_used;
+    for(i = 0; i < LLDP_REMOTE_STR_CNT; i++) {
+        if(len == id_len && i >= LLDP_REMOTE_STR_OPT_FIRST) {
+            entry->str_len[i] = 0;
+        } else {
+            entry->str_len[i] = rx_entry->str_len[i];
+            memcpy(&str_pool[pool_used], rx_entry->str[i], rx_entry->str_len[i]);
+            pool_used += rx_entry->str_len[i];
+        }
+    }
+
+    entry->pool_next = LLDP_REMOTE_NIL;
+    entry->pool_prev = pool_tail;
+    if(pool_tail == LLDP_REMOTE_NIL) {
+        pool_head = idx;
+    } else {
+        remote_entries[pool_tail].pool_next = idx;
+    }
+    pool_tail = idx;
+    return LLDP_TRUE;
+}
+
+static void pool_release (lldp_u8_t idx)
+{
+    lldp_remote_entry_t xdata * entry = &remote_entries[idx];
+    lldp_u16_t len = pool_block_len(entry);
+
+    if(entry->pool_prev == LLDP_REMOTE_NIL) {
+        pool_head = entry->pool_next;
+    } else {
+        remote_entries[entry->pool_prev].pool_next = entry->pool_next;
+    }
+    if(entry->pool_next == LLDP_REMOTE_NIL) {
+        /* the last block and the hole below it are given back right away */
+        pool_tail = entry->pool_prev;
+        pool_used = (pool_tail == LLDP_REMOTE_NIL) ? 0 :
+                    remote_entries[pool_tail].str_offset + pool_block_len(&remote_entries[pool_tail]);
+        pool_holes -= entry->str_offset - pool_used;
+    } else {
+        remote_entries[entry->pool_next].pool_prev = entry->pool_prev;
+        pool_holes += len;
+    }
+    memset(entry->str_len, 0, sizeof(entry->str_len));
+}
+
+
+static lldp_bool_t insert_new_entry (lldp_rx_remote_entry_t xdata * rx_entry)
+{
+    lldp_u8_t i = free_head;
+    lldp_remote_entry_t xdata * entry;
+
+    if(i != LLDP_REMOTE_NIL && pool_alloc(i, rx_entry)) {
+        entry = &remote_entries[i];
+        free_head = entry->hash_next;
+
+        update_entry(rx_entry, i);
+        update_entry_mib_info(entry, LLDP_TRUE);
+
+        entry->hash = msap_hash(rx_entry);
+        entry->hash_next = hash_head[entry->hash];
+        hash_head[entry->hash] = i;
+        port_list_insert(i);
+        expire_list_insert(i, rx_entry->ttl);
+        return LLDP_TRUE;
     }
 
-    /* no room */
+    /* no room in the table or the string pool */
 
     /* for now we just discard the new LLDPDU */
     too_many_neighbors_discard_current_lldpdu(rx_entry);
@@ -549,24 +967,33 @@ static void too_many_neighbors_discard_current_lldpdu (lldp_rx_remote_entry_t xd
     lldp_sm_t xdata * sm;
 
     sm = lldp_get_port_sm(rx_entry->receive_port);
+#if TRANSIT_TIMER_WHEEL
+    if(!too_many_neighbors || too_many_neighbors_end < remote_now() + rx_entry->ttl) {
+        too_many_neighbors_end = remote_now() + rx_entry->ttl;
+    }
+    too_many_neighbors = LLDP_TRUE;
+    remote_timer_set();
+#else
     too_many_neighbors = LLDP_TRUE;
     too_many_neighbors_timer = MAX(too_many_neighbors_timer, rx_entry->ttl);
+#endif
     sm->stats.statsFramesDiscardedTotal++;
 }
 
-static void update_entry (lldp_rx_remote_entry_t xdata * rx_entry, lldp_remote_entry_t xdata * entry)
+/* the strings of a new entry are already stored by pool_alloc() */
+static void update_entry (lldp_rx_remote_entry_t xdata * rx_entry, lldp_u8_t idx)
 {
-    entry->receive_port = rx_entry->receive_port;
+    lldp_remote_entry_t xdata * entry = &remote_entries[idx];
 
-    entry->chassis_id_subtype = rx_entry->chassis_id_subtype;
-    entry->chassis_id_length = rx_entry->chassis_id_length;
-    memcpy(entry->chassis_id, rx_entry->chassis_id, MIN(rx_entry->chassis_id_length, MAX_CHASSIS_ID_LENGTH));
-    entry->chassis_id[MAX_CHASSIS_ID_LENGTH] = '\0';
+    if(entry->in_use) {
+        /* the IDs are the same, so at least they fit again */
+        pool_release(idx);
+        (void)pool_alloc(idx, rx_entry);
+    }
 
+    entry->receive_port = rx_entry->receive_port;
+    entry->chassis_id_subtype = rx_entry->chassis_id_subtype;
     entry->port_id_subtype = rx_entry->port_id_subtype;
-    entry->port_id_length = rx_entry->port_id_length;
-    memcpy(entry->port_id, rx_entry->port_id, MIN(rx_entry->port_id_length, MAX_PORT_ID_LENGTH));
-    entry->port_id[MAX_PORT_ID_LENGTH] = '\0';
 
 #if TRANSIT_EEE_LLDP
     if(entry->mgmt_ieee_subtype != rx_entry->mgmt_ieee_subtype) {
@@ -601,6 +1028,8 @@ static void update_entry (lldp_rx_remote_entry_t xdata * rx_entry, lldp_remote_e
 
 static lldp_bool_t update_neccessary (lldp_rx_remote_entry_t xdata * rx_entry, lldp_remote_entry_t xdata * entry)
 {
+    lldp_u8_t i;
+
     /* we don't need to check the MSAP id here, we already know these are identical */
 
     /* we check simple variables first */
@@ -609,6 +1038,15 @@ static lldp_bool_t update_neccessary (lldp_rx_remote_entry_t xdata * rx_entry, l
         return LLDP_TRUE;
     }
 
+    /* an optional string left out for lack of pool space is retried here */
+    for(i = LLDP_REMOTE_STR_OPT_FIRST; i < LLDP_REMOTE_STR_CNT; i++) {
+        if(rx_entry->str_len[i] != entry->str_len[i] ||
+           xmemcmp(rx_entry->str[i], lldp_remote_str(entry, i), rx_entry->str_len[i]) != 0) {
+            VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("- String %u", (unsigned)i));
+            return LLDP_TRUE;
+        }
+    }
+
 #if TRANSIT_EEE_LLDP
     if(entry->mgmt_ieee_subtype != rx_entry->mgmt_ieee_subtype) {
         VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_DEBUG, ("- mgmt IEEE 802.3 subtype"));
@@ -649,10 +1087,7 @@ static void delete_entry (lldp_rx_remote_entry_t xdata * rx_entry)
 
     if(idx != MSAP_ID_IDX_UNKNOWN) {
         /* delete it */
-        remote_entries[idx].in_use = 0;
-#if TRANSIT_EEE_LLDP
-        remote_entries[idx].is_eee = 0;
-#endif
+        remove_entry(idx);
         mib_stats_table_changed_now();
         mib_stats_inc_deletes();
     }
@@ -683,6 +1118,11 @@ static void mib_stats_inc_ageouts (void)
     lldp_mib_stats.table_ageouts++;
 }
 
+static void mib_stats_inc_evictions (void)
+{
+    lldp_mib_stats.pool_evictions++;
+}
+
 #if UNMANAGED_LLDP_DEBUG_IF
 #if 0
 static lldp_u8_t compare_values (lldp_u32_t time_mark, lldp_port_t port, lldp_u16_t remote_idx, lldp_remote_entry_t xdata * entry)
@@ -8,15 +8,25 @@
 
 #include "lldp_os.h"
 
-/* all lengths must be below 255 (octets)
-** If not, change the type of the _length fields to lldp_u16_t
+/* End of the remote table lists, see lldp_remote_entry_t */
+#define LLDP_REMOTE_NIL         0xFF
+
+/* Strings of a remote entry, stored back to back in the string pool in this
+** order. All lengths must be below 256 (octets). The management address is
+** the address string of the first Management Address TLV: the IANA address
+** family followed by the address.
 */
-#define MAX_CHASSIS_ID_LENGTH   10
-#define MAX_PORT_ID_LENGTH      10
-#define MAX_PORT_DESCR_LENGTH   10
-#define MAX_SYSTEM_NAME_LENGTH  10
-#define MAX_SYSTEM_DESCR_LENGTH 10
-#define MAX_MGMT_OID_LENGTH     10
+enum {
+    LLDP_REMOTE_STR_CHASSIS_ID,
+    LLDP_REMOTE_STR_PORT_ID,
+    LLDP_REMOTE_STR_PORT_DESCR,
+    LLDP_REMOTE_STR_SYSTEM_NAME,
+    LLDP_REMOTE_STR_MGMT_ADDR,
+    LLDP_REMOTE_STR_CNT
+};
+
+/* The strings which are left out first when the pool is full */
+#define LLDP_REMOTE_STR_OPT_FIRST   LLDP_REMOTE_STR_PORT_DESCR
 
 typedef struct {
     /* to begin with, we have a number of fields needed for
@@ -30,12 +40,11 @@ typedef struct {
 
     /* The following fields are "data fields" with received data */
     lldp_u8_t      chassis_id_subtype;
-    lldp_u8_t      chassis_id_length;
-    lldp_u8_t      chassis_id[MAX_CHASSIS_ID_LENGTH + 1];
-
     lldp_u8_t      port_id_subtype;
-    lldp_u8_t      port_id_length;
-    lldp_u8_t      port_id[MAX_PORT_ID_LENGTH + 1];
+
+    /* Strings in the pool, see lldp_remote_str() */
+    lldp_u16_t     str_offset;
+    lldp_u8_t      str_len[LLDP_REMOTE_STR_CNT];
 
     lldp_u16_t     rx_info_ttl;
 #if TRANSIT_EEE_LLDP
@@ -48,6 +57,16 @@ typedef struct {
     lldp_u16_t    echo_recv_time;
 #endif
     lldp_u8_t      something_changed_remote;
+
+    /* Table index, entry numbers with LLDP_REMOTE_NIL as end of list */
+    lldp_u8_t      hash;            /* MSAP hash bucket */
+    lldp_u8_t      hash_next;       /* Next in bucket, or next free entry */
+    lldp_u8_t      port_next;       /* Next on receive_port */
+    lldp_u8_t      expire_prev;     /* Expiry list, ordered by expire_time */
+    lldp_u8_t      expire_next;
+    lldp_u32_t     expire_time;     /* Second of the remote clock where the TTL runs out */
+    lldp_u8_t      pool_prev;       /* Pool list, ordered by str_offset */
+    lldp_u8_t      pool_next;
 } lldp_remote_entry_t;
 
 /* like a remote entry, but with pointers into the received frame instead
@@ -57,12 +76,11 @@ typedef struct {
 
     /* The following fields are "data fields" with received data */
     lldp_u8_t      chassis_id_subtype;
-    lldp_u8_t      chassis_id_length;
-    lldp_u8_t xdata * chassis_id;
-
     lldp_u8_t      port_id_subtype;
-    lldp_u8_t      port_id_length;
-    lldp_u8_t xdata * port_id;
+
+    /* LLDP_REMOTE_STR_xxx, length 0 if the TLV is not present */
+    lldp_u8_t xdata * str[LLDP_REMOTE_STR_CNT];
+    lldp_u8_t      str_len[LLDP_REMOTE_STR_CNT];
 
     lldp_u16_t     ttl;
 
@@ -82,13 +100,25 @@ typedef struct {
     lldp_counter_t table_deletes;
     lldp_counter_t table_drops;
     lldp_counter_t table_ageouts;
+    lldp_counter_t pool_compactions;
+    lldp_counter_t pool_evictions;  /* Entries stored without their optional strings */
 } lldp_mib_stats_t;
 
+void lldp_remote_init (void);
 void lldp_remote_delete_entries_for_local_port (lldp_port_t port);
 lldp_bool_t lldp_remote_handle_msap (lldp_rx_remote_entry_t xdata * rx_entry);
 lldp_u8_t lldp_remote_get_max_entries (void);
 lldp_remote_entry_t xdata * lldp_get_remote_entry (lldp_u8_t idx);
+lldp_remote_entry_t xdata * lldp_remote_get_port_first (lldp_port_t port);
+lldp_remote_entry_t xdata * lldp_remote_get_port_next (lldp_remote_entry_t xdata * entry);
+lldp_u16_t lldp_remote_ttl_left (lldp_remote_entry_t xdata * entry);
+lldp_u8_t xdata * lldp_remote_str (lldp_remote_entry_t xdata * entry, lldp_u8_t str);
+lldp_u16_t lldp_remote_pool_used (void);
+#if TRANSIT_TIMER_WHEEL
+void lldp_remote_timer_expired (void);
+#else
 void lldp_remote_1sec_timer (void);
+#endif
 void lldp_remote_tlv_to_string (lldp_remote_entry_t xdata * entry, lldp_u8_t field, lldp_u8_t xdata * dest);
 void lldp_chassis_type_to_string (lldp_remote_entry_t xdata * entry, lldp_u8_t xdata * dest);
 void lldp_port_type_to_string (lldp_remote_entry_t xdata * entry, lldp_u8_t xdata * dest);
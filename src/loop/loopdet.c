@@ -52,12 +52,6 @@ typedef enum {
     LOOPING
 } state_t;
 
-enum {
-    VTSS_PGID_DEST_MASK_START   =   0,
-    VTSS_PGID_AGGR_MASK_START   =  64,
-    VTSS_PGID_SOURCE_MASK_START =  80
-};
-
 /*****************************************************************************
  *
  *
@@ -81,7 +75,9 @@ enum {
 static state_t          g_state                     = IDLE;
 
 static bit              ldet_aging_timer_started    = 0;
+#if !TRANSIT_TIMER_WHEEL
 static uchar            loopback_aging_timeout      = LOOPBACK_AGE_TIMEOUT;
+#endif
 
 static port_bit_mask_t  log_block_mask              = 0;
 static uchar xdata      loop_count [NO_OF_BOARD_PORTS];
@@ -167,7 +163,11 @@ static void ldet_timer_refresh (void)
 {
     /* loop might happend, start to monitor if happened again in 10 second */
     ldet_aging_timer_started   = 1;
+#if TRANSIT_TIMER_WHEEL
+    tmr_start(TMR_ID_LDET_AGING, LOOPBACK_AGE_TIMEOUT * MSEC_1000, 0);
+#else
     loopback_aging_timeout     = LOOPBACK_AGE_TIMEOUT;  // Refresh the timer
+#endif
 }
 
 /*****************************************************************************
@@ -460,6 +460,10 @@ void ldettsk ( void )
         }
 #endif
     } // End of for loop
+
+#if TRANSIT_LAG
+    vtss_src_masks_changed();
+#endif // TRANSIT_LAG
 }
 
 #if 0   // Uncalled function
@@ -478,14 +482,24 @@ void ldet_aging_100ms (void)
 void ldet_aging_1s (void)
 {
     ldet_uptime++;
+#if !TRANSIT_TIMER_WHEEL
     if (ldet_aging_timer_started) {
         loopback_aging_timeout--;
         if (loopback_aging_timeout == 0) {
             ldet_aging_timer_started = 0;
         }
     }
+#endif
 }
 
+#if TRANSIT_TIMER_WHEEL
+/* TMR_ID_LDET_AGING expired, no loop seen for LOOPBACK_AGE_TIMEOUT seconds */
+void ldet_aging_expired (void)
+{
+    ldet_aging_timer_started = 0;
+}
+#endif
+
 
 
 #if 0
@@ -9,6 +9,9 @@
 void                ldettsk             (void);
 void                ldet_aging_100ms    (void);
 void                ldet_aging_1s       (void);
+#if TRANSIT_TIMER_WHEEL
+void                ldet_aging_expired  (void);
+#endif
 void                ldet_add_cpu_found  (vtss_port_no_t i_port_no);
 port_bit_mask_t     ldet_blocked_ports  (void);
 
@@ -34,6 +34,10 @@
 #include "h2e2etc.h"
 #endif
 
+#if TRANSIT_IGMP_SNOOPING
+#include "ipmc_snoop.h"
+#endif
+
 /*****************************************************************************
  *
  *
@@ -144,6 +148,10 @@ void callback_link_down (vtss_cport_no_t chip_port)
 #if TRANSIT_EEE
     eee_port_link_change(cport2iport(chip_port), FALSE);
 #endif /* TRANSIT_EEE */
+
+#if TRANSIT_IGMP_SNOOPING
+    ipmc_port_down(chip_port);
+#endif /* TRANSIT_IGMP_SNOOPING */
 }
 
 
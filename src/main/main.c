@@ -54,10 +54,38 @@
 #include "h2aggr.h"
 #endif /* TRANSIT_LAG */
 
+#if TRANSIT_VLAN
+#include "h2vlan.h"
+#endif /* TRANSIT_VLAN */
+
+#if TRANSIT_STORM_CONTROL
+#include "h2storm.h"
+#endif /* TRANSIT_STORM_CONTROL */
+
+#if TRANSIT_MIRROR
+#include "h2mirror.h"
+#endif /* TRANSIT_MIRROR */
+
+#if TRANSIT_QOS
+#include "h2qos.h"
+#endif /* TRANSIT_QOS */
+
+#if TRANSIT_BUF_PROFILE
+#include "h2buf.h"
+#endif /* TRANSIT_BUF_PROFILE */
+
 #if TRANSIT_LOOPDETECT
 #include "loopdet.h"
 #endif
 
+#if TRANSIT_IGMP_SNOOPING
+#include "ipmc_snoop.h"
+#endif
+
+#if TRANSIT_SFLOW
+#include "h2sflow.h"
+#endif /* TRANSIT_SFLOW */
+
 #if TRANSIT_POE
 #include "poetsk.h"
 #endif /* TRANSIT_POE */
@@ -162,8 +190,8 @@ static void error_check (void)
 #if defined(HW_TEST_UART)
 void sleep_ms(u32 ms)
 {
-  /* Set the timer value (the default timer ticks every 100 us) */
-  H2_WRITE(VTSS_ICPU_CFG_TIMERS_TIMER_VALUE(0), ms * 10);
+  /* Set the timer value (see TIMER_TICKS_PER_MSEC) */
+  H2_WRITE(VTSS_ICPU_CFG_TIMERS_TIMER_VALUE(0), ms * TIMER_TICKS_PER_MSEC);
 
   /* Enable timer 0 for one-shot */
   H2_WRITE(VTSS_ICPU_CFG_TIMERS_TIMER_CTRL(0),
@@ -308,10 +336,6 @@ static void handle_timeout_event_10ms(void)
             TASK(TASK_ID_LACP_TIMER, lacp_timer_check());
 #endif /* TRANSIT_LACP */
 
-#if (WATCHDOG_PRESENT && WATCHDOG_ENABLE)
-    TASK(TASK_ID_WATCHDOG, kick_watchdog());
-#endif
-
     // Clear event flag
     ms_10_timeout_flag = 0;
 }
@@ -334,6 +358,10 @@ static void handle_timeout_event_100ms(void)
     TASK(TASK_ID_EEE, eee_mgmt());
 #endif
 
+#if TRANSIT_SPI_FLASH_MANIFEST
+    TASK(TASK_ID_FLASH_VERIFY, flash_verify_tsk());
+#endif
+
     // Clear event flag
     ms_100_timeout_flag = 0;
 }
@@ -344,7 +372,7 @@ static void handle_timeout_event_1sec(void)
         return;
     }
 
-#if FRONT_LED_PRESENT
+#if FRONT_LED_PRESENT && !TRANSIT_TIMER_WHEEL
     led_1s_timer();
 #endif
 
@@ -377,6 +405,10 @@ static void handle_timeout_event_1sec(void)
      ldet_aging_1s();
 #endif
 
+#if TRANSIT_IGMP_SNOOPING
+    ipmc_aging_1s();
+#endif
+
     /* toggle any alive LED */
     ALIVE_LED_TOGGLE;
 
@@ -385,6 +417,36 @@ static void handle_timeout_event_1sec(void)
     up_time++;
 }
 
+#if TRANSIT_TIMER_WHEEL
+static void handle_timer_wheel(void)
+{
+    uchar id;
+
+    // Dispatch the expired timers to their modules
+    while ((id = tmr_expired_get()) != TMR_ID_NONE) {
+        switch (id) {
+#if FRONT_LED_PRESENT
+        case TMR_ID_LED_BLINK:
+            led_1s_timer();
+            break;
+#endif
+#if TRANSIT_LOOPDETECT
+        case TMR_ID_LDET_AGING:
+            ldet_aging_expired();
+            break;
+#endif
+#if TRANSIT_LLDP
+        case TMR_ID_LLDP_REMOTE:
+            lldp_remote_timer_expired();
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+}
+#endif /* TRANSIT_TIMER_WHEEL */
+
 /*****************************************************************************
  *
  *
@@ -567,8 +629,25 @@ void main (void)
      */
     phy_hw_init();  // Initializes the internal PHY by releasing resets.
 
+#if TRANSIT_BUF_PROFILE
+    // Queue system watermarks, before any port is enabled
+    h2_buf_init();
+#endif /* TRANSIT_BUF_PROFILE */
+
     // Initialize hardware L2 port features
     h2_init_ports();
+#if TRANSIT_VLAN
+    h2_vlan_init();
+#endif /* TRANSIT_VLAN */
+#if TRANSIT_STORM_CONTROL
+    h2_storm_init();
+#endif /* TRANSIT_STORM_CONTROL */
+#if TRANSIT_MIRROR
+    h2_mirror_init();
+#endif /* TRANSIT_MIRROR */
+#if TRANSIT_QOS
+    h2_qos_init();
+#endif /* TRANSIT_QOS */
 
     /*
      * Initialize and check PHYs, hang the system if chek not passed.
@@ -601,6 +680,14 @@ void main (void)
     lldp_init();
 #endif /* TRANSIT_LLDP */
 
+#if TRANSIT_IGMP_SNOOPING
+    ipmc_init();
+#endif /* TRANSIT_IGMP_SNOOPING */
+
+#if TRANSIT_SFLOW
+    h2_sflow_init();
+#endif /* TRANSIT_SFLOW */
+
 #if TRANSIT_LACP || TRANSIT_RSTP
     vtss_os_init();
 #endif /* TRANSIT_LACP || TRANSIT_RSTP */
@@ -714,6 +801,11 @@ void main (void)
         // Handle 1 second timeout event
         handle_timeout_event_1sec();
 
+#if TRANSIT_TIMER_WHEEL
+        // Handle expired timers
+        handle_timer_wheel();
+#endif
+
         /* For profiling/debug purposes */
         MAIN_LOOP_EXIT();
 
@@ -10,6 +10,13 @@
 #include "sysutil.h"
 #include "timer.h"
 #include "h2.h"
+#if TRANSIT_UART_TX_RING
+#include "uartdrv.h"
+#endif
+#if TRANSIT_TASK_PROFILE
+#include <string.h>
+#include "taskdef.h"
+#endif
 
 #if !defined(NO_DEBUG_IF)
 #include "print.h"
@@ -24,6 +31,22 @@
  *
  ****************************************************************************/
 
+/*****************************************************************************
+ *
+ *
+ * Typedefs and enums
+ *
+ *
+ ****************************************************************************/
+
+#if TRANSIT_TASK_PROFILE
+typedef struct {
+    ulong   total_us;   // Saturates at 0xFFFFFFFF
+    ulong   max_us;
+    ushort  calls;      // Saturates at 0xFFFF
+} task_prof_t;
+#endif // TRANSIT_TASK_PROFILE
+
 /*****************************************************************************
  *
  *
@@ -35,6 +58,11 @@
 static BOOL g_suspend_enable = FALSE;
 static sys_assert_event_t sys_assert_event = SYS_ASSERT_EVENT_OK;
 
+#if TRANSIT_TASK_PROFILE
+static task_prof_t task_prof[TOT_NUM_TASKS];
+static ulong       task_prof_loop_start;
+#endif // TRANSIT_TASK_PROFILE
+
 /*****************************************************************************
  *
  *
@@ -43,6 +71,21 @@ static sys_assert_event_t sys_assert_event = SYS_ASSERT_EVENT_OK;
  *
  ****************************************************************************/
 
+#if TRANSIT_TASK_PROFILE
+/* Print value right adjusted in a width-char field */
+static void task_prof_print_col (ulong value, uchar width)
+{
+    ulong v;
+    uchar digits = 1;
+
+    for (v = value; v > 9; v /= 10) {
+        digits++;
+    }
+    print_spaces(width > digits ? width - digits : 0);
+    print_dec(value);
+}
+#endif // TRANSIT_TASK_PROFILE
+
 
 /*****************************************************************************
  *
@@ -58,6 +101,10 @@ static sys_assert_event_t sys_assert_event = SYS_ASSERT_EVENT_OK;
  */
 void sysutil_reboot(void)
 {
+#if TRANSIT_UART_TX_RING
+    /* Send the queued console output before the reset */
+    uart_tx_flush();
+#endif
     MMAP = 0xAF;
     h2_chip_reset();
     while (1) ;
@@ -111,6 +158,75 @@ BOOL sysutil_get_suspend(void)
     return g_suspend_enable;
 }
 
+#if TRANSIT_TASK_PROFILE
+/**
+ * Account one run of a task which started at start_us, see TASK().
+ */
+void task_prof_add(uchar task_id, ulong start_us)
+{
+    task_prof_t *prof = &task_prof[task_id];
+    ulong       us = elapsed_us(start_us);
+
+    if (prof->total_us + us < prof->total_us) {
+        prof->total_us = 0xFFFFFFFF;
+    } else {
+        prof->total_us += us;
+    }
+    if (us > prof->max_us) {
+        prof->max_us = us;
+    }
+    if (prof->calls != 0xFFFF) {
+        prof->calls++;
+    }
+}
+
+/**
+ * Start timing a main loop iteration. The idle time waiting for the next
+ * interrupt is not included.
+ */
+void task_prof_loop_enter(void)
+{
+    task_prof_loop_start = us_clock_get();
+}
+
+void task_prof_loop_exit(void)
+{
+    task_prof_add(TASK_ID_MAIN, task_prof_loop_start);
+}
+
+void task_prof_clear(void)
+{
+    memset(task_prof, 0, sizeof(task_prof));
+}
+
+/**
+ * Show the run time per task since the last clear.
+ */
+void task_prof_print(void)
+{
+    task_prof_t *prof;
+    uchar       task_id;
+
+    println_str("Task      Calls  Total (us)    Avg (us)    Max (us)");
+    for (task_id = 0; task_id < TOT_NUM_TASKS; task_id++) {
+        prof = &task_prof[task_id];
+        if (prof->calls == 0) {
+            continue;
+        }
+        if (task_id == TASK_ID_MAIN) {
+            print_str("loop");
+        } else {
+            task_prof_print_col(task_id, 4);
+        }
+        task_prof_print_col(prof->calls, 11);
+        task_prof_print_col(prof->total_us, 12);
+        task_prof_print_col(prof->total_us / prof->calls, 12);
+        task_prof_print_col(prof->max_us, 12);
+        print_cr_lf();
+    }
+}
+#endif // TRANSIT_TASK_PROFILE
+
 void sysutil_show_compile_date(void)
 {
     print_str("Build Date      : ");
@@ -23,9 +23,6 @@ typedef enum {
     TASK_ID_WEB_TIMER,
 
     TASK_ID_ERROR_CHECK,
-#if (WATCHDOG_PRESENT && WATCHDOG_ENABLE)
-    TASK_ID_WATCHDOG,
-#endif
 #if TRANSIT_EEE
     TASK_ID_EEE,
 #endif
@@ -51,6 +48,10 @@ typedef enum {
     TASK_ID_MAILBOX_COMM,
 #endif // TRANSIT_MAILBOX_COMM
 
+#if TRANSIT_SPI_FLASH_MANIFEST
+    TASK_ID_FLASH_VERIFY,
+#endif // TRANSIT_SPI_FLASH_MANIFEST
+
     TASK_ID_TIMER_SINCE_BOOT,
 
     NUM_TASKS
@@ -69,13 +70,61 @@ typedef enum {
 #if TRANSIT_LACP
     SUB_TASK_ID_LACP_RX,
     SUB_TASK_ID_LACP_LINK,
+#endif
+#if TRANSIT_IGMP_SNOOPING
+    SUB_TASK_ID_IPMC_RX,
+#endif
+#if TRANSIT_SFLOW
+    SUB_TASK_ID_SFLOW_RX,
 #endif
     TOT_NUM_TASKS
 } sub_task_id_t;
 
-#define TASK(TASK_ID,EXPR)     EXPR
+#if TRANSIT_TASK_WDT
+/* Task watchdog: the running task and the 100 msec ticks it has been running
+ * without returning or calling WDT_TASK_ALIVE(), see wdt_tick() */
+extern data uchar wdt_task;
+extern data uchar wdt_task_ticks;
+
+#define TASK_WDT_DECL          uchar wdt_task_prev = wdt_task;
+#define TASK_WDT_ENTER(TASK_ID) wdt_task = TASK_ID; wdt_task_ticks = 0;
+#define TASK_WDT_EXIT()        wdt_task = wdt_task_prev; wdt_task_ticks = 0;
+#define WDT_TASK_ALIVE()       { wdt_task_ticks = 0; }
+#else
+#define TASK_WDT_DECL
+#define TASK_WDT_ENTER(TASK_ID)
+#define TASK_WDT_EXIT()
+#define WDT_TASK_ALIVE()       {}
+#endif /* TRANSIT_TASK_WDT */
+
+#if TRANSIT_TASK_PROFILE
+#include "timer.h"
+
+/* Task profiling, implemented in sysutil.c. The time of a task includes
+ * the sub tasks it calls. TASK_ID_MAIN holds the main loop iterations. */
+void task_prof_add        (uchar task_id, ulong start_us);
+void task_prof_loop_enter (void);
+void task_prof_loop_exit  (void);
+void task_prof_clear      (void);
+void task_prof_print      (void);
+
+#define TASK_PROF_DECL         ulong task_prof_start = us_clock_get();
+#define TASK_PROF_EXIT(TASK_ID) task_prof_add(TASK_ID, task_prof_start);
+#define MAIN_LOOP_ENTER()      task_prof_loop_enter()
+#define MAIN_LOOP_EXIT()       task_prof_loop_exit()
+#else
+#define TASK_PROF_DECL
+#define TASK_PROF_EXIT(TASK_ID)
 #define MAIN_LOOP_ENTER()      {}
 #define MAIN_LOOP_EXIT()       {}
+#endif /* TRANSIT_TASK_PROFILE */
+
+#if TRANSIT_TASK_WDT || TRANSIT_TASK_PROFILE
+#define TASK(TASK_ID,EXPR)     { TASK_WDT_DECL TASK_PROF_DECL TASK_WDT_ENTER(TASK_ID) \
+                                 EXPR; TASK_PROF_EXIT(TASK_ID) TASK_WDT_EXIT() }
+#else
+#define TASK(TASK_ID,EXPR)     EXPR
+#endif
 
 #endif /* __TASKDEF_H__ */
 
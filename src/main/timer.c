@@ -7,6 +7,12 @@
 #include "vtss_api_base_regs.h"
 #include "h2io.h"
 #include "timer.h"
+#if TRANSIT_TASK_WDT
+#include "hwport.h"
+#endif
+#if TRANSIT_TIMER_WHEEL
+#include "string.h"
+#endif /* TRANSIT_TIMER_WHEEL */
 #if defined(VTSS_ARCH_OCELOT)
 #include "misc2.h"
 #endif // VTSS_ARCH_OCELOT
@@ -36,6 +42,21 @@ bit     sec_1_timeout_flag  = 0;
  *
  ****************************************************************************/
 
+#if TRANSIT_TIMER_WHEEL
+/*
+ * The wheel has TMR_WHEEL_LEVELS levels of TMR_WHEEL_SLOTS slots. A slot on
+ * level n covers 16^n ticks of 10 msec, so the levels reach 160 msec,
+ * 2.56 sec, 41 sec and 655 sec ahead. A timer sits on the lowest level
+ * which reaches its expiry and moves one level down each time the slot
+ * comes around (cascading), so a tick only visits the timers which are
+ * due or cascade.
+ */
+#define TMR_WHEEL_BITS      4
+#define TMR_WHEEL_SLOTS     (1 << TMR_WHEEL_BITS)
+#define TMR_WHEEL_LEVELS    4
+#define TMR_NIL             0xFF
+#endif /* TRANSIT_TIMER_WHEEL */
+
 /*****************************************************************************
  *
  *
@@ -45,6 +66,18 @@ bit     sec_1_timeout_flag  = 0;
  *
  ****************************************************************************/
 
+#if TRANSIT_TIMER_WHEEL
+typedef struct {
+    ushort  expire;     /* Tick of tmr_now where the timer runs out */
+    ushort  period;     /* 0 for one-shot timers */
+    uchar   slot;       /* Level * TMR_WHEEL_SLOTS + slot */
+    uchar   next;       /* Next in slot */
+    uchar   exp_next;   /* Next in expired queue */
+    uchar   running;
+    uchar   pending;    /* Expired, but not returned by tmr_expired_get() yet */
+} tmr_t;
+#endif /* TRANSIT_TIMER_WHEEL */
+
 /*****************************************************************************
  *
  *
@@ -65,8 +98,16 @@ bit     sec_1_timeout_flag  = 0;
  ****************************************************************************/
 
 static uchar                data timer_count        = 0;
+static uchar                data delay_count        = 0;
+
+#if TRANSIT_US_CLOCK
+/* Bits 16-31 of the msec count, tick_count is bits 0-15 */
+static ushort               data tick_wraps         = 0;
+static ulong xdata          us_last                 = 0;
+#endif /* TRANSIT_US_CLOCK */
 
 static bit                  sw_timer_active_flag    = FALSE;
+static bit                  delay_active_flag       = FALSE;
 static bit                  ms_1_timeout_flag       = FALSE;
 
 static ulong xdata          time_since_boot_t       = 0;
@@ -75,6 +116,17 @@ static ulong xdata          time_since_boot_t       = 0;
 static struct timeb xdata   t_now;
 #endif /* TRANSIT_FTIME */
 
+#if TRANSIT_TIMER_WHEEL
+/* 10 msec ticks not yet run by the wheel, counted by the interrupt */
+static uchar                data tmr_ticks_pending  = 0;
+static ushort xdata         tmr_now                 = 0;
+static uchar xdata          tmr_slot_head[TMR_WHEEL_LEVELS * TMR_WHEEL_SLOTS];
+static uchar xdata          tmr_exp_head            = TMR_NIL;
+static uchar xdata          tmr_exp_tail;
+static tmr_t xdata          tmr[TMR_ID_CNT];
+static bit                  tmr_init_done           = FALSE;
+#endif /* TRANSIT_TIMER_WHEEL */
+
 /*****************************************************************************
  *
  *
@@ -102,6 +154,83 @@ static void _time_carry()
 }
 #endif /* TRANSIT_FTIME */
 
+#if TRANSIT_TIMER_WHEEL
+/* Put timer id in the slot of the lowest level which reaches its expiry */
+static void tmr_link (uchar id)
+{
+    ushort delta = tmr[id].expire - tmr_now;
+    uchar  level = 0;
+
+    while (level < TMR_WHEEL_LEVELS - 1 && (delta >> (TMR_WHEEL_BITS * (level + 1))) != 0) {
+        level++;
+    }
+
+    tmr[id].slot = level * TMR_WHEEL_SLOTS +
+                   ((tmr[id].expire >> (TMR_WHEEL_BITS * level)) & (TMR_WHEEL_SLOTS - 1));
+    tmr[id].next = tmr_slot_head[tmr[id].slot];
+    tmr_slot_head[tmr[id].slot] = id;
+}
+
+static void tmr_unlink (uchar id)
+{
+    uchar xdata *p = &tmr_slot_head[tmr[id].slot];
+
+    while (*p != id) {
+        p = &tmr[*p].next;
+    }
+    *p = tmr[id].next;
+}
+
+/* Run the wheel one tick: cascade the higher levels, then expire level 0 */
+static void tmr_tick (void)
+{
+    uchar level, slot, id, next;
+
+    tmr_now++;
+
+    /* Top down, so timers cascading two levels are moved on in the same tick */
+    for (level = TMR_WHEEL_LEVELS - 1; level > 0; level--) {
+        if (tmr_now & ((1 << (TMR_WHEEL_BITS * level)) - 1)) {
+            continue;
+        }
+        slot = level * TMR_WHEEL_SLOTS +
+               ((tmr_now >> (TMR_WHEEL_BITS * level)) & (TMR_WHEEL_SLOTS - 1));
+        id = tmr_slot_head[slot];
+        tmr_slot_head[slot] = TMR_NIL;
+        for (; id != TMR_NIL; id = next) {
+            next = tmr[id].next;
+            tmr_link(id);
+        }
+    }
+
+    slot = tmr_now & (TMR_WHEEL_SLOTS - 1);
+    id = tmr_slot_head[slot];
+    tmr_slot_head[slot] = TMR_NIL;
+    for (; id != TMR_NIL; id = next) {
+        next = tmr[id].next;
+        if (tmr[id].period) {
+            tmr[id].expire += tmr[id].period;
+            tmr_link(id);
+        } else {
+            tmr[id].running = FALSE;
+        }
+
+        /*
+         * The wheel only ticks when the queue is empty, so a timer is never
+         * queued twice
+         */
+        tmr[id].pending  = TRUE;
+        tmr[id].exp_next = TMR_NIL;
+        if (tmr_exp_head == TMR_NIL) {
+            tmr_exp_head = id;
+        } else {
+            tmr[tmr_exp_tail].exp_next = id;
+        }
+        tmr_exp_tail = id;
+    }
+}
+#endif /* TRANSIT_TIMER_WHEEL */
+
 /*****************************************************************************
  *
  *
@@ -127,10 +256,20 @@ void timer_1_init (void) small
      * before the interrupt mechanism is ready
      */
 
+#if TRANSIT_US_CLOCK
+    /*
+     * Divide the timer tick down from 100 us (the reset value of the
+     * divider) to 1 us, so TIMER_VALUE of timer 1 gives the usec within the
+     * msec. Timer 0 and 2 are not used with this tick.
+     */
+    h2_write(VTSS_ICPU_CFG_TIMERS_TIMER_TICK_DIV,
+             (h2_read(VTSS_ICPU_CFG_TIMERS_TIMER_TICK_DIV) + 1) / 100 - 1);
+#endif /* TRANSIT_US_CLOCK */
+
     /* Wrap out every 1ms */
-    h2_write(VTSS_ICPU_CFG_TIMERS_TIMER_RELOAD_VALUE(TIMER_1), 0x9);
+    h2_write(VTSS_ICPU_CFG_TIMERS_TIMER_RELOAD_VALUE(TIMER_1), TIMER_TICKS_PER_MSEC - 1);
 
-#if defined(VTSS_ARCH_OCELOT)
+#if defined(VTSS_ARCH_OCELOT)
 
     /* Output to iCPU_IRQ0 */
     h2_write_masked(VTSS_ICPU_CFG_INTR_DST_INTR_MAP(0),
@@ -179,7 +318,13 @@ void timer_1_interrupt (void) small
     _time_carry();
 #endif /* TRANSIT_FTIME */
 
+#if TRANSIT_US_CLOCK
+    if (++tick_count == 0) {
+        tick_wraps++;
+    }
+#else
     tick_count++;
+#endif /* TRANSIT_US_CLOCK */
     ms_1_timeout_flag = TRUE;
 
     if (--ms_1_count == 0) {
@@ -195,18 +340,37 @@ void timer_1_interrupt (void) small
             /* If 100 ms elapsed, request 100 ms jobs to be done */
             ms_100_timeout_flag = TRUE;
 
+#if TRANSIT_TASK_WDT
+            /* Check the task deadline and kick the watchdog */
+            wdt_tick();
+#endif /* TRANSIT_TASK_WDT */
+
             if (--ms_100_count == 0) {
                 ms_100_count = 10;
                 sec_1_timeout_flag = TRUE;
             }
         }
 
-        /* If the delay/timeout timer is active, tick it */
+        /* If the timeout timer is active, tick it */
         if (sw_timer_active_flag) {
             if (--timer_count == 0) {
                 sw_timer_active_flag = FALSE;
             }
         }
+
+        /* If the delay timer is active, tick it */
+        if (delay_active_flag) {
+            if (--delay_count == 0) {
+                delay_active_flag = FALSE;
+            }
+        }
+
+#if TRANSIT_TIMER_WHEEL
+        /* The wheel itself is run by tmr_expired_get() in the main loop */
+        if (tmr_ticks_pending != 0xFF) {
+            tmr_ticks_pending++;
+        }
+#endif /* TRANSIT_TIMER_WHEEL */
     }
 }
 
@@ -218,19 +382,19 @@ void timer_1_interrupt (void) small
  * synchronization with the HW timer, so the actual delay may be +/- 10 msec
  * (so specifying 1 (= 10 msec) may result in almost no delay at all).
  *
- * @note May only be called when interrupt is enabled. Can not be used
- *       simultaneously with start_timer/timeout mechanism.
+ * @note May only be called when interrupt is enabled. Has its own counter,
+ *       so it may be used inside a start_timer/timeout loop.
  */
 #if !defined(BRINGUP)
 void delay (uchar delay_in_10_msec) small
 {
     /* set timer value to be ticked by interrupt function */
-    sw_timer_active_flag = FALSE;
-    timer_count = delay_in_10_msec;
-    sw_timer_active_flag = TRUE;
+    delay_active_flag = FALSE;
+    delay_count = delay_in_10_msec;
+    delay_active_flag = TRUE;
 
     /* Await that time has elapsed */
-    while (sw_timer_active_flag) {
+    while (delay_active_flag) {
         /* do nothing but wait */
     }
 }
@@ -296,6 +460,155 @@ bool timeout (void) small
 }
 
 
+#if TRANSIT_US_CLOCK
+/**
+ * Read the usec clock. It counts from boot and wraps after 71 minutes.
+ *
+ * Interrupts are only disabled while the timer register is read. The msec
+ * count is read before and after the timer and the reading is repeated if
+ * the timer interrupt came in between.
+ *
+ * @note Only to be called from the main loop, not from interrupts.
+ *
+ * @see elapsed_us
+ */
+ulong us_clock_get (void)
+{
+    ushort  ms_lo, ms_hi;
+    ulong   val;
+    ulong   now;
+
+    do {
+        ms_hi = tick_wraps;
+        ms_lo = tick_count;
+        H2_READ(VTSS_ICPU_CFG_TIMERS_TIMER_VALUE(TIMER_1), val);
+    } while (ms_lo != tick_count || ms_hi != tick_wraps);
+
+    now = ((((ulong) ms_hi << 16) | ms_lo) * 1000) + (TIMER_TICKS_PER_MSEC - 1 - val);
+
+    /*
+     * The timer may have reloaded while the interrupt is still on its way,
+     * so the msec count is one behind: keep the clock monotonic
+     */
+    if ((long) (now - us_last) < 0) {
+        now += 1000;
+    }
+    us_last = now;
+
+    return now;
+}
+
+
+/**
+ * @return  usec since start_us, which was read with us_clock_get().
+ */
+ulong elapsed_us (ulong start_us)
+{
+    return us_clock_get() - start_us;
+}
+#endif /* TRANSIT_US_CLOCK */
+
+
+#if TRANSIT_TIMER_WHEEL
+/**
+ * Start timer id on the timer wheel, or restart it if it is running. An
+ * expiry which has not been returned by tmr_expired_get() yet is dropped.
+ *
+ * time_in_10_msec is the time to the first expiry (at least 1 tick, at most
+ * 0xFF00 ticks), period_in_10_msec the time between the following expiries
+ * of a periodic timer or 0 for a one-shot timer.
+ *
+ * @see tmr_expired_get
+ */
+void tmr_start (uchar id, ushort time_in_10_msec, ushort period_in_10_msec)
+{
+    if (!tmr_init_done) {
+        memset(tmr_slot_head, TMR_NIL, sizeof(tmr_slot_head));
+        memset(tmr, 0, sizeof(tmr));
+        tmr_init_done = TRUE;
+    }
+
+    if (tmr[id].running) {
+        tmr_unlink(id);
+    }
+    if (time_in_10_msec == 0) {
+        time_in_10_msec = 1;
+    }
+
+    /* Count from now, not from where the wheel has come to */
+    tmr[id].expire  = tmr_now + tmr_ticks_pending + time_in_10_msec;
+    tmr[id].period  = period_in_10_msec;
+    tmr[id].running = TRUE;
+    tmr[id].pending = FALSE;
+    tmr_link(id);
+}
+
+
+/**
+ * Stop timer id and drop an expiry not returned by tmr_expired_get() yet.
+ */
+void tmr_stop (uchar id)
+{
+    if (!tmr_init_done) {
+        return;
+    }
+    if (tmr[id].running) {
+        tmr_unlink(id);
+        tmr[id].running = FALSE;
+    }
+    tmr[id].pending = FALSE;
+}
+
+
+/**
+ * @return  TRUE, if timer id is running (periodic timers always are).
+ */
+bool tmr_active (uchar id)
+{
+    return tmr_init_done && tmr[id].running;
+}
+
+
+/**
+ * Run the wheel up to now and return the next expired timer. To be called
+ * from the main loop until it returns TMR_ID_NONE, the caller dispatches
+ * the timers to their modules.
+ *
+ * @return  The id of an expired timer, or TMR_ID_NONE.
+ */
+uchar tmr_expired_get (void)
+{
+    uchar id;
+
+    if (!tmr_init_done) {
+        tmr_ticks_pending = 0;
+        return TMR_ID_NONE;
+    }
+
+    for (;;) {
+        if (tmr_exp_head == TMR_NIL) {
+            if (tmr_ticks_pending == 0) {
+                return TMR_ID_NONE;
+            }
+            /* Single DEC instruction, the interrupt only increments */
+            tmr_ticks_pending--;
+            tmr_tick();
+            continue;
+        }
+
+        id = tmr_exp_head;
+        tmr_exp_head = tmr[id].exp_next;
+
+        /* Skip timers stopped or restarted after they expired */
+        if (tmr[id].pending) {
+            tmr[id].pending = FALSE;
+            return id;
+        }
+    }
+}
+#endif /* TRANSIT_TIMER_WHEEL */
+
+
 #if TRANSIT_LLDP
 void time_since_boot_update (void)
 {
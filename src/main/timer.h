@@ -19,6 +19,13 @@
 #define TIMER_1	 	1
 #define TIMER_2		2
 
+/* Ticks of the ICPU_CFG timers per msec, see timer_1_init() */
+#if TRANSIT_US_CLOCK
+#define TIMER_TICKS_PER_MSEC    1000    /* 1 us timer tick */
+#else
+#define TIMER_TICKS_PER_MSEC    10      /* 100 us timer tick, the chip default */
+#endif
+
 /* Some frequently used timer values in granularity of 10 msec */
 #define MSEC_20     2
 #define MSEC_30     3
@@ -43,6 +50,24 @@
 
 typedef unsigned long time_t;
 
+#if TRANSIT_TIMER_WHEEL
+/* Timers on the timer wheel, see tmr_start() */
+typedef enum {
+#if FRONT_LED_PRESENT
+    TMR_ID_LED_BLINK,
+#endif
+#if TRANSIT_LOOPDETECT
+    TMR_ID_LDET_AGING,
+#endif
+#if TRANSIT_LLDP
+    TMR_ID_LLDP_REMOTE,
+#endif
+    TMR_ID_CNT
+} tmr_id_t;
+
+#define TMR_ID_NONE 0xFF
+#endif /* TRANSIT_TIMER_WHEEL */
+
 /****************************************************************************
  *
  *
@@ -84,6 +109,18 @@ void    delay_1                 (uchar delay_in_1_msec) small;
 void    start_timer             (uchar time_in_10_msec) small;
 bool    timeout                 (void) small;
 
+#if TRANSIT_US_CLOCK
+ulong   us_clock_get            (void);
+ulong   elapsed_us              (ulong start_us);
+#endif /* TRANSIT_US_CLOCK */
+
+#if TRANSIT_TIMER_WHEEL
+void    tmr_start               (uchar id, ushort time_in_10_msec, ushort period_in_10_msec);
+void    tmr_stop                (uchar id);
+bool    tmr_active              (uchar id);
+uchar   tmr_expired_get         (void);
+#endif /* TRANSIT_TIMER_WHEEL */
+
 #if TRANSIT_LLDP
 void    time_since_boot_update  (void);
 ulong   time_since_boot_ticks   (void);
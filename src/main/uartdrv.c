@@ -25,6 +25,10 @@
 
 bit uart_rx_buf_overrun = FALSE;
 
+#if TRANSIT_UART_TX_RING && (UART_TX_OVERFLOW_MODE == UART_TX_OVERFLOW_COUNT)
+ulong uart_tx_drop_cnt = 0;
+#endif
+
 /*****************************************************************************
  *
  *
@@ -46,6 +50,26 @@ bit uart_rx_buf_overrun = FALSE;
 /* size of receive buffer. Must be a power of 2, i.e. 2, 4, 8 ... 256 */
 #define RX_BUF_SIZE 32
 
+#if TRANSIT_UART_TX_RING
+/* size of transmit ring. 256, so the uchar indexes wrap by themselves */
+#define TX_BUF_SIZE 256
+
+/* Bytes written per transmit interrupt, the depth of the TX FIFO */
+#define TX_FIFO_SIZE 16
+
+#if defined(VTSS_ARCH_OCELOT)
+#define UART_REG_THR    VTSS_UART_UART_RBR_THR(VTSS_TO_UART)
+#define UART_REG_IER    VTSS_UART_UART_IER(VTSS_TO_UART)
+#define UART_REG_LSR    VTSS_UART_UART_LSR(VTSS_TO_UART)
+#define UART_IER_ETBEI  VTSS_M_UART_UART_IER_ETBEI
+#elif defined(VTSS_ARCH_LUTON26)
+#define UART_REG_THR    VTSS_UART_UART_RBR_THR
+#define UART_REG_IER    VTSS_UART_UART_IER
+#define UART_REG_LSR    VTSS_UART_UART_LSR
+#define UART_IER_ETBEI  VTSS_F_UART_UART_IER_ETBEI
+#endif // VTSS_ARCH_OCELOT
+#endif // TRANSIT_UART_TX_RING
+
 
 /*****************************************************************************
  *
@@ -85,6 +109,13 @@ static uchar data rx_tail  = 0;
 #endif /* RX_BUF_SIZE > 256 */
 
 
+#if TRANSIT_UART_TX_RING
+static uchar xdata tx_buf [TX_BUF_SIZE];
+static uchar data tx_head = 0;              // Next free entry
+static volatile uchar data tx_tail = 0;     // Next byte to send, moved by the interrupt
+static bit tx_active = FALSE;               // Transmit interrupt enabled
+#endif // TRANSIT_UART_TX_RING
+
 static data uchar xdata *redir_ptr = 0;
 
 /* ************************************************************************ */
@@ -211,6 +242,19 @@ void uart_interrupt (void) small
             temp = h2_read(VTSS_UART_UART_LSR(VTSS_TO_UART));
         } while (test_bit_32(0, &temp));
     }
+#if TRANSIT_UART_TX_RING
+    else if (temp == IIR_TX_EMPTY) {
+        /* TX FIFO empty, refill it from the ring */
+        for (ch = 0; ch < TX_FIFO_SIZE && tx_tail != tx_head; ch++) {
+            h2_write(UART_REG_THR, tx_buf[tx_tail]);
+            tx_tail++;
+        }
+        if (tx_tail == tx_head) {
+            h2_write_masked(UART_REG_IER, 0, UART_IER_ETBEI);
+            tx_active = FALSE;
+        }
+    }
+#endif // TRANSIT_UART_TX_RING
     EA = 1;
 
 #elif defined(VTSS_ARCH_LUTON26)
@@ -246,6 +290,19 @@ void uart_interrupt (void) small
             //} while (temp & lsr_dr_mask);
         } while (test_bit_32(0, &temp));
     }
+#if TRANSIT_UART_TX_RING
+    else if (temp == IIR_TX_EMPTY) {
+        /* TX FIFO empty, refill it from the ring */
+        for (ch = 0; ch < TX_FIFO_SIZE && tx_tail != tx_head; ch++) {
+            h2_write(UART_REG_THR, tx_buf[tx_tail]);
+            tx_tail++;
+        }
+        if (tx_tail == tx_head) {
+            h2_write_masked(UART_REG_IER, 0, UART_IER_ETBEI);
+            tx_active = FALSE;
+        }
+    }
+#endif // TRANSIT_UART_TX_RING
     EA = 1;
 #endif // VTSS_ARCH_OCELOT
 }
@@ -280,16 +337,79 @@ uchar uart_get_byte (void) small
     return tmp;
 }
 
+#if TRANSIT_UART_TX_RING
+/* ************************************************************************ */
+static void uart_tx_poll (void) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Move a burst from the ring to the TX FIFO without interrupt.
+ * Remarks     : Only used while the UART interrupt is disabled (EX1 = 0),
+ *               so it never runs concurrently with uart_interrupt().
+ * Restrictions:
+ * See also    : uart_interrupt
+ * Example     :
+ ****************************************************************************/
+{
+    ulong lsr;
+    uchar cnt;
+
+    H2_READ(UART_REG_LSR, lsr);
+    if (!test_bit_32(5, &lsr)) {
+        return; // TX FIFO not empty yet
+    }
+    for (cnt = 0; cnt < TX_FIFO_SIZE && tx_tail != tx_head; cnt++) {
+        H2_WRITE(UART_REG_THR, tx_buf[tx_tail]);
+        tx_tail++;
+    }
+}
+#endif // TRANSIT_UART_TX_RING
+
+/* ************************************************************************ */
 void uart_put_byte (uchar ch) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Send a char.
+ * Remarks     : With TRANSIT_UART_TX_RING the char is queued and sent by the
+ *               transmit interrupt. UART_TX_OVERFLOW_MODE selects what is
+ *               done when the ring is full.
+ * Restrictions:
+ * See also    : uart_tx_flush
+ * Example     :
+ ****************************************************************************/
 {
+#if !TRANSIT_UART_TX_RING
     ulong lsr;
+#endif
 
     if(redir_ptr != 0) {
         *redir_ptr++ = ch;
         return;
     }
 
-#if defined(VTSS_ARCH_OCELOT)
+#if TRANSIT_UART_TX_RING
+    while ((uchar) (tx_head + 1) == tx_tail) {
+#if UART_TX_OVERFLOW_MODE == UART_TX_OVERFLOW_BLOCK
+        /* Wait for the interrupt to make room */
+        if (!EX1) {
+            uart_tx_poll();
+        }
+#elif UART_TX_OVERFLOW_MODE == UART_TX_OVERFLOW_COUNT
+        uart_tx_drop_cnt++;
+        return;
+#else
+        return;
+#endif // UART_TX_OVERFLOW_MODE
+    }
+
+    tx_buf[tx_head] = ch;
+    EA = 0;
+    tx_head++;
+    if (!tx_active) {
+        /* Raises the transmit interrupt at once when the FIFO is empty */
+        tx_active = TRUE;
+        h2_write_masked(UART_REG_IER, UART_IER_ETBEI, UART_IER_ETBEI);
+    }
+    EA = 1;
+
+#elif defined(VTSS_ARCH_OCELOT)
     do {
         /* Wait TX FIFO be empty */
         H2_READ(VTSS_UART_UART_LSR(VTSS_TO_UART), lsr);
@@ -304,8 +424,127 @@ void uart_put_byte (uchar ch) small
     } while(!test_bit_32(6, &lsr));
 
     H2_WRITE(VTSS_UART_UART_RBR_THR, ch);
+#endif // TRANSIT_UART_TX_RING
+}
+
+#if TRANSIT_UART_TX_RING
+/* ************************************************************************ */
+uchar uart_tx_room (void) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the number of bytes which can be queued without waiting.
+ * Remarks     :
+ * Restrictions:
+ * See also    : uart_put_byte
+ * Example     :
+ ****************************************************************************/
+{
+    return (uchar) (tx_tail - tx_head - 1);
+}
+#endif // TRANSIT_UART_TX_RING
+
+#if TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_UART_TX_RING
+/* ************************************************************************ */
+void uart_tx_flush (void) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Wait until all output has left the transmitter.
+ * Remarks     : Drains the transmit ring first.
+ * Restrictions:
+ * See also    : uart_set_baud
+ * Example     :
+ ****************************************************************************/
+{
+    ulong lsr;
+
+#if TRANSIT_UART_TX_RING
+    while (tx_tail != tx_head) {
+        if (!EX1) {
+            uart_tx_poll();
+        }
+    }
+#endif // TRANSIT_UART_TX_RING
+
+    do {
+#if defined(VTSS_ARCH_OCELOT)
+        H2_READ(VTSS_UART_UART_LSR(VTSS_TO_UART), lsr);
+#elif defined(VTSS_ARCH_LUTON26)
+        H2_READ(VTSS_UART_UART_LSR, lsr);
 #endif // VTSS_ARCH_OCELOT
+    } while (!test_bit_32(6, &lsr));
+}
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_UART_TX_RING
+
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+#if defined(VTSS_ARCH_OCELOT)
+#define UART_DIVISOR_BASE   (CLOCK_FREQ / 16)
+#elif defined(VTSS_ARCH_LUTON26)
+#define UART_DIVISOR_BASE   (CLOCK_FREQ / 32)
+#endif // VTSS_ARCH_OCELOT
+
+/* ************************************************************************ */
+ulong uart_baud_check (ulong baud)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the baud rate the divisor actually generates for baud.
+ * Remarks     : Returns 0 when it cannot be generated within 2%.
+ * Restrictions:
+ * See also    : uart_set_baud
+ * Example     :
+ ****************************************************************************/
+{
+    ulong divisor, actual;
+
+    if (baud == 0) {
+        return 0;
+    }
+    divisor = (UART_DIVISOR_BASE + baud / 2) / baud;
+    if (divisor == 0 || divisor > 0xFFFF) {
+        return 0;
+    }
+    actual = UART_DIVISOR_BASE / divisor;
+    if ((actual > baud ? actual - baud : baud - actual) > baud / 50) {
+        return 0;
+    }
+    return actual;
+}
+
+/* ************************************************************************ */
+ulong uart_set_baud (ulong baud)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Change the baud rate of the UART.
+ * Remarks     : Returns the actual baud rate, or 0 (and nothing is changed)
+ *               when it is rejected by uart_baud_check().
+ *               Pending output is sent with the old rate first.
+ * Restrictions:
+ * See also    : uart_tx_flush
+ * Example     :
+ ****************************************************************************/
+{
+    ushort divisor;
+
+    if (uart_baud_check(baud) == 0) {
+        return 0;
+    }
+    divisor = (UART_DIVISOR_BASE + baud / 2) / baud;
+
+    uart_tx_flush();
+
+    /* The divisor latch shares address with RBR, keep the RX interrupt out */
+    EA = 0;
+#if defined(VTSS_ARCH_OCELOT)
+    h2_write_masked(VTSS_UART_UART_LCR(VTSS_TO_UART), VTSS_F_UART_UART_LCR_DLAB(1), VTSS_M_UART_UART_LCR_DLAB);
+    h2_write(VTSS_UART_UART_RBR_THR(VTSS_TO_UART), LOW_BYTE(divisor));
+    h2_write(VTSS_UART_UART_IER(VTSS_TO_UART), HIGH_BYTE(divisor));
+    h2_write_masked(VTSS_UART_UART_LCR(VTSS_TO_UART), 0, VTSS_M_UART_UART_LCR_DLAB);
+#elif defined(VTSS_ARCH_LUTON26)
+    h2_write_masked(VTSS_UART_UART_LCR, VTSS_F_UART_UART_LCR_DLAB, VTSS_F_UART_UART_LCR_DLAB);
+    h2_write(VTSS_UART_UART_RBR_THR, LOW_BYTE(divisor));
+    h2_write(VTSS_UART_UART_IER, HIGH_BYTE(divisor));
+    h2_write_masked(VTSS_UART_UART_LCR, 0, VTSS_F_UART_UART_LCR_DLAB);
+#endif // VTSS_ARCH_OCELOT
+    EA = 1;
+
+    return UART_DIVISOR_BASE / divisor;
 }
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM
 
 /* ************************************************************************ */
 #if !defined(NDEBUG)
@@ -11,7 +11,15 @@
 #define IIR_RX_CHAR_TIMEOUT	  0x0C
 #define IIR_TX_EMPTY		  0x02
 
+/* UART_TX_OVERFLOW_MODE values, see swconf_def.h */
+#define UART_TX_OVERFLOW_BLOCK  0
+#define UART_TX_OVERFLOW_DROP   1
+#define UART_TX_OVERFLOW_COUNT  2
+
 extern bit uart_rx_buf_overrun;
+#if TRANSIT_UART_TX_RING && (UART_TX_OVERFLOW_MODE == UART_TX_OVERFLOW_COUNT)
+extern ulong uart_tx_drop_cnt;
+#endif
 
 void  uart_init (void) small;
 void  uart_interrupt (void) small;
@@ -22,6 +30,16 @@ void  uart_interrupt (void) small;
 bool  uart_byte_ready (void) small;
 uchar uart_get_byte (void) small;
 void  uart_put_byte (uchar ch) small;
+#if TRANSIT_UART_TX_RING
+uchar uart_tx_room (void) small;
+#endif
+#if TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_UART_TX_RING
+void  uart_tx_flush (void) small;
+#endif
+#if TRANSIT_UNMANAGED_SWUP_STREAM
+ulong uart_baud_check (ulong baud);
+ulong uart_set_baud (ulong baud);
+#endif // TRANSIT_UNMANAGED_SWUP_STREAM
 
 
 #endif /* __UARTDRV_H__ */
@@ -10,6 +10,9 @@
 /** todo: move switch register access out of phydrv.c */
 #include "h2io.h"
 #include "vtss_api_base_regs.h"
+#if TRANSIT_REG_TRACE
+#include "h2trace.h"
+#endif
 
 #include "phydrv.h"
 #include "phymap.h"
@@ -361,6 +364,9 @@ ushort phy_read (vtss_port_no_t port_no, uchar reg_no) small
     while(_phy_read_reg_data(port_no, reg_no, &phy_data)); // Infinite loop until read success
     // EA = 1; // Enable interrupt
 
+#if TRANSIT_REG_TRACE
+    h2_trace_phy(H2_TRACE_OP_PHY_RD, port_no, reg_no, phy_data);
+#endif
     return phy_data;
 }
 
@@ -415,6 +421,9 @@ void phy_write(vtss_port_no_t   port_no,
     phy_await_completed(miim_no);
 
     // EA = 1; // Enable interrupt
+#if TRANSIT_REG_TRACE
+    h2_trace_phy(H2_TRACE_OP_PHY_WR, port_no, reg_no, value);
+#endif
 }
 
 /**
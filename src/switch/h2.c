@@ -44,6 +44,9 @@
 #if MAC_TO_MEDIA
 #include "h2pcs1g.h"
 #endif
+#if TRANSIT_UART_TX_RING
+#include "uartdrv.h"
+#endif
 
 /*****************************************************************************
  *
@@ -66,12 +69,6 @@
  *
  ****************************************************************************/
 
-enum {
-    VTSS_PGID_DEST_MASK_START   =   0,
-    VTSS_PGID_AGGR_MASK_START   =  64,
-    VTSS_PGID_SOURCE_MASK_START =  80
-};
-
 /*****************************************************************************
  *
  *
@@ -83,6 +80,16 @@ enum {
 #if TRANSIT_LAG
 typedef struct {
     port_bit_mask_t h2_current_aggr_groups[TOTAL_AGGRS];
+
+    /* Shadow of the PGID masks and PORTID values last written by
+       vtss_update_masks(), only the changed entries are rewritten */
+    BOOL            masks_valid;        /* Shadow matches the chip */
+    BOOL            src_masks_valid;    /* Also written by the loop detection */
+    port_bit_mask_t link_mask;          /* Link mask of the shadow */
+    port_bit_mask_t dest_masks[NO_OF_CHIP_PORTS];
+    port_bit_mask_t src_masks[NO_OF_CHIP_PORTS];
+    port_bit_mask_t aggr_masks[MAX_KEY];
+    uchar           portid[NO_OF_CHIP_PORTS];
 } h2_current_state_t;
 #endif 
 /*****************************************************************************
@@ -236,237 +243,6 @@ static void _l26_buf_conf_set(void)
     }
     return;
 }
-#elif defined(VTSS_ARCH_SERVAL_ORG)
-#define MULTIPLIER_BIT 256 
-static u16 wm_enc(u16 value)
-{
-    if (value >= MULTIPLIER_BIT) {
-        return MULTIPLIER_BIT + value / 16;
-    }
-    return value;
-}
-
-#define FERRET_BUFFER_MEMORY 229380
-#define FERRET_BUFFER_REFERENCE 1911
-#define FERRET_BUFFER_CELL_SZ 60
-#ifndef VTSS_PRIOS
-#define VTSS_PRIOS 8
-#endif
-
-static void _ferret_buf_conf_set(void)
-{
-    int q;
-    ulong port_no, port, dp;
-    ulong buf_q_rsrv_i, buf_q_rsrv_e, ref_q_rsrv_i, ref_q_rsrv_e, buf_prio_shr_i[8], buf_prio_shr_e[8], ref_prio_shr_i[8], ref_prio_shr_e[8];
-    ulong buf_p_rsrv_i, buf_p_rsrv_e, ref_p_rsrv_i, ref_p_rsrv_e, buf_col_shr_i, buf_col_shr_e, ref_col_shr_i, ref_col_shr_e;
-    ulong buf_prio_rsrv, ref_prio_rsrv, guaranteed, q_rsrv_mask, prio_mem, prio_ref, oversubscription_factor;
-    u8 prio_strict,prios=8;
-
-    /* This mode to be configurable by user somehow */
-    /* Mode 0: Strict priorities. Higher priorities have right to use all shared before lower */
-    /* Mode 1: Classes with equal memory rights */
-    ulong shr_mode = 0;
-
-    /* BZ#21592 - 2 to All random frame size (64-9600 bytes).
-     *
-     * Squeeze a little more out of the buffer resource.
-     *
-     * In Ferret unmanaged software, only qos 0/7 being in use and
-     * qos-7 only has a small amount of memory as a source on the cpu port only
-     */
-    BOOL is_squeeze_buffer_resource = TRUE;
-
-    /***********************/
-    /* Settings for mode 0 */
-    /***********************/
-    /* SYS::RES_CFG : 1024 watermarks for 1024000 byte shared buffer, unit is 60 byte */
-    /* Is divided into 4 resource consumptions, ingress and egress memory (BUF) and ingress and egress frame reference (REF) blocks */
-    /* Queue reserved (q_rsrv) : starts at offset 0 within in each BUF and REF   */
-    /* Prio shared (prio_shr)  : starts at offset 216 within in each BUF and REF */
-    /* Port reserved (p_rsrv)  : starts at offset 224 within in each BUF and REF */
-    /* Colour shared (col_shr) : starts at offset 254 within in each BUF and REF */
-
-    /* Buffer values are in BYTES */
-    buf_q_rsrv_i = 3000;    /* Guarantees at least 1 MTU  */
-    buf_p_rsrv_i = 0;       /* No additional ingress guarantees   */
-    buf_q_rsrv_e = 0;       /* Guarantees all QoS classes some space */
-    buf_p_rsrv_e = 3000;    /* Guarantees a space to the egress ports */
-    buf_col_shr_i = FERRET_BUFFER_MEMORY; /* Green color - disabled for now */
-    buf_col_shr_e = FERRET_BUFFER_MEMORY; /* Green color - disabled for now */
-    buf_prio_rsrv = 4000;  /* In the shared area, each priority is cut off 12kB before the others. Yellow colour is cut of 12kb before lowest */
-    prio_strict   = TRUE;   /* The priorities are treated strict in the shared memory */
-
-    /* Reference values in NUMBER of FRAMES */
-    ref_q_rsrv_e = 8;     /* Number of frames that can be pending at each egress queue   */
-    ref_q_rsrv_i = 8;     /* Number of frames that can be pending at each ingress queue  */
-    ref_p_rsrv_e = 20;    /* Number of frames that can be pending shared between the QoS classes at egress */
-    ref_p_rsrv_i = 20;     /* Number of frames that can be pending shared between the QoS classes at ingress */
-    ref_col_shr_i = FERRET_BUFFER_REFERENCE; /* Green color - disabled for now */
-    ref_col_shr_e = FERRET_BUFFER_REFERENCE; /* Green color - disabled for now */
-    ref_prio_rsrv = 50;   /* Number of frames that can be pending for each class */
-
-    /* The memory is oversubsrcribed by this factor (factor 1 = 100) */
-    /* Oversubscription is possible (in some degree) because it's rare that all ports use their reserved space at the same time */
-    oversubscription_factor = 200; /* No oversubscription */
-
-
-    /****** User configured mode changes *************/
-
-    /************/
-    /* Mode 1   */
-    /************/
-    if (shr_mode == 1) {
-        prio_strict     = FALSE; /* Each priority has its own share */
-        buf_prio_rsrv   = 30000; /* 30kB set aside to each active priority */
-        buf_p_rsrv_i    = 0;     /* No port reservation allowed in this mode */
-        buf_p_rsrv_e    = 0;
-        ref_prio_rsrv   = 200;  /* 200 frames set aside to each active priority */
-        ref_p_rsrv_i    = 0;    /* No port reservation allowed in this mode */
-        ref_p_rsrv_e    = 0;
-        oversubscription_factor = 200; /* Assume only half of the reserved memory is in use at any time */
-    }
-    /*************************************************/
-
-
-    /* Note, the shared reserved space (buf_prio_shr_i, ref_prio_shr_i, buf_prio_shr_e, ref_prio_shr_e) is calulated based on above */
-
-    /* The number of supported queues is given through the state structure                           */
-    /* The supported queues (lowest to higest) are givin reserved buffer space as specified above.   */
-    /* Frames in remaining queues (if any) are not getting any reserved space - but are allowed in the system.*/
-    if (is_squeeze_buffer_resource) {
-        q_rsrv_mask = 0x1 | (1 << PACKET_XTR_QU_BPDU_LLDP);
-    } else {
-        q_rsrv_mask = 0xff >> (8 - prios);
-    }
-
-
-    /* **************************************************  */
-    /* BELOW, everything is calculated based on the above. */
-    /* **************************************************  */
-
-    /* Find the amount of guaranteeed space per port */
-    guaranteed = buf_p_rsrv_i+buf_p_rsrv_e;
-    for (q=0; q<VTSS_PRIOS; q++) {
-        if (q_rsrv_mask & (1<<q))
-            guaranteed+=(buf_q_rsrv_i+buf_q_rsrv_e);
-    }
-
-    prio_mem = FERRET_BUFFER_MEMORY - (MAX_PORT+1)*guaranteed*100/oversubscription_factor;
-
-    /* Find the amount of guaranteeed frame references */
-    guaranteed = ref_p_rsrv_i+ref_p_rsrv_e;
-    for (q=0; q<VTSS_PRIOS; q++) {
-        if (q_rsrv_mask & (1<<q)) {
-            guaranteed+=(ref_q_rsrv_i+ref_q_rsrv_e);
-        }
-    }
-    prio_ref = FERRET_BUFFER_REFERENCE - (MAX_PORT+1)*guaranteed*100/oversubscription_factor;
-
-    /* Configuring the prio watermarks */
-    if (prio_strict) {
-        for (q = prios-1; q>=0; q--) {
-            if (q_rsrv_mask & (1<<q)) {
-                buf_prio_shr_i[q] = prio_mem;
-                ref_prio_shr_i[q] = prio_ref;
-                buf_prio_shr_e[q] = prio_mem;
-                ref_prio_shr_e[q] = prio_ref;
-
-                prio_mem -= buf_prio_rsrv;
-                prio_ref -= ref_prio_rsrv;
-            } else {
-                buf_prio_shr_i[q] = 0;
-                ref_prio_shr_i[q] = 0;
-                buf_prio_shr_e[q] = 0;
-                ref_prio_shr_e[q] = 0;
-            }
-        }
-        buf_col_shr_i = prio_mem - buf_prio_rsrv;
-        buf_col_shr_e = prio_mem - buf_prio_rsrv;
-        ref_col_shr_i = prio_ref - ref_prio_rsrv;
-        ref_col_shr_e = prio_ref - ref_prio_rsrv;
-    } else {
-        /* Shared area per prio */
-        for (q=0; q<prios; q++) {
-            buf_prio_shr_i[q] = buf_prio_rsrv;
-            ref_prio_shr_i[q] = ref_prio_rsrv;
-            buf_prio_shr_e[q] = buf_prio_rsrv;
-            ref_prio_shr_e[q] = ref_prio_rsrv;
-            prio_mem -= buf_prio_rsrv;
-            prio_ref -= ref_prio_rsrv;
-        }
-        buf_col_shr_i = prio_mem;
-        buf_col_shr_e = prio_mem;
-        ref_col_shr_i = prio_ref;
-        ref_col_shr_e = prio_ref;
-        /* Use per priority shared areas */
-        H2_WRITE(VTSS_QSYS_RES_QOS_ADV_RES_QOS_MODE, 0xff);
-    }
-
-
-    /* Port and QoS class reservation watermarks (Q_RSRV):
-       Configure reserved space for all QoS classes per port */
-    for (port_no = 0; port_no <= MAX_PORT; port_no++) {
-        if (port_no == MAX_PORT) {
-            port = CPU_CHIP_PORT;
-        } else {
-            port = iport2cport(port_no);
-        }
-        for (q = 0; q < VTSS_PRIOS; q++) {
-            if (q_rsrv_mask&(1<<q)
-                /* && (is_squeeze_buffer_resource && (q==0 || q==7 && port==CPU_CHIP_PORT)) */) {
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 0),   wm_enc(buf_q_rsrv_i / FERRET_BUFFER_CELL_SZ));
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 256), wm_enc(ref_q_rsrv_i));
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 512), wm_enc(buf_q_rsrv_e / FERRET_BUFFER_CELL_SZ));
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 768), wm_enc(ref_q_rsrv_e));
-            } else {
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 0),   0);
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 256), 0);
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 512), 0);
-                H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port * VTSS_PRIOS + q + 768), 0);
-            }
-        }
-    }
-
-    /* QoS class sharing watermarks (PRIO_SHR):
-       Configure shared space for all QoS classes */
-    for (q = 0; q < VTSS_PRIOS; q++) {
-        /* Save initial encoded value of shared area for later use by WRED */
-        //vtss_state->port.buf_prio_shr[q] = wm_enc(buf_prio_shr_e[q] / FERRET_BUFFER_CELL_SZ);
-
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG((q + 216 + 0)),   wm_enc(buf_prio_shr_i[q] / FERRET_BUFFER_CELL_SZ));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG((q + 216 + 256)), wm_enc(ref_prio_shr_i[q]));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG((q + 216 + 512)), wm_enc(buf_prio_shr_e[q] / FERRET_BUFFER_CELL_SZ));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG((q + 216 + 768)), wm_enc(ref_prio_shr_e[q]));
-    }
-
-    /* Port reservation watermarks (P_RSRV):
-       Configure reserved space for all ports */
-    for (port_no = 0; port_no <= MAX_PORT; port_no++) {
-        if (port_no == MAX_PORT) {
-            port = CPU_CHIP_PORT;
-        } else {
-            port = iport2cport(port_no);
-        }
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port + 224 +   0), wm_enc(buf_p_rsrv_i / FERRET_BUFFER_CELL_SZ));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port + 224 + 256), wm_enc(ref_p_rsrv_i));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port + 224 + 512), wm_enc(buf_p_rsrv_e / FERRET_BUFFER_CELL_SZ));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(port + 224 + 768), wm_enc(ref_p_rsrv_e));
-    }
-
-    /* Color sharing watermarks (COL_SHR):
-       Configure shared space for both DP levels.
-       In this context dp:0 is yellow and dp:1 is green */
-    for (dp = 0; dp < 2; dp++) {
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(dp + 254 +   0), wm_enc(buf_col_shr_i / FERRET_BUFFER_CELL_SZ));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(dp + 254 + 256), wm_enc(ref_col_shr_i));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(dp + 254 + 512), wm_enc(buf_col_shr_e / FERRET_BUFFER_CELL_SZ));
-        H2_WRITE(VTSS_QSYS_RES_CTRL_RES_CFG(dp + 254 + 768), wm_enc(ref_col_shr_e));
-        // Green watermark should match the highest priority watermark. Otherwise the will be no
-        //// strict shared space per qos level
-        buf_col_shr_i=buf_col_shr_e=buf_prio_shr_i[7];
-        ref_col_shr_i=ref_col_shr_e=ref_prio_shr_i[7];
-    }
-}
 #endif //#if defined(VTSS_ARCH_LUTON26)
 
 #if defined(VTSS_ARCH_OCELOT)
@@ -1080,6 +856,10 @@ static void _setup_mac(vtss_cport_no_t chip_port, uchar link_mode)
  */
 void h2_reset (void) small
 {
+#if TRANSIT_UART_TX_RING
+    /* Send the queued console output before the reset */
+    uart_tx_flush();
+#endif
 
 #if defined(VTSS_ARCH_OCELOT)
     H2_WRITE_MASKED(VTSS_DEVCPU_GCB_CHIP_REGS_SOFT_RST,
@@ -1188,10 +968,10 @@ void h2_post_reset (void)
     do { /* Wait until leaky buckets initialization is completed  */
         H2_READ(VTSS_SYS_SCH_SCH_LB_CTRL, cmd);
     } while(cmd & VTSS_F_SYS_SCH_SCH_LB_CTRL_LB_INIT);
-#elif defined(VTSS_ARCH_SERVAL_ORG)
-    // Ferret, TODO. Keep the QoS setting as the chip factory default
-	// See srvl_port_buf_conf_set() in VSC7514 API
-    _ferret_buf_conf_set();
+#elif defined(VTSS_ARCH_OCELOT)
+    // Ferret keeps the chip default watermarks here. With TRANSIT_BUF_PROFILE
+    // the profile in flash is applied by h2_buf_init() after the configuration
+    // is loaded.
 #endif
 
     /* Setup frame ageing - "2 sec" */
@@ -1492,10 +1272,43 @@ static port_bit_mask_t vtss_aggr_find_group(uchar port_no)
 }
 
 
+/* ************************************************************************ */
+static uchar _vtss_mask_bits(port_bit_mask_t mask)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Count the ports in a port mask.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar cnt = 0;
+
+    while (mask) {
+        mask &= mask - 1;
+        cnt++;
+    }
+    return cnt;
+}
+
+/* ************************************************************************ */
+static void _vtss_pgid_update(uchar pgid, port_bit_mask_t *shadow, port_bit_mask_t member, BOOL valid)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write a PGID mask if it differs from its shadow.
+ * Remarks     : valid FALSE writes the mask anyway.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (!valid || *shadow != member) {
+        H2_WRITE(VTSS_ANA_PGID_PGID(pgid), member);
+        *shadow = member;
+    }
+}
+
 static void _vtss_update_dest_mask(port_bit_mask_t link_mask)
 {
-    // Fix compilation warning.
-    
     vtss_iport_no_t iport_idx;
     vtss_cport_no_t chip_port;
     port_bit_mask_t member;
@@ -1503,10 +1316,10 @@ static void _vtss_update_dest_mask(port_bit_mask_t link_mask)
     for (iport_idx = MIN_PORT; iport_idx < MAX_PORT; iport_idx++) {
         chip_port = iport2cport(iport_idx);
         member = vtss_aggr_find_group(chip_port) & link_mask;
-        H2_WRITE(VTSS_ANA_PGID_PGID(chip_port + VTSS_PGID_DEST_MASK_START), member);
-        //print_dec(chip_port + VTSS_PGID_DEST_MASK_START); print_spaces(3); print_hex_dw(member); print_cr_lf();
-    }    
-    
+        _vtss_pgid_update(chip_port + VTSS_PGID_DEST_MASK_START,
+                          &h2_current_state.dest_masks[chip_port], member,
+                          h2_current_state.masks_valid);
+    }
 }
 
 static void _vtss_update_src_mask(port_bit_mask_t link_mask)
@@ -1520,8 +1333,9 @@ static void _vtss_update_src_mask(port_bit_mask_t link_mask)
 #if defined(VTSS_ARCH_OCELOT)
         member = link_mask & _vtss_get_pvlan_mask(chip_port) & (~vtss_aggr_find_group(chip_port));
         //member = member | PORT_BIT_MASK(CPU_CHIP_PORT);
-        H2_WRITE(VTSS_ANA_PGID_PGID(chip_port + VTSS_PGID_SOURCE_MASK_START), member);
-        //print_dec(chip_port + VTSS_PGID_SOURCE_MASK_START); print_spaces(3); print_hex_dw(member); print_cr_lf();
+        _vtss_pgid_update(chip_port + VTSS_PGID_SOURCE_MASK_START,
+                          &h2_current_state.src_masks[chip_port], member,
+                          h2_current_state.masks_valid && h2_current_state.src_masks_valid);
 #elif defined(VTSS_ARCH_LUTON26)
         /* STP and Authentication state allow forwarding from port. */
         if (_ingr_forwarding(chip_port)) {
@@ -1557,82 +1371,65 @@ static void _vtss_update_src_mask(port_bit_mask_t link_mask)
 #endif /* H2_DEBUG_ENABLE */
     }
 
-    delay(MSEC_100);
+    h2_current_state.src_masks_valid = TRUE;
 }
 
 static void _vtss_update_aggr_mask(port_bit_mask_t link_mask)
 {
-    vtss_iport_no_t i_port_no, e_port_no;
-    vtss_cport_no_t ic_port_no, ec_port_no;
+    vtss_iport_no_t i_port_no;
+    vtss_cport_no_t ic_port_no;
     // The size of aggr_xxx array must be NO_OF_CHIP_PORTS
     uchar           aggr_count[NO_OF_CHIP_PORTS], aggr_index[NO_OF_CHIP_PORTS], n;
-    uchar           aggr_lport[NO_OF_CHIP_PORTS]; 
-    port_bit_mask_t member_mask = 0;
-    port_bit_mask_t test_member_mask = 0;
+    uchar           aggr_lport[NO_OF_CHIP_PORTS];
+    port_bit_mask_t member_mask;
     uchar ix;
-    
-    /* Update aggregation masks */
-    //memset(aggr_count, 0, sizeof(aggr_count));
-    //memset(aggr_index, 0, sizeof(aggr_index));
 
     /* Count number of operational ports and index of each port */
     for (i_port_no = MIN_PORT; i_port_no < MAX_PORT; i_port_no++) {
         ic_port_no = iport2cport(i_port_no);
-        aggr_count[ic_port_no] = 0; 
+        aggr_count[ic_port_no] = 0;
         aggr_index[ic_port_no] = 0;
         aggr_lport[ic_port_no] = ic_port_no;
 
         /* If port is up and forwarding */
         if (TEST_PORT_BIT_MASK(ic_port_no, &link_mask)) {
+            /* Forwarding members of the same aggregation, the port included.
+               The lowest one is the logical port of the aggregation. */
             member_mask = vtss_aggr_find_group(ic_port_no) & link_mask;
-            //print_cr_lf(); print_str("yyy "); print_dec(ic_port_no); print_spaces(3); print_hex_dw(member_mask); print_cr_lf();
-            for (e_port_no = MIN_PORT; e_port_no < MAX_PORT; e_port_no++) {
-                ec_port_no = iport2cport(e_port_no);
-                if (TEST_PORT_BIT_MASK(ec_port_no, &member_mask)) {
-                    /* Port is forwarding and member of the same aggregation */
-                    aggr_count[ic_port_no] += 1;
-                    if (ec_port_no < ic_port_no) {
-                        aggr_index[ic_port_no] += 1;
-                        if (ec_port_no < aggr_lport[ic_port_no] ) {
-                            aggr_lport[ic_port_no] = ec_port_no;
-                        }    
-                    }    
-                }
+            aggr_count[ic_port_no] = _vtss_mask_bits(member_mask);
+            aggr_index[ic_port_no] = _vtss_mask_bits(member_mask & (PORT_BIT_MASK(ic_port_no) - 1));
+            for (n = 0; !TEST_PORT_BIT_MASK(n, &member_mask); n++) {
             }
-            //print_str("xxx ");
-            //print_dec(ic_port_no); print_spaces(3); print_dec(aggr_count[ic_port_no]);
-            //print_spaces(3); print_dec(aggr_index[ic_port_no]);
-            //print_str("lport: "); print_dec(aggr_lport[ic_port_no]);print_cr_lf();
-            
+            aggr_lport[ic_port_no] = n;
         }
     }
 
     for (ix = 0; ix < MAX_KEY; ix++) {
         /* Include one forwarding port from each aggregation */
+        member_mask = 0;
         for (i_port_no = MIN_PORT; i_port_no < MAX_PORT; i_port_no++) {
             ic_port_no = iport2cport(i_port_no);
             n = aggr_index[ic_port_no] + ix;
-            WRITE_PORT_BIT_MASK(ic_port_no,
-                                (aggr_count[ic_port_no] && (n % aggr_count[ic_port_no]) == 0) ? 1 : 0,
-                                &member_mask);
+            if (aggr_count[ic_port_no] && (n % aggr_count[ic_port_no]) == 0) {
+                member_mask |= PORT_BIT_MASK(ic_port_no);
+            }
         }
 
         /* Write to aggregation table */
-        H2_WRITE(VTSS_ANA_PGID_PGID(VTSS_PGID_AGGR_MASK_START + ix), member_mask);
-        H2_READ(VTSS_ANA_PGID_PGID(VTSS_PGID_AGGR_MASK_START + ix), test_member_mask);
-        if (test_member_mask != member_mask) {
-            //delay_1(10);
-            print_dec(VTSS_PGID_AGGR_MASK_START + ix); print_spaces(3); print_hex_dw(member_mask);
-            print_spaces(3); print_hex_dw(test_member_mask); print_cr_lf();
-        }
+        _vtss_pgid_update(VTSS_PGID_AGGR_MASK_START + ix,
+                          &h2_current_state.aggr_masks[ix], member_mask,
+                          h2_current_state.masks_valid);
     }
-    
+
     /* Update port map table on aggregation changes */
-    for (i_port_no = MIN_PORT; i_port_no < MAX_PORT; i_port_no++) {    
+    for (i_port_no = MIN_PORT; i_port_no < MAX_PORT; i_port_no++) {
         ic_port_no = iport2cport(i_port_no);
-        H2_WRITE_MASKED(VTSS_ANA_PORT_PORT_CFG(ic_port_no),
-                            VTSS_F_ANA_PORT_PORT_CFG_PORTID_VAL(aggr_lport[ic_port_no]), 
+        if (!h2_current_state.masks_valid || h2_current_state.portid[ic_port_no] != aggr_lport[ic_port_no]) {
+            H2_WRITE_MASKED(VTSS_ANA_PORT_PORT_CFG(ic_port_no),
+                            VTSS_F_ANA_PORT_PORT_CFG_PORTID_VAL(aggr_lport[ic_port_no]),
                             VTSS_M_ANA_PORT_PORT_CFG_PORTID_VAL);
+            h2_current_state.portid[ic_port_no] = aggr_lport[ic_port_no];
+        }
     }
 }
 
@@ -1653,7 +1450,7 @@ void vtss_show_masks(void)
 void vtss_update_masks(void)
 {
 #if TRANSIT_LAG     
-    port_bit_mask_t     link_mask;
+    port_bit_mask_t     link_mask, old_mask;
 
 #ifndef VTSS_COMMON_NDEBUG
     vtss_printf("vtss_update_masks: from file \"%s\" line %u\n",
@@ -1661,24 +1458,68 @@ void vtss_update_masks(void)
 #endif /* !VTSS_COMMON_NDEBUG */
 
     link_mask = linkup_cport_mask_get();
+    old_mask  = h2_current_state.masks_valid ? h2_current_state.link_mask : link_mask;
 
     /*
-     * Update source mask
+     * The new masks are diffed against the shadow and only the changed
+     * entries are written. The order keeps a link change hitless, without
+     * waiting for the frames in flight:
+     * - A port leaving is first removed from the source masks, so nothing
+     *   is forwarded to it, then from the aggregation masks, which pick
+     *   another member of the aggregation, and at last from the
+     *   destination masks.
+     * - A port joining is first added to the destination masks, then to
+     *   the aggregation masks and at last to the source masks.
+     * Each step leaves out the ports of the other direction, so it writes
+     * nothing when no port goes that way.
      */
-     _vtss_update_src_mask(link_mask);
 
     /*
-     * Update destination table
+     * Update source mask, ports leaving
      */
-    _vtss_update_dest_mask(link_mask);
+    _vtss_update_src_mask(link_mask & old_mask);
+
+    /*
+     * Update destination table, ports joining
+     */
+    _vtss_update_dest_mask(link_mask | old_mask);
 
     /*
      * Update aggregation masks
      */
     _vtss_update_aggr_mask(link_mask);
+
+    /*
+     * Update destination table, ports leaving
+     */
+    _vtss_update_dest_mask(link_mask);
+
+    /*
+     * Update source mask, ports joining
+     */
+    _vtss_update_src_mask(link_mask);
+
+    h2_current_state.link_mask   = link_mask;
+    h2_current_state.masks_valid = TRUE;
 #endif //TRANSIT_LAG
 }
 
+#if TRANSIT_LAG
+/* ************************************************************************ */
+void vtss_src_masks_changed(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Invalidate the source mask shadow.
+ * Remarks     : To be called after writing the source masks elsewhere, so
+ *               the next vtss_update_masks() rewrites all of them.
+ * Restrictions:
+ * See also    : vtss_update_masks
+ * Example     :
+ ****************************************************************************/
+{
+    h2_current_state.src_masks_valid = FALSE;
+}
+#endif //TRANSIT_LAG
+
 #if TRANSIT_LAG 
 void vtss_set_aggr_group(uchar group, port_bit_mask_t members)
 /* ------------------------------------------------------------------------ --
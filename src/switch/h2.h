@@ -24,6 +24,28 @@
 #define MAX_PGIDS       (VTSS_PGIDS - NO_OF_CHIP_PORTS - 1) /* First MAX_PORT reserved for auto-learned MACs */
 #define BAD_PGID        (0xFF)
 
+/* PGID table layout */
+enum {
+    VTSS_PGID_DEST_MASK_START   =   0,
+    VTSS_PGID_IPMC_FLOOD        =  62,  /* Flood mask of the unknown IP multicast data, see ipmc_snoop.c */
+    VTSS_PGID_AGGR_MASK_START   =  64,
+    VTSS_PGID_SOURCE_MASK_START =  80
+};
+
+/* ANA:POL policer layout */
+#define VTSS_POL_PORT_START     0       /* Port policer of chip port P: P */
+#define VTSS_POL_QUEUE_START    32      /* QoS policer of chip port P, class Q: 32 + P * 8 + Q */
+
+/* Values of ANA:POL:POL_MODE_CFG:FRM_MODE */
+#define POL_FRM_MODE_DATA       1       /* Rate unit 33 1/3 kbit/s, burst unit 4 KB */
+#define POL_FRM_MODE_FPS_33     2       /* Rate unit 33 1/3 frames/s, burst unit 32.8 frames */
+#define POL_FRM_MODE_FPS_1_3    3       /* Rate unit 1/3 frames/s, burst unit 0.3 frames */
+
+#define POL_RATE_MAX            0x7FFF
+#define POL_BURST_DATA          4       /* 16 KB */
+#define POL_BURST_FPS_33        2       /* 65 frames */
+#define POL_BURST_FPS_1_3       60      /* 18 frames */
+
 
 /*
  * This clause is dirty, but is a must when debugging hard-to-find
@@ -58,6 +80,9 @@ void                h2_enable_exc_col_drop  (vtss_cport_no_t chip_port, uchar dr
  */
 void                vtss_update_masks       (void);
 void                vtss_show_masks         (void);
+#if TRANSIT_LAG
+void                vtss_src_masks_changed  (void);
+#endif // TRANSIT_LAG
 
 extern void             vtss_set_aggr_group(uchar group, port_bit_mask_t members);
 extern port_bit_mask_t  vtss_get_aggr_group(uchar group);
@@ -8,6 +8,7 @@
 #include "main.h"
 #include "h2aggr.h"
 //#include "eeprom.h"
+#include "spiflash.h"
 #include "phytsk.h"
 #include "misc2.h"
 #include "hwport.h"
@@ -22,6 +23,10 @@
 #include "hwport.h"
 #include "ieee8021x.h"
 #endif
+#if UNMANAGED_PORT_STATISTICS_IF
+#include "h2stats.h"
+#include "print.h"
+#endif
 
 #if TRANSIT_LAG
 
@@ -34,10 +39,7 @@
  *
  *
  * ************************************************************************ */
-//VTSS_F_ANA_COMMON_AGGR_CFG_AC_IP4_SIPDIP_ENA | VTSS_F_ANA_COMMON_AGGR_CFG_AC_IP4_TCPUDP_ENA |
-//VTSS_F_ANA_COMMON_AGGR_CFG_AC_DMAC_ENA | VTSS_F_ANA_COMMON_AGGR_CFG_AC_SMAC_ENA |
-//VTSS_F_ANA_COMMON_AGGR_CFG_AC_IP6_TCPUDP_ENA | VTSS_F_ANA_COMMON_AGGR_CFG_AC_IP6_FLOW_LBL_ENA
-#define     DEFAULT_AGGR_MODE   0x7E 
+#define PERCENT_MAX_BASE    (0xFFFFFFFF / 100)
 
 
 
@@ -75,6 +77,10 @@ static void update_aggr_mask(uchar port_no);
  * ************************************************************************ */
 static uchar           h2_aggr_mode_conf;
 static port_bit_mask_t h2_aggr_group[MAX_AGGR_GROUP];
+#if UNMANAGED_PORT_STATISTICS_IF
+/* Tx octet counters at the previous h2_aggr_print_util() */
+static ulong           h2_aggr_tx_octets[NO_OF_CHIP_PORTS];
+#endif
 
 
 #if TRANSIT_LACP
@@ -116,8 +122,12 @@ void h2_aggr_init (void)
 {
     uchar group;
 
-    h2_aggr_mode_conf = DEFAULT_AGGR_MODE;
-    h2_aggr_mode(DEFAULT_AGGR_MODE);
+    h2_aggr_mode_conf = flash_read_aggr_mode();
+    if (h2_aggr_mode_conf & ~H2_AGGR_HASH_ALL) {
+        /* Not configured */
+        h2_aggr_mode_conf = H2_AGGR_HASH_DEFAULT;
+    }
+    h2_aggr_mode(h2_aggr_mode_conf);
 
     for (group = 0; group < MAX_AGGR_GROUP; group++) {
         h2_aggr_group [group] = 0;           
@@ -128,20 +138,103 @@ void h2_aggr_init (void)
 }
 
 /* ************************************************************************ */
-#if 0 // not used
-void h2_aggr_set_mode (uchar mode)
+uchar h2_aggr_set_mode (uchar mode)
 /* ------------------------------------------------------------------------ --
- * Purpose     : Set aggregation mode in EEPROM and in Heathrow.
- * Remarks     : mode is 1 for SMAC, 2 for DMAC, 3 for SMAC XOR DMAC
+ * Purpose     : Set aggregation hash mode in the configuration and in the
+ *               switch chip.
+ * Remarks     : mode is a mask of H2_AGGR_HASH_xxx.
+ *               Returns 0, if succeeded, otherwise ERROR_AGGR_5 for unknown
+ *               fields.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ *               The mode is saved only with TRANSIT_SPI_FLASH_JOURNAL,
+ *               otherwise it is lost at the next boot.
  * Restrictions:
  * See also    :
- * Example     :
+ * Example     : h2_aggr_set_mode(H2_AGGR_HASH_IP4_SIPDIP | H2_AGGR_HASH_IP4_TCPUDP)
  * ************************************************************************ */
 {
-    h2_aggr_mode_conf = DEFAULT_AGGR_MODE;
+    if (mode & ~H2_AGGR_HASH_ALL) {
+        return ERROR_AGGR_5;
+    }
+    h2_aggr_mode_conf = mode;
     h2_aggr_mode(mode);
+    flash_write_aggr_mode(mode);
+    return 0;
+}
+
+/* ************************************************************************ */
+uchar h2_aggr_get_mode (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Return aggregation hash mode (H2_AGGR_HASH_xxx).
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ * ************************************************************************ */
+{
+    return h2_aggr_mode_conf;
+}
+
+#if UNMANAGED_PORT_STATISTICS_IF
+/* ************************************************************************ */
+void h2_aggr_print_util (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the transmitted octets of each aggregation member since
+ *               the previous call and its share of the aggregation.
+ * Remarks     : With a good hash distribution the forwarding members get
+ *               about the same share. LACP aggregations are included.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ * ************************************************************************ */
+{
+    uchar           group, shift;
+    vtss_cport_no_t chip_port;
+    port_bit_mask_t members;
+    ulong           octets[NO_OF_CHIP_PORTS];
+    ulong           total, delta;
+
+    for (group = 0; group < TOTAL_AGGRS; group++) {
+        members = vtss_get_aggr_group(group);
+        if (members == 0) {
+            continue;
+        }
+
+        total = 0;
+        for (chip_port = 0; chip_port < NO_OF_CHIP_PORTS; chip_port++) {
+            if (TEST_PORT_BIT_MASK(chip_port, &members)) {
+                octets[chip_port] = h2_stats_counter_get(chip_port, CNT_TX_OCTETS);
+                total += octets[chip_port] - h2_aggr_tx_octets[chip_port];
+            }
+        }
+
+        /* Scale down so that the share fits in 32 bits */
+        for (shift = 0; (total >> shift) > PERCENT_MAX_BASE; shift++) {
+        }
+
+        print_str("Group ");
+        print_dec(group);
+        print_cr_lf();
+        for (chip_port = 0; chip_port < NO_OF_CHIP_PORTS; chip_port++) {
+            if (!TEST_PORT_BIT_MASK(chip_port, &members)) {
+                continue;
+            }
+            delta = octets[chip_port] - h2_aggr_tx_octets[chip_port];
+            h2_aggr_tx_octets[chip_port] = octets[chip_port];
+
+            print_str("  Port ");
+            print_dec(cport2uport(chip_port));
+            print_str(": Tx octets");
+            print_dec_right(delta);
+            print_spaces(2);
+            print_dec(total ? (delta >> shift) * 100 / (total >> shift) : 0);
+            print_ch('%');
+            print_cr_lf();
+        }
+    }
 }
-#endif // not used
+#endif // UNMANAGED_PORT_STATISTICS_IF
 
 static uchar ports_in_mask(port_bit_mask_t i_port_mask, port_bit_mask_t *c_port_mask)
 /* ------------------------------------------------------------------------ --
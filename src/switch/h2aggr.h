@@ -6,8 +6,23 @@
 
 #define MAX_KEY   16
 
+/* Fields feeding the aggregation code, bits of ANA:COMMON:AGGR_CFG */
+#define H2_AGGR_HASH_IP4_TCPUDP     0x02    /* IPv4 TCP/UDP ports */
+#define H2_AGGR_HASH_IP4_SIPDIP     0x04    /* IPv4 source and destination IP */
+#define H2_AGGR_HASH_IP6_TCPUDP     0x08    /* IPv6 TCP/UDP ports */
+#define H2_AGGR_HASH_IP6_FLOW       0x10    /* IPv6 flow label */
+#define H2_AGGR_HASH_SMAC           0x20    /* Source MAC */
+#define H2_AGGR_HASH_DMAC           0x40    /* Destination MAC */
+#define H2_AGGR_HASH_RND            0x80    /* Random, overrides the others */
+#define H2_AGGR_HASH_ALL            0xFE
+#define H2_AGGR_HASH_DEFAULT        0x7E    /* All but random */
+
 void   h2_aggr_init (void);
-void   h2_aggr_set_mode (uchar mode);
+uchar  h2_aggr_set_mode (uchar mode);
+uchar  h2_aggr_get_mode (void);
+#if UNMANAGED_PORT_STATISTICS_IF
+void   h2_aggr_print_util (void);
+#endif
 uchar h2_aggr_add (port_bit_mask_t i_port_mask);
 uchar  h2_aggr_delete (port_bit_mask_t port_mask);
 void   h2_aggr_update (void);
@@ -21,5 +36,6 @@ uchar chk_staggr_member (uchar pno);
 #define ERROR_AGGR_2 2
 #define ERROR_AGGR_3 3
 #define ERROR_AGGR_4 4
+#define ERROR_AGGR_5 5
 
 #endif
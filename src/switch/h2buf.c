@@ -0,0 +1,414 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_BUF_PROFILE
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "h2buf.h"
+#include "h2packet.h"
+#include "hwport.h"
+#include "spiflash.h"
+#include "print.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+#define FERRET_BUFFER_MEMORY    229380
+#define FERRET_BUFFER_REFERENCE 1911
+#define FERRET_BUFFER_CELL_SZ   60
+#ifndef VTSS_PRIOS
+#define VTSS_PRIOS 8
+#endif
+
+/* Watermarks at or above MULTIPLIER_BIT are in units of WM_MULTIPLIER */
+#define MULTIPLIER_BIT          256
+#define WM_MULTIPLIER           16
+
+/*
+ * QSYS:RES_CTRL:RES_CFG holds 1024 watermarks, 256 for each of the 4
+ * resources: memory and frame references per source (BUF_I, REF_I) and
+ * per destination (BUF_E, REF_E). The unit is a cell for BUF and a frame
+ * for REF.
+ */
+#define RES_BUF_I               0
+#define RES_REF_I               1
+#define RES_BUF_E               2
+#define RES_REF_E               3
+#define RES_CNT                 4
+#define RES_IS_BUF(res)         (((res) & 1) == 0)
+
+/* Watermark index within a resource */
+#define RES_Q_RSRV(port, q)     ((port) * VTSS_PRIOS + (q))     /* Queue reserved */
+#define RES_PRIO_SHR(q)         (216 + (q))                     /* Prio shared */
+#define RES_P_RSRV(port)        (224 + (port))                  /* Port reserved */
+#define RES_COL_SHR(col)        (254 + (col))                   /* Colour shared, col 0 is yellow (DP 1), 1 green */
+
+#define RES_CFG(res, idx)       VTSS_QSYS_RES_CTRL_RES_CFG((res) * 256 + (idx))
+
+/*****************************************************************************
+ *
+ * Typedefs and enums
+ *
+ *
+ *
+ ****************************************************************************/
+
+/*
+ * Buffer values are in bytes, reference values in frames. Ingress port and
+ * egress queue memory are not reserved by any profile.
+ */
+typedef struct {
+    ushort  buf_q_rsrv_i;               /* Reserved per ingress queue */
+    ushort  buf_p_rsrv_e;               /* Reserved per egress port */
+    ushort  buf_prio_rsrv;              /* Shared cut off per class (strict) or share per class */
+    uchar   ref_q_rsrv;                 /* Reserved per ingress and egress queue */
+    uchar   ref_p_rsrv;                 /* Reserved per ingress and egress port */
+    uchar   ref_prio_rsrv;              /* As buf_prio_rsrv */
+    ushort  oversubscription_factor;    /* Reservations are oversubscribed by this factor, 100 is none */
+    BOOL    prio_strict;                /* Higher classes have the right to use all shared before lower */
+    BOOL    all_queues;                 /* Reserve for all queues, otherwise queue 0 and the BPDU queue */
+} h2_buf_profile_t;
+
+/* Watermarks before encoding, cells for BUF and frames for REF */
+typedef struct {
+    ushort  q_rsrv[RES_CNT];
+    ushort  p_rsrv[RES_CNT];
+    ushort  prio_shr[RES_CNT][VTSS_PRIOS];
+    ushort  col_shr[RES_CNT][2];
+    uchar   q_rsrv_mask;
+    uchar   qos_mode;                   /* QSYS:RES_QOS_ADV:RES_QOS_MODE */
+} h2_buf_wm_t;
+
+/*****************************************************************************
+ *
+ *
+ * Prototypes for local functions
+ *
+ *
+ *
+ ****************************************************************************/
+static void  _ferret_buf_conf_set(uchar profile);
+static void  _h2_buf_wm_write(void);
+static ushort _h2_buf_wm_enc(ushort value);
+static ulong _h2_buf_wm_get(uchar res, ushort idx);
+static void  _h2_buf_wm_print(const char *name, ushort idx);
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+static code h2_buf_profile_t buf_profiles[H2_BUF_PROFILE_CNT] = {
+    /* Default: at least one MTU per queue, each class cut off 4kB before the class above */
+    { 3000,  3000,  4000,  8, 20,  50, 200, TRUE,  FALSE },
+    /* Jumbo: one 9600 byte frame per queue and egress port, fewer frames */
+    { 10000, 10000, 10000, 4, 10,  20, 300, TRUE,  FALSE },
+    /* QoS: all 8 queues reserved, each class has its own share */
+    { 1600,  0,     12000, 4, 0,  100, 200, FALSE, TRUE  },
+    /* Burst: small reservations, most memory shared and oversubscribed */
+    { 1600,  1600,  2000,  4, 10,  20, 400, TRUE,  FALSE },
+};
+
+static code char *buf_profile_names[H2_BUF_PROFILE_CNT] = {
+    "default", "jumbo", "qos", "burst"
+};
+
+static uchar xdata buf_profile;         /* Applied at boot */
+static h2_buf_wm_t xdata buf_wm;
+
+/* ************************************************************************ */
+void h2_buf_init (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Apply the buffer profile in flash.
+ * Remarks     : An invalid (erased) setting gets the default profile.
+ *               Must be called after flash_load_config() and before the
+ *               ports are enabled, the watermarks are only written while
+ *               the queue system is empty.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    buf_profile = flash_read_buf_profile();
+    if (buf_profile >= H2_BUF_PROFILE_CNT) {
+        buf_profile = H2_BUF_PROFILE_DEFAULT;
+        flash_write_buf_profile(buf_profile);
+    }
+    _ferret_buf_conf_set(buf_profile);
+    _h2_buf_wm_write();
+}
+
+/* ************************************************************************ */
+uchar h2_buf_profile_set (uchar profile)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Select the buffer profile of the next boot.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_BUF_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (profile >= H2_BUF_PROFILE_CNT) {
+        return ERROR_BUF_PARM;
+    }
+
+    flash_write_buf_profile(profile);
+    return 0;
+}
+
+/* ************************************************************************ */
+void h2_buf_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the buffer profile and the shared watermarks.
+ * Remarks     : The watermarks are read back from the switch chip and
+ *               decoded, buf is bytes and ref is frames, ingress/egress.
+ * Restrictions:
+ * See also    : h2_buf_port_print()
+ * Example     :
+ ****************************************************************************/
+{
+    ulong reg_val;
+    uchar profile;
+    uchar q;
+
+    print_str("Profile: ");
+    print_str(buf_profile_names[buf_profile]);
+    profile = flash_read_buf_profile();
+    if (profile != buf_profile && profile < H2_BUF_PROFILE_CNT) {
+        print_str(", next boot ");
+        print_str(buf_profile_names[profile]);
+    }
+    print_cr_lf();
+
+    H2_READ(VTSS_QSYS_RES_QOS_ADV_RES_QOS_MODE, reg_val);
+    print_str("Sharing: ");
+    println_str(VTSS_X_QSYS_RES_QOS_ADV_RES_QOS_MODE_RES_QOS_RSRVD(reg_val) ? "per class" : "strict");
+
+    for (q = 0; q < VTSS_PRIOS; q++) {
+        print_str("Class ");
+        print_dec(q);
+        _h2_buf_wm_print(": ", RES_PRIO_SHR(q));
+    }
+    _h2_buf_wm_print("Yellow: ", RES_COL_SHR(0));
+    _h2_buf_wm_print("Green: ", RES_COL_SHR(1));
+}
+
+/* ************************************************************************ */
+void h2_buf_port_print (vtss_uport_no_t uport)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the reserved watermarks of a port.
+ * Remarks     : uport 0 is the CPU port.
+ * Restrictions:
+ * See also    : h2_buf_print()
+ * Example     :
+ ****************************************************************************/
+{
+    vtss_cport_no_t chip_port = uport ? uport2cport(uport) : CPU_CHIP_PORT;
+    uchar           q;
+
+    for (q = 0; q < VTSS_PRIOS; q++) {
+        print_str("Queue ");
+        print_dec(q);
+        _h2_buf_wm_print(": ", RES_Q_RSRV(chip_port, q));
+    }
+    _h2_buf_wm_print("Port: ", RES_P_RSRV(chip_port));
+}
+
+/* ************************************************************************ */
+static void _ferret_buf_conf_set(uchar profile)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Calculate the watermarks of a buffer profile.
+ * Remarks     : The memory left when all ports hold their reservations,
+ *               scaled by the oversubscription, is shared. In strict
+ *               sharing each class is cut off buf_prio_rsrv before the
+ *               class above, otherwise each class gets buf_prio_rsrv of
+ *               its own. Classes without reserved queues still get a
+ *               shared watermark.
+ *               See srvl_port_buf_conf_set() in the VSC7514 API.
+ * Restrictions: The profiles are sized for at most 12 ports incl. the CPU.
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    const h2_buf_profile_t code *prof = &buf_profiles[profile];
+    ulong  guaranteed, prio_mem, prio_ref;
+    uchar  q;
+    uchar  q_cnt = 0;
+    uchar  res;
+
+    buf_wm.q_rsrv_mask = prof->all_queues ? 0xFF : (0x1 | (1 << PACKET_XTR_QU_BPDU_LLDP));
+    for (q = 0; q < VTSS_PRIOS; q++) {
+        if (buf_wm.q_rsrv_mask & (1 << q)) {
+            q_cnt++;
+        }
+    }
+
+    /* Find the amount of guaranteed space per port */
+    guaranteed = prof->buf_p_rsrv_e + (ulong) q_cnt * prof->buf_q_rsrv_i;
+    prio_mem = FERRET_BUFFER_MEMORY - (MAX_PORT + 1) * guaranteed * 100 / prof->oversubscription_factor;
+
+    /* Find the amount of guaranteed frame references */
+    guaranteed = 2 * prof->ref_p_rsrv + 2 * (ulong) q_cnt * prof->ref_q_rsrv;
+    prio_ref = FERRET_BUFFER_REFERENCE - (MAX_PORT + 1) * guaranteed * 100 / prof->oversubscription_factor;
+
+    /* Configuring the prio watermarks, highest class first */
+    q = VTSS_PRIOS;
+    do {
+        q--;
+        if (prof->prio_strict) {
+            buf_wm.prio_shr[RES_BUF_I][q] = prio_mem / FERRET_BUFFER_CELL_SZ;
+            buf_wm.prio_shr[RES_REF_I][q] = prio_ref;
+        } else {
+            buf_wm.prio_shr[RES_BUF_I][q] = prof->buf_prio_rsrv / FERRET_BUFFER_CELL_SZ;
+            buf_wm.prio_shr[RES_REF_I][q] = prof->ref_prio_rsrv;
+        }
+        buf_wm.prio_shr[RES_BUF_E][q] = buf_wm.prio_shr[RES_BUF_I][q];
+        buf_wm.prio_shr[RES_REF_E][q] = buf_wm.prio_shr[RES_REF_I][q];
+        prio_mem -= prof->buf_prio_rsrv;
+        prio_ref -= prof->ref_prio_rsrv;
+    } while (q);
+    if (prof->prio_strict) {
+        /* Yellow colour is cut off before the lowest class */
+        prio_mem -= prof->buf_prio_rsrv;
+        prio_ref -= prof->ref_prio_rsrv;
+    }
+
+    /* Green watermark matches the highest class, otherwise there will be no
+       strict shared space per class */
+    for (res = 0; res < RES_CNT; res++) {
+        buf_wm.col_shr[res][0] = RES_IS_BUF(res) ? prio_mem / FERRET_BUFFER_CELL_SZ : prio_ref;
+        buf_wm.col_shr[res][1] = buf_wm.prio_shr[res][VTSS_PRIOS - 1];
+    }
+
+    /* Queue and port reservations */
+    buf_wm.q_rsrv[RES_BUF_I] = prof->buf_q_rsrv_i / FERRET_BUFFER_CELL_SZ;
+    buf_wm.q_rsrv[RES_REF_I] = prof->ref_q_rsrv;
+    buf_wm.q_rsrv[RES_BUF_E] = 0;
+    buf_wm.q_rsrv[RES_REF_E] = prof->ref_q_rsrv;
+    buf_wm.p_rsrv[RES_BUF_I] = 0;
+    buf_wm.p_rsrv[RES_REF_I] = prof->ref_p_rsrv;
+    buf_wm.p_rsrv[RES_BUF_E] = prof->buf_p_rsrv_e / FERRET_BUFFER_CELL_SZ;
+    buf_wm.p_rsrv[RES_REF_E] = prof->ref_p_rsrv;
+
+    /* Use per priority shared areas */
+    buf_wm.qos_mode = prof->prio_strict ? 0 : 0xFF;
+}
+
+/* ************************************************************************ */
+static void _h2_buf_wm_write(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the calculated watermarks to the switch chip.
+ * Remarks     : All RES_CFG watermarks of a resource are written in one
+ *               pass, the resources one after the other. Queues outside
+ *               q_rsrv_mask get no reservation.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    vtss_iport_no_t port_no;
+    vtss_cport_no_t port;
+    uchar           res, q;
+
+    H2_WRITE(VTSS_QSYS_RES_QOS_ADV_RES_QOS_MODE,
+             VTSS_F_QSYS_RES_QOS_ADV_RES_QOS_MODE_RES_QOS_RSRVD(buf_wm.qos_mode));
+
+    for (res = 0; res < RES_CNT; res++) {
+        for (port_no = 0; port_no <= MAX_PORT; port_no++) {
+            if (port_no == MAX_PORT) {
+                port = CPU_CHIP_PORT;
+            } else {
+                port = iport2cport(port_no);
+            }
+            for (q = 0; q < VTSS_PRIOS; q++) {
+                H2_WRITE(RES_CFG(res, RES_Q_RSRV(port, q)),
+                         (buf_wm.q_rsrv_mask & (1 << q)) ? _h2_buf_wm_enc(buf_wm.q_rsrv[res]) : 0);
+            }
+            H2_WRITE(RES_CFG(res, RES_P_RSRV(port)), _h2_buf_wm_enc(buf_wm.p_rsrv[res]));
+        }
+        for (q = 0; q < VTSS_PRIOS; q++) {
+            H2_WRITE(RES_CFG(res, RES_PRIO_SHR(q)), _h2_buf_wm_enc(buf_wm.prio_shr[res][q]));
+        }
+        H2_WRITE(RES_CFG(res, RES_COL_SHR(0)), _h2_buf_wm_enc(buf_wm.col_shr[res][0]));
+        H2_WRITE(RES_CFG(res, RES_COL_SHR(1)), _h2_buf_wm_enc(buf_wm.col_shr[res][1]));
+    }
+}
+
+/* ************************************************************************ */
+static ushort _h2_buf_wm_enc(ushort value)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Encode a watermark for RES_CFG.
+ * Remarks     : WM_HIGH is 9 bits, bit 8 selects the unit of 16. Larger
+ *               values than 255 * 16 are cut to that.
+ * Restrictions:
+ * See also    : _h2_buf_wm_get()
+ * Example     :
+ ****************************************************************************/
+{
+    if (value >= MULTIPLIER_BIT) {
+        value /= WM_MULTIPLIER;
+        return MULTIPLIER_BIT + (value > 0xFF ? 0xFF : value);
+    }
+    return value;
+}
+
+/* ************************************************************************ */
+static ulong _h2_buf_wm_get(uchar res, ushort idx)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Read and decode a watermark.
+ * Remarks     : Returns bytes for BUF resources, frames for REF resources.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong reg_val, value;
+
+    H2_READ(RES_CFG(res, idx), reg_val);
+    value = VTSS_X_QSYS_RES_CTRL_RES_CFG_WM_VALE(reg_val);
+    if (VTSS_X_QSYS_RES_CTRL_RES_CFG_WM_MULTIPLIER_UNIT(reg_val)) {
+        value *= WM_MULTIPLIER;
+    }
+    if (RES_IS_BUF(res)) {
+        value *= FERRET_BUFFER_CELL_SZ;
+    }
+    return value;
+}
+
+/* ************************************************************************ */
+static void _h2_buf_wm_print(const char *name, ushort idx)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the watermark of all 4 resources at an index.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     : Class 7: buf 174720/174720, ref 1472/1472
+ ****************************************************************************/
+{
+    print_str(name);
+    print_str("buf ");
+    print_dec(_h2_buf_wm_get(RES_BUF_I, idx));
+    print_ch('/');
+    print_dec(_h2_buf_wm_get(RES_BUF_E, idx));
+    print_str(", ref ");
+    print_dec(_h2_buf_wm_get(RES_REF_I, idx));
+    print_ch('/');
+    print_dec(_h2_buf_wm_get(RES_REF_E, idx));
+    print_cr_lf();
+}
+#endif // TRANSIT_BUF_PROFILE
@@ -0,0 +1,28 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __H2BUF_H__
+#define __H2BUF_H__
+
+#if TRANSIT_BUF_PROFILE
+/*
+ * Buffer profiles, the split of the shared queue system memory into
+ * reserved and shared watermarks (QSYS:RES_CTRL:RES_CFG).
+ */
+#define H2_BUF_PROFILE_DEFAULT  0       /* One MTU per queue, strict priority sharing */
+#define H2_BUF_PROFILE_JUMBO    1       /* One jumbo frame per queue and port */
+#define H2_BUF_PROFILE_QOS      2       /* All queues reserved, a share per class */
+#define H2_BUF_PROFILE_BURST    3       /* Small reservations, large shared pool */
+#define H2_BUF_PROFILE_CNT      4
+
+#define ERROR_BUF_PARM      1           /* Invalid parameter */
+
+void   h2_buf_init (void);
+uchar  h2_buf_profile_set (uchar profile);
+void   h2_buf_print (void);
+void   h2_buf_port_print (vtss_uport_no_t uport);
+#endif // TRANSIT_BUF_PROFILE
+
+#endif
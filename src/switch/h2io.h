@@ -26,6 +26,19 @@ void h2_write_val(ulong value) small;
    The functions are found in h2ioutil.c */
 void h2_write_masked(ulong addr, ulong value, ulong mask)   small;
 
+#if TRANSIT_TASK_WDT
+/* Address of the last register access outside interrupts, for the task
+   watchdog. Set by h2_read and h2_write_addr. */
+extern ulong data h2_last_addr;
+#endif
+
+#if TRANSIT_REG_TRACE
+/* Address and value of the register access passed to h2_trace_sba(). Set by
+   h2_read, h2_write_val and h2_write_addr. */
+extern ulong data h2_trace_addr;
+extern ulong data h2_trace_val;
+#endif
+
 /*****************************************************************************
  * I/O protected functions. Used after EA is enabled;
  ****************************************************************************/
@@ -333,6 +333,16 @@ void h2_mactab_flush_port(vtss_cport_no_t chip_port)
     h2_mactab_age(1, chip_port, 0, 0);
 }
 
+#if TRANSIT_VLAN
+/* Flush the entries learned on a port in one VLAN only */
+void h2_mactab_flush_port_vid(vtss_cport_no_t chip_port, ushort vid)
+{
+    // Age twice means flush
+    h2_mactab_age(1, chip_port, 1, vid);
+    h2_mactab_age(1, chip_port, 1, vid);
+}
+#endif // TRANSIT_VLAN
+
 /*****************************************************************************
  *
  *
@@ -22,6 +22,9 @@ ulong h2_mactab_get_next(mac_tab_t xdata *mac_tab_entry_ptr, BOOL xdata *ipmc_en
 
 void h2_mactab_agetime_set(void);
 void h2_mactab_flush_port(vtss_cport_no_t chip_port);
+#if TRANSIT_VLAN
+void h2_mactab_flush_port_vid(vtss_cport_no_t chip_port, ushort vid);
+#endif // TRANSIT_VLAN
 void h2_mactab_age(uchar pgid_age, uchar pgid, uchar vid_age, ushort vid);
 void h2_mactab_clear(void);
 
@@ -3,6 +3,8 @@
 
 
 
+#include <string.h>
+
 #include "common.h"     /* Always include common.h at the first place of user-defined herder files */
 #include "vtss_api_base_regs.h"
 #include "h2io.h"
@@ -11,11 +13,152 @@
 #if TRANSIT_LACP
 #include "vtss_lacp.h"
 #endif // TRANSIT_LACP
+#if TRANSIT_LAG
+#include "h2aggr.h"
+#endif // TRANSIT_LAG
+#if TRANSIT_MIRROR
+#include "h2mirror.h"
+#endif // TRANSIT_MIRROR
 #include "print.h"
+#if TRANSIT_MAILBOX_RING
+#include "hwport.h"
+#include "phytsk.h"
+#if UNMANAGED_PORT_STATISTICS_IF
+#include "h2stats.h"
+#endif // UNMANAGED_PORT_STATISTICS_IF
+#endif // TRANSIT_MAILBOX_RING
 
 
 #if TRANSIT_MAILBOX_COMM
 
+#if TRANSIT_MAILBOX_RING
+/* The ring must start on a 32-bit word, see h2mailc_ring_init() */
+static uchar xdata ring_mem[sizeof(h2mailc_ring_t) + 3];
+static h2mailc_ring_t xdata *ring;
+
+static ulong ring_get_ulong(uchar xdata *p)
+{
+    return ((ulong) p[0] << 24) | ((ulong) p[1] << 16) | ((ulong) p[2] << 8) | p[3];
+}
+
+static void ring_put_ulong(h2mailc_ring_rsp_t xdata *rsp, ulong val)
+{
+    rsp->payload[rsp->len++] = (uchar) (val >> 24);
+    rsp->payload[rsp->len++] = (uchar) (val >> 16);
+    rsp->payload[rsp->len++] = (uchar) (val >> 8);
+    rsp->payload[rsp->len++] = (uchar) val;
+}
+
+static void h2mailc_ring_init(void)
+{
+    ring = (h2mailc_ring_t xdata *) (((ushort) ring_mem + 3) & ~3);
+    memset(ring, 0, sizeof(h2mailc_ring_t));
+    ring->version = H2MAILC_RING_VERSION;
+    ring->cmd_cnt = H2MAILC_RING_CMD_CNT;
+    ring->rsp_cnt = H2MAILC_RING_RSP_CNT;
+    ring->magic   = H2MAILC_RING_MAGIC;
+}
+
+static h2mailc_ring_rc_t h2mailc_ring_exec(h2mailc_ring_cmd_t xdata *cmd, h2mailc_ring_rsp_t xdata *rsp)
+{
+    vtss_uport_no_t uport;
+    ulong           addr, val;
+    uchar           i;
+
+    switch (cmd->op) {
+    case H2MAILC_RING_OP_NOP:
+        break;
+
+    case H2MAILC_RING_OP_LINK_MASK:
+        val = 0;
+        for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+            if (is_port_link(uport2cport(uport))) {
+                val |= 1UL << uport;
+            }
+        }
+        ring_put_ulong(rsp, val);
+        break;
+
+    case H2MAILC_RING_OP_LINK_MODES:
+        for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+            rsp->payload[rsp->len++] = port_link_mode_get(uport2cport(uport));
+        }
+        break;
+
+#if UNMANAGED_PORT_STATISTICS_IF
+    case H2MAILC_RING_OP_COUNTERS:
+        uport = cmd->arg[0];
+        if (uport == 0 || uport > NO_OF_BOARD_PORTS) {
+            return H2MAILC_RING_RC_BAD_PARM;
+        }
+        for (i = 1; i < sizeof(cmd->arg) && cmd->arg[i] != 0xFF; i++) {
+            ring_put_ulong(rsp, h2_stats_counter_get(uport2cport(uport), (port_statistics_t) cmd->arg[i]));
+        }
+        break;
+#endif // UNMANAGED_PORT_STATISTICS_IF
+
+    case H2MAILC_RING_OP_REG_READ:
+        addr = ring_get_ulong(&cmd->arg[0]);
+        if (cmd->arg[4] == 0 || cmd->arg[4] > H2MAILC_RING_RSP_PAYLOAD_LEN / 4) {
+            return H2MAILC_RING_RC_BAD_PARM;
+        }
+        for (i = 0; i < cmd->arg[4]; i++) {
+            H2_READ(addr, val);
+            ring_put_ulong(rsp, val);
+            addr += 4;
+        }
+        break;
+
+    case H2MAILC_RING_OP_REG_WRITE:
+        addr = ring_get_ulong(&cmd->arg[0]);
+        val  = ring_get_ulong(&cmd->arg[4]);
+        H2_WRITE(addr, val);
+        break;
+
+    case H2MAILC_RING_OP_SYS_MAC_SET:
+        if (flash_write_mac_addr(cmd->arg)) {
+            return H2MAILC_RING_RC_FAIL;
+        }
+#if TRANSIT_SPI_FLASH_JOURNAL
+        if (flash_program_config()) {
+            return H2MAILC_RING_RC_FAIL;
+        }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+        break;
+
+    default:
+        return H2MAILC_RING_RC_BAD_OP;
+    }
+
+    return H2MAILC_RING_RC_OK;
+}
+
+/* Execute the pending commands, at most H2MAILC_RING_CMDS_PER_POLL per call */
+static void h2mailc_ring_poll(void)
+{
+    h2mailc_ring_cmd_t xdata *cmd;
+    h2mailc_ring_rsp_t xdata *rsp;
+    uchar cmd_head = ring->cmd_head;
+    uchar cnt;
+
+    for (cnt = 0; cnt < H2MAILC_RING_CMDS_PER_POLL && ring->cmd_tail != cmd_head; cnt++) {
+        if ((uchar) (ring->rsp_head - ring->rsp_tail) >= H2MAILC_RING_RSP_CNT) {
+            break; /* Response ring is full */
+        }
+
+        cmd = &ring->cmd[ring->cmd_tail % H2MAILC_RING_CMD_CNT];
+        rsp = &ring->rsp[ring->rsp_head % H2MAILC_RING_RSP_CNT];
+        rsp->seq = cmd->seq;
+        rsp->op  = cmd->op;
+        rsp->len = 0;
+        rsp->rc  = h2mailc_ring_exec(cmd, rsp);
+
+        ring->rsp_head++;
+        ring->cmd_tail++;
+    }
+}
+#endif // TRANSIT_MAILBOX_RING
+
 
 void h2mailc_conf_set(h2mailc_conf_t comm_conf)
 {
@@ -29,6 +172,9 @@ void h2mailc_tsk(void)
     BOOL                is_changed = FALSE;
     h2mailc_conf_t      comm_conf;
     uchar               rc = 0;
+#if TRANSIT_LAG
+    uchar               aggr_mode_saved = 0;
+#endif // TRANSIT_LAG
 
     H2_READ(VTSS_DEVCPU_ORG_DEVCPU_ORG_MAILBOX, comm_conf.reg_value);
 
@@ -37,6 +183,9 @@ void h2mailc_tsk(void)
         is_changed = TRUE;
         comm_conf.reg_value = 0;
         comm_conf.reg_bit.conf_oper = H2MAILC_OPER_READY;
+#if TRANSIT_MAILBOX_RING
+        h2mailc_ring_init();
+#endif // TRANSIT_MAILBOX_RING
 
     } else { // Normal state (none initial state)
         if (comm_conf.reg_bit.conf_oper == H2MAILC_OPER_REQUIRE) {
@@ -63,6 +212,12 @@ void h2mailc_tsk(void)
                     break;
                 case H2MAILC_TYPE_SYS_MAC_APPLY:
                     rc = flash_write_mac_addr(&sys_mac_buf);
+#if TRANSIT_SPI_FLASH_JOURNAL
+                    /* Persist it right away, it is only a journal record append */
+                    if (!rc) {
+                        rc = flash_program_config();
+                    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
                     break;
     
 #if TRANSIT_LACP
@@ -82,6 +237,56 @@ void h2mailc_tsk(void)
                     break;
                 }
 #endif // TRANSIT_LACP
+
+#if TRANSIT_MAILBOX_RING
+                case H2MAILC_TYPE_RING_ADDR:
+                    break;
+#endif // TRANSIT_MAILBOX_RING
+
+#if TRANSIT_LAG
+                case H2MAILC_TYPE_AGGR_MODE_SET:
+                    rc = h2_aggr_set_mode(comm_conf.reg_bit.conf_data.general.data0);
+#if TRANSIT_SPI_FLASH_JOURNAL
+                    if (!rc) {
+                        rc = flash_program_config();
+                        aggr_mode_saved = (rc == 0);
+                    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+                    break;
+#endif // TRANSIT_LAG
+
+#if TRANSIT_MIRROR
+                case H2MAILC_TYPE_MIRROR_DEST_SET:
+                case H2MAILC_TYPE_MIRROR_PORT_SET:
+                case H2MAILC_TYPE_MIRROR_VID_SET: {
+                    h2_mirror_conf_t mirror_conf;
+                    uchar            data0 = comm_conf.reg_bit.conf_data.general.data0;
+                    uchar            data1 = comm_conf.reg_bit.conf_data.general.data1;
+                    ulong            uport_bit = (ulong) 1 << (data0 & 0x1F);
+
+                    h2_mirror_conf_get(&mirror_conf);
+                    if (comm_conf.reg_bit.conf_type == H2MAILC_TYPE_MIRROR_DEST_SET) {
+                        mirror_conf.dest = data0;
+                        mirror_conf.cpu = data1 & 0x1;
+                    } else if (comm_conf.reg_bit.conf_type == H2MAILC_TYPE_MIRROR_PORT_SET) {
+                        if (data0 < 1 || data0 > NO_OF_BOARD_PORTS) {
+                            rc = ERROR_MIRROR_PARM;
+                            break;
+                        }
+                        mirror_conf.rx_mask = (data1 & 0x1) ? (mirror_conf.rx_mask | uport_bit) : (mirror_conf.rx_mask & ~uport_bit);
+                        mirror_conf.tx_mask = (data1 & 0x2) ? (mirror_conf.tx_mask | uport_bit) : (mirror_conf.tx_mask & ~uport_bit);
+                    } else {
+                        mirror_conf.vid = ((ushort) data1 << 8) | data0;
+                    }
+                    rc = h2_mirror_conf_set(&mirror_conf);
+#if TRANSIT_SPI_FLASH_JOURNAL
+                    if (!rc) {
+                        rc = flash_program_config();
+                    }
+#endif // TRANSIT_SPI_FLASH_JOURNAL
+                    break;
+                }
+#endif // TRANSIT_MIRROR
     
                 default:
             println_str("%% unknown configured type for MAILBOX communication");
@@ -99,12 +304,27 @@ void h2mailc_tsk(void)
             comm_conf.reg_bit.conf_data.general.data0 = 0;
             comm_conf.reg_bit.conf_data.general.data1 = 0;
             comm_conf.reg_bit.conf_data.general.data2 = rc;
+#if TRANSIT_MAILBOX_RING
+            if (comm_conf.reg_bit.conf_type == H2MAILC_TYPE_RING_ADDR) {
+                comm_conf.reg_bit.conf_data.general.data1 = (uchar) ((ushort) ring >> 8);
+                comm_conf.reg_bit.conf_data.general.data0 = (uchar) (ushort) ring;
+            }
+#endif // TRANSIT_MAILBOX_RING
+#if TRANSIT_LAG
+            if (comm_conf.reg_bit.conf_type == H2MAILC_TYPE_AGGR_MODE_SET) {
+                comm_conf.reg_bit.conf_data.general.data0 = aggr_mode_saved;
+            }
+#endif // TRANSIT_LAG
         } // End Normal state
     }
 
     if (is_changed) {
         h2mailc_conf_set(comm_conf);
     }
+
+#if TRANSIT_MAILBOX_RING
+    h2mailc_ring_poll();
+#endif // TRANSIT_MAILBOX_RING
 }
 
 #endif // TRANSIT_MAILBOX_COMM
@@ -36,6 +36,20 @@ typedef enum {
     H2MAILC_TYPE_LACP_DISABLE,      // Disable LACP on specific port.
 #endif // TRANSIT_LACP
 
+#if TRANSIT_MAILBOX_RING
+    H2MAILC_TYPE_RING_ADDR,         // Reply the 8051 memory address of the command ring in <conf_data>.
+#endif // TRANSIT_MAILBOX_RING
+
+#if TRANSIT_LAG
+    H2MAILC_TYPE_AGGR_MODE_SET,     // Set and save the aggregation hash mode (H2_AGGR_HASH_xxx) in <data0>. The reply <data0> is 1 when it was saved, 0 when it is lost at the next boot (no TRANSIT_SPI_FLASH_JOURNAL).
+#endif // TRANSIT_LAG
+
+#if TRANSIT_MIRROR
+    H2MAILC_TYPE_MIRROR_DEST_SET,   // Set and save the mirror destination uport in <data0>, 0 is off, and the CPU source in bit 0 of <data1>.
+    H2MAILC_TYPE_MIRROR_PORT_SET,   // Set and save the mirror source uport <data0>, ingress in bit 0 and egress in bit 1 of <data1>.
+    H2MAILC_TYPE_MIRROR_VID_SET,    // Set and save the mirror source VLAN, <data1> MSB and <data0> LSB, 0 is none.
+#endif // TRANSIT_MIRROR
+
     H2MAILC_TYPE_CNT                // Total count of types
 } h2mailc_type_t;
 
@@ -84,6 +98,85 @@ typedef union {
     ulong reg_value;
 } h2mailc_conf_t;
 
+#if TRANSIT_MAILBOX_RING
+/* Command ring in the onchip 8051 memory.
+ *
+ * The external CPU gets the byte address of h2mailc_ring_t with the
+ * mailbox type H2MAILC_TYPE_RING_ADDR, the address is returned in the
+ * lower 16 bits of <conf_data>. It reads and writes the ring with the
+ * ICPU_CFG:MPU8051:MEMACC load/examine mechanism, staging the data in the
+ * 8 general purpose registers (ICPU_CFG:CPU_SYSTEM_CTRL:GPR). MEMACC moves
+ * 32-bit words, so every word of the ring is written by one side only.
+ * Multi byte fields are MSB first.
+ *
+ * 1. The external CPU writes one or more commands at cmd[cmd_head % cnt]
+ *    and then advances cmd_head once for the whole batch.
+ * 2. Every 10ms the iCPU executes up to H2MAILC_RING_CMDS_PER_POLL
+ *    commands, writes a response with the seq of the command at
+ *    rsp[rsp_head % cnt] and advances cmd_tail and rsp_head. Commands wait
+ *    while the response ring is full.
+ * 3. The external CPU reads the responses and advances rsp_tail.
+ *
+ * The indexes count from 0 to 255 and wrap around.
+ */
+#define H2MAILC_RING_MAGIC              0x4D
+#define H2MAILC_RING_VERSION            1
+#define H2MAILC_RING_CMD_CNT            8
+#define H2MAILC_RING_RSP_CNT            4
+#define H2MAILC_RING_RSP_PAYLOAD_LEN    32
+#define H2MAILC_RING_CMDS_PER_POLL      4
+
+typedef enum {
+    H2MAILC_RING_OP_NOP,            // No operation
+    H2MAILC_RING_OP_LINK_MASK,      // Response: <uport link mask>(32-bit), bit n is uport n
+    H2MAILC_RING_OP_LINK_MODES,     // Response: <link mode (LINK_MODE_xxx)>(8-bit) per uport
+    H2MAILC_RING_OP_COUNTERS,       // <uport> <counter id>... (0xFF ends), response: <counter>(32-bit) per id
+    H2MAILC_RING_OP_REG_READ,       // <addr>(32-bit) <cnt>(1-8), response: <value>(32-bit) per register
+    H2MAILC_RING_OP_REG_WRITE,      // <addr>(32-bit) <value>(32-bit)
+    H2MAILC_RING_OP_SYS_MAC_SET,    // <MAC address>(48-bit), set and apply the system MAC address
+} h2mailc_ring_op_t;
+
+typedef enum {
+    H2MAILC_RING_RC_OK,
+    H2MAILC_RING_RC_BAD_OP,
+    H2MAILC_RING_RC_BAD_PARM,
+    H2MAILC_RING_RC_FAIL
+} h2mailc_ring_rc_t;
+
+typedef struct {
+    uchar   seq;                    // Returned in the response
+    uchar   op;                     // h2mailc_ring_op_t
+    uchar   reserved[2];
+    uchar   arg[8];
+} h2mailc_ring_cmd_t;
+
+typedef struct {
+    uchar   seq;
+    uchar   op;
+    uchar   rc;                     // h2mailc_ring_rc_t
+    uchar   len;                    // Valid bytes in payload
+    uchar   payload[H2MAILC_RING_RSP_PAYLOAD_LEN];
+} h2mailc_ring_rsp_t;
+
+typedef struct {
+    // Written by the iCPU
+    uchar               magic;      // H2MAILC_RING_MAGIC when the ring is ready
+    uchar               version;    // H2MAILC_RING_VERSION
+    uchar               cmd_cnt;    // H2MAILC_RING_CMD_CNT
+    uchar               rsp_cnt;    // H2MAILC_RING_RSP_CNT
+    uchar               cmd_tail, reserved1[3];
+    uchar               rsp_head, reserved2[3];
+
+    // Written by the external CPU
+    uchar               cmd_head, reserved3[3];
+    uchar               rsp_tail, reserved4[3];
+    h2mailc_ring_cmd_t  cmd[H2MAILC_RING_CMD_CNT];
+
+    // Written by the iCPU
+    h2mailc_ring_rsp_t  rsp[H2MAILC_RING_RSP_CNT];
+} h2mailc_ring_t;
+#endif // TRANSIT_MAILBOX_RING
+
 void h2mailc_conf_set(h2mailc_conf_t comm_conf);
 void h2mailc_tsk(void);
 
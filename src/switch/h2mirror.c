@@ -0,0 +1,220 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_MIRROR
+#include <string.h>
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "h2mirror.h"
+#include "h2vlan.h"
+#include "hwport.h"
+#include "spiflash.h"
+#include "print.h"
+#if UNMANAGED_PORT_STATISTICS_IF
+#include "h2stats.h"
+#endif // UNMANAGED_PORT_STATISTICS_IF
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* Bit 1 to NO_OF_BOARD_PORTS */
+#define MIRROR_UPORT_MASK       ((((ulong) 1 << NO_OF_BOARD_PORTS) - 1) << 1)
+
+#define MIRROR_VID_MAX          4095
+
+/*****************************************************************************
+ *
+ *
+ * Prototypes for local functions
+ *
+ *
+ *
+ ****************************************************************************/
+static BOOL _h2_mirror_conf_valid(const h2_mirror_conf_t *conf);
+static void _h2_mirror_apply(void);
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+/* The applied configuration */
+static h2_mirror_conf_t xdata mirror_conf;
+
+/* ************************************************************************ */
+void h2_mirror_init (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Apply the mirror configuration in flash.
+ * Remarks     : An invalid (erased) configuration turns mirroring off.
+ *               Must be called after h2_vlan_init(), which writes the VLAN
+ *               table.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    flash_read_mirror_conf(&mirror_conf);
+    if (!_h2_mirror_conf_valid(&mirror_conf)) {
+        memset(&mirror_conf, 0, sizeof(mirror_conf));
+    }
+    _h2_mirror_apply();
+    flash_write_mirror_conf(&mirror_conf);
+}
+
+/* ************************************************************************ */
+void h2_mirror_conf_get (h2_mirror_conf_t *conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the mirror configuration.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    *conf = mirror_conf;
+}
+
+/* ************************************************************************ */
+uchar h2_mirror_conf_set (const h2_mirror_conf_t *conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the mirror configuration.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_MIRROR_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (!_h2_mirror_conf_valid(conf)) {
+        return ERROR_MIRROR_PARM;
+    }
+
+    mirror_conf = *conf;
+    _h2_mirror_apply();
+    flash_write_mirror_conf(&mirror_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+void h2_mirror_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the mirror configuration and the drop counters.
+ * Remarks     : When the destination port is oversubscribed the mirror
+ *               copies are dropped at its egress queues, as tx drops, or
+ *               at the ingress of the source port, as tail drops.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    vtss_uport_no_t uport;
+    ulong           uport_bit;
+
+    print_str("Destination: ");
+    if (mirror_conf.dest == 0) {
+        println_str("off");
+        return;
+    }
+    print_dec(mirror_conf.dest);
+#if UNMANAGED_PORT_STATISTICS_IF
+    print_str(", tx drops ");
+    print_dec(h2_stats_counter_get(uport2cport(mirror_conf.dest), CNT_TX_DROP) +
+              h2_stats_counter_get(uport2cport(mirror_conf.dest), CNT_TX_AGED));
+#endif // UNMANAGED_PORT_STATISTICS_IF
+    print_cr_lf();
+
+    print_str("CPU: ");
+    println_str(mirror_conf.cpu ? "on" : "off");
+    print_str("VLAN: ");
+    if (mirror_conf.vid == 0) {
+        print_str("none");
+    } else {
+        print_dec(mirror_conf.vid);
+    }
+    print_cr_lf();
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        uport_bit = (ulong) 1 << uport;
+        if (!((mirror_conf.rx_mask | mirror_conf.tx_mask) & uport_bit)) {
+            continue;
+        }
+        print_str("Port ");
+        print_dec(uport);
+        print_str(":");
+        print_str(mirror_conf.rx_mask & uport_bit ? " rx" : "");
+        print_str(mirror_conf.tx_mask & uport_bit ? " tx" : "");
+#if UNMANAGED_PORT_STATISTICS_IF
+        print_str(", tail drops ");
+        print_dec(h2_stats_counter_get(uport2cport(uport), CNT_DROP_TAIL));
+#endif // UNMANAGED_PORT_STATISTICS_IF
+        print_cr_lf();
+    }
+}
+
+/* ************************************************************************ */
+static BOOL _h2_mirror_conf_valid(const h2_mirror_conf_t *conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Check a mirror configuration.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (conf->dest > NO_OF_BOARD_PORTS || conf->cpu > 1 || conf->vid > MIRROR_VID_MAX ||
+        ((conf->rx_mask | conf->tx_mask) & ~MIRROR_UPORT_MASK)) {
+        return FALSE;
+    }
+    if (conf->dest != 0 && ((conf->rx_mask | conf->tx_mask) & ((ulong) 1 << conf->dest))) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* ************************************************************************ */
+static void _h2_mirror_apply(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the mirror configuration to the switch chip.
+ * Remarks     : All sources are turned off while there is no destination.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    vtss_uport_no_t uport;
+    vtss_cport_no_t chip_port;
+    ulong           emask = 0;
+    BOOL            on = (mirror_conf.dest != 0);
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        chip_port = uport2cport(uport);
+        H2_WRITE_MASKED(VTSS_ANA_PORT_PORT_CFG(chip_port),
+                        VTSS_F_ANA_PORT_PORT_CFG_SRC_MIRROR_ENA(on && (mirror_conf.rx_mask & ((ulong) 1 << uport))),
+                        VTSS_M_ANA_PORT_PORT_CFG_SRC_MIRROR_ENA);
+        if (on && (mirror_conf.tx_mask & ((ulong) 1 << uport))) {
+            emask |= PORT_BIT_MASK(chip_port);
+        }
+    }
+
+    H2_WRITE(VTSS_ANA_ANA_EMIRRORPORTS, emask);
+    H2_WRITE_MASKED(VTSS_ANA_ANA_AGENCTRL,
+                    VTSS_F_ANA_ANA_AGENCTRL_MIRROR_CPU(on && mirror_conf.cpu),
+                    VTSS_M_ANA_ANA_AGENCTRL_MIRROR_CPU);
+    h2_vlan_mirror_set(on ? mirror_conf.vid : 0);
+    H2_WRITE(VTSS_ANA_ANA_MIRRORPORTS, on ? PORT_BIT_MASK(uport2cport(mirror_conf.dest)) : 0);
+}
+#endif // TRANSIT_MIRROR
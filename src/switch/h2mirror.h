@@ -0,0 +1,32 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __H2MIRROR_H__
+#define __H2MIRROR_H__
+
+#if TRANSIT_MIRROR
+/*
+ * Port mirroring (SPAN). Frames received on the ports of rx_mask, sent on
+ * the ports of tx_mask, classified to vid, or sent to the CPU extraction
+ * queues are copied to the destination port. The sources add up, a frame
+ * is mirrored once. The destination port cannot be a source.
+ */
+typedef struct {
+    ulong   rx_mask;                    /* Ingress sources, bit n is uport n */
+    ulong   tx_mask;                    /* Egress sources, bit n is uport n */
+    ushort  vid;                        /* Mirror frames of this VLAN, 0 is none */
+    uchar   cpu;                        /* Mirror frames to the CPU */
+    uchar   dest;                       /* Destination uport, 0 is off */
+} h2_mirror_conf_t;
+
+#define ERROR_MIRROR_PARM   1           /* Invalid parameter */
+
+void   h2_mirror_init (void);
+void   h2_mirror_conf_get (h2_mirror_conf_t *conf);
+uchar  h2_mirror_conf_set (const h2_mirror_conf_t *conf);
+void   h2_mirror_print (void);
+#endif // TRANSIT_MIRROR
+
+#endif
@@ -107,6 +107,7 @@ typedef struct vtss_eth_hdr_t {
 } vtss_eth_hdr;
 
 #define VTSS_ETHTYPE_ARP  0x0806
+#define VTSS_ETHTYPE_CTAG 0x8100
 #define VTSS_ETHTYPE_IP   0x0800
 #define VTSS_ETHTYPE_SLOW 0x8809
 #define VTSS_ETHTYPE_IP6  0x86dd
@@ -194,14 +195,27 @@ typedef struct {
 #define PACKET_XTR_QU_SPROUT        PACKET_XTR_QU_HIGH
 #define PACKET_XTR_QU_STACK         PACKET_XTR_QU_HIGH
 #define PACKET_XTR_QU_BPDU_LLDP     PACKET_XTR_QU_HIGH /* For Ferret, we use the same queue(7) for BPDU and LLDP frame */
+#if TRANSIT_CPU_PROTECT
+/* One queue per protocol, the CPU port serves the queues in strict priority */
+#define PACKET_XTR_QU_LLDP          PACKET_XTR_QU_HIGH
+#define PACKET_XTR_QU_SLOW          PACKET_XTR_QU_MEDIUM_HIGH /* Slow protocols, LACP */
+#define PACKET_XTR_QU_MAC_COPY      PACKET_XTR_QU_MEDIUM      /* MAC table copies, e.g. the own MAC looped back */
+#define PACKET_XTR_QU_BPDU          PACKET_XTR_QU_MEDIUM_LOW
+#define PACKET_XTR_QU_IGMP          PACKET_XTR_QU_NORMAL_HIGH
+#else
+#define PACKET_XTR_QU_LLDP          PACKET_XTR_QU_BPDU_LLDP
+#define PACKET_XTR_QU_SLOW          PACKET_XTR_QU_BPDU_LLDP
+#define PACKET_XTR_QU_MAC_COPY      PACKET_XTR_QU_IP
 #define PACKET_XTR_QU_BPDU          PACKET_XTR_QU_MEDIUM
 #define PACKET_XTR_QU_IGMP          PACKET_XTR_QU_MEDIUM
+#endif // TRANSIT_CPU_PROTECT
 #define PACKET_XTR_QU_IP            PACKET_XTR_QU_NORMAL
 #define PACKET_XTR_QU_MGMT_MAC      PACKET_XTR_QU_NORMAL /* For the switch's own MAC address                */
 #define PACKET_XTR_QU_MAC           PACKET_XTR_QU_LOW    /* For other MAC addresses that require CPU copies */
 #define PACKET_XTR_QU_BC            PACKET_XTR_QU_LOW    /* For Broadcast MAC address frames                */
 #define PACKET_XTR_QU_LEARN         PACKET_XTR_QU_LOW /* For the sake of MAC-based Authentication */
 #define PACKET_XTR_QU_ACL           PACKET_XTR_QU_LOW
+#define PACKET_XTR_QU_SFLOW         PACKET_XTR_QU_NORMAL_LOW /* sFlow samples only */
 
 #endif
 
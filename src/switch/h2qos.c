@@ -0,0 +1,415 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_QOS
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "h2qos.h"
+#include "hwport.h"
+#include "spiflash.h"
+#include "print.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ANA:PORT:QOS_PCP_DEI_MAP_CFG index is 8 * DEI + PCP */
+#define PCP_DEI_MAP_CNT         16
+
+/* QSYS:HSCH:SE_DWRR_CFG:DWRR_COST, the bandwidth share is 1 / (cost + 1) */
+#define DWRR_COST_MAX           31
+
+/* The scheduler element serving the queues of a chip port */
+#define QOS_PORT_SE(chip_port)  (chip_port)
+
+/* Per QoS class counters, the drops are counted at the ingress port */
+#define STAT_TX_YELLOW_PRIO_0   0x4e
+#define STAT_TX_GREEN_PRIO_0    0x56
+#define STAT_DR_YELLOW_PRIO_0   0x82
+#define STAT_DR_GREEN_PRIO_0    0x8a
+
+#define DSCP_QUEUE_GET(conf, dscp) \
+    (((dscp) & 1) ? ((conf).dscp_queue[(dscp) >> 1] & 0xF) : ((conf).dscp_queue[(dscp) >> 1] >> 4))
+
+/*****************************************************************************
+ *
+ *
+ * Prototypes for local functions
+ *
+ *
+ *
+ ****************************************************************************/
+static void _h2_qos_dscp_put(uchar dscp, uchar queue);
+static void _h2_qos_pcp_apply(uchar pcp);
+static void _h2_qos_dscp_apply(uchar dscp);
+static void _h2_qos_port_apply(vtss_uport_no_t uport);
+static ulong _h2_qos_stat_get(vtss_uport_no_t uport, uchar yellow_idx, uchar green_idx);
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+/* The applied configuration */
+static h2_qos_conf_t xdata qos_conf;
+
+/* ************************************************************************ */
+void h2_qos_init (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Apply the QoS configuration in flash.
+ * Remarks     : Invalid (erased) settings get the chip defaults: PCP and
+ *               DSCP class selector maps, classification by port default
+ *               queue 0 and strict priority scheduling.
+ *               The maps and all ports are written in one batch at boot,
+ *               before the ports are enabled.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_qos_port_conf_t xdata *port_conf;
+    vtss_uport_no_t          uport;
+    uchar                    idx;
+
+    flash_read_qos_conf(&qos_conf);
+
+    for (idx = 0; idx < H2_QOS_PCP_CNT; idx++) {
+        if (qos_conf.pcp_queue[idx] >= H2_QOS_QUEUE_CNT) {
+            qos_conf.pcp_queue[idx] = idx;
+        }
+        _h2_qos_pcp_apply(idx);
+    }
+
+    for (idx = 0; idx < H2_QOS_DSCP_CNT; idx++) {
+        if (DSCP_QUEUE_GET(qos_conf, idx) >= H2_QOS_QUEUE_CNT) {
+            _h2_qos_dscp_put(idx, idx >> 3);
+        }
+        _h2_qos_dscp_apply(idx);
+    }
+
+    for (idx = 0; idx < H2_QOS_QUEUE_CNT; idx++) {
+        if (qos_conf.weight[idx] == 0 || qos_conf.weight[idx] > H2_QOS_WEIGHT_MAX) {
+            qos_conf.weight[idx] = 1;
+        }
+    }
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        port_conf = &qos_conf.port[uport - 1];
+        if (port_conf->trust > H2_QOS_TRUST_DSCP || port_conf->default_queue >= H2_QOS_QUEUE_CNT ||
+            port_conf->dwrr_cnt > H2_QOS_QUEUE_CNT) {
+            port_conf->trust = H2_QOS_TRUST_PORT;
+            port_conf->default_queue = 0;
+            port_conf->dwrr_cnt = 0;
+        }
+        _h2_qos_port_apply(uport);
+    }
+
+    flash_write_qos_conf(&qos_conf);
+}
+
+/* ************************************************************************ */
+uchar h2_qos_port_set (vtss_uport_no_t uport, const h2_qos_port_conf_t *port_conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the classification and the scheduling of a port.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_QOS_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (uport < 1 || uport > NO_OF_BOARD_PORTS || port_conf->trust > H2_QOS_TRUST_DSCP ||
+        port_conf->default_queue >= H2_QOS_QUEUE_CNT || port_conf->dwrr_cnt > H2_QOS_QUEUE_CNT) {
+        return ERROR_QOS_PARM;
+    }
+
+    qos_conf.port[uport - 1] = *port_conf;
+    _h2_qos_port_apply(uport);
+    flash_write_qos_conf(&qos_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+uchar h2_qos_pcp_set (uchar pcp, uchar queue)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the queue of a PCP value, on all ports.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_QOS_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (pcp >= H2_QOS_PCP_CNT || queue >= H2_QOS_QUEUE_CNT) {
+        return ERROR_QOS_PARM;
+    }
+
+    qos_conf.pcp_queue[pcp] = queue;
+    _h2_qos_pcp_apply(pcp);
+    flash_write_qos_conf(&qos_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+uchar h2_qos_dscp_set (uchar dscp, uchar queue)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the queue of a DSCP value.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_QOS_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (dscp >= H2_QOS_DSCP_CNT || queue >= H2_QOS_QUEUE_CNT) {
+        return ERROR_QOS_PARM;
+    }
+
+    _h2_qos_dscp_put(dscp, queue);
+    _h2_qos_dscp_apply(dscp);
+    flash_write_qos_conf(&qos_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+uchar h2_qos_weight_set (uchar queue, uchar weight)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the DWRR weight of a queue.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_QOS_PARM.
+ *               The schedulers of all ports are rewritten.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    vtss_uport_no_t uport;
+
+    if (queue >= H2_QOS_QUEUE_CNT || weight == 0 || weight > H2_QOS_WEIGHT_MAX) {
+        return ERROR_QOS_PARM;
+    }
+
+    qos_conf.weight[queue] = weight;
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        _h2_qos_port_apply(uport);
+    }
+    flash_write_qos_conf(&qos_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+void h2_qos_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the QoS configuration.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_qos_port_conf_t xdata *port_conf;
+    vtss_uport_no_t          uport;
+    uchar                    idx;
+
+    print_str("PCP queue:   ");
+    for (idx = 0; idx < H2_QOS_PCP_CNT; idx++) {
+        print_dec(qos_conf.pcp_queue[idx]);
+        print_spaces(1);
+    }
+    print_cr_lf();
+
+    print_str("DWRR weight: ");
+    for (idx = 0; idx < H2_QOS_QUEUE_CNT; idx++) {
+        print_dec(qos_conf.weight[idx]);
+        print_spaces(1);
+    }
+    print_cr_lf();
+
+    print_str("DSCP queue:");
+    for (idx = 0; idx < H2_QOS_DSCP_CNT; idx++) {
+        if ((idx % 16) == 0) {
+            print_cr_lf();
+            print_spaces(2);
+        }
+        print_dec(DSCP_QUEUE_GET(qos_conf, idx));
+        print_spaces(1);
+    }
+    print_cr_lf();
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        port_conf = &qos_conf.port[uport - 1];
+        print_str("Port ");
+        print_dec(uport);
+        print_str(port_conf->trust == H2_QOS_TRUST_PCP ? ": PCP" :
+                  port_conf->trust == H2_QOS_TRUST_DSCP ? ": DSCP" : ": port");
+        print_str(", default queue ");
+        print_dec(port_conf->default_queue);
+        print_str(", DWRR queues ");
+        print_dec(port_conf->dwrr_cnt);
+        print_cr_lf();
+    }
+}
+
+/* ************************************************************************ */
+void h2_qos_queue_print (vtss_uport_no_t uport)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the per queue counters of a port.
+ * Remarks     : Tx is the frames sent from the queue of the port. Drops
+ *               is the frames received on the port which the queue system
+ *               dropped, counted by their queue. The counters are cleared
+ *               along with the other port counters.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar queue;
+
+    for (queue = 0; queue < H2_QOS_QUEUE_CNT; queue++) {
+        print_str("Queue ");
+        print_dec(queue);
+        print_str(": tx ");
+        print_dec(_h2_qos_stat_get(uport, STAT_TX_YELLOW_PRIO_0 + queue, STAT_TX_GREEN_PRIO_0 + queue));
+        print_str(", drops ");
+        print_dec(_h2_qos_stat_get(uport, STAT_DR_YELLOW_PRIO_0 + queue, STAT_DR_GREEN_PRIO_0 + queue));
+        print_cr_lf();
+    }
+}
+
+/* ************************************************************************ */
+static void _h2_qos_dscp_put(uchar dscp, uchar queue)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the queue of a DSCP value in the configuration.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar xdata *p = &qos_conf.dscp_queue[dscp >> 1];
+
+    if (dscp & 1) {
+        *p = (*p & 0xF0) | queue;
+    } else {
+        *p = (*p & 0x0F) | (queue << 4);
+    }
+}
+
+/* ************************************************************************ */
+static void _h2_qos_pcp_apply(uchar pcp)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the queue of a PCP value to all ports.
+ * Remarks     : The DEI is not used for the queue, both DEI entries get
+ *               the same queue.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    vtss_uport_no_t uport;
+    vtss_cport_no_t chip_port;
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        chip_port = uport2cport(uport);
+        H2_WRITE(VTSS_ANA_PORT_QOS_PCP_DEI_MAP_CFG(chip_port, pcp),
+                 VTSS_F_ANA_PORT_QOS_PCP_DEI_MAP_CFG_QOS_PCP_DEI_VAL(qos_conf.pcp_queue[pcp]));
+        H2_WRITE(VTSS_ANA_PORT_QOS_PCP_DEI_MAP_CFG(chip_port, pcp + H2_QOS_PCP_CNT),
+                 VTSS_F_ANA_PORT_QOS_PCP_DEI_MAP_CFG_QOS_PCP_DEI_VAL(qos_conf.pcp_queue[pcp]));
+    }
+}
+
+/* ************************************************************************ */
+static void _h2_qos_dscp_apply(uchar dscp)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the queue of a DSCP value to the switch chip.
+ * Remarks     : All DSCP values are trusted, ports use them with
+ *               QOS_DSCP_ENA.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    H2_WRITE_MASKED(VTSS_ANA_COMMON_DSCP_CFG(dscp),
+                    VTSS_F_ANA_COMMON_DSCP_CFG_QOS_DSCP_VAL(DSCP_QUEUE_GET(qos_conf, dscp)) |
+                    VTSS_F_ANA_COMMON_DSCP_CFG_DSCP_TRUST_ENA(1),
+                    VTSS_M_ANA_COMMON_DSCP_CFG_QOS_DSCP_VAL |
+                    VTSS_M_ANA_COMMON_DSCP_CFG_DSCP_TRUST_ENA);
+}
+
+/* ************************************************************************ */
+static void _h2_qos_port_apply(vtss_uport_no_t uport)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the classification and the scheduler of a port to
+ *               the switch chip.
+ * Remarks     : The DWRR cost of a queue is inverse to its weight, the
+ *               lowest weight of the DWRR queues gets the highest cost.
+ * Restrictions:
+ * See also    :
+ * Example     : Weights 1 and 4 give the costs 31 and 7, so the second
+ *               queue gets 4 times the bandwidth of the first.
+ ****************************************************************************/
+{
+    h2_qos_port_conf_t xdata *port_conf = &qos_conf.port[uport - 1];
+    vtss_cport_no_t          chip_port = uport2cport(uport);
+    uchar                    queue, weight_min, cost;
+
+    H2_WRITE_MASKED(VTSS_ANA_PORT_QOS_CFG(chip_port),
+                    VTSS_F_ANA_PORT_QOS_CFG_QOS_DEFAULT_VAL(port_conf->default_queue) |
+                    VTSS_F_ANA_PORT_QOS_CFG_QOS_PCP_ENA(port_conf->trust == H2_QOS_TRUST_PCP) |
+                    VTSS_F_ANA_PORT_QOS_CFG_QOS_DSCP_ENA(port_conf->trust == H2_QOS_TRUST_DSCP),
+                    VTSS_M_ANA_PORT_QOS_CFG_QOS_DEFAULT_VAL |
+                    VTSS_M_ANA_PORT_QOS_CFG_QOS_PCP_ENA |
+                    VTSS_M_ANA_PORT_QOS_CFG_QOS_DSCP_ENA);
+
+    weight_min = H2_QOS_WEIGHT_MAX;
+    for (queue = 0; queue < port_conf->dwrr_cnt; queue++) {
+        if (qos_conf.weight[queue] < weight_min) {
+            weight_min = qos_conf.weight[queue];
+        }
+    }
+    for (queue = 0; queue < port_conf->dwrr_cnt; queue++) {
+        cost = ((ushort) weight_min * (DWRR_COST_MAX + 1)) / qos_conf.weight[queue];
+        H2_WRITE(VTSS_QSYS_HSCH_SE_DWRR_CFG(QOS_PORT_SE(chip_port), queue),
+                 VTSS_F_QSYS_HSCH_SE_DWRR_CFG_DWRR_COST(cost ? cost - 1 : 0));
+    }
+    H2_WRITE_MASKED(VTSS_QSYS_HSCH_SE_CFG(QOS_PORT_SE(chip_port)),
+                    VTSS_F_QSYS_HSCH_SE_CFG_SE_DWRR_CNT(port_conf->dwrr_cnt),
+                    VTSS_M_QSYS_HSCH_SE_CFG_SE_DWRR_CNT);
+}
+
+/* ************************************************************************ */
+static ulong _h2_qos_stat_get(vtss_uport_no_t uport, uchar yellow_idx, uchar green_idx)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the sum of a yellow and a green counter of a port.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong yellow, green;
+
+    H2_WRITE_MASKED(VTSS_SYS_SYSTEM_STAT_CFG,
+                    VTSS_F_SYS_SYSTEM_STAT_CFG_STAT_VIEW(uport2cport(uport)),
+                    VTSS_M_SYS_SYSTEM_STAT_CFG_STAT_VIEW);
+    H2_READ(VTSS_SYS_STAT_CNT(yellow_idx), yellow);
+    H2_READ(VTSS_SYS_STAT_CNT(green_idx), green);
+    return yellow + green;
+}
+#endif // TRANSIT_QOS
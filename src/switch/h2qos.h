@@ -0,0 +1,51 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __H2QOS_H__
+#define __H2QOS_H__
+
+#if TRANSIT_QOS
+#define H2_QOS_QUEUE_CNT        8       /* QoS classes, one egress queue each */
+#define H2_QOS_PCP_CNT          8
+#define H2_QOS_DSCP_CNT         64
+#define H2_QOS_WEIGHT_MAX       100
+
+/* Ingress classification of a port */
+#define H2_QOS_TRUST_PORT       0       /* All frames get the port default queue */
+#define H2_QOS_TRUST_PCP        1       /* Tagged frames by PCP */
+#define H2_QOS_TRUST_DSCP       2       /* IP frames by DSCP */
+
+/*
+ * Frames are classified to a QoS class, which is the egress queue, by the
+ * PCP or DSCP map of the trusted field, otherwise the port default queue
+ * is used. The egress scheduler of a port serves the lowest dwrr_cnt
+ * queues by DWRR with the shared weights, the queues above in strict
+ * priority, highest queue first. dwrr_cnt 0 is strict priority only.
+ */
+typedef struct {
+    uchar   trust;                      /* H2_QOS_TRUST_xxx */
+    uchar   default_queue;
+    uchar   dwrr_cnt;                   /* 0 - H2_QOS_QUEUE_CNT */
+} h2_qos_port_conf_t;
+
+typedef struct {
+    uchar               pcp_queue[H2_QOS_PCP_CNT];
+    uchar               dscp_queue[H2_QOS_DSCP_CNT / 2];    /* Even DSCP in the high nibble */
+    uchar               weight[H2_QOS_QUEUE_CNT];          /* DWRR weight, 1 - H2_QOS_WEIGHT_MAX */
+    h2_qos_port_conf_t  port[NO_OF_BOARD_PORTS];
+} h2_qos_conf_t;
+
+#define ERROR_QOS_PARM      1           /* Invalid parameter */
+
+void   h2_qos_init (void);
+uchar  h2_qos_port_set (vtss_uport_no_t uport, const h2_qos_port_conf_t *port_conf);
+uchar  h2_qos_pcp_set (uchar pcp, uchar queue);
+uchar  h2_qos_dscp_set (uchar dscp, uchar queue);
+uchar  h2_qos_weight_set (uchar queue, uchar weight);
+void   h2_qos_print (void);
+void   h2_qos_queue_print (vtss_uport_no_t uport);
+#endif // TRANSIT_QOS
+
+#endif
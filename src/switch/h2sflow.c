@@ -0,0 +1,263 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_SFLOW
+#include <string.h>
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "h2sflow.h"
+#include "hwport.h"
+#include "print.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+#define SF_RATE_UNIT            4096    /* ANA:ANA:SFLOW_CFG:SF_RATE is (n + 1) / 4096 */
+
+/* Bytes of the export header and of a sample without the frame header */
+#define EXPORT_HDR_LEN          5
+#define EXPORT_SAMPLE_LEN       7
+
+/*****************************************************************************
+ *
+ * Typedefs and enums
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* A sample waiting for export */
+typedef struct {
+    uchar   uport;
+    uchar   dir;                        /* H2_SFLOW_DIR_xxx */
+    ushort  rate;                       /* Sampling rate of the port */
+    ushort  frame_len;                  /* Length of the sampled frame */
+    uchar   hdr_len;
+    uchar   hdr[H2_SFLOW_HDR_LEN];
+} h2_sflow_sample_t;
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+static h2_sflow_port_conf_t xdata sflow_port[NO_OF_BOARD_PORTS];
+
+/* Samples in the order received, sflow_seq is the number of the oldest */
+static h2_sflow_sample_t xdata sflow_queue[H2_SFLOW_QUEUE_CNT];
+static uchar  xdata sflow_head;
+static uchar  xdata sflow_cnt;
+static ushort xdata sflow_seq;
+static ushort xdata sflow_lost;         /* Lost since the last export */
+
+static ulong  xdata sflow_sample_cnt;
+static ulong  xdata sflow_lost_cnt;
+
+/* ************************************************************************ */
+void h2_sflow_init (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Turn off sampling on all ports and empty the sample queue.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    vtss_uport_no_t uport;
+
+    memset(sflow_port, 0, sizeof(sflow_port));
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        H2_WRITE(VTSS_ANA_ANA_SFLOW_CFG(uport2cport(uport)), 0);
+    }
+    sflow_head = sflow_cnt = 0;
+    sflow_seq = sflow_lost = 0;
+    sflow_sample_cnt = sflow_lost_cnt = 0;
+}
+
+/* ************************************************************************ */
+uchar h2_sflow_port_set (vtss_uport_no_t uport, const h2_sflow_port_conf_t *port_conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the sampling of a port.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_SFLOW_PARM.
+ *               The rate is rounded up to what the chip can do, the
+ *               applied rate is kept in the configuration.
+ * Restrictions:
+ * See also    :
+ * Example     : Sample 1 of 1000 frames is applied as 1 of 1024.
+ ****************************************************************************/
+{
+    h2_sflow_port_conf_t xdata *conf;
+    ushort                     sf_rate;
+
+    if (uport < 1 || uport > NO_OF_BOARD_PORTS || port_conf->rate > H2_SFLOW_RATE_MAX) {
+        return ERROR_SFLOW_PARM;
+    }
+
+    conf = &sflow_port[uport - 1];
+    *conf = *port_conf;
+    if (conf->rate == 0 || (!conf->rx && !conf->tx)) {
+        conf->rate = 0;
+        conf->rx = conf->tx = 0;
+        H2_WRITE(VTSS_ANA_ANA_SFLOW_CFG(uport2cport(uport)), 0);
+        return 0;
+    }
+
+    sf_rate = SF_RATE_UNIT / conf->rate - 1;
+    conf->rate = SF_RATE_UNIT / (sf_rate + 1);
+    H2_WRITE(VTSS_ANA_ANA_SFLOW_CFG(uport2cport(uport)),
+             VTSS_F_ANA_ANA_SFLOW_CFG_SF_RATE(sf_rate) |
+             VTSS_F_ANA_ANA_SFLOW_CFG_SF_SAMPLE_RX(conf->rx) |
+             VTSS_F_ANA_ANA_SFLOW_CFG_SF_SAMPLE_TX(conf->tx));
+    return 0;
+}
+
+/* ************************************************************************ */
+void h2_sflow_frame_received (vtss_cport_no_t chip_port, uchar sflow_id, uchar xdata *frame, ushort len)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Queue a sampled frame for export.
+ * Remarks     : chip_port is the ingress port. The SFLOW_ID of the
+ *               extraction header is the chip port of a Tx sample, Rx
+ *               samples have an ID above the front ports.
+ *               Only the start of the frame is kept. When the queue is full
+ *               the sample is lost and counted.
+ * Restrictions:
+ * See also    : h2_sflow_export()
+ * Example     :
+ ****************************************************************************/
+{
+    h2_sflow_sample_t xdata *sample;
+    vtss_uport_no_t         uport;
+    uchar                   dir;
+
+    if (sflow_id < NO_OF_CHIP_PORTS) {
+        uport = cport2uport(sflow_id);
+        dir = H2_SFLOW_DIR_TX;
+    } else {
+        uport = cport2uport(chip_port);
+        dir = H2_SFLOW_DIR_RX;
+    }
+    if (uport < 1 || uport > NO_OF_BOARD_PORTS) {
+        return;
+    }
+
+    sflow_sample_cnt++;
+    if (sflow_cnt == H2_SFLOW_QUEUE_CNT) {
+        sflow_lost++;
+        sflow_lost_cnt++;
+        return;
+    }
+
+    sample = &sflow_queue[(sflow_head + sflow_cnt) % H2_SFLOW_QUEUE_CNT];
+    sflow_cnt++;
+    sample->uport     = uport;
+    sample->dir       = dir;
+    sample->rate      = sflow_port[uport - 1].rate;
+    sample->frame_len = len;
+    sample->hdr_len   = len > H2_SFLOW_HDR_LEN ? H2_SFLOW_HDR_LEN : len;
+    memcpy(sample->hdr, frame, sample->hdr_len);
+}
+
+/* ************************************************************************ */
+uchar h2_sflow_export (uchar xdata *p, uchar size)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Move the queued samples into an export buffer.
+ * Remarks     : Layout, multi byte fields MSB first:
+ *                 <cnt> <seq, 2> <lost, 2>
+ *                 cnt * (<uport> <dir> <rate, 2> <frame len, 2>
+ *                        <hdr len> <hdr len bytes of the frame>)
+ *               seq is the sequence number of the first sample, lost the
+ *               number of samples lost since the last export.
+ *               As many samples as fit in size bytes are moved, returns
+ *               the number of bytes written.
+ * Restrictions: size must be at least EXPORT_HDR_LEN.
+ * See also    : BP_OP_SFLOW
+ * Example     :
+ ****************************************************************************/
+{
+    h2_sflow_sample_t xdata *sample;
+    uchar xdata             *q = &p[EXPORT_HDR_LEN];
+    uchar                   cnt = 0;
+
+    p[1] = (uchar) (sflow_seq >> 8);
+    p[2] = (uchar) sflow_seq;
+    p[3] = (uchar) (sflow_lost >> 8);
+    p[4] = (uchar) sflow_lost;
+    sflow_lost = 0;
+
+    while (sflow_cnt) {
+        sample = &sflow_queue[sflow_head];
+        if ((q - p) + EXPORT_SAMPLE_LEN + sample->hdr_len > size) {
+            break;
+        }
+        *q++ = sample->uport;
+        *q++ = sample->dir;
+        *q++ = (uchar) (sample->rate >> 8);
+        *q++ = (uchar) sample->rate;
+        *q++ = (uchar) (sample->frame_len >> 8);
+        *q++ = (uchar) sample->frame_len;
+        *q++ = sample->hdr_len;
+        memcpy(q, sample->hdr, sample->hdr_len);
+        q += sample->hdr_len;
+
+        cnt++;
+        sflow_seq++;
+        sflow_cnt--;
+        if (++sflow_head == H2_SFLOW_QUEUE_CNT) {
+            sflow_head = 0;
+        }
+    }
+    p[0] = cnt;
+    return q - p;
+}
+
+/* ************************************************************************ */
+void h2_sflow_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the sampling configuration and the sample counters.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_sflow_port_conf_t xdata *conf;
+    vtss_uport_no_t            uport;
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        conf = &sflow_port[uport - 1];
+        print_str("Port ");
+        print_dec(uport);
+        print_str(": ");
+        if (conf->rate == 0) {
+            print_str("off");
+        } else {
+            print_str("1/");
+            print_dec(conf->rate);
+            print_str(conf->rx ? " rx" : "");
+            print_str(conf->tx ? " tx" : "");
+        }
+        print_cr_lf();
+    }
+
+    print_str("Samples: ");
+    print_dec(sflow_sample_cnt);
+    print_str(", lost: ");
+    print_dec(sflow_lost_cnt);
+    print_str(", queued: ");
+    print_dec(sflow_cnt);
+    print_cr_lf();
+}
+#endif // TRANSIT_SFLOW
@@ -0,0 +1,38 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __H2SFLOW_H__
+#define __H2SFLOW_H__
+
+#if TRANSIT_SFLOW
+#define H2_SFLOW_RATE_MAX       4096    /* Sample 1 of 4096 frames */
+#define H2_SFLOW_HDR_LEN        32      /* Bytes of the sampled frame kept */
+#define H2_SFLOW_QUEUE_CNT      6       /* Samples waiting for export */
+
+/* Sample direction */
+#define H2_SFLOW_DIR_RX         0
+#define H2_SFLOW_DIR_TX         1
+
+/*
+ * One sampling rate per port, used for the received and the transmitted
+ * frames. The chip samples with a probability in units of 1/4096, the rate
+ * is rounded up to the nearest 4096 / n.
+ */
+typedef struct {
+    ushort  rate;                       /* Sample 1 of rate frames, 0 is off */
+    uchar   rx;                         /* Sample received frames */
+    uchar   tx;                         /* Sample transmitted frames */
+} h2_sflow_port_conf_t;
+
+#define ERROR_SFLOW_PARM    1           /* Invalid parameter */
+
+void   h2_sflow_init (void);
+uchar  h2_sflow_port_set (vtss_uport_no_t uport, const h2_sflow_port_conf_t *port_conf);
+void   h2_sflow_frame_received (vtss_cport_no_t chip_port, uchar sflow_id, uchar xdata *frame, ushort len);
+uchar  h2_sflow_export (uchar xdata *p, uchar size);
+void   h2_sflow_print (void);
+#endif // TRANSIT_SFLOW
+
+#endif
@@ -133,6 +133,7 @@ extern BOOL GPARM_break_show_statistic_flag;
 uchar h2_stats_counter_exists(port_statistics_t counter_id);
 ulong h2_stats_counter_get(vtss_cport_no_t chip_port, port_statistics_t counter_id);
 void  h2_stats_counter_clear(vtss_cport_no_t chip_port);
+BOOL  print_port_statistics_line(vtss_cport_no_t chip_port, uchar j);
 void  print_port_statistics(vtss_cport_no_t chip_port);
 
 #endif
@@ -0,0 +1,337 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_STORM_CONTROL
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "h2.h"
+#include "h2storm.h"
+#include "hwport.h"
+#include "spiflash.h"
+#include "print.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* Values of ANA:ANA:STORMLIMIT_CFG:STORM_MODE */
+#define STORM_MODE_OFF          0
+#define STORM_MODE_ALL          3       /* Police frames to the CPU and the front ports */
+
+#define STORM_UNIT_FPS_MAX      32768UL /* Highest rate in the frame/s unit */
+#define STORM_RATE_MAX          15      /* Rate is 2^STORM_RATE */
+#define STORM_BURST             6       /* 2^6 = 64 frames, shared by all classes */
+
+/* Policed frames are counted as red, CNT_RX_RED_PRIO_0 - 7 */
+#define STAT_RX_RED_PRIO_0      0x14
+#define STAT_PRIO_CNT           8
+
+/*****************************************************************************
+ *
+ * Typedefs and enums
+ *
+ *
+ *
+ ****************************************************************************/
+
+
+/*****************************************************************************
+ *
+ *
+ * Prototypes for local functions
+ *
+ *
+ *
+ ****************************************************************************/
+static void _h2_storm_class_apply(uchar class_idx);
+static void _h2_storm_port_apply(vtss_uport_no_t uport);
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+/* The applied configuration */
+static h2_storm_conf_t xdata storm_conf;
+
+/* ************************************************************************ */
+void h2_storm_init (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Apply the storm control configuration in flash.
+ * Remarks     : Invalid (erased) settings are turned off.
+ *               All policers are written in one batch at boot, before
+ *               the ports are enabled.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_storm_port_conf_t xdata *port_conf;
+    vtss_uport_no_t            uport;
+    uchar                      idx;
+
+    flash_read_storm_conf(&storm_conf);
+
+    H2_WRITE(VTSS_ANA_ANA_STORMLIMIT_BURST,
+             VTSS_F_ANA_ANA_STORMLIMIT_BURST_STORM_BURST(STORM_BURST));
+    for (idx = 0; idx < H2_STORM_CLASS_CNT; idx++) {
+        if (storm_conf.class_rate[idx] > H2_STORM_CLASS_RATE_MAX) {
+            storm_conf.class_rate[idx] = 0;
+        }
+        _h2_storm_class_apply(idx);
+    }
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        port_conf = &storm_conf.port[uport - 1];
+        if (port_conf->mode > H2_STORM_PORT_FPS || port_conf->rate == 0 ||
+            port_conf->rate > (port_conf->mode == H2_STORM_PORT_KBPS ?
+                               H2_STORM_PORT_KBPS_MAX : H2_STORM_PORT_FPS_MAX)) {
+            port_conf->mode = H2_STORM_PORT_OFF;
+            port_conf->rate = 0;
+        }
+        _h2_storm_port_apply(uport);
+    }
+
+    flash_write_storm_conf(&storm_conf);
+}
+
+/* ************************************************************************ */
+uchar h2_storm_class_set (uchar class_idx, ulong fps)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the rate of a storm policer.
+ * Remarks     : class_idx is H2_STORM_CLASS_xxx, fps 0 turns it off.
+ *               Returns 0, if succeeded, otherwise ERROR_STORM_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (class_idx >= H2_STORM_CLASS_CNT || fps > H2_STORM_CLASS_RATE_MAX) {
+        return ERROR_STORM_PARM;
+    }
+
+    storm_conf.class_rate[class_idx] = fps;
+    _h2_storm_class_apply(class_idx);
+    flash_write_storm_conf(&storm_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+uchar h2_storm_port_set (vtss_uport_no_t uport, const h2_storm_port_conf_t *port_conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the ingress policer of a port.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_STORM_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (uport < 1 || uport > NO_OF_BOARD_PORTS || port_conf->mode > H2_STORM_PORT_FPS ||
+        (port_conf->mode != H2_STORM_PORT_OFF &&
+         (port_conf->rate == 0 ||
+          port_conf->rate > (port_conf->mode == H2_STORM_PORT_KBPS ?
+                             H2_STORM_PORT_KBPS_MAX : H2_STORM_PORT_FPS_MAX)))) {
+        return ERROR_STORM_PARM;
+    }
+
+    storm_conf.port[uport - 1] = *port_conf;
+    if (port_conf->mode == H2_STORM_PORT_OFF) {
+        storm_conf.port[uport - 1].rate = 0;
+    }
+    _h2_storm_port_apply(uport);
+    flash_write_storm_conf(&storm_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+ulong h2_storm_port_drops (vtss_uport_no_t uport)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the number of frames policed on a port.
+ * Remarks     : Sum of the red counters of all priorities, they are cleared
+ *               along with the other port counters.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong cnt, drops = 0;
+    uchar prio;
+
+    H2_WRITE_MASKED(VTSS_SYS_SYSTEM_STAT_CFG,
+                    VTSS_F_SYS_SYSTEM_STAT_CFG_STAT_VIEW(uport2cport(uport)),
+                    VTSS_M_SYS_SYSTEM_STAT_CFG_STAT_VIEW);
+    for (prio = 0; prio < STAT_PRIO_CNT; prio++) {
+        H2_READ(VTSS_SYS_STAT_CNT(STAT_RX_RED_PRIO_0 + prio), cnt);
+        drops += cnt;
+    }
+    return drops;
+}
+
+/* ************************************************************************ */
+void h2_storm_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the storm control configuration and the drop counters.
+ * Remarks     : The storm policers have no counters, only a sticky event
+ *               which is cleared when printed.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_storm_port_conf_t xdata *port_conf;
+    vtss_uport_no_t            uport;
+    ulong                      reg;
+    uchar                      idx;
+
+    for (idx = 0; idx < H2_STORM_CLASS_CNT; idx++) {
+        print_str(idx == H2_STORM_CLASS_UC ? "UC: " :
+                  idx == H2_STORM_CLASS_BC ? "BC: " : "MC: ");
+        if (storm_conf.class_rate[idx] == 0) {
+            print_str("off");
+        } else {
+            print_dec(storm_conf.class_rate[idx]);
+            print_str(" fps, applied ");
+            H2_READ(VTSS_ANA_ANA_STORMLIMIT_CFG(idx), reg);
+            print_dec((ulong) 1 << VTSS_X_ANA_ANA_STORMLIMIT_CFG_STORM_RATE(reg));
+            print_str(VTSS_X_ANA_ANA_STORMLIMIT_CFG_STORM_UNIT(reg) ? " fps" : " kfps");
+        }
+        print_cr_lf();
+    }
+
+    H2_READ(VTSS_ANA_ANA_ANEVENTS, reg);
+    if (reg & VTSS_M_ANA_ANA_ANEVENTS_STORM_DROP) {
+        H2_WRITE(VTSS_ANA_ANA_ANEVENTS, VTSS_M_ANA_ANA_ANEVENTS_STORM_DROP);
+        println_str("Storm policer drops since last shown");
+    }
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        port_conf = &storm_conf.port[uport - 1];
+        print_str("Port ");
+        print_dec(uport);
+        print_str(": ");
+        if (port_conf->mode == H2_STORM_PORT_OFF) {
+            print_str("off");
+        } else {
+            print_dec(port_conf->rate);
+            print_str(port_conf->mode == H2_STORM_PORT_KBPS ? " kbps" : " fps");
+        }
+        print_str(", dropped ");
+        print_dec(h2_storm_port_drops(uport));
+        print_cr_lf();
+    }
+}
+
+/* ************************************************************************ */
+static void _h2_storm_class_apply(uchar class_idx)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the rate of a storm policer to the switch chip.
+ * Remarks     : The rate is rounded down to a power of two, in frame/s up
+ *               to 32768 and in kframe/s above.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong rate = storm_conf.class_rate[class_idx];
+    uchar unit_fps = TRUE;
+    uchar n = 0;
+
+    if (rate == 0) {
+        H2_WRITE(VTSS_ANA_ANA_STORMLIMIT_CFG(class_idx),
+                 VTSS_F_ANA_ANA_STORMLIMIT_CFG_STORM_MODE(STORM_MODE_OFF));
+        return;
+    }
+
+    if (rate > STORM_UNIT_FPS_MAX) {
+        rate /= 1000;
+        unit_fps = FALSE;
+    }
+    while (n < STORM_RATE_MAX && (rate >> (n + 1)) != 0) {
+        n++;
+    }
+
+    H2_WRITE(VTSS_ANA_ANA_STORMLIMIT_CFG(class_idx),
+             VTSS_F_ANA_ANA_STORMLIMIT_CFG_STORM_RATE(n) |
+             VTSS_F_ANA_ANA_STORMLIMIT_CFG_STORM_UNIT(unit_fps) |
+             VTSS_F_ANA_ANA_STORMLIMIT_CFG_STORM_MODE(STORM_MODE_ALL));
+}
+
+/* ************************************************************************ */
+static void _h2_storm_port_apply(vtss_uport_no_t uport)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the ingress policer of a port to the switch chip.
+ * Remarks     : The port policer of a chip port is the policer with the
+ *               same index. Frame rates are policed in 1/3 frame/s units
+ *               as long as the rate fits, for a finer granularity.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_storm_port_conf_t xdata *port_conf = &storm_conf.port[uport - 1];
+    vtss_cport_no_t            chip_port = uport2cport(uport);
+    ulong                      rate;
+    uchar                      frm_mode, burst;
+
+    if (port_conf->mode == H2_STORM_PORT_OFF) {
+        H2_WRITE_MASKED(VTSS_ANA_PORT_POL_CFG(chip_port), 0, VTSS_M_ANA_PORT_POL_CFG_PORT_POL_ENA);
+        return;
+    }
+
+    if (port_conf->mode == H2_STORM_PORT_KBPS) {
+        frm_mode = POL_FRM_MODE_DATA;
+        rate = (port_conf->rate * 3 + 99) / 100;
+        burst = POL_BURST_DATA;
+    } else if (port_conf->rate * 3 <= POL_RATE_MAX) {
+        frm_mode = POL_FRM_MODE_FPS_1_3;
+        rate = port_conf->rate * 3;
+        burst = POL_BURST_FPS_1_3;
+    } else {
+        frm_mode = POL_FRM_MODE_FPS_33;
+        rate = (port_conf->rate * 3 + 99) / 100;
+        burst = POL_BURST_FPS_33;
+    }
+
+    H2_WRITE_MASKED(VTSS_ANA_POL_POL_MODE_CFG(VTSS_POL_PORT_START + chip_port),
+                    VTSS_F_ANA_POL_POL_MODE_CFG_FRM_MODE(frm_mode) |
+                    VTSS_F_ANA_POL_POL_MODE_CFG_CIR_ENA(0),
+                    VTSS_M_ANA_POL_POL_MODE_CFG_FRM_MODE |
+                    VTSS_M_ANA_POL_POL_MODE_CFG_CIR_ENA);
+    H2_WRITE(VTSS_ANA_POL_POL_PIR_CFG(VTSS_POL_PORT_START + chip_port),
+             VTSS_F_ANA_POL_POL_PIR_CFG_PIR_RATE(rate) |
+             VTSS_F_ANA_POL_POL_PIR_CFG_PIR_BURST(burst));
+
+#if TRANSIT_CPU_PROTECT
+    /* Control frames for the CPU stay policed, by the CPU queue policers
+       too, see h2_rx_init() */
+    H2_WRITE_MASKED(VTSS_ANA_PORT_POL_CFG(chip_port),
+                    VTSS_F_ANA_PORT_POL_CFG_PORT_POL_ENA(1),
+                    VTSS_M_ANA_PORT_POL_CFG_PORT_POL_ENA);
+#else
+    /* Control frames for the CPU pass the policer */
+    H2_WRITE_MASKED(VTSS_ANA_PORT_POL_CFG(chip_port),
+                    VTSS_F_ANA_PORT_POL_CFG_PORT_POL_ENA(1) |
+                    VTSS_F_ANA_PORT_POL_CFG_POL_CPU_REDIR_8021(1) |
+                    VTSS_F_ANA_PORT_POL_CFG_POL_CPU_REDIR_IP(1),
+                    VTSS_M_ANA_PORT_POL_CFG_PORT_POL_ENA |
+                    VTSS_M_ANA_PORT_POL_CFG_POL_CPU_REDIR_8021 |
+                    VTSS_M_ANA_PORT_POL_CFG_POL_CPU_REDIR_IP);
+#endif // TRANSIT_CPU_PROTECT
+}
+#endif // TRANSIT_STORM_CONTROL
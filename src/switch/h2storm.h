@@ -0,0 +1,52 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __H2STORM_H__
+#define __H2STORM_H__
+
+#if TRANSIT_STORM_CONTROL
+/* Traffic classes of the storm policers, index of ANA:ANA:STORMLIMIT_CFG */
+#define H2_STORM_CLASS_UC       0       /* Unknown (flooded) unicast */
+#define H2_STORM_CLASS_BC       1       /* Broadcast */
+#define H2_STORM_CLASS_MC       2       /* Multicast, flooded and known */
+#define H2_STORM_CLASS_CNT      3
+
+#define H2_STORM_CLASS_RATE_MAX 32768000UL      /* frames/s */
+
+/* Port policer modes */
+#define H2_STORM_PORT_OFF       0
+#define H2_STORM_PORT_KBPS      1       /* Rate in kbit/s, data rate excluding IPG */
+#define H2_STORM_PORT_FPS       2       /* Rate in frames/s */
+
+#define H2_STORM_PORT_KBPS_MAX  1000000UL       /* 1 Gbit/s */
+#define H2_STORM_PORT_FPS_MAX   1000000UL
+
+/*
+ * The storm policers are global, one per traffic class, and police the
+ * frames of the class from all ports together. The chip runs them in powers
+ * of two, the rate is rounded down. The port policer polices all frames
+ * received on the port, except the IEEE reserved and IP control frames
+ * for the CPU.
+ */
+typedef struct {
+    ulong   rate;                       /* frames/s or kbit/s, see mode */
+    uchar   mode;                       /* H2_STORM_PORT_xxx */
+} h2_storm_port_conf_t;
+
+typedef struct {
+    ulong                class_rate[H2_STORM_CLASS_CNT];   /* frames/s, 0 is off */
+    h2_storm_port_conf_t port[NO_OF_BOARD_PORTS];
+} h2_storm_conf_t;
+
+#define ERROR_STORM_PARM    1           /* Invalid parameter */
+
+void   h2_storm_init (void);
+uchar  h2_storm_class_set (uchar class_idx, ulong fps);
+uchar  h2_storm_port_set (vtss_uport_no_t uport, const h2_storm_port_conf_t *port_conf);
+ulong  h2_storm_port_drops (vtss_uport_no_t uport);
+void   h2_storm_print (void);
+#endif // TRANSIT_STORM_CONTROL
+
+#endif
@@ -0,0 +1,319 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#include "common.h"     /* Always include common.h at the first place of user-defined herder files */
+
+#if TRANSIT_REG_TRACE
+
+#include <string.h>
+
+#include "vtss_api_base_regs.h"
+#include "h2io.h"
+#include "h2trace.h"
+#include "timer.h"
+#include "print.h"
+
+/*****************************************************************************
+ *
+ *
+ * Defines
+ *
+ *
+ *
+ ****************************************************************************/
+
+#define H2_TRACE_CNT            32      /* Records in the trace ring */
+
+/* Bits 16-23 of the register addresses of the switch core targets */
+#define H2_TRACE_TGT(to)        ((uchar) ((to) >> 16))
+
+/*****************************************************************************
+ *
+ *
+ * Typedefs and enums
+ *
+ *
+ *
+ ****************************************************************************/
+
+enum {
+    TRACE_STATE_IDLE,                   /* Stopped */
+    TRACE_STATE_ARMED,                  /* Waiting for a write to trace_trig_addr */
+    TRACE_STATE_RUN,                    /* Recording, the oldest records are overwritten */
+    TRACE_STATE_CAPTURE                 /* Recording until the ring is full */
+};
+
+typedef struct {
+    uchar  op;                          /* H2_TRACE_OP_xxx */
+    ushort tick;                        /* tick_count (msec) */
+    ulong  addr;
+    ulong  value;
+} h2_trace_rec_t;
+
+/*****************************************************************************
+ *
+ *
+ * Local data
+ *
+ *
+ *
+ ****************************************************************************/
+
+static h2_trace_rec_t xdata trace_rec [H2_TRACE_CNT];
+static uchar xdata trace_next;          /* Record to write next */
+static uchar xdata trace_cnt;           /* Records in trace_rec */
+static uchar xdata trace_state = TRACE_STATE_IDLE;
+static uchar xdata trace_mask = H2_TRACE_MOD_DEFAULT;
+static ulong xdata trace_trig_addr;
+static ulong xdata trace_ops [H2_TRACE_OP_CNT];    /* Accesses while recording, also the masked ones */
+
+static const char code trace_op_txt [H2_TRACE_OP_CNT][3] = {"RD", "WR", "PR", "PW"};
+
+/*****************************************************************************
+ *
+ *
+ * Local functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+static uchar trace_mod (ulong addr) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the module (H2_TRACE_MOD_xxx) of an SBA register address.
+ * Remarks     :
+ * Restrictions:
+ * See also    : vtss_ocelot_regs_common.h
+ * Example     :
+ ****************************************************************************/
+{
+    uchar tgt;
+
+    if ((uchar) (addr >> 24) != (uchar) (VTSS_IO_ORIGIN2_OFFSET >> 24)) {
+        return H2_TRACE_MOD_CPU;
+    }
+
+    tgt = (uchar) (addr >> 16);
+    if (tgt >= H2_TRACE_TGT(VTSS_TO_ANA)) {
+        return H2_TRACE_MOD_ANA;
+    }
+    if (tgt >= H2_TRACE_TGT(VTSS_TO_QSYS) || tgt == H2_TRACE_TGT(VTSS_TO_SYS)) {
+        return H2_TRACE_MOD_SYS;
+    }
+    if (tgt >= H2_TRACE_TGT(VTSS_TO_DEV_0) || tgt == H2_TRACE_TGT(VTSS_TO_HSIO)) {
+        return H2_TRACE_MOD_DEV;
+    }
+    if (tgt == H2_TRACE_TGT(VTSS_TO_REW)) {
+        return H2_TRACE_MOD_REW;
+    }
+    if (tgt >= H2_TRACE_TGT(VTSS_TO_VCAP_ES0) && tgt <= H2_TRACE_TGT(VTSS_TO_VCAP_IS2)) {
+        return H2_TRACE_MOD_VCAP;
+    }
+    return H2_TRACE_MOD_DEVCPU;
+}
+
+/* ************************************************************************ */
+static void trace_add (uchar op, uchar mod, ulong addr, ulong value) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Record an access.
+ * Remarks     : Not called while the trace is stopped.
+ * Restrictions: Must not access registers, it is called from h2_read.
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_trace_rec_t xdata *rec;
+
+    if (trace_state == TRACE_STATE_ARMED) {
+        if (op != H2_TRACE_OP_WR || addr != trace_trig_addr) {
+            return;
+        }
+        /* The trigger write is recorded whatever the mask */
+        trace_state = TRACE_STATE_CAPTURE;
+    } else {
+        trace_ops[op]++;
+        if ((trace_mask & mod) == 0) {
+            return;
+        }
+    }
+
+    rec = &trace_rec[trace_next];
+    rec->op    = op;
+    rec->tick  = tick_count;
+    rec->addr  = addr;
+    rec->value = value;
+
+    if (++trace_next == H2_TRACE_CNT) {
+        trace_next = 0;
+    }
+    if (trace_cnt < H2_TRACE_CNT) {
+        trace_cnt++;
+    }
+    if (trace_cnt == H2_TRACE_CNT && trace_state == TRACE_STATE_CAPTURE) {
+        trace_state = TRACE_STATE_IDLE;
+    }
+}
+
+/*****************************************************************************
+ *
+ *
+ * Public functions
+ *
+ *
+ *
+ ****************************************************************************/
+
+/* ************************************************************************ */
+void h2_trace_sba (uchar op) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Trace the register access in h2_trace_addr/h2_trace_val.
+ * Remarks     : Called by h2_read and h2_write_addr in h2io.a51, except in
+ *               interrupts. It is excluded from data overlaying with
+ *               trace_add and trace_mod (OVERLAY in the project), as the
+ *               linker sees the interrupts calling it.
+ * Restrictions: Must not change h2_trace_val, h2_read returns it.
+ * See also    : h2io.a51
+ * Example     :
+ ****************************************************************************/
+{
+    if (trace_state != TRACE_STATE_IDLE) {
+        trace_add(op, trace_mod(h2_trace_addr), h2_trace_addr, h2_trace_val);
+    }
+}
+
+/* ************************************************************************ */
+void h2_trace_phy (uchar op, vtss_cport_no_t chip_port, uchar reg_no, ushort value) small
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Trace a PHY register access.
+ * Remarks     : Called by phy_read and phy_write after the MIIM accesses.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (trace_state != TRACE_STATE_IDLE) {
+        trace_add(op, H2_TRACE_MOD_PHY, ((ushort) chip_port << 8) | reg_no, value);
+    }
+}
+
+/* ************************************************************************ */
+void h2_trace_start (ulong trig_addr)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Clear the trace and start recording.
+ * Remarks     : trig_addr 0 starts at once, the oldest records are then
+ *               overwritten. Otherwise recording starts with the first write
+ *               to trig_addr and stops when the ring is full.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_trace_clear();
+    trace_trig_addr = trig_addr;
+    trace_state = trig_addr ? TRACE_STATE_ARMED : TRACE_STATE_RUN;
+}
+
+/* ************************************************************************ */
+void h2_trace_stop (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Stop recording, the records are kept.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    trace_state = TRACE_STATE_IDLE;
+}
+
+/* ************************************************************************ */
+void h2_trace_clear (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Clear the records and access counters.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    trace_next = 0;
+    trace_cnt = 0;
+    memset(trace_ops, 0, sizeof(trace_ops));
+}
+
+/* ************************************************************************ */
+void h2_trace_mask_set (uchar mask)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the modules (H2_TRACE_MOD_xxx) to record.
+ * Remarks     : The access counters include the other modules as well.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    trace_mask = mask;
+}
+
+/* ************************************************************************ */
+void h2_trace_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the state, access counters and records, oldest first.
+ * Remarks     : Recording is paused meanwhile, so the console accesses are
+ *               left out. Address and value are printed as raw hex, the
+ *               host script switch/test/trace_decode.py adds the register
+ *               names of vtss_ocelot_regs_*.h and replays the records.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_trace_rec_t xdata *rec;
+    uchar state = trace_state;
+    uchar idx;
+    uchar i;
+
+    trace_state = TRACE_STATE_IDLE;
+
+    print_str("State: ");
+    print_str(state == TRACE_STATE_IDLE  ? "stopped" :
+              state == TRACE_STATE_ARMED ? "armed" : "recording");
+    print_str(", mask: 0x");
+    print_hex_b(trace_mask);
+    if (trace_trig_addr) {
+        print_str(", trigger: 0x");
+        print_hex_dw(trace_trig_addr);
+    }
+    print_cr_lf();
+
+    for (i = 0; i < H2_TRACE_OP_CNT; i++) {
+        print_str(trace_op_txt[i]);
+        print_str(": ");
+        print_dec(trace_ops[i]);
+        print_spaces(2);
+    }
+    print_cr_lf();
+
+    println_str("      Tick Op Address    Value");
+    idx = (trace_next + H2_TRACE_CNT - trace_cnt) % H2_TRACE_CNT;
+    for (i = 0; i < trace_cnt; i++) {
+        rec = &trace_rec[idx];
+        print_dec_right(rec->tick);
+        print_spaces(1);
+        print_str(trace_op_txt[rec->op]);
+        print_str(" 0x");
+        print_hex_dw(rec->addr);
+        print_str(" 0x");
+        print_hex_dw(rec->value);
+        print_cr_lf();
+        if (++idx == H2_TRACE_CNT) {
+            idx = 0;
+        }
+    }
+
+    trace_state = state;
+}
+
+#endif // TRANSIT_REG_TRACE
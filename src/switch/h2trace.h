@@ -0,0 +1,42 @@
+//Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+//SPDX-License-Identifier: MIT
+
+
+
+#ifndef __H2TRACE_H__
+#define __H2TRACE_H__
+
+#if TRANSIT_REG_TRACE
+/* Operation of a trace record. Keep H2_TRACE_OP_RD/WR equal to h2io.a51 */
+#define H2_TRACE_OP_RD          0       /* SBA register read */
+#define H2_TRACE_OP_WR          1       /* SBA register write */
+#define H2_TRACE_OP_PHY_RD      2       /* PHY register read, address is chip port << 8 | reg */
+#define H2_TRACE_OP_PHY_WR      3       /* PHY register write, address as above */
+#define H2_TRACE_OP_CNT         4
+
+/* Module mask bits, see h2_trace_mask_set() */
+#define H2_TRACE_MOD_CPU        0x01    /* ICPU_CFG, UART, TWI, SIMC, SBA */
+#define H2_TRACE_MOD_DEVCPU     0x02    /* DEVCPU_ORG/GCB/QS/PTP, OAM_MEP, DMAC */
+#define H2_TRACE_MOD_SYS        0x04    /* SYS, QSYS */
+#define H2_TRACE_MOD_ANA        0x08    /* ANA */
+#define H2_TRACE_MOD_REW        0x10    /* REW */
+#define H2_TRACE_MOD_VCAP       0x20    /* VCAP_ES0/IS1/IS2 */
+#define H2_TRACE_MOD_DEV        0x40    /* DEV_x, HSIO */
+#define H2_TRACE_MOD_PHY        0x80    /* PHY registers */
+
+/* The CPU module is left out by default, as the timer and console accesses
+   would fill the trace */
+#define H2_TRACE_MOD_DEFAULT    ((uchar) ~H2_TRACE_MOD_CPU)
+
+/* Called by h2_read and h2_write_addr in h2io.a51 */
+void h2_trace_sba (uchar op) small;
+void h2_trace_phy (uchar op, vtss_cport_no_t chip_port, uchar reg_no, ushort value) small;
+
+void h2_trace_start (ulong trig_addr);
+void h2_trace_stop (void);
+void h2_trace_clear (void);
+void h2_trace_mask_set (uchar mask);
+void h2_trace_print (void);
+#endif // TRANSIT_REG_TRACE
+
+#endif // __H2TRACE_H__
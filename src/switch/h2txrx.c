@@ -19,6 +19,15 @@
 #include "taskdef.h"
 #include "vtss_common_os.h"
 #include "lldp.h"
+#if TRANSIT_IGMP_SNOOPING
+#include "ipmc_snoop.h"
+#endif
+#if TRANSIT_SFLOW
+#include "h2sflow.h"
+#endif
+#if TRANSIT_CPU_PROTECT
+#include "print.h"
+#endif
 
 #if defined(VTSS_ARCH_OCELOT)
 #if TRANSIT_LLDP
@@ -61,6 +70,10 @@
 #define CPU_INJ_REG		0 /* CPU Injection GRP - register based */
 #define CPU_INJ_DMA		1 /* CPU Injection GRP - DMA based */
 
+#if TRANSIT_CPU_PROTECT && PACKET_XTR_QU_CNT != 8
+#error "The CPU protection profile requires 8 extraction queues"
+#endif
+
 /*****************************************************************************
  *
  *
@@ -72,6 +85,15 @@
 
 #define BUF ((vtss_eth_hdr *)&rx_packet[0])
 
+#if TRANSIT_CPU_PROTECT
+/* CPU protection profile of an extraction queue */
+typedef struct {
+    const char  *name;
+    ushort      rate;           /* Frames/s of the queue policer */
+    uchar       budget;         /* Frames per rx_packet_tsk() pass */
+} h2_cpuq_prof_t;
+#endif // TRANSIT_CPU_PROTECT
+
 /*****************************************************************************
  *
  *
@@ -80,6 +102,11 @@
  *
  *
  ****************************************************************************/
+static void _h2_rx_frame_dispatch(void);
+#if TRANSIT_CPU_PROTECT
+static void _h2_cpuq_pol_apply(uchar cpuq);
+static void _h2_rx_grp_service(uchar grp);
+#endif // TRANSIT_CPU_PROTECT
 
 /*****************************************************************************
  *
@@ -108,6 +135,23 @@ vtss_rx_frame_t vtss_rx_frame;
 static uchar rx_packet_tsk_init = 0;
 vtss_packet_rx_conf_t rx_conf;
 
+#if TRANSIT_CPU_PROTECT
+/* Default profile, index is the extraction queue, see PACKET_XTR_QU_xxx */
+static code h2_cpuq_prof_t cpuq_prof[VTSS_PACKET_RX_QUEUE_CNT] = {
+    { "Learn/other",  50, 1 },
+    { "sFlow",       100, 2 },
+    { "IP",          100, 2 },
+    { "IGMP/MLD",    200, 4 },
+    { "BPDU/GARP",    50, 2 },
+    { "MAC copy",     50, 2 },
+    { "Slow proto",  100, 4 },
+    { "LLDP",        100, 4 },
+};
+
+static ushort xdata cpuq_rate[VTSS_PACKET_RX_QUEUE_CNT];        // Current policer rate
+static ulong  xdata cpuq_rx_cnt[VTSS_PACKET_RX_QUEUE_CNT];
+#endif // TRANSIT_CPU_PROTECT
+
 
 
 /* ************************************************************************ */
@@ -357,7 +401,7 @@ void h2_rx_conf_set (void)
 
     /* Fixme - chipset has more queues than the classification the API expose */
     value =
-        VTSS_F_ANA_COMMON_CPUQ_CFG_CPUQ_SFLOW(VTSS_PACKET_RX_QUEUE_START) |
+        VTSS_F_ANA_COMMON_CPUQ_CFG_CPUQ_SFLOW(PACKET_XTR_QU_SFLOW-VTSS_PACKET_RX_QUEUE_START) |
         VTSS_F_ANA_COMMON_CPUQ_CFG_CPUQ_MIRROR(map->mac_vid_queue-VTSS_PACKET_RX_QUEUE_START) |
         VTSS_F_ANA_COMMON_CPUQ_CFG_CPUQ_LRN(map->learn_queue-VTSS_PACKET_RX_QUEUE_START) |
         VTSS_F_ANA_COMMON_CPUQ_CFG_CPUQ_MAC_COPY(map->mac_vid_queue-VTSS_PACKET_RX_QUEUE_START) |
@@ -380,17 +424,35 @@ void h2_rx_conf_set (void)
 
 #if TRANSIT_LLDP
     H2_WRITE_MASKED(VTSS_ANA_COMMON_CPUQ_8021_CFG(0xe),
-                    VTSS_F_ANA_COMMON_CPUQ_8021_CFG_CPUQ_BPDU_VAL(PACKET_XTR_QU_BPDU_LLDP-VTSS_PACKET_RX_QUEUE_START),
+                    VTSS_F_ANA_COMMON_CPUQ_8021_CFG_CPUQ_BPDU_VAL(PACKET_XTR_QU_LLDP-VTSS_PACKET_RX_QUEUE_START),
                     VTSS_M_ANA_COMMON_CPUQ_8021_CFG_CPUQ_BPDU_VAL);
 #endif
 
-#if TRANSIT_LACP
+#if TRANSIT_LACP || TRANSIT_CPU_PROTECT
     H2_WRITE_MASKED(VTSS_ANA_COMMON_CPUQ_8021_CFG(0x2), 
-                    VTSS_F_ANA_COMMON_CPUQ_8021_CFG_CPUQ_BPDU_VAL(PACKET_XTR_QU_BPDU_LLDP-VTSS_PACKET_RX_QUEUE_START),
+                    VTSS_F_ANA_COMMON_CPUQ_8021_CFG_CPUQ_BPDU_VAL(PACKET_XTR_QU_SLOW-VTSS_PACKET_RX_QUEUE_START),
                     VTSS_M_ANA_COMMON_CPUQ_8021_CFG_CPUQ_BPDU_VAL);
 #endif
 }
 
+#if TRANSIT_IGMP_SNOOPING
+/* ************************************************************************ */
+void h2_ipmc_registration (BOOL enable)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Redirect IGMP and MLD frames to the CPU, or forward them
+ *               as other IP multicast.
+ * Remarks     :
+ * Restrictions:
+ * See also    : ipmc_enable_set()
+ * Example     :
+ ****************************************************************************/
+{
+    rx_conf.reg.igmp_cpu_only = enable;
+    rx_conf.reg.mld_cpu_only  = enable;
+    h2_rx_conf_set();
+}
+#endif // TRANSIT_IGMP_SNOOPING
+
 #if LOOPBACK_TEST
 void h2_rx_flush (void) small
 /* ------------------------------------------------------------------------ --
@@ -434,7 +496,7 @@ void h2_rx_init (void)
         conf->map.learn_queue     = PACKET_XTR_QU_LEARN;
         conf->map.igmp_queue      = PACKET_XTR_QU_IGMP;
         conf->map.ipmc_ctrl_queue = PACKET_XTR_QU_IGMP;
-        conf->map.mac_vid_queue   = PACKET_XTR_QU_IP;
+        conf->map.mac_vid_queue   = PACKET_XTR_QU_MAC_COPY;
 
 
         for (i = 0; i < VTSS_PACKET_RX_QUEUE_END; i++) {
@@ -461,9 +523,125 @@ void h2_rx_init (void)
         vtss_rx_frame.total_bytes = 0;
         vtss_rx_frame.pruned = 0;
         rx_packet_tsk_init = 1;
+
+#if TRANSIT_CPU_PROTECT
+        /* The QoS policers of the CPU port police the extraction queues.
+           Control frames redirected to the CPU must not bypass them */
+        for (i = 0; i < VTSS_PACKET_RX_QUEUE_CNT; i++) {
+            cpuq_rate[i] = cpuq_prof[i].rate;
+            _h2_cpuq_pol_apply(i);
+        }
+        H2_WRITE_MASKED(VTSS_ANA_PORT_POL_CFG(CPU_CHIP_PORT),
+                        VTSS_F_ANA_PORT_POL_CFG_QUEUE_POL_ENA(0xFF),
+                        VTSS_M_ANA_PORT_POL_CFG_QUEUE_POL_ENA);
+        for (i = 0; i < NO_OF_CHIP_PORTS; i++) {
+            H2_WRITE_MASKED(VTSS_ANA_PORT_POL_CFG(i), 0,
+                            VTSS_M_ANA_PORT_POL_CFG_POL_CPU_REDIR_8021 |
+                            VTSS_M_ANA_PORT_POL_CFG_POL_CPU_REDIR_IP);
+        }
+        h2_cpuq_clear();
+#endif // TRANSIT_CPU_PROTECT
     }
 }
 
+#if TRANSIT_CPU_PROTECT
+/* ************************************************************************ */
+static void _h2_cpuq_pol_apply (uchar cpuq)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the policer of an extraction queue to the switch chip.
+ * Remarks     : The queue policer of CPU_CHIP_PORT for the QoS class equal
+ *               to the extraction queue. Policed in 1/3 frame/s units as
+ *               long as the rate fits, for a finer granularity.
+ * Restrictions:
+ * See also    : _h2_storm_port_apply()
+ * Example     :
+ ****************************************************************************/
+{
+    ushort pol  = VTSS_POL_QUEUE_START + CPU_CHIP_PORT * 8 + cpuq;
+    ulong  rate = cpuq_rate[cpuq];
+    uchar  frm_mode, burst;
+
+    if (rate * 3 <= POL_RATE_MAX) {
+        frm_mode = POL_FRM_MODE_FPS_1_3;
+        rate = rate * 3;
+        burst = POL_BURST_FPS_1_3;
+    } else {
+        frm_mode = POL_FRM_MODE_FPS_33;
+        rate = (rate * 3 + 99) / 100;
+        burst = POL_BURST_FPS_33;
+    }
+
+    H2_WRITE_MASKED(VTSS_ANA_POL_POL_MODE_CFG(pol),
+                    VTSS_F_ANA_POL_POL_MODE_CFG_FRM_MODE(frm_mode) |
+                    VTSS_F_ANA_POL_POL_MODE_CFG_CIR_ENA(0),
+                    VTSS_M_ANA_POL_POL_MODE_CFG_FRM_MODE |
+                    VTSS_M_ANA_POL_POL_MODE_CFG_CIR_ENA);
+    H2_WRITE(VTSS_ANA_POL_POL_PIR_CFG(pol),
+             VTSS_F_ANA_POL_POL_PIR_CFG_PIR_RATE(rate) |
+             VTSS_F_ANA_POL_POL_PIR_CFG_PIR_BURST(burst));
+}
+
+/* ************************************************************************ */
+uchar h2_cpuq_rate_set (uchar cpuq, ushort rate)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the frames per second of the policer of an extraction
+ *               queue.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_CPUQ_PARM.
+ *               Not saved, the profile default is used at boot.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    if (cpuq >= VTSS_PACKET_RX_QUEUE_CNT || rate == 0) {
+        return ERROR_CPUQ_PARM;
+    }
+    cpuq_rate[cpuq] = rate;
+    _h2_cpuq_pol_apply(cpuq);
+    return 0;
+}
+
+/* ************************************************************************ */
+void h2_cpuq_clear (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Clear the receive counters of the extraction queues.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    memset(cpuq_rx_cnt, 0, sizeof(cpuq_rx_cnt));
+}
+
+/* ************************************************************************ */
+void h2_cpuq_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the profile and the counters of the extraction queues.
+ * Remarks     : Highest priority first.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar cpuq = VTSS_PACKET_RX_QUEUE_CNT;
+
+    while (cpuq-- > 0) {
+        print_str("Queue ");
+        print_dec(cpuq);
+        print_str(" ");
+        print_str(cpuq_prof[cpuq].name);
+        print_str(": ");
+        print_dec(cpuq_rate[cpuq]);
+        print_str(" fps, budget ");
+        print_dec(cpuq_prof[cpuq].budget);
+        print_str(", rx ");
+        print_dec(cpuq_rx_cnt[cpuq]);
+        print_cr_lf();
+    }
+}
+#endif // TRANSIT_CPU_PROTECT
+
 #if defined(H2TXRX_DEBUG_ENABLE)
 void dump_frame(uchar *rx_packet , ulong total_bytes)
 {
@@ -493,56 +671,136 @@ void dump_frame(uchar *rx_packet , ulong total_bytes)
  ****************************************************************************/
 void rx_packet_tsk (void)
 {
-    uchar source_port;
     uchar recv_q;
 
     //println_str("rx_packet_tsk 1");
     for (recv_q = VTSS_PACKET_RX_GROUP_START; recv_q < VTSS_PACKET_RX_GROUP_END; recv_q++) {
+#if TRANSIT_CPU_PROTECT
+        _h2_rx_grp_service(recv_q);
+#else
         h2_rx_frame_get(recv_q, &vtss_rx_frame);
         //println_str("rx_packet_tsk 2");
         if(!vtss_rx_frame.discard && vtss_rx_frame.total_bytes) {
-            source_port = cport2uport(vtss_rx_frame.header.port);
+            _h2_rx_frame_dispatch();
+        } else {
+            ; /* Already discard in function "h2_rx_frame_get" */
+        }
+#endif // TRANSIT_CPU_PROTECT
+    }
+}
+
+#if TRANSIT_CPU_PROTECT
+/* ************************************************************************ */
+static void _h2_rx_grp_service (uchar grp)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Receive the frames of an extraction group.
+ * Remarks     : The CPU port delivers the queues in strict priority. The
+ *               queue policers keep the rate of each queue, and the pass
+ *               ends when a queue has used up its budget, so a flood in one
+ *               queue only costs its budget per pass of the main loop.
+ *               A frame copied to several queues counts in the highest.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar used[VTSS_PACKET_RX_QUEUE_CNT];
+    uchar cpuq;
+
+    memset(used, 0, sizeof(used));
+    for (;;) {
+        h2_rx_frame_get(grp, &vtss_rx_frame);
+        if (vtss_rx_frame.discard || !vtss_rx_frame.total_bytes) {
+            return; /* No frame or already discarded in h2_rx_frame_get() */
+        }
+
+        cpuq = VTSS_PACKET_RX_QUEUE_CNT - 1;
+        while (cpuq > 0 && !(vtss_rx_frame.header.cpuq & (1 << cpuq))) {
+            cpuq--;
+        }
+
+        cpuq_rx_cnt[cpuq]++;
+        _h2_rx_frame_dispatch();
+
+        if (++used[cpuq] >= cpuq_prof[cpuq].budget) {
+            return;
+        }
+    }
+}
+#endif // TRANSIT_CPU_PROTECT
+
+/* ************************************************************************ */
+static void _h2_rx_frame_dispatch (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Pass the received frame in vtss_rx_frame to its protocol.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar source_port;
+
+    source_port = cport2uport(vtss_rx_frame.header.port);
 
 #if defined(H2TXRX_DEBUG_ENABLE)
-         dump_frame(vtss_rx_frame.rx_packet ,vtss_rx_frame.total_bytes); 
+    dump_frame(vtss_rx_frame.rx_packet ,vtss_rx_frame.total_bytes); 
 #endif /* H2TXRX_DEBUG_ENABLE */
 
 #ifndef  VTSS_COMMON_NDEBUG
-            vtss_common_dump_frame(vtss_rx_frame.rx_packet ,vtss_rx_frame.total_bytes);
+    vtss_common_dump_frame(vtss_rx_frame.rx_packet ,vtss_rx_frame.total_bytes);
 #endif
-            switch (BUF->type) {
+
+#if TRANSIT_SFLOW
+    /* A sampled frame may also be a copy for a protocol */
+    if (vtss_rx_frame.header.cpuq & (1 << PACKET_XTR_QU_SFLOW)) {
+        TASK(SUB_TASK_ID_SFLOW_RX, h2_sflow_frame_received(vtss_rx_frame.header.port, vtss_rx_frame.header.sflow_id,
+                                                          vtss_rx_frame.rx_packet, vtss_rx_frame.total_bytes));
+        if (vtss_rx_frame.header.cpuq == (1 << PACKET_XTR_QU_SFLOW)) {
+            h2_discard_frame(&vtss_rx_frame);
+            return;
+        }
+    }
+#endif // TRANSIT_SFLOW
+
+    switch (BUF->type) {
 #if TRANSIT_LLDP
-            case HTONS(VTSS_ETHTYPE_LLDP):
-                if (VTSS_COMMON_MACADDR_CMP(BUF->dest.addr, mac_addr_lldp) == 0) {
-                    TASK(SUB_TASK_ID_LLDP_RX, lldp_frame_received(source_port, vtss_rx_frame.rx_packet, vtss_rx_frame.total_bytes));
-                } else {
-                    VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_NOISE, ("Dropping on port %u type 0x%x len %u\n",
-                                      (unsigned)source_port, (unsigned)BUF->type, (unsigned)rx_packet));
-                    h2_discard_frame(&vtss_rx_frame);
-                }
-                break;
+    case HTONS(VTSS_ETHTYPE_LLDP):
+        if (VTSS_COMMON_MACADDR_CMP(BUF->dest.addr, mac_addr_lldp) == 0) {
+            TASK(SUB_TASK_ID_LLDP_RX, lldp_frame_received(source_port, vtss_rx_frame.rx_packet, vtss_rx_frame.total_bytes));
+        } else {
+            VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_NOISE, ("Dropping on port %u type 0x%x len %u\n",
+                              (unsigned)source_port, (unsigned)BUF->type, (unsigned)rx_packet));
+            h2_discard_frame(&vtss_rx_frame);
+        }
+        break;
 #endif
 
 #if  TRANSIT_LACP
-            case HTONS(VTSS_ETHTYPE_SLOW):
-                if (VTSS_COMMON_MACADDR_CMP(BUF->dest.addr, vtss_lacp_protocol_addr) == 0) {
-                    TASK(SUB_TASK_ID_LLDP_RX, vtss_lacp_receive(source_port, vtss_rx_frame.rx_packet, vtss_rx_frame.total_bytes));
-                } else {
-                    VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_NOISE, ("Dropping on port %u type 0x%x len %u\n",
-                                      (unsigned)source_port, (unsigned)BUF->type, (unsigned)rx_packet));
-                    h2_discard_frame(&vtss_rx_frame);
-                }
-                break;
-#endif
-            default:
-                VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_NOISE, ("Dropping on port %u type 0x%x len %u\n",
-                                  (unsigned)source_port, (unsigned)BUF->type, (unsigned)rx_packet));
-                h2_discard_frame(&vtss_rx_frame);
-
-            }
+    case HTONS(VTSS_ETHTYPE_SLOW):
+        if (VTSS_COMMON_MACADDR_CMP(BUF->dest.addr, vtss_lacp_protocol_addr) == 0) {
+            TASK(SUB_TASK_ID_LLDP_RX, vtss_lacp_receive(source_port, vtss_rx_frame.rx_packet, vtss_rx_frame.total_bytes));
         } else {
-            ; /* Already discard in function "h2_rx_frame_get" */
+            VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_NOISE, ("Dropping on port %u type 0x%x len %u\n",
+                              (unsigned)source_port, (unsigned)BUF->type, (unsigned)rx_packet));
+            h2_discard_frame(&vtss_rx_frame);
         }
+        break;
+#endif
+
+#if TRANSIT_IGMP_SNOOPING
+    case HTONS(VTSS_ETHTYPE_IP):
+    case HTONS(VTSS_ETHTYPE_IP6):
+    case HTONS(VTSS_ETHTYPE_CTAG):
+        TASK(SUB_TASK_ID_IPMC_RX, ipmc_frame_received(vtss_rx_frame.header.port, vtss_rx_frame.header.vid,
+                                                      vtss_rx_frame.rx_packet, vtss_rx_frame.total_bytes));
+        break;
+#endif
+    default:
+        VTSS_COMMON_TRACE(VTSS_COMMON_TRLVL_NOISE, ("Dropping on port %u type 0x%x len %u\n",
+                          (unsigned)source_port, (unsigned)BUF->type, (unsigned)rx_packet));
+        h2_discard_frame(&vtss_rx_frame);
+
     }
 }
 #endif //#if __BASIC_TX_RX__
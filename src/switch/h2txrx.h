@@ -17,6 +17,16 @@ extern uchar xdata rx_packet[];
 
 void   h2_bpdu_t_registration (uchar type, uchar enable);
 void   h2_rx_conf_set(void);
+#if TRANSIT_IGMP_SNOOPING
+void   h2_ipmc_registration (BOOL enable);
+#endif // TRANSIT_IGMP_SNOOPING
+#if TRANSIT_CPU_PROTECT
+#define ERROR_CPUQ_PARM     1           /* Invalid parameter */
+
+uchar  h2_cpuq_rate_set (uchar cpuq, ushort rate);
+void   h2_cpuq_clear (void);
+void   h2_cpuq_print (void);
+#endif // TRANSIT_CPU_PROTECT
 void   h2_rx_flush (void) small;
 void   h2_send_frame (uchar port_no, uchar xdata *frame_ptr, ushort frame_len);
 
@@ -123,6 +123,8 @@ void h2_rx_frame_get (const uchar qno, vtss_rx_frame_t xdata * rx_frame_ptr)
         rx_frame_ptr->header.port = VTSS_EXTRACT_BITFIELD(ifh2, 43 - 32, 4);
         //print_str("rx_frame_ptr->header.port: ");    print_dec(rx_frame_ptr->header.port);     print_cr_lf();
         rx_frame_ptr->header.vid  = VTSS_EXTRACT_BITFIELD(ifh3,  0, 12);
+        rx_frame_ptr->header.cpuq = VTSS_EXTRACT_BITFIELD(ifh3, 20, 8);
+        rx_frame_ptr->header.sflow_id = VTSS_EXTRACT_BITFIELD(ifh2, 32 - 32, 4);
         //print_str("rx_frame_ptr->header.vid: ");    print_dec(rx_frame_ptr->header.vid);     print_cr_lf();
         /* Check actual extracted length vs. the length reported in the IFH */
         wlen = VTSS_EXTRACT_BITFIELD(ifh1, 71 - 64, 8);
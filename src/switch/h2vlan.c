@@ -10,9 +10,16 @@
 #include "h2io.h"
 #include "h2vlan.h"
 #include "misc2.h"
+#if TRANSIT_VLAN
+#include "hwport.h"
+#include "h2mactab.h"
+#include "spiflash.h"
+#include "print.h"
+#else
 #ifndef NDEBUG
 #include "print.h"
 #endif
+#endif // TRANSIT_VLAN
 
 /*****************************************************************************
  *
@@ -29,6 +36,8 @@
 #define VLAN_TAB_WRITE 2
 #define VLAN_TAB_CLEAR 3
 
+#define VLAN_TAB_TIMEOUT    1000    /* msec */
+
 /*****************************************************************************
  *
  * Typedefs and enums
@@ -46,7 +55,14 @@
  *
  *
  ****************************************************************************/
-static void _h2_vlan_do_command(ulong aces_value);
+static void _h2_vlan_wait_idle(void);
+#if TRANSIT_VLAN
+static void _h2_vlan_tab_write(ushort vid, ulong uport_mask);
+static void _h2_vlan_port_apply(vtss_uport_no_t uport, const h2_vlan_port_conf_t *old_conf);
+#endif // TRANSIT_VLAN
+#if TRANSIT_MIRROR
+static void _h2_vlan_mirror_write(ushort vid, BOOL enable);
+#endif // TRANSIT_MIRROR
 
 /*****************************************************************************
  *
@@ -56,6 +72,15 @@ static void _h2_vlan_do_command(ulong aces_value);
  *
  *
  ****************************************************************************/
+#if TRANSIT_VLAN
+/* The applied configuration */
+static h2_vlan_conf_t xdata vlan_conf;
+#endif // TRANSIT_VLAN
+#if TRANSIT_MIRROR
+/* VLAN with the mirror flag set, 0 is none */
+static ushort xdata vlan_mirror_vid = 0;
+#endif // TRANSIT_MIRROR
+
 /* ************************************************************************ */
 void h2_vlan_clear_tab (void)
 /* ------------------------------------------------------------------------ --
@@ -66,23 +91,409 @@ void h2_vlan_clear_tab (void)
  * Example     :
  ****************************************************************************/
 {
-    _h2_vlan_do_command(VTSS_F_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(VLAN_TAB_CLEAR));
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANACCESS,
+             VTSS_F_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(VLAN_TAB_CLEAR));
+    _h2_vlan_wait_idle();
+}
+
+/* ************************************************************************ */
+ulong h2_vlan_members_get (ushort vid)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Get the member ports of a VLAN.
+ * Remarks     : Returns a chip port mask, read from the VLAN table so it
+ *               also holds without TRANSIT_VLAN (all ports are members).
+ * Restrictions:
+ * See also    : h2_vlan_tx_tagged()
+ * Example     :
+ ****************************************************************************/
+{
+    ulong value;
+
+    _h2_vlan_wait_idle();
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANTIDX, VTSS_F_ANA_ANA_TABLES_VLANTIDX_V_INDEX(vid));
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANACCESS,
+             VTSS_F_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(VLAN_TAB_READ));
+    _h2_vlan_wait_idle();
+    H2_READ(VTSS_ANA_ANA_TABLES_VLANACCESS, value);
+    return VTSS_X_ANA_ANA_TABLES_VLANACCESS_VLAN_PORT_MASK(value);
+}
+
+/* ************************************************************************ */
+BOOL h2_vlan_tx_tagged (vtss_cport_no_t chip_port, ushort vid)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Tell whether the rewriter tags frames of a VLAN on a port.
+ * Remarks     : For frames sent by h2_tx_frame_port(), which bypasses the
+ *               rewriter and inserts the tag itself.
+ * Restrictions:
+ * See also    : H2_VLAN_TX_xxx
+ * Example     :
+ ****************************************************************************/
+{
+    ulong tag_cfg, vlan_cfg;
+
+    H2_READ(VTSS_REW_PORT_TAG_CFG(chip_port), tag_cfg);
+    switch (VTSS_X_REW_PORT_TAG_CFG_TAG_CFG(tag_cfg)) {
+    case H2_VLAN_TX_UNTAG:
+        return FALSE;
+    case H2_VLAN_TX_TAG_ALL:
+        return TRUE;
+    default:
+        H2_READ(VTSS_REW_PORT_PORT_VLAN_CFG(chip_port), vlan_cfg);
+        if (vid == VTSS_X_REW_PORT_PORT_VLAN_CFG_PORT_VID(vlan_cfg)) {
+            return FALSE;
+        }
+        return vid != 0 || VTSS_X_REW_PORT_TAG_CFG_TAG_CFG(tag_cfg) == H2_VLAN_TX_TAG_NO_PVID;
+    }
+}
+
+#if TRANSIT_MIRROR
+/* ************************************************************************ */
+void h2_vlan_mirror_set (ushort vid)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Mirror the frames classified to a VLAN.
+ * Remarks     : Only one VLAN is mirrored, vid 0 turns it off. The flag
+ *               is kept when the VLAN configuration is changed.
+ * Restrictions:
+ * See also    : h2mirror.h
+ * Example     :
+ ****************************************************************************/
+{
+    if (vlan_mirror_vid != 0 && vlan_mirror_vid != vid) {
+        _h2_vlan_mirror_write(vlan_mirror_vid, FALSE);
+    }
+    vlan_mirror_vid = vid;
+    if (vid != 0) {
+        _h2_vlan_mirror_write(vid, TRUE);
+    }
+}
+#endif // TRANSIT_MIRROR
+
+#if TRANSIT_VLAN
+/* ************************************************************************ */
+void h2_vlan_init (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Apply the VLAN configuration in flash.
+ * Remarks     : Invalid (erased) port settings and entries get the default,
+ *               an unaware port in VLAN 1 and an unused entry.
+ *               The VLAN table entries are written in one batch, after
+ *               h2_vlan_clear_tab() made all ports members of all VLANs.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_vlan_port_conf_t xdata *port_conf;
+    h2_vlan_entry_t xdata     *entry;
+    vtss_uport_no_t           uport;
+    uchar                     idx;
+
+    flash_read_vlan_conf(&vlan_conf);
+
+    for (idx = 0; idx < H2_VLAN_CNT; idx++) {
+        entry = &vlan_conf.vlan[idx];
+        if (entry->vid > H2_VLAN_VID_MAX) {
+            entry->vid = H2_VLAN_VID_NONE;
+        }
+        if (entry->vid != H2_VLAN_VID_NONE) {
+            _h2_vlan_tab_write(entry->vid, entry->uport_mask);
+        }
+    }
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        port_conf = &vlan_conf.port[uport - 1];
+        if (port_conf->pvid == H2_VLAN_VID_NONE || port_conf->pvid > H2_VLAN_VID_MAX ||
+            port_conf->tx_tag > H2_VLAN_TX_TAG_ALL) {
+            port_conf->pvid   = H2_VLAN_PVID_DEFAULT;
+            port_conf->aware  = FALSE;
+            port_conf->tx_tag = H2_VLAN_TX_UNTAG;
+        }
+        _h2_vlan_port_apply(uport, 0);
+    }
+
+    _h2_vlan_wait_idle();
+    flash_write_vlan_conf(&vlan_conf);
+}
+
+/* ************************************************************************ */
+uchar h2_vlan_port_set (vtss_uport_no_t uport, const h2_vlan_port_conf_t *port_conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the VLAN configuration of a port.
+ * Remarks     : Returns 0, if succeeded, otherwise ERROR_VLAN_PARM.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_vlan_port_conf_t old_conf;
+
+    if (uport < 1 || uport > NO_OF_BOARD_PORTS ||
+        port_conf->pvid == H2_VLAN_VID_NONE || port_conf->pvid > H2_VLAN_VID_MAX ||
+        port_conf->tx_tag > H2_VLAN_TX_TAG_ALL) {
+        return ERROR_VLAN_PARM;
+    }
+
+    old_conf = vlan_conf.port[uport - 1];
+    vlan_conf.port[uport - 1] = *port_conf;
+    _h2_vlan_port_apply(uport, &old_conf);
+    flash_write_vlan_conf(&vlan_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+uchar h2_vlan_entry_set (ushort vid, ulong uport_mask)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set the member ports of a VLAN.
+ * Remarks     : uport_mask 0 deletes the entry, the VLAN then gets all ports
+ *               as members again.
+ *               The MAC addresses learned in the VLAN on the removed ports
+ *               are flushed.
+ *               Returns 0, if succeeded, otherwise an ERROR_VLAN_xxx code.
+ *               Only the RAM copy of the configuration is updated, call
+ *               flash_program_config() to write it into flash.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_vlan_entry_t xdata *entry = 0;
+    vtss_uport_no_t       uport;
+    ulong                 removed;
+    uchar                 idx;
+
+    if (vid == H2_VLAN_VID_NONE || vid > H2_VLAN_VID_MAX ||
+        (uport_mask & ~(((ulong) 1 << (NO_OF_BOARD_PORTS + 1)) - 2))) {
+        return ERROR_VLAN_PARM;
+    }
+
+    for (idx = 0; idx < H2_VLAN_CNT; idx++) {
+        if (vlan_conf.vlan[idx].vid == vid) {
+            entry = &vlan_conf.vlan[idx];
+            break;
+        }
+        if (entry == 0 && vlan_conf.vlan[idx].vid == H2_VLAN_VID_NONE) {
+            entry = &vlan_conf.vlan[idx];
+        }
+    }
+    if (entry == 0) {
+        return ERROR_VLAN_FULL;
+    }
+
+    if (entry->vid == vid) {
+        removed = entry->uport_mask & ~uport_mask;
+    } else {
+        /* New entry, all ports were members */
+        removed = ~uport_mask;
+    }
+    if (uport_mask == 0) {
+        /* Deleted, all ports are members again */
+        entry->vid = H2_VLAN_VID_NONE;
+        removed = 0;
+        _h2_vlan_tab_write(vid, ~(ulong) 0);
+    } else {
+        entry->vid = vid;
+        entry->uport_mask = uport_mask;
+        _h2_vlan_tab_write(vid, uport_mask);
+    }
+    _h2_vlan_wait_idle();
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        if (removed & ((ulong) 1 << uport)) {
+            h2_mactab_flush_port_vid(uport2cport(uport), vid);
+        }
+    }
+
+    flash_write_vlan_conf(&vlan_conf);
+    return 0;
+}
+
+/* ************************************************************************ */
+void h2_vlan_print (void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Print the VLAN configuration.
+ * Remarks     :
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_vlan_port_conf_t xdata *port_conf;
+    vtss_uport_no_t           uport;
+    uchar                     idx;
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        port_conf = &vlan_conf.port[uport - 1];
+        print_str("Port ");
+        print_dec(uport);
+        print_str(": PVID ");
+        print_dec(port_conf->pvid);
+        print_str(port_conf->aware ? ", aware" : ", unaware");
+        print_str(", tag ");
+        print_str(port_conf->tx_tag == H2_VLAN_TX_UNTAG ? "none" :
+                  port_conf->tx_tag == H2_VLAN_TX_TAG_ALL ? "all" : "all but PVID");
+        print_cr_lf();
+    }
+
+    for (idx = 0; idx < H2_VLAN_CNT; idx++) {
+        if (vlan_conf.vlan[idx].vid != H2_VLAN_VID_NONE) {
+            print_str("VLAN ");
+            print_dec(vlan_conf.vlan[idx].vid);
+            print_str(": ports 0x");
+            print_hex_dw(vlan_conf.vlan[idx].uport_mask);
+            print_cr_lf();
+        }
+    }
 }
+#endif // TRANSIT_VLAN
 
-static void _h2_vlan_do_command(ulong aces_value)
+/* ************************************************************************ */
+static void _h2_vlan_wait_idle(void)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Wait until the VLAN table command is done.
+ * Remarks     : Polls against tick_count, the timer of start_timer() may be
+ *               in use by the caller. The 16-bit tick_count is two byte
+ *               reads for the 8051 and the timer interrupt may come in
+ *               between, so it is read until two reads agree as in
+ *               us_clock_get().
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
 {
-    ulong cmd;
+    ulong  cmd;
+    ushort start, now;
 
-    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANACCESS, aces_value);
+    do {
+        start = tick_count;
+    } while (start != tick_count);
 
-    start_timer(MSEC_1000);
     do {
         H2_READ(VTSS_ANA_ANA_TABLES_VLANACCESS, cmd);
-    } while (VTSS_X_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(cmd) != VLAN_CMD_IDLE && !timeout());
+        if (VTSS_X_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(cmd) == VLAN_CMD_IDLE) {
+            return;
+        }
+        do {
+            now = tick_count;
+        } while (now != tick_count);
+    } while ((ushort) (now - start) < VLAN_TAB_TIMEOUT);
 
 #ifndef NDEBUG
-    if (timeout()) {
-        println_str("%% Timeout when calling _h2_vlan_do_command()");
-    }
+    println_str("%% Timeout when calling _h2_vlan_wait_idle()");
 #endif
 }
+
+#if TRANSIT_VLAN
+/* ************************************************************************ */
+static void _h2_vlan_tab_write(ushort vid, ulong uport_mask)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Issue a write of a VLAN table entry.
+ * Remarks     : Waits for the previous command only, so the chip runs a
+ *               command while the next one is prepared. Call
+ *               _h2_vlan_wait_idle() after the last write.
+ *               The CPU port is always a member.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    port_bit_mask_t chip_mask = PORT_BIT_MASK(CPU_CHIP_PORT);
+    vtss_uport_no_t uport;
+
+    for (uport = 1; uport <= NO_OF_BOARD_PORTS; uport++) {
+        if (uport_mask & ((ulong) 1 << uport)) {
+            chip_mask |= PORT_BIT_MASK(uport2cport(uport));
+        }
+    }
+
+    _h2_vlan_wait_idle();
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANTIDX,
+#if TRANSIT_MIRROR
+             VTSS_F_ANA_ANA_TABLES_VLANTIDX_VLAN_MIRROR(vid == vlan_mirror_vid) |
+#endif // TRANSIT_MIRROR
+             VTSS_F_ANA_ANA_TABLES_VLANTIDX_V_INDEX(vid));
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANACCESS,
+             VTSS_F_ANA_ANA_TABLES_VLANACCESS_VLAN_PORT_MASK(chip_mask) |
+             VTSS_F_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(VLAN_TAB_WRITE));
+}
+
+/* ************************************************************************ */
+static void _h2_vlan_port_apply(vtss_uport_no_t uport, const h2_vlan_port_conf_t *old_conf)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Write the VLAN configuration of a port to the switch chip.
+ * Remarks     : old_conf 0 writes all registers, otherwise only the
+ *               changed ones. The MAC addresses learned in the old PVID are
+ *               flushed when the PVID changes.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    h2_vlan_port_conf_t xdata *port_conf = &vlan_conf.port[uport - 1];
+    vtss_cport_no_t           chip_port = uport2cport(uport);
+
+    if (old_conf == 0 || old_conf->pvid != port_conf->pvid || old_conf->aware != port_conf->aware) {
+        /* Ingress classification, an aware port pops the tag */
+        H2_WRITE_MASKED(VTSS_ANA_PORT_VLAN_CFG(chip_port),
+                        VTSS_F_ANA_PORT_VLAN_CFG_VLAN_AWARE_ENA(port_conf->aware) |
+                        VTSS_F_ANA_PORT_VLAN_CFG_VLAN_POP_CNT(port_conf->aware ? 1 : 0) |
+                        VTSS_F_ANA_PORT_VLAN_CFG_VLAN_VID(port_conf->pvid),
+                        VTSS_M_ANA_PORT_VLAN_CFG_VLAN_AWARE_ENA |
+                        VTSS_M_ANA_PORT_VLAN_CFG_VLAN_POP_CNT |
+                        VTSS_M_ANA_PORT_VLAN_CFG_VLAN_VID);
+
+        /* Ingress filtering */
+        H2_WRITE_MASKED(VTSS_ANA_ANA_VLANMASK,
+                        port_conf->aware ? PORT_BIT_MASK(chip_port) : 0,
+                        PORT_BIT_MASK(chip_port));
+    }
+
+    if (old_conf == 0 || old_conf->pvid != port_conf->pvid || old_conf->tx_tag != port_conf->tx_tag) {
+        /* Egress tagging */
+        H2_WRITE_MASKED(VTSS_REW_PORT_PORT_VLAN_CFG(chip_port),
+                        VTSS_F_REW_PORT_PORT_VLAN_CFG_PORT_TPID(0x8100) |
+                        VTSS_F_REW_PORT_PORT_VLAN_CFG_PORT_VID(port_conf->pvid),
+                        VTSS_M_REW_PORT_PORT_VLAN_CFG_PORT_TPID |
+                        VTSS_M_REW_PORT_PORT_VLAN_CFG_PORT_VID);
+        H2_WRITE_MASKED(VTSS_REW_PORT_TAG_CFG(chip_port),
+                        VTSS_F_REW_PORT_TAG_CFG_TAG_CFG(port_conf->tx_tag) |
+                        VTSS_F_REW_PORT_TAG_CFG_TAG_TPID_CFG(0),
+                        VTSS_M_REW_PORT_TAG_CFG_TAG_CFG |
+                        VTSS_M_REW_PORT_TAG_CFG_TAG_TPID_CFG);
+    }
+
+    if (old_conf != 0 && old_conf->pvid != port_conf->pvid) {
+        h2_mactab_flush_port_vid(chip_port, old_conf->pvid);
+    }
+}
+#endif // TRANSIT_VLAN
+
+#if TRANSIT_MIRROR
+/* ************************************************************************ */
+static void _h2_vlan_mirror_write(ushort vid, BOOL enable)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Set or clear the mirror flag of a VLAN table entry.
+ * Remarks     : The entry is read first to keep its port mask.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    ulong value;
+
+    _h2_vlan_wait_idle();
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANTIDX, VTSS_F_ANA_ANA_TABLES_VLANTIDX_V_INDEX(vid));
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANACCESS,
+             VTSS_F_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(VLAN_TAB_READ));
+    _h2_vlan_wait_idle();
+    H2_READ(VTSS_ANA_ANA_TABLES_VLANACCESS, value);
+
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANTIDX,
+             VTSS_F_ANA_ANA_TABLES_VLANTIDX_VLAN_MIRROR(enable) |
+             VTSS_F_ANA_ANA_TABLES_VLANTIDX_V_INDEX(vid));
+    H2_WRITE(VTSS_ANA_ANA_TABLES_VLANACCESS,
+             (value & VTSS_M_ANA_ANA_TABLES_VLANACCESS_VLAN_PORT_MASK) |
+             VTSS_F_ANA_ANA_TABLES_VLANACCESS_VLAN_TBL_CMD(VLAN_TAB_WRITE));
+    _h2_vlan_wait_idle();
+}
+#endif // TRANSIT_MIRROR
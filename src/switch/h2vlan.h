@@ -6,7 +6,55 @@
 #ifndef __H2VLAN_H__
 #define __H2VLAN_H__
 
+/* Egress tagging, values of REW:PORT:TAG_CFG:TAG_CFG */
+#define H2_VLAN_TX_UNTAG        0       /* Untag all frames */
+#define H2_VLAN_TX_TAG_NO_PVID  1       /* Tag all frames except in the PVID */
+#define H2_VLAN_TX_TAG_NO_PVID0 2       /* Tag all frames except in the PVID and VID 0 */
+#define H2_VLAN_TX_TAG_ALL      3       /* Tag all frames */
+
+#if TRANSIT_VLAN
+#define H2_VLAN_CNT             8       /* VLAN table entries in the configuration */
+#define H2_VLAN_VID_NONE        0       /* Unused VLAN table entry */
+#define H2_VLAN_VID_MAX         4095
+#define H2_VLAN_PVID_DEFAULT    1
+
+/*
+ * A port is VLAN unaware by default and classifies all frames to its PVID,
+ * which gives port-based VLANs. An aware port classifies tagged frames to
+ * their VID and discards frames of VLANs it is not member of.
+ */
+typedef struct {
+    ushort  pvid;                       /* Port VLAN ID, 1-4095 */
+    uchar   aware;                      /* IEEE 802.1Q aware */
+    uchar   tx_tag;                     /* H2_VLAN_TX_xxx */
+} h2_vlan_port_conf_t;
+
+/* VLANs not in the table keep all ports as members */
+typedef struct {
+    ushort  vid;                        /* H2_VLAN_VID_NONE for an unused entry */
+    ulong   uport_mask;                 /* Member ports, bit n is uport n */
+} h2_vlan_entry_t;
+
+typedef struct {
+    h2_vlan_port_conf_t port[NO_OF_BOARD_PORTS];
+    h2_vlan_entry_t     vlan[H2_VLAN_CNT];
+} h2_vlan_conf_t;
+
+#define ERROR_VLAN_PARM     1           /* Invalid parameter */
+#define ERROR_VLAN_FULL     2           /* No free VLAN table entry */
+
+void   h2_vlan_init (void);
+uchar  h2_vlan_port_set (vtss_uport_no_t uport, const h2_vlan_port_conf_t *port_conf);
+uchar  h2_vlan_entry_set (ushort vid, ulong uport_mask);
+void   h2_vlan_print (void);
+#endif // TRANSIT_VLAN
+
 void   h2_vlan_clear_tab (void);
+ulong  h2_vlan_members_get (ushort vid);
+BOOL   h2_vlan_tx_tagged (vtss_cport_no_t chip_port, ushort vid);
+#if TRANSIT_MIRROR
+void   h2_vlan_mirror_set (ushort vid);
+#endif // TRANSIT_MIRROR
 
 #endif
 
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+# Copyright (c) 2004-2020 Microchip Technology Inc. and its subsidiaries.
+# SPDX-License-Identifier: MIT
+#
+# Decode and replay a register access trace, the output of the CLI command
+# TRACE (h2_trace_print() in h2trace.c):
+#   python3 trace_decode.py [-r <regs dir>] [<dump file>]
+# The records are printed with the register names of vtss_ocelot_regs_*.h,
+# e.g. ANA:PORT[3]:VLAN_CFG or DEV_2:MAC_CFG_STATUS:MAC_ENA_CFG. Then the
+# trace is replayed into a register file which starts unknown, and the
+# accesses are counted per register and per target. A write of the value
+# the register already holds and a read of a value already known from an
+# earlier access of the trace are counted as avoidable; a read of a status
+# register may still be needed, see the register description.
+# The dump is read from stdin when no file is given. Other lines of the
+# console log, such as the command echo, are skipped.
+#
+# trace.txt is a sample dump, expected.txt the output to compare with:
+#   python3 trace_decode.py trace.txt | diff - expected.txt
+
+import glob
+import os
+import re
+import sys
+
+REGS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'vtss_api', 'base', 'ocelot')
+
+RE_ORIGIN = re.compile(r'#define VTSS_IO_ORIGIN(\d)_OFFSET\s+(0x[0-9a-fA-F]+)')
+RE_TARGET = re.compile(r'#define VTSS_TO_(\w+)\s+VTSS_IO_OFFSET(\d)\((0x[0-9a-fA-F]+)\)')
+RE_DOC_REG = re.compile(r'Register: \\a (\S+)')
+RE_DOC_PARAM = re.compile(r'@param (gi|ri) .*, (\d+)-(\d+)\s*$')
+RE_DOC_TARGET = re.compile(r'@param target A \\a ::vtss_target_(\w+)_e target')
+RE_REG = re.compile(r'#define VTSS_\w+?(\([\w,]+\))?\s+VTSS_IOREG(_IX)?\(([^)]*\)?)\)\s*$')
+RE_REC = re.compile(r'^\s*(\d+) (RD|WR|PR|PW) 0x([0-9A-Fa-f]{8}) 0x([0-9A-Fa-f]{8})\s*$')
+
+
+def target_instances(family, targets):
+    """Targets of a register defined with a target parameter"""
+    if family == 'VCAP_CORE':
+        return [t for t in targets if t.startswith('VCAP_')]
+    return [t for t in targets if re.fullmatch(family + r'_?\d*', t)]
+
+
+def load_regs(regs_dir):
+    """Map of address to register name from vtss_ocelot_regs_*.h"""
+    origin = {}
+    targets = {}
+    with open(os.path.join(regs_dir, 'vtss_ocelot_regs_common.h')) as f:
+        for line in f:
+            m = RE_ORIGIN.match(line)
+            if m:
+                origin[m.group(1)] = int(m.group(2), 16)
+            m = RE_TARGET.match(line)
+            if m:
+                targets.setdefault(m.group(1), origin[m.group(2)] + int(m.group(3), 16))
+
+    regs = {}
+    for path in sorted(glob.glob(os.path.join(regs_dir, 'vtss_ocelot_regs_*.h'))):
+        name, rng, family = None, {}, None
+        with open(path) as f:
+            for line in f:
+                m = RE_DOC_REG.search(line)
+                if m:
+                    name, rng, family = m.group(1), {}, None
+                    continue
+                m = RE_DOC_PARAM.search(line)
+                if m:
+                    rng[m.group(1)] = range(int(m.group(2)), int(m.group(3)) + 1)
+                    continue
+                m = RE_DOC_TARGET.search(line)
+                if m:
+                    family = m.group(1)
+                    continue
+                m = RE_REG.match(line)
+                if not m or name is None:
+                    continue
+                add_reg(regs, targets, name, rng, family, m.group(2), m.group(3).replace(' ', ''))
+                name = None
+    return regs
+
+
+def add_reg(regs, targets, name, rng, family, ix, args):
+    args = args.split(',')
+    tgt, grp, reg = name.split(':')
+    if args[0] == 'target':
+        bases = [(t, targets[t]) for t in target_instances(family, targets)]
+    else:
+        bases = [(tgt, targets[args[0][len('VTSS_TO_'):]])]
+
+    if ix:
+        # VTSS_IOREG_IX(t,o,gi,gw,ri,ro): o + gi * gw + ri + ro
+        off, gw, ro = int(args[1], 16), int(args[3]), int(args[5])
+        ris = rng.get('ri', [0]) if args[4] == 'ri' else [int(args[4])]
+        for t, base in bases:
+            for gi in rng.get('gi', [0]):
+                for ri in ris:
+                    rname = '%s[%u]' % (reg, ri) if args[4] == 'ri' else reg
+                    addr = base + 4 * (off + gi * gw + ri + ro)
+                    regs.setdefault(addr, '%s:%s[%u]:%s' % (t, grp, gi, rname))
+        return
+
+    # VTSS_IOREG(t,o) or VTSS_IOREG(t,o + (ri))
+    off = int(args[1].split('+')[0], 16)
+    for t, base in bases:
+        if '+' in args[1]:
+            for ri in rng.get('ri', [0]):
+                regs.setdefault(base + 4 * (off + ri), '%s:%s:%s[%u]' % (t, grp, reg, ri))
+        else:
+            regs.setdefault(base + 4 * off, '%s:%s:%s' % (t, grp, reg))
+
+
+def rec_name(regs, op, addr):
+    if op in ('PR', 'PW'):
+        return 'PHY[%u]:%u' % (addr >> 8, addr & 0xFF)
+    return regs.get(addr, '?')
+
+
+def main(argv):
+    regs_dir = REGS_DIR
+    if len(argv) > 2 and argv[1] == '-r':
+        regs_dir = argv[2]
+        argv = argv[:1] + argv[3:]
+    regs = load_regs(regs_dir)
+    dump = open(argv[1]) if len(argv) > 1 else sys.stdin
+
+    known = {}      # (phy, addr): value held by the register file
+    stats = {}      # name: [reads, writes, known reads, same writes]
+    print('      Tick Op Address    Value      Register')
+    for line in dump:
+        m = RE_REC.match(line)
+        if not m:
+            continue
+        tick, op = int(m.group(1)), m.group(2)
+        addr, value = int(m.group(3), 16), int(m.group(4), 16)
+        name = rec_name(regs, op, addr)
+        print('%10u %s 0x%08X 0x%08X %s' % (tick, op, addr, value, name))
+
+        key = (op[0] == 'P', addr)
+        st = stats.setdefault(name if name != '?' else '? 0x%08X' % addr, [0, 0, 0, 0])
+        if op in ('RD', 'PR'):
+            st[0] += 1
+            if known.get(key) == value:
+                st[2] += 1
+        else:
+            st[1] += 1
+            if known.get(key) == value:
+                st[3] += 1
+        known[key] = value
+
+    print()
+    print('Replay: reads, writes, reads of a known value, writes of the value held')
+    tgt = {}
+    for name in sorted(stats):
+        st = stats[name]
+        print('%-48s %5u %5u %5u %5u' % (name, st[0], st[1], st[2], st[3]))
+        t = tgt.setdefault(name.split(':')[0].split('[')[0].split(' ')[0], [0, 0, 0, 0])
+        for i in range(4):
+            t[i] += st[i]
+    print()
+    tot = [0, 0, 0, 0]
+    for t in sorted(tgt):
+        print('%-48s %5u %5u %5u %5u' % (t, tgt[t][0], tgt[t][1], tgt[t][2], tgt[t][3]))
+        for i in range(4):
+            tot[i] += tgt[t][i]
+    print('%-48s %5u %5u %5u %5u' % ('Total', tot[0], tot[1], tot[2], tot[3]))
+
+
+if __name__ == '__main__':
+    main(sys.argv)
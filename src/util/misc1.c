@@ -135,4 +135,56 @@ void xmemcpy(uchar xdata *dst, uchar xdata *src, ushort length)
         }
     }
 }
-#endif
\ No newline at end of file
+#endif
+
+#if TRANSIT_SPI_FLASH_JOURNAL || TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_BIN_PROTO
+/* ************************************************************************ */
+ushort crc16_update (ushort crc, uchar ch)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Update a CRC-16/CCITT with one byte.
+ * Remarks     : Start with crc = CRC16_INIT. Bitwise to save code space,
+ *               the callers only checksum a few bytes at a time.
+ * Restrictions:
+ * See also    :
+ * Example     :
+ ****************************************************************************/
+{
+    uchar i;
+
+    crc ^= (ushort) ch << 8;
+    for (i = 0; i < 8; i++) {
+        if (crc & 0x8000) {
+            crc = (crc << 1) ^ 0x1021;
+        } else {
+            crc <<= 1;
+        }
+    }
+    return crc;
+}
+#endif // TRANSIT_SPI_FLASH_JOURNAL || TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_BIN_PROTO
+
+#if TRANSIT_SPI_FLASH_MANIFEST
+/* ************************************************************************ */
+ulong crc32_update (ulong crc, uchar ch)
+/* ------------------------------------------------------------------------ --
+ * Purpose     : Update a CRC-32 with one byte.
+ * Remarks     : Start with crc = CRC32_INIT and invert the result. Bitwise,
+ *               a 1K lookup table does not fit the code budget.
+ * Restrictions:
+ * See also    : crc16_update
+ * Example     :
+ ****************************************************************************/
+{
+    uchar i;
+
+    crc ^= ch;
+    for (i = 0; i < 8; i++) {
+        if (crc & 1) {
+            crc = (crc >> 1) ^ 0xEDB88320UL;
+        } else {
+            crc >>= 1;
+        }
+    }
+    return crc;
+}
+#endif // TRANSIT_SPI_FLASH_MANIFEST
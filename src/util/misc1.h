@@ -15,4 +15,17 @@ uchar ascii_to_hex_nib (uchar ch);
 uchar hex_to_ascii_nib (uchar nib);
 char  conv_to_upper_case (char ch);
 
+#if TRANSIT_SPI_FLASH_JOURNAL || TRANSIT_UNMANAGED_SWUP_STREAM || TRANSIT_BIN_PROTO
+/* CRC-16/CCITT (polynomial 0x1021), updated one byte at a time */
+#define CRC16_INIT      0xFFFF
+ushort crc16_update (ushort crc, uchar ch);
+#endif
+
+#if TRANSIT_SPI_FLASH_MANIFEST
+/* CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320), updated one byte at
+   a time. The final value is ~crc. */
+#define CRC32_INIT      0xFFFFFFFFUL
+ulong crc32_update (ulong crc, uchar ch);
+#endif
+
 #endif